@@ -0,0 +1,8 @@
+--
+DELETE FROM `rbac_permissions` WHERE `id`=799;
+INSERT INTO `rbac_permissions` (`id`,`name`) VALUES
+(799,'Command: debug mapupdater');
+
+DELETE FROM `rbac_linked_permissions` WHERE `linkedId`=799;
+INSERT INTO `rbac_linked_permissions` (`id`,`linkedId`) VALUES
+(196,799);
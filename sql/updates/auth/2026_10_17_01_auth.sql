@@ -0,0 +1,7 @@
+DELETE FROM `rbac_permissions` WHERE `id`=800;
+INSERT INTO `rbac_permissions` (`id`,`name`) VALUES
+(800,'Command: debug netlatency');
+
+DELETE FROM `rbac_linked_permissions` WHERE `linkedId`=800;
+INSERT INTO `rbac_linked_permissions` (`id`,`linkedId`) VALUES
+(196,800);
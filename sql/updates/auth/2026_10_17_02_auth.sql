@@ -0,0 +1,7 @@
+DELETE FROM `rbac_permissions` WHERE `id`=801;
+INSERT INTO `rbac_permissions` (`id`,`name`) VALUES
+(801,'Command: debug compression');
+
+DELETE FROM `rbac_linked_permissions` WHERE `linkedId`=801;
+INSERT INTO `rbac_linked_permissions` (`id`,`linkedId`) VALUES
+(196,801);
@@ -0,0 +1,7 @@
+DELETE FROM `rbac_permissions` WHERE `id`=802;
+INSERT INTO `rbac_permissions` (`id`,`name`) VALUES
+(802,'Command: debug updatecache');
+
+DELETE FROM `rbac_linked_permissions` WHERE `linkedId`=802;
+INSERT INTO `rbac_linked_permissions` (`id`,`linkedId`) VALUES
+(196,802);
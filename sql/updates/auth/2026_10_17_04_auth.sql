@@ -0,0 +1,7 @@
+DELETE FROM `rbac_permissions` WHERE `id`=803;
+INSERT INTO `rbac_permissions` (`id`,`name`) VALUES
+(803,'Command: debug auctionsearch');
+
+DELETE FROM `rbac_linked_permissions` WHERE `linkedId`=803;
+INSERT INTO `rbac_linked_permissions` (`id`,`linkedId`) VALUES
+(196,803);
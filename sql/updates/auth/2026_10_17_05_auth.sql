@@ -0,0 +1,7 @@
+DELETE FROM `rbac_permissions` WHERE `id`=804;
+INSERT INTO `rbac_permissions` (`id`,`name`) VALUES
+(804,'Command: debug movementcodecs');
+
+DELETE FROM `rbac_linked_permissions` WHERE `linkedId`=804;
+INSERT INTO `rbac_linked_permissions` (`id`,`linkedId`) VALUES
+(196,804);
@@ -0,0 +1,7 @@
+DELETE FROM `rbac_permissions` WHERE `id`=805;
+INSERT INTO `rbac_permissions` (`id`,`name`) VALUES
+(805,'Command: debug dbqueues');
+
+DELETE FROM `rbac_linked_permissions` WHERE `linkedId`=805;
+INSERT INTO `rbac_linked_permissions` (`id`,`linkedId`) VALUES
+(196,805);
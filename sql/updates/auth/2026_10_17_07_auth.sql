@@ -0,0 +1,7 @@
+DELETE FROM `rbac_permissions` WHERE `id`=806;
+INSERT INTO `rbac_permissions` (`id`,`name`) VALUES
+(806,'Command: debug playersave');
+
+DELETE FROM `rbac_linked_permissions` WHERE `linkedId`=806;
+INSERT INTO `rbac_linked_permissions` (`id`,`linkedId`) VALUES
+(196,806);
@@ -0,0 +1,7 @@
+DELETE FROM `rbac_permissions` WHERE `id`=807;
+INSERT INTO `rbac_permissions` (`id`,`name`) VALUES
+(807,'Command: debug logbench');
+
+DELETE FROM `rbac_linked_permissions` WHERE `linkedId`=807;
+INSERT INTO `rbac_linked_permissions` (`id`,`linkedId`) VALUES
+(196,807);
@@ -0,0 +1,7 @@
+DELETE FROM `rbac_permissions` WHERE `id`=808;
+INSERT INTO `rbac_permissions` (`id`,`name`) VALUES
+(808,'Command: debug vmapbench');
+
+DELETE FROM `rbac_linked_permissions` WHERE `linkedId`=808;
+INSERT INTO `rbac_linked_permissions` (`id`,`linkedId`) VALUES
+(196,808);
@@ -0,0 +1,7 @@
+DELETE FROM `rbac_permissions` WHERE `id`=809;
+INSERT INTO `rbac_permissions` (`id`,`name`) VALUES
+(809,'Command: debug collisioncache');
+
+DELETE FROM `rbac_linked_permissions` WHERE `linkedId`=809;
+INSERT INTO `rbac_linked_permissions` (`id`,`linkedId`) VALUES
+(196,809);
@@ -0,0 +1,7 @@
+DELETE FROM `rbac_permissions` WHERE `id`=810;
+INSERT INTO `rbac_permissions` (`id`,`name`) VALUES
+(810,'Command: debug achievementstats');
+
+DELETE FROM `rbac_linked_permissions` WHERE `linkedId`=810;
+INSERT INTO `rbac_linked_permissions` (`id`,`linkedId`) VALUES
+(196,810);
@@ -0,0 +1,7 @@
+DELETE FROM `rbac_permissions` WHERE `id`=812;
+INSERT INTO `rbac_permissions` (`id`,`name`) VALUES
+(812,'Command: debug gridpreload');
+
+DELETE FROM `rbac_linked_permissions` WHERE `linkedId`=812;
+INSERT INTO `rbac_linked_permissions` (`id`,`linkedId`) VALUES
+(196,812);
@@ -0,0 +1,7 @@
+DELETE FROM `rbac_permissions` WHERE `id`=813;
+INSERT INTO `rbac_permissions` (`id`,`name`) VALUES
+(813,'Command: debug terrainbench');
+
+DELETE FROM `rbac_linked_permissions` WHERE `linkedId`=813;
+INSERT INTO `rbac_linked_permissions` (`id`,`linkedId`) VALUES
+(196,813);
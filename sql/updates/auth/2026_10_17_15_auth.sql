@@ -0,0 +1,7 @@
+DELETE FROM `rbac_permissions` WHERE `id`=814;
+INSERT INTO `rbac_permissions` (`id`,`name`) VALUES
+(814,'Command: debug auramodbench');
+
+DELETE FROM `rbac_linked_permissions` WHERE `linkedId`=814;
+INSERT INTO `rbac_linked_permissions` (`id`,`linkedId`) VALUES
+(196,814);
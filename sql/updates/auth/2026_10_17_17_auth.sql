@@ -0,0 +1,7 @@
+DELETE FROM `rbac_permissions` WHERE `id`=816;
+INSERT INTO `rbac_permissions` (`id`,`name`) VALUES
+(816,'Command: debug regionbench');
+
+DELETE FROM `rbac_linked_permissions` WHERE `linkedId`=816;
+INSERT INTO `rbac_linked_permissions` (`id`,`linkedId`) VALUES
+(196,816);
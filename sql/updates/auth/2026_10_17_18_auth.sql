@@ -0,0 +1,7 @@
+DELETE FROM `rbac_permissions` WHERE `id`=817;
+INSERT INTO `rbac_permissions` (`id`,`name`) VALUES
+(817,'Command: debug lfgbench');
+
+DELETE FROM `rbac_linked_permissions` WHERE `linkedId`=817;
+INSERT INTO `rbac_linked_permissions` (`id`,`linkedId`) VALUES
+(196,817);
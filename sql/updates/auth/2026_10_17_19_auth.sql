@@ -0,0 +1,7 @@
+DELETE FROM `rbac_permissions` WHERE `id`=818;
+INSERT INTO `rbac_permissions` (`id`,`name`) VALUES
+(818,'Command: debug broadcastbench');
+
+DELETE FROM `rbac_linked_permissions` WHERE `linkedId`=818;
+INSERT INTO `rbac_linked_permissions` (`id`,`linkedId`) VALUES
+(196,818);
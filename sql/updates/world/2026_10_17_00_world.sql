@@ -0,0 +1,4 @@
+--
+DELETE FROM `command` WHERE `name`='debug mapupdater';
+INSERT INTO `command` (`name`,`permission`,`help`) VALUES
+('debug mapupdater',799,'Syntax: .debug mapupdater\r\n\r\nShow busy and idle time, number of map updates and stolen updates for every map update worker thread.');
@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name`='debug netlatency';
+INSERT INTO `command` (`name`,`permission`,`help`) VALUES
+('debug netlatency',800,'Syntax: .debug netlatency [reset]\r\n\r\nShow the latency between queueing a packet on an idle world socket and the data being written to the network. Optionally resets the collected samples.');
@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name`='debug compression';
+INSERT INTO `command` (`name`,`permission`,`help`) VALUES
+('debug compression',801,'Syntax: .debug compression\r\n\r\nShow the opcodes that spent the most time in packet compression, with packet count, total and average compression time and compression ratio.');
@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name`='debug updatecache';
+INSERT INTO `command` (`name`,`permission`,`help`) VALUES
+('debug updatecache',802,'Syntax: .debug updatecache\r\n\r\nShow how many object values update blocks were built and how many were reused for other players with the same visibility of the object.');
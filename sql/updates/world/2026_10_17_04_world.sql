@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name`='debug auctionsearch';
+INSERT INTO `command` (`name`,`permission`,`help`) VALUES
+('debug auctionsearch',803,'Syntax: .debug auctionsearch [#auctions]\r\n\r\nBuild a synthetic auction house (2000 auctions by default, at most 5000) from random item templates and compare the time of a few searches done by scanning every auction against the search index.');
@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name`='debug movementcodecs';
+INSERT INTO `command` (`name`,`permission`,`help`) VALUES
+('debug movementcodecs',804,'Syntax: .debug movementcodecs [#iterations]\r\n\r\nEncode #iterations (100 by default, at most 1000) random movement status blocks with the codec of every movement opcode and with the element interpreter used before the codecs, then decode and encode them again. Reports blocks whose bytes differ from the old encoding or do not survive the round trip, and the average time needed to decode a heartbeat.');
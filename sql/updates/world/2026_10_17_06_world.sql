@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name`='debug dbqueues';
+INSERT INTO `command` (`name`,`permission`,`help`) VALUES
+('debug dbqueues',805,'Syntax: .debug dbqueues [reset]\r\n\r\nShow queue length, batching and latency statistics of the asynchronous login, world and character database workers. With reset, the statistics are cleared after being shown.');
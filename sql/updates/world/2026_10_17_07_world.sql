@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name`='debug playersave';
+INSERT INTO `command` (`name`,`permission`,`help`) VALUES
+('debug playersave',806,'Syntax: .debug playersave [reset]\r\n\r\nShow the average number of statements and bytes written per player save, separately for autosaves and other saves, and how many unchanged sections were skipped. With reset, the statistics are cleared after being shown.');
@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name`='debug logbench';
+INSERT INTO `command` (`name`,`permission`,`help`) VALUES
+('debug logbench',807,'Syntax: .debug logbench [#count] [filter]\r\n\r\nMeasure the logging system. Shows the cost of a filtered out log call for the given filter (default debug.logbench), and if a logger is configured for exactly that filter (e.g. Logger.debug.logbench with its own appender) and logs at info level, writes #count messages (default 10000) to it and shows messages per second and the latency seen by the caller. Parent loggers are never written to.');
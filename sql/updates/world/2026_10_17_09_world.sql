@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name`='debug vmapbench';
+INSERT INTO `command` (`name`,`permission`,`help`) VALUES
+('debug vmapbench',808,'Syntax: .debug vmapbench [#rays]\r\n\r\nTrace #rays (default 10000, at most 100000) random line of sight rays within 100 yards of you through the vmaps of your map. The rays are traced as one batch with the scalar triangle test, as one batch with the SIMD triangle test and once with one call per ray. Shows the time taken by each run and how many results differ between them.');
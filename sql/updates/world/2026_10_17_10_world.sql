@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name`='debug collisioncache';
+INSERT INTO `command` (`name`,`permission`,`help`) VALUES
+('debug collisioncache',809,'Syntax: .debug collisioncache [reset]\r\n\r\nShow the hits and misses of the line of sight and ground height cache of your current map. Hits where only GameObjects had to be checked again are counted separately. With reset, the statistics are cleared after being shown.');
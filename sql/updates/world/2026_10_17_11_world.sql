@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name`='debug achievementstats';
+INSERT INTO `command` (`name`,`permission`,`help`) VALUES
+('debug achievementstats',810,'Syntax: .debug achievementstats [reset]\r\n\r\nShow how many achievement criteria were visited per criteria update event, in total and for the ten most visited criteria types, and how many were skipped by the criteria index. With reset, the statistics are cleared after being shown.');
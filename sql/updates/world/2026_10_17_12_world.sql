@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name`='debug objectupdates';
+INSERT INTO `command` (`name`,`permission`,`help`) VALUES
+('debug objectupdates',811,'Syntax: .debug objectupdates [reset]\r\n\r\nShow how long your current map spent sending the changed fields of its objects at the end of its updates: objects and packets sent, time spent building the updates and time spent building and sending the packets. With reset, the statistics are cleared after being shown.');
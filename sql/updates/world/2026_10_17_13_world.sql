@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name`='debug gridpreload';
+INSERT INTO `command` (`name`,`permission`,`help`) VALUES
+('debug gridpreload',812,'Syntax: .debug gridpreload [reset]\r\n\r\nShow how many grids were read ahead of moving players by the grid preloader, how many grid loads found their terrain prefetched and how many read it on the map thread, and the time spent on each. With reset, the statistics are cleared after being shown.');
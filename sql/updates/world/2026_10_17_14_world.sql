@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name`='debug terrainbench';
+INSERT INTO `command` (`name`,`permission`,`help`) VALUES
+('debug terrainbench',813,'Syntax: .debug terrainbench [#radius]\r\n\r\nLoad the .map and .mmtile files of the grids within #radius (default 1, at most 2) of your grid once read into buffers and once memory mapped, and show the load time, the time of the first access to the data and how much the resident memory of the process grew in each mode (anonymous and file backed pages on Linux, the working set on Windows). The files are read once before to have both modes start from the page cache. The map is not updated while the files load.');
@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name`='debug auramodbench';
+INSERT INTO `command` (`name`,`permission`,`help`) VALUES
+('debug auramodbench',814,'Syntax: .debug auramodbench [#hits]\r\n\r\nRun the aura modifier queries of #hits (default 10000, at most 100000) simulated melee and spell hits against the selected unit, once walking its aura effects and once through the unit''s queries, which use the cached modifiers when Auras.ModifierCache is enabled. Shows the time taken by each and whether both gave the same results. Also shows how many stale cached values Auras.ModifierCache.Check has found.');
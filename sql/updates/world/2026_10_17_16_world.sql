@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name`='debug spellallocbench';
+INSERT INTO `command` (`name`,`permission`,`help`) VALUES
+('debug spellallocbench',815,'Syntax: .debug spellallocbench #spellid [#rounds]\r\n\r\nSimulate #rounds (default 20, at most 200) rounds of a 25 player fight: 25 triggers in a ring around 10 hostile dummies in front of you cast #spellid within one second, the next second lets launched spells hit. The fight runs once with Spells.AllocationPool enabled and once disabled. Shows the time taken, the damage dealt, the global heap allocations and bytes of all threads per cast and how many allocations per cast the pool served. The configured setting is restored and the summons are despawned afterwards. The map is not updated while the command runs.');
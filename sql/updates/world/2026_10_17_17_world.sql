@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name`='debug regionbench';
+INSERT INTO `command` (`name`,`permission`,`help`) VALUES
+('debug regionbench',816,'Syntax: .debug regionbench [#clusters] [#creatures]\r\n\r\nSpawn #clusters (default 4, at most 16) clusters of #creatures (default 50, at most 200) wandering triggers in a row east of you, far enough apart to be updated as separate regions. Then update the active cells of the map 20 times with one thread, and again with twice as many threads up to one per region or all map update threads. Shows the regions found and the time per tick for every thread count. The triggers are despawned afterwards.');
@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name`='debug lfgbench';
+INSERT INTO `command` (`name`,`permission`,`help`) VALUES
+('debug lfgbench',817,'Syntax: .debug lfgbench [#players]\r\n\r\nQueue #players (default 5000, at most 5000) simulated solo players in a dungeon finder queue of their own, 250 per update, and match them after every update. Shows the groups formed, the players left in the queue, the size of the compatibility cache and the time spent matching. Matched players leave at once, no proposals are sent and the real queues are not touched. No new updates are started after 30 seconds. The server does not update while the test runs.');
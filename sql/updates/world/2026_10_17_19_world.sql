@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name`='debug broadcastbench';
+INSERT INTO `command` (`name`,`permission`,`help`) VALUES
+('debug broadcastbench',818,'Syntax: .debug broadcastbench [#sessions] [#bytes]\r\n\r\nConnect #sessions (default 5000, at most 5000) sessions to client sockets over loopback and broadcast a system message of #bytes (default 512, at most 900) to all of them 10 times, once copying the packet for every session and once sharing one copy between all sockets. Shows the time per broadcast on the sending thread and the time until the clients received everything. Every session needs two file descriptors and a compression stream, raise the open file limit for large counts. The server does not update while the test runs.');
@@ -30,6 +30,7 @@
 #include <algorithm>
 #include <limits>
 #include <cmath>
+#include <type_traits>
 
 #define MAX_STACK_SIZE 64
 
@@ -60,6 +61,11 @@ struct AABound
     G3D::Vector3 lo, hi;
 };
 
+/** Ray callbacks deriving from this are passed whole leaves instead of single objects:
+    bool IntersectLeaf(const G3D::Ray& ray, uint32 firstPosition, uint32 count, float& maxDist, bool stopAtFirst)
+    The positions index the object order of the tree, see BIH::getObject(). */
+struct BIHLeafRayCallback { };
+
 /** Bounding Interval Hierarchy Class.
     Building and Ray-Intersection functions based on BIH from
     Sunflow, a Java Raytracer, released under MIT/X11 License
@@ -116,6 +122,8 @@ class BIH
             delete[] dat.indices;
         }
         uint32 primCount() const { return objects.size(); }
+        //! primitive stored at the given position, leaves reference consecutive positions
+        uint32 getObject(uint32 position) const { return objects[position]; }
 
         template<typename RayCallback>
         void intersectRay(const G3D::Ray &r, RayCallback& intersectCallback, float &maxDist, bool stopAtFirst=false) const
@@ -216,12 +224,9 @@ class BIH
                         {
                             // leaf - test some objects
                             int n = tree[node + 1];
-                            while (n > 0) {
-                                bool hit = intersectCallback(r, objects[offset], maxDist, stopAtFirst);
-                                if (stopAtFirst && hit) return;
-                                --n;
-                                ++offset;
-                            }
+                            if (intersectLeaf(r, intersectCallback, offset, n, maxDist, stopAtFirst,
+                                typename std::is_base_of<BIHLeafRayCallback, RayCallback>::type()))
+                                return;
                             break;
                         }
                     }
@@ -338,6 +343,26 @@ class BIH
         bool readFromFile(FILE* rf);
 
     protected:
+        // returns true if traversal should stop
+        template<typename RayCallback>
+        bool intersectLeaf(const G3D::Ray &r, RayCallback& intersectCallback, int offset, int n, float &maxDist, bool stopAtFirst, std::false_type) const
+        {
+            while (n > 0) {
+                bool hit = intersectCallback(r, objects[offset], maxDist, stopAtFirst);
+                if (stopAtFirst && hit) return true;
+                --n;
+                ++offset;
+            }
+            return false;
+        }
+
+        template<typename RayCallback>
+        bool intersectLeaf(const G3D::Ray &r, RayCallback& intersectCallback, int offset, int n, float &maxDist, bool stopAtFirst, std::true_type) const
+        {
+            bool hit = intersectCallback.IntersectLeaf(r, uint32(offset), uint32(n), maxDist, stopAtFirst);
+            return stopAtFirst && hit;
+        }
+
         std::vector<uint32> tree;
         std::vector<uint32> objects;
         G3D::AABox bounds;
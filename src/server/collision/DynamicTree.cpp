@@ -107,7 +107,7 @@ struct DynTreeImpl : public ParentTree/*, public Intersectable*/
     int unbalanced_times;
 };
 
-DynamicMapTree::DynamicMapTree() : impl(new DynTreeImpl()) { }
+DynamicMapTree::DynamicMapTree() : impl(new DynTreeImpl()), generation(0) { }
 
 DynamicMapTree::~DynamicMapTree()
 {
@@ -117,11 +117,13 @@ DynamicMapTree::~DynamicMapTree()
 void DynamicMapTree::insert(const GameObjectModel& mdl)
 {
     impl->insert(mdl);
+    invalidate();
 }
 
 void DynamicMapTree::remove(const GameObjectModel& mdl)
 {
     impl->remove(mdl);
+    invalidate();
 }
 
 bool DynamicMapTree::contains(const GameObjectModel& mdl) const
@@ -21,6 +21,7 @@
 #define _DYNTREE_H
 
 #include "Define.h"
+#include <atomic>
 
 namespace G3D
 {
@@ -34,6 +35,7 @@ struct DynTreeImpl;
 class DynamicMapTree
 {
     DynTreeImpl *impl;
+    std::atomic<uint32> generation;
 
 public:
 
@@ -59,6 +61,11 @@ public:
 
     void balance();
     void update(uint32 diff);
+
+    //! changes whenever models are inserted, removed or toggled, for caches of query results
+    uint32 getGeneration() const { return generation.load(std::memory_order_acquire); }
+    //! a model changed in place (enabled, disabled or phased)
+    void invalidate() { ++generation; }
 };
 
 #endif // _DYNTREE_H
@@ -41,6 +41,14 @@ namespace VMAP
     #define VMAP_INVALID_HEIGHT       -100000.0f            // for check
     #define VMAP_INVALID_HEIGHT_VALUE -200000.0f            // real assigned value in unknown height case
 
+    /// One ray of a batched line of sight check, positions in game coordinates
+    struct LineOfSightRay
+    {
+        float X1, Y1, Z1;
+        float X2, Y2, Z2;
+        bool Result;                                        // out: true if nothing blocks the ray
+    };
+
     //===========================================================
     class IVMapManager
     {
@@ -61,6 +69,8 @@ namespace VMAP
             virtual void unloadMap(unsigned int pMapId) = 0;
 
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) = 0;
+            /// Traces all rays against the same map, the map tree is only looked up once
+            virtual void isInLineOfSight(unsigned int pMapId, LineOfSightRay* rays, size_t count) = 0;
             virtual float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist) = 0;
             /**
             test if we hit an object. return true if we hit one. rx, ry, rz will hold the hit position or the dest position, if no intersection was found
@@ -124,45 +124,79 @@ namespace MMAP
         if (!loadMapData(mapId))
             return false;
 
-        // get this mmap data
-        MMapData* mmap = loadedMMaps[mapId];
-        ASSERT(mmap->navMesh);
-
         // check if we already have this tile loaded
-        uint32 packedGridPos = packTileID(x, y);
-        if (mmap->loadedTileRefs.find(packedGridPos) != mmap->loadedTileRefs.end())
+        if (loadedMMaps[mapId]->loadedTileRefs.find(packTileID(x, y)) != loadedMMaps[mapId]->loadedTileRefs.end())
             return false;
 
+        if (sWorld->getBoolConfig(CONFIG_MEMORY_MAPPED_DATA_FILES))
+        {
+            std::unique_ptr<MappedFile> file = mapTileFile(mapId, x, y);
+            if (!file)
+                return false;
+
+            return loadMapTile(mapId, x, y, std::move(file));
+        }
+
+        uint32 size = 0;
+        unsigned char* data = readTileData(mapId, x, y, size);
+        if (!data)
+            return false;
+
+        return loadMapTile(mapId, x, y, data, size);
+    }
+
+    std::string MMapManager::getTileFileName(uint32 mapId, int32 x, int32 y) const
+    {
         // load this tile :: mmaps/MMMXXYY.mmtile
         uint32 pathLen = sWorld->GetDataPath().length() + strlen("mmaps/%03i%02i%02i.mmtile") + 1;
-        char *fileName = new char[pathLen];
+        std::vector<char> fileName(pathLen);
 
-        snprintf(fileName, pathLen, (sWorld->GetDataPath() + "mmaps/%03i%02i%02i.mmtile").c_str(), mapId, x, y);
+        snprintf(fileName.data(), pathLen, (sWorld->GetDataPath() + "mmaps/%03i%02i%02i.mmtile").c_str(), mapId, x, y);
+        return fileName.data();
+    }
 
-        FILE* file = fopen(fileName, "rb");
-        if (!file)
+    bool MMapManager::checkTileHeader(MmapTileHeader const& fileHeader, uint32 mapId, int32 x, int32 y) const
+    {
+        if (fileHeader.mmapMagic != MMAP_MAGIC)
         {
-            TC_LOG_DEBUG("maps", "MMAP:loadMap: Could not open mmtile file '%s'", fileName);
-            delete[] fileName;
+            TC_LOG_ERROR("maps", "MMAP:loadMap: Bad header in mmap %03u%02i%02i.mmtile", mapId, x, y);
+            return false;
+        }
+
+        if (fileHeader.mmapVersion != MMAP_VERSION)
+        {
+            TC_LOG_ERROR("maps", "MMAP:loadMap: %03u%02i%02i.mmtile was built with generator v%i, expected v%i",
+                mapId, x, y, fileHeader.mmapVersion, MMAP_VERSION);
             return false;
         }
-        delete[] fileName;
+
+        return true;
+    }
+
+    unsigned char* MMapManager::readTileData(uint32 mapId, int32 x, int32 y, uint32& size) const
+    {
+        std::string fileName = getTileFileName(mapId, x, y);
+
+        FILE* file = fopen(fileName.c_str(), "rb");
+        if (!file)
+        {
+            TC_LOG_DEBUG("maps", "MMAP:loadMap: Could not open mmtile file '%s'", fileName.c_str());
+            return NULL;
+        }
 
         // read header
         MmapTileHeader fileHeader;
-        if (fread(&fileHeader, sizeof(MmapTileHeader), 1, file) != 1 || fileHeader.mmapMagic != MMAP_MAGIC)
+        if (fread(&fileHeader, sizeof(MmapTileHeader), 1, file) != 1)
         {
             TC_LOG_ERROR("maps", "MMAP:loadMap: Bad header in mmap %03u%02i%02i.mmtile", mapId, x, y);
             fclose(file);
-            return false;
+            return NULL;
         }
 
-        if (fileHeader.mmapVersion != MMAP_VERSION)
+        if (!checkTileHeader(fileHeader, mapId, x, y))
         {
-            TC_LOG_ERROR("maps", "MMAP:loadMap: %03u%02i%02i.mmtile was built with generator v%i, expected v%i",
-                mapId, x, y, fileHeader.mmapVersion, MMAP_VERSION);
             fclose(file);
-            return false;
+            return NULL;
         }
 
         unsigned char* data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
@@ -173,18 +207,96 @@ namespace MMAP
         {
             TC_LOG_ERROR("maps", "MMAP:loadMap: Bad header or data in mmap %03u%02i%02i.mmtile", mapId, x, y);
             fclose(file);
-            return false;
+            dtFree(data);
+            return NULL;
         }
 
         fclose(file);
 
+        size = fileHeader.size;
+        return data;
+    }
+
+    std::unique_ptr<MappedFile> MMapManager::mapTileFile(uint32 mapId, int32 x, int32 y) const
+    {
+        std::string fileName = getTileFileName(mapId, x, y);
+
+        std::unique_ptr<MappedFile> file(new MappedFile());
+        if (!file->Open(fileName.c_str(), true))
+        {
+            TC_LOG_DEBUG("maps", "MMAP:loadMap: Could not map mmtile file '%s'", fileName.c_str());
+            return nullptr;
+        }
+
+        MmapTileHeader fileHeader;
+        if (file->GetSize() < sizeof(MmapTileHeader))
+        {
+            TC_LOG_ERROR("maps", "MMAP:loadMap: Bad header in mmap %03u%02i%02i.mmtile", mapId, x, y);
+            return nullptr;
+        }
+
+        memcpy(&fileHeader, file->GetData(), sizeof(MmapTileHeader));
+        if (!checkTileHeader(fileHeader, mapId, x, y))
+            return nullptr;
+
+        if (file->GetSize() - sizeof(MmapTileHeader) < fileHeader.size)
+        {
+            TC_LOG_ERROR("maps", "MMAP:loadMap: Bad header or data in mmap %03u%02i%02i.mmtile", mapId, x, y);
+            return nullptr;
+        }
+
+        return file;
+    }
+
+    bool MMapManager::loadMapTile(uint32 mapId, int32 x, int32 y, unsigned char* data, uint32 size)
+    {
+        return addTile(mapId, x, y, data, size, nullptr);
+    }
+
+    bool MMapManager::loadMapTile(uint32 mapId, int32 x, int32 y, std::unique_ptr<MappedFile> file)
+    {
+        // the tile data follows the header, detour only needs it 4 byte aligned
+        MmapTileHeader fileHeader;
+        memcpy(&fileHeader, file->GetData(), sizeof(MmapTileHeader));
+
+        unsigned char* data = file->GetData() + sizeof(MmapTileHeader);
+        return addTile(mapId, x, y, data, fileHeader.size, std::move(file));
+    }
+
+    bool MMapManager::addTile(uint32 mapId, int32 x, int32 y, unsigned char* data, uint32 size, std::unique_ptr<MappedFile> file)
+    {
+        if (!loadMapData(mapId))
+        {
+            if (!file)
+                dtFree(data);
+            return false;
+        }
+
+        // get this mmap data
+        MMapData* mmap = loadedMMaps[mapId];
+        ASSERT(mmap->navMesh);
+
+        // the tile may have been loaded since the data was read
+        uint32 packedGridPos = packTileID(x, y);
+        if (mmap->loadedTileRefs.find(packedGridPos) != mmap->loadedTileRefs.end())
+        {
+            if (!file)
+                dtFree(data);
+            return false;
+        }
+
         dtMeshHeader* header = (dtMeshHeader*)data;
         dtTileRef tileRef = 0;
 
-        // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
-        if (dtStatusSucceed(mmap->navMesh->addTile(data, fileHeader.size, NULL/*DT_TILE_FREE_DATA*/, 0, &tileRef)))
+        // the data stays ours, it is freed (or unmapped) by MMapData::ReleaseTileData when the tile is removed
+        if (dtStatusSucceed(mmap->navMesh->addTile(data, size, NULL/*DT_TILE_FREE_DATA*/, 0, &tileRef)))
         {
             mmap->loadedTileRefs.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
+            if (file)
+                mmap->mappedTiles[packedGridPos] = std::move(file);
+            else
+                mmap->allocatedTiles[packedGridPos] = data;
+
             ++loadedTiles;
             TC_LOG_DEBUG("maps", "MMAP:loadMap: Loaded mmtile %03i[%02i, %02i] into %03i[%02i, %02i]", mapId, x, y, mapId, header->x, header->y);
 
@@ -195,7 +307,8 @@ namespace MMAP
         else
         {
             TC_LOG_ERROR("maps", "MMAP:loadMap: Could not load %03u%02i%02i.mmtile into navmesh", mapId, x, y);
-            dtFree(data);
+            if (!file)
+                dtFree(data);
             return false;
         }
     }
@@ -330,6 +443,7 @@ namespace MMAP
         else
         {
             mmap->loadedTileRefs.erase(packedGridPos);
+            mmap->ReleaseTileData(packedGridPos);
             --loadedTiles;
             TC_LOG_DEBUG("maps", "MMAP:unloadMap: Unloaded mmtile %03i[%02i, %02i] from %03i", mapId, x, y, mapId);
 
@@ -360,6 +474,7 @@ namespace MMAP
                 TC_LOG_ERROR("maps", "MMAP:unloadMap: Could not unload %03u%02i%02i.mmtile from navmesh", mapId, x, y);
             else
             {
+                mmap->ReleaseTileData(i->first);
                 UnloadPhaseTile(mapId, x, y);
                 --loadedTiles;
                 TC_LOG_DEBUG("maps", "MMAP:unloadMap: Unloaded mmtile %03i[%02i, %02i] from %03i", mapId, x, y, mapId);
@@ -385,16 +500,29 @@ namespace MMAP
         }
 
         MMapData* mmap = itr->second;
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
+        std::lock_guard<std::mutex> lock(mmap->navMeshQueriesLock);
+
+        // queries of every thread that updated the instance
+        bool found = false;
+        for (NavMeshQuerySet::iterator query = mmap->navMeshQueries.begin(); query != mmap->navMeshQueries.end();)
+        {
+            if (query->first.first != instanceId)
+            {
+                ++query;
+                continue;
+            }
+
+            dtFreeNavMeshQuery(query->second);
+            query = mmap->navMeshQueries.erase(query);
+            found = true;
+        }
+
+        if (!found)
         {
             TC_LOG_DEBUG("maps", "MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId %03u instanceId %u", mapId, instanceId);
             return false;
         }
 
-        dtNavMeshQuery* query = mmap->navMeshQueries[instanceId];
-
-        dtFreeNavMeshQuery(query);
-        mmap->navMeshQueries.erase(instanceId);
         TC_LOG_DEBUG("maps", "MMAP:unloadMapInstance: Unloaded mapId %03u instanceId %u", mapId, instanceId);
 
         return true;
@@ -416,7 +544,11 @@ namespace MMAP
             return NULL;
 
         MMapData* mmap = itr->second;
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
+        std::pair<uint32, std::thread::id> key(instanceId, std::this_thread::get_id());
+
+        std::lock_guard<std::mutex> lock(mmap->navMeshQueriesLock);
+        NavMeshQuerySet::const_iterator queryItr = mmap->navMeshQueries.find(key);
+        if (queryItr == mmap->navMeshQueries.end())
         {
             // allocate mesh query
             dtNavMeshQuery* query = dtAllocNavMeshQuery();
@@ -429,10 +561,10 @@ namespace MMAP
             }
 
             TC_LOG_DEBUG("maps", "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-            mmap->navMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(instanceId, query));
+            queryItr = mmap->navMeshQueries.insert(NavMeshQuerySet::value_type(key, query)).first;
         }
 
-        return mmap->navMeshQueries[instanceId];
+        return queryItr->second;
     }
 
     MMapData::MMapData(dtNavMesh* mesh, uint32 mapId)
@@ -450,11 +582,56 @@ namespace MMAP
 
         for (PhaseTileContainer::iterator i = _baseTiles.begin(); i != _baseTiles.end(); ++i)
         {
-            delete (*i).second->data;
+            if (!IsMappedData((*i).second->data))
+                delete (*i).second->data;
             delete (*i).second;
         }
     }
 
+    void MMapData::ReleaseTileData(uint32 packedXY)
+    {
+        // a base tile that was swapped out is kept in _baseTiles and freed with the map
+        if (_baseTiles.find(packedXY) != _baseTiles.end())
+        {
+            allocatedTiles.erase(packedXY);
+
+            auto itr = mappedTiles.find(packedXY);
+            if (itr != mappedTiles.end())
+            {
+                _swappedOutFiles.push_back(std::move(itr->second));
+                mappedTiles.erase(itr);
+            }
+            return;
+        }
+
+        auto itr = allocatedTiles.find(packedXY);
+        if (itr != allocatedTiles.end())
+        {
+            dtFree(itr->second);
+            allocatedTiles.erase(itr);
+        }
+
+        mappedTiles.erase(packedXY);
+    }
+
+    bool MMapData::IsMappedData(unsigned char const* data) const
+    {
+        auto isInFile = [data](std::unique_ptr<MappedFile> const& file)
+        {
+            return data >= file->GetData() && data < file->GetData() + file->GetSize();
+        };
+
+        for (auto const& itr : mappedTiles)
+            if (isInFile(itr.second))
+                return true;
+
+        for (std::unique_ptr<MappedFile> const& file : _swappedOutFiles)
+            if (isInFile(file))
+                return true;
+
+        return false;
+    }
+
     void MMapData::RemoveSwap(PhasedTile* ptile, uint32 swap, uint32 packedXY)
     {
         uint32 x = (packedXY >> 16);
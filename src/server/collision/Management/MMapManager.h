@@ -22,16 +22,22 @@
 #include "Define.h"
 #include "DetourNavMesh.h"
 #include "DetourNavMeshQuery.h"
+#include "MappedFile.h"
 #include "World.h"
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <set>
+#include <thread>
+#include <vector>
 
 //  move map related classes
 namespace MMAP
 {
     typedef std::unordered_map<uint32, dtTileRef> MMapTileSet;
-    typedef std::unordered_map<uint32, dtNavMeshQuery*> NavMeshQuerySet;
+    typedef std::map<std::pair<uint32, std::thread::id>, dtNavMeshQuery*> NavMeshQuerySet;
 
 
     typedef std::set<uint32> TerrainSet;
@@ -68,19 +74,31 @@ namespace MMAP
 
         dtNavMesh* GetNavMesh(TerrainSet swaps);
 
-        // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-        NavMeshQuerySet navMeshQueries;     // instanceId to query
+        // we have to use single dtNavMeshQuery for every instance and thread, since those are not thread safe.
+        // The regions of one map may be updated on several threads (MapUpdate.Regions.Enable)
+        NavMeshQuerySet navMeshQueries;     // instanceId and thread to query
+        std::mutex navMeshQueriesLock;
 
         dtNavMesh* navMesh;
         MMapTileSet loadedTileRefs;
         TerrainSetMap loadedPhasedTiles;
 
+        // data of the loaded tiles, added to the navmesh without DT_TILE_FREE_DATA so detour never frees it
+        std::unordered_map<uint32, unsigned char*> allocatedTiles;                  // allocated with dtAlloc
+        std::unordered_map<uint32, std::unique_ptr<MappedFile>> mappedTiles;        // pointing into the mapped .mmtile
+
+        // frees the data of a tile removed from the navmesh
+        void ReleaseTileData(uint32 packedXY);
+
     private:
         uint32 _mapId;
         PhaseTileContainer _baseTiles;
         std::set<uint32> _activeSwaps;
+        // mapped files of unloaded tiles that are still referenced by _baseTiles
+        std::vector<std::unique_ptr<MappedFile>> _swappedOutFiles;
         void RemoveSwap(PhasedTile* ptile, uint32 swap, uint32 packedXY);
         void AddSwap(PhasedTile* tile, uint32 swap, uint32 packedXY);
+        bool IsMappedData(unsigned char const* data) const;
     };
 
 
@@ -96,11 +114,20 @@ namespace MMAP
 
             void InitializeThreadUnsafe(const std::vector<uint32>& mapIds);
             bool loadMap(const std::string& basePath, uint32 mapId, int32 x, int32 y);
+
+            // reads a tile file into memory allocated with dtAlloc, does not touch any loaded data and is safe to call from any thread
+            unsigned char* readTileData(uint32 mapId, int32 x, int32 y, uint32& size) const;
+            // adds tile data returned by readTileData to the navmesh, takes ownership of data
+            bool loadMapTile(uint32 mapId, int32 x, int32 y, unsigned char* data, uint32 size);
+            // maps a tile file copy on write, detour writes the links of the tile into its data when it is added
+            std::unique_ptr<MappedFile> mapTileFile(uint32 mapId, int32 x, int32 y) const;
+            // adds the tile data of a file returned by mapTileFile to the navmesh
+            bool loadMapTile(uint32 mapId, int32 x, int32 y, std::unique_ptr<MappedFile> file);
             bool unloadMap(uint32 mapId, int32 x, int32 y);
             bool unloadMap(uint32 mapId);
             bool unloadMapInstance(uint32 mapId, uint32 instanceId);
 
-            // the returned [dtNavMeshQuery const*] is NOT threadsafe
+            // the returned [dtNavMeshQuery const*] is NOT threadsafe, it belongs to the calling thread
             dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId, TerrainSet swaps);
             dtNavMesh const* GetNavMesh(uint32 mapId, TerrainSet swaps);
 
@@ -114,6 +141,9 @@ namespace MMAP
         private:
             bool loadMapData(uint32 mapId);
             uint32 packTileID(int32 x, int32 y);
+            std::string getTileFileName(uint32 mapId, int32 x, int32 y) const;
+            bool checkTileHeader(MmapTileHeader const& fileHeader, uint32 mapId, int32 x, int32 y) const;
+            bool addTile(uint32 mapId, int32 x, int32 y, unsigned char* data, uint32 size, std::unique_ptr<MappedFile> file);
 
             MMapDataSet::const_iterator GetMMapData(uint32 mapId) const;
             MMapDataSet loadedMMaps;
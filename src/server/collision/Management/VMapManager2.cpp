@@ -17,6 +17,7 @@
  */
 
 #include <iostream>
+#include <algorithm>
 #include <iomanip>
 #include <string>
 #include <sstream>
@@ -181,6 +182,26 @@ namespace VMAP
         return true;
     }
 
+    void VMapManager2::isInLineOfSight(unsigned int mapId, LineOfSightRay* rays, size_t count, bool usePackets)
+    {
+        InstanceTreeMap::const_iterator instanceTree = iInstanceMapTrees.end();
+        if (isLineOfSightCalcEnabled() && !IsVMAPDisabledForPtr(mapId, VMAP_DISABLE_LOS))
+            instanceTree = GetMapTree(mapId);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            LineOfSightRay& ray = rays[i];
+            ray.Result = true;
+            if (instanceTree == iInstanceMapTrees.end())
+                continue;
+
+            Vector3 pos1 = convertPositionToInternalRep(ray.X1, ray.Y1, ray.Z1);
+            Vector3 pos2 = convertPositionToInternalRep(ray.X2, ray.Y2, ray.Z2);
+            if (pos1 != pos2)
+                ray.Result = instanceTree->second->isInLineOfSight(pos1, pos2, usePackets);
+        }
+    }
+
     /**
     get the hit position and return true if we hit something
     otherwise the result pos will be the dest pos
@@ -281,23 +302,39 @@ namespace VMAP
 
     WorldModel* VMapManager2::acquireModelInstance(const std::string& basepath, const std::string& filename)
     {
-        //! Critical section, thread safe access to iLoadedModelFiles
+        {
+            //! Critical section, thread safe access to iLoadedModelFiles
+            std::lock_guard<std::mutex> lock(LoadedModelFilesLock);
+
+            ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
+            if (model != iLoadedModelFiles.end())
+            {
+                model->second.incRefCount();
+                return model->second.getModel();
+            }
+        }
+
+        // read the file outside of the lock, other threads keep acquiring loaded models meanwhile
+        WorldModel* worldmodel = new WorldModel();
+        if (!worldmodel->readFile(basepath + filename + ".vmo"))
+        {
+            VMAP_ERROR_LOG("misc", "VMapManager2: could not load '%s%s.vmo'", basepath.c_str(), filename.c_str());
+            delete worldmodel;
+            return NULL;
+        }
+
         std::lock_guard<std::mutex> lock(LoadedModelFilesLock);
 
         ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
         if (model == iLoadedModelFiles.end())
         {
-            WorldModel* worldmodel = new WorldModel();
-            if (!worldmodel->readFile(basepath + filename + ".vmo"))
-            {
-                VMAP_ERROR_LOG("misc", "VMapManager2: could not load '%s%s.vmo'", basepath.c_str(), filename.c_str());
-                delete worldmodel;
-                return NULL;
-            }
             VMAP_DEBUG_LOG("maps", "VMapManager2: loading file '%s%s'", basepath.c_str(), filename.c_str());
             model = iLoadedModelFiles.insert(std::pair<std::string, ManagedModel>(filename, ManagedModel())).first;
             model->second.setModel(worldmodel);
         }
+        else
+            delete worldmodel;                              // another thread loaded the same model meanwhile
+
         model->second.incRefCount();
         return model->second.getModel();
     }
@@ -321,6 +358,30 @@ namespace VMAP
         }
     }
 
+    void VMapManager2::preloadMapTile(const char* basePath, unsigned int mapId, int x, int y, std::vector<std::string>& models)
+    {
+        std::string vmapPath(basePath);
+        if (!vmapPath.empty() && vmapPath[vmapPath.length() - 1] != '/' && vmapPath[vmapPath.length() - 1] != '\\')
+            vmapPath.push_back('/');
+
+        std::vector<std::string> names;
+        StaticMapTree::ReadTileModelNames(vmapPath, mapId, x, y, names);
+
+        // many spawns of a tile share their model
+        std::sort(names.begin(), names.end());
+        names.erase(std::unique(names.begin(), names.end()), names.end());
+
+        for (std::string const& name : names)
+            if (acquireModelInstance(vmapPath, name))
+                models.push_back(name);
+    }
+
+    void VMapManager2::releaseModelInstances(std::vector<std::string> const& models)
+    {
+        for (std::string const& name : models)
+            releaseModelInstance(name);
+    }
+
     bool VMapManager2::existsMap(const char* basePath, unsigned int mapId, int x, int y)
     {
         return StaticMapTree::CanLoadMap(std::string(basePath), mapId, x, y);
@@ -108,6 +108,9 @@ namespace VMAP
             void unloadMap(unsigned int mapId) override;
 
             bool isInLineOfSight(unsigned int mapId, float x1, float y1, float z1, float x2, float y2, float z2) override ;
+            void isInLineOfSight(unsigned int mapId, LineOfSightRay* rays, size_t count) override { isInLineOfSight(mapId, rays, count, true); }
+            /// usePackets = false forces the scalar triangle test, only meant to compare both kernels
+            void isInLineOfSight(unsigned int mapId, LineOfSightRay* rays, size_t count, bool usePackets);
             /**
             fill the hit pos and return true, if an object was hit
             */
@@ -122,6 +125,11 @@ namespace VMAP
             WorldModel* acquireModelInstance(const std::string& basepath, const std::string& filename);
             void releaseModelInstance(const std::string& filename);
 
+            /// Loads the models spawned on a tile without touching the map tree, safe to call from any thread.
+            /// The models stay loaded until releaseModelInstances, loading the tile afterwards only finds them.
+            void preloadMapTile(const char* basePath, unsigned int mapId, int x, int y, std::vector<std::string>& models);
+            void releaseModelInstances(std::vector<std::string> const& models);
+
             // what's the use of this? o.O
             virtual std::string getDirFileName(unsigned int mapId, int /*x*/, int /*y*/) const override
             {
@@ -36,10 +36,10 @@ namespace VMAP
     class MapRayCallback
     {
         public:
-            MapRayCallback(ModelInstance* val): prims(val), hit(false) { }
+            MapRayCallback(ModelInstance* val, bool packets = true): prims(val), hit(false), usePackets(packets) { }
             bool operator()(const G3D::Ray& ray, uint32 entry, float& distance, bool pStopAtFirstHit=true)
             {
-                bool result = prims[entry].intersectRay(ray, distance, pStopAtFirstHit);
+                bool result = prims[entry].intersectRay(ray, distance, pStopAtFirstHit, usePackets);
                 if (result)
                     hit = true;
                 return result;
@@ -48,6 +48,7 @@ namespace VMAP
     protected:
         ModelInstance* prims;
         bool hit;
+        bool usePackets;
     };
 
     class AreaInfoCallback
@@ -142,10 +143,10 @@ namespace VMAP
     Else, pMaxDist is not modified and returns false;
     */
 
-    bool StaticMapTree::getIntersectionTime(const G3D::Ray& pRay, float &pMaxDist, bool pStopAtFirstHit) const
+    bool StaticMapTree::getIntersectionTime(const G3D::Ray& pRay, float &pMaxDist, bool pStopAtFirstHit, bool usePackets) const
     {
         float distance = pMaxDist;
-        MapRayCallback intersectionCallBack(iTreeValues);
+        MapRayCallback intersectionCallBack(iTreeValues, usePackets);
         iTree.intersectRay(pRay, intersectionCallBack, distance, pStopAtFirstHit);
         if (intersectionCallBack.didHit())
             pMaxDist = distance;
@@ -153,7 +154,7 @@ namespace VMAP
     }
     //=========================================================
 
-    bool StaticMapTree::isInLineOfSight(const Vector3& pos1, const Vector3& pos2) const
+    bool StaticMapTree::isInLineOfSight(const Vector3& pos1, const Vector3& pos2, bool usePackets) const
     {
         float maxDist = (pos2 - pos1).magnitude();
         // return false if distance is over max float, in case of cheater teleporting to the end of the universe
@@ -167,7 +168,7 @@ namespace VMAP
             return true;
         // direction with length of 1
         G3D::Ray ray = G3D::Ray::fromOriginAndDirection(pos1, (pos2 - pos1)/maxDist);
-        if (getIntersectionTime(ray, maxDist, true))
+        if (getIntersectionTime(ray, maxDist, true, usePackets))
             return false;
 
         return true;
@@ -275,6 +276,38 @@ namespace VMAP
 
     //=========================================================
 
+    bool StaticMapTree::ReadTileModelNames(const std::string &vmapPath, uint32 mapID, uint32 tileX, uint32 tileY, std::vector<std::string> &names)
+    {
+        std::string basePath = vmapPath;
+        if (basePath.length() > 0 && basePath[basePath.length()-1] != '/' && basePath[basePath.length()-1] != '\\')
+            basePath.push_back('/');
+
+        std::string tilefile = basePath + getTileFileName(mapID, tileX, tileY);
+        FILE* tf = fopen(tilefile.c_str(), "rb");
+        if (!tf)
+            return true;
+
+        bool result = true;
+        char chunk[8];
+        uint32 numSpawns = 0;
+        if (!readChunk(tf, chunk, VMAP_MAGIC, 8) || fread(&numSpawns, sizeof(uint32), 1, tf) != 1)
+            result = false;
+
+        for (uint32 i = 0; i < numSpawns && result; ++i)
+        {
+            ModelSpawn spawn;
+            uint32 referencedVal;
+            result = ModelSpawn::readFromFile(tf, spawn) && fread(&referencedVal, sizeof(uint32), 1, tf) == 1;
+            if (result)
+                names.push_back(spawn.name);
+        }
+
+        fclose(tf);
+        return result;
+    }
+
+    //=========================================================
+
     bool StaticMapTree::InitMap(const std::string &fname, VMapManager2* vm)
     {
         VMAP_DEBUG_LOG("maps", "StaticMapTree::InitMap() : initializing StaticMapTree '%s'", fname.c_str());
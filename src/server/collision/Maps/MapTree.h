@@ -21,7 +21,9 @@
 
 #include "Define.h"
 #include "BoundingIntervalHierarchy.h"
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace VMAP
 {
@@ -57,18 +59,21 @@ namespace VMAP
             std::string iBasePath;
 
         private:
-            bool getIntersectionTime(const G3D::Ray& pRay, float &pMaxDist, bool pStopAtFirstHit) const;
+            bool getIntersectionTime(const G3D::Ray& pRay, float &pMaxDist, bool pStopAtFirstHit, bool usePackets = true) const;
             //bool containsLoadedMapTile(unsigned int pTileIdent) const { return(iLoadedMapTiles.containsKey(pTileIdent)); }
         public:
             static std::string getTileFileName(uint32 mapID, uint32 tileX, uint32 tileY);
             static uint32 packTileID(uint32 tileX, uint32 tileY) { return tileX<<16 | tileY; }
             static void unpackTileID(uint32 ID, uint32 &tileX, uint32 &tileY) { tileX = ID>>16; tileY = ID&0xFF; }
             static bool CanLoadMap(const std::string &basePath, uint32 mapID, uint32 tileX, uint32 tileY);
+            // names of the models spawned on a tile, empty if the map is not tiled or the tile has no file
+            static bool ReadTileModelNames(const std::string &basePath, uint32 mapID, uint32 tileX, uint32 tileY, std::vector<std::string> &names);
 
             StaticMapTree(uint32 mapID, const std::string &basePath);
             ~StaticMapTree();
 
-            bool isInLineOfSight(const G3D::Vector3& pos1, const G3D::Vector3& pos2) const;
+            // usePackets = false forces the scalar triangle test, only meant to compare both kernels
+            bool isInLineOfSight(const G3D::Vector3& pos1, const G3D::Vector3& pos2, bool usePackets = true) const;
             bool getObjectHitPos(const G3D::Vector3& pos1, const G3D::Vector3& pos2, G3D::Vector3& pResultHitPos, float pModifyDist) const;
             float getHeight(const G3D::Vector3& pPos, float maxSearchDist) const;
             bool getAreaInfo(G3D::Vector3 &pos, uint32 &flags, int32 &adtId, int32 &rootId, int32 &groupId) const;
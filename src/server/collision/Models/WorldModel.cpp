@@ -20,6 +20,11 @@
 #include "VMapDefinitions.h"
 #include "MapTree.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define VMAP_TRIANGLE_PACKETS
+# include <emmintrin.h>
+#endif
+
 using G3D::Vector3;
 using G3D::Ray;
 
@@ -80,6 +85,116 @@ namespace VMAP
         return false;
     }
 
+    bool HasTrianglePackets()
+    {
+#ifdef VMAP_TRIANGLE_PACKETS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    enum TrianglePacketComponent
+    {
+        PACKET_V0_X, PACKET_V0_Y, PACKET_V0_Z,
+        PACKET_E1_X, PACKET_E1_Y, PACKET_E1_Z,
+        PACKET_E2_X, PACKET_E2_Y, PACKET_E2_Z,
+        MAX_PACKET_COMPONENTS
+    };
+
+    // padding so the last 4 wide load of every component stays inside the array
+    static uint32 const TRIANGLE_PACKET_PADDING = 3;
+
+#ifdef VMAP_TRIANGLE_PACKETS
+    /*
+    Same algorithm and operation order as IntersectTriangle, for count triangles starting at position first.
+    No fused or approximate operations are used so every lane computes exactly what the scalar code does.
+    */
+    bool IntersectTrianglePackets(float const* data, uint32 stride, uint32 first, uint32 count, const G3D::Ray &ray, float &distance, bool stopAtFirstHit)
+    {
+        const Vector3& org = ray.origin();
+        const Vector3& dir = ray.direction();
+        const __m128 orgX = _mm_set1_ps(org.x), orgY = _mm_set1_ps(org.y), orgZ = _mm_set1_ps(org.z);
+        const __m128 dirX = _mm_set1_ps(dir.x), dirY = _mm_set1_ps(dir.y), dirZ = _mm_set1_ps(dir.z);
+        const __m128 eps = _mm_set1_ps(1e-5f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+        bool hit = false;
+        for (uint32 i = 0; i < count; i += 4)
+        {
+            float const* lane = data + first + i;
+            const __m128 v0X = _mm_loadu_ps(lane + PACKET_V0_X * stride);
+            const __m128 v0Y = _mm_loadu_ps(lane + PACKET_V0_Y * stride);
+            const __m128 v0Z = _mm_loadu_ps(lane + PACKET_V0_Z * stride);
+            const __m128 e1X = _mm_loadu_ps(lane + PACKET_E1_X * stride);
+            const __m128 e1Y = _mm_loadu_ps(lane + PACKET_E1_Y * stride);
+            const __m128 e1Z = _mm_loadu_ps(lane + PACKET_E1_Z * stride);
+            const __m128 e2X = _mm_loadu_ps(lane + PACKET_E2_X * stride);
+            const __m128 e2Y = _mm_loadu_ps(lane + PACKET_E2_Y * stride);
+            const __m128 e2Z = _mm_loadu_ps(lane + PACKET_E2_Z * stride);
+
+            // p = dir x e2, a = e1 . p
+            const __m128 pX = _mm_sub_ps(_mm_mul_ps(dirY, e2Z), _mm_mul_ps(dirZ, e2Y));
+            const __m128 pY = _mm_sub_ps(_mm_mul_ps(dirZ, e2X), _mm_mul_ps(dirX, e2Z));
+            const __m128 pZ = _mm_sub_ps(_mm_mul_ps(dirX, e2Y), _mm_mul_ps(dirY, e2X));
+            const __m128 a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1X, pX), _mm_mul_ps(e1Y, pY)), _mm_mul_ps(e1Z, pZ));
+            const __m128 f = _mm_div_ps(one, a);
+
+            // s = org - v0, u = f * (s . p)
+            const __m128 sX = _mm_sub_ps(orgX, v0X);
+            const __m128 sY = _mm_sub_ps(orgY, v0Y);
+            const __m128 sZ = _mm_sub_ps(orgZ, v0Z);
+            const __m128 u = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(sX, pX), _mm_mul_ps(sY, pY)), _mm_mul_ps(sZ, pZ)));
+
+            // q = s x e1, v = f * (dir . q), t = f * (e2 . q)
+            const __m128 qX = _mm_sub_ps(_mm_mul_ps(sY, e1Z), _mm_mul_ps(sZ, e1Y));
+            const __m128 qY = _mm_sub_ps(_mm_mul_ps(sZ, e1X), _mm_mul_ps(sX, e1Z));
+            const __m128 qZ = _mm_sub_ps(_mm_mul_ps(sX, e1Y), _mm_mul_ps(sY, e1X));
+            const __m128 v = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dirX, qX), _mm_mul_ps(dirY, qY)), _mm_mul_ps(dirZ, qZ)));
+            const __m128 t = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2X, qX), _mm_mul_ps(e2Y, qY)), _mm_mul_ps(e2Z, qZ)));
+
+            // negated comparisons keep the scalar behaviour for NaN
+            __m128 valid = _mm_cmpnlt_ps(_mm_and_ps(a, absMask), eps);
+            valid = _mm_and_ps(valid, _mm_cmpnlt_ps(u, zero));
+            valid = _mm_and_ps(valid, _mm_cmpngt_ps(u, one));
+            valid = _mm_and_ps(valid, _mm_cmpnlt_ps(v, zero));
+            valid = _mm_and_ps(valid, _mm_cmpngt_ps(_mm_add_ps(u, v), one));
+            valid = _mm_and_ps(valid, _mm_cmpgt_ps(t, zero));
+            valid = _mm_and_ps(valid, _mm_cmplt_ps(t, _mm_set1_ps(distance)));
+
+            int mask = _mm_movemask_ps(valid);
+            if (count - i < 4)
+                mask &= (1 << (count - i)) - 1;
+
+            if (!mask)
+                continue;
+
+            float times[4];
+            _mm_storeu_ps(times, t);
+            for (uint32 l = 0; l < 4; ++l)
+            {
+                if (!(mask & (1 << l)))
+                    continue;
+
+                // the scalar loop stops at the first hit, otherwise it keeps the closest one
+                if (stopAtFirstHit)
+                {
+                    distance = times[l];
+                    return true;
+                }
+
+                if (times[l] < distance)
+                    distance = times[l];
+                hit = true;
+            }
+        }
+
+        return hit;
+    }
+#endif
+
     class TriBoundFunc
     {
         public:
@@ -253,7 +368,8 @@ namespace VMAP
 
     GroupModel::GroupModel(const GroupModel &other):
         iBound(other.iBound), iMogpFlags(other.iMogpFlags), iGroupWMOID(other.iGroupWMOID),
-        vertices(other.vertices), triangles(other.triangles), meshTree(other.meshTree), iLiquid(nullptr)
+        vertices(other.vertices), triangles(other.triangles), meshTree(other.meshTree),
+        trianglePackets(other.trianglePackets), trianglePacketStride(other.trianglePacketStride), iLiquid(nullptr)
     {
         if (other.iLiquid)
             iLiquid = new WmoLiquid(*other.iLiquid);
@@ -265,6 +381,53 @@ namespace VMAP
         triangles.swap(tri);
         TriBoundFunc bFunc(vertices);
         meshTree.build(triangles, bFunc);
+        buildTrianglePackets();
+    }
+
+    void GroupModel::buildTrianglePackets()
+    {
+        trianglePackets.clear();
+        trianglePacketStride = 0;
+
+#ifdef VMAP_TRIANGLE_PACKETS
+        uint32 count = meshTree.primCount();
+        if (!count)
+            return;
+
+        // broken files keep using the per triangle path
+        for (uint32 i = 0; i < count; ++i)
+        {
+            uint32 entry = meshTree.getObject(i);
+            if (entry >= triangles.size())
+                return;
+
+            MeshTriangle const& tri = triangles[entry];
+            if (tri.idx0 >= vertices.size() || tri.idx1 >= vertices.size() || tri.idx2 >= vertices.size())
+                return;
+        }
+
+        // padding is left zeroed, degenerate triangles never hit
+        trianglePacketStride = count + TRIANGLE_PACKET_PADDING;
+        trianglePackets.resize(trianglePacketStride * MAX_PACKET_COMPONENTS, 0.0f);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            MeshTriangle const& tri = triangles[meshTree.getObject(i)];
+            Vector3 const& v0 = vertices[tri.idx0];
+            Vector3 const e1 = vertices[tri.idx1] - v0;
+            Vector3 const e2 = vertices[tri.idx2] - v0;
+
+            float* data = &trianglePackets[i];
+            data[PACKET_V0_X * trianglePacketStride] = v0.x;
+            data[PACKET_V0_Y * trianglePacketStride] = v0.y;
+            data[PACKET_V0_Z * trianglePacketStride] = v0.z;
+            data[PACKET_E1_X * trianglePacketStride] = e1.x;
+            data[PACKET_E1_Y * trianglePacketStride] = e1.y;
+            data[PACKET_E1_Z * trianglePacketStride] = e1.z;
+            data[PACKET_E2_X * trianglePacketStride] = e2.x;
+            data[PACKET_E2_Y * trianglePacketStride] = e2.y;
+            data[PACKET_E2_Z * trianglePacketStride] = e2.z;
+        }
+#endif
     }
 
     bool GroupModel::writeToFile(FILE* wf)
@@ -321,6 +484,8 @@ namespace VMAP
         uint32 count = 0;
         triangles.clear();
         vertices.clear();
+        trianglePackets.clear();
+        trianglePacketStride = 0;
         delete iLiquid;
         iLiquid = NULL;
 
@@ -347,6 +512,7 @@ namespace VMAP
         // read mesh BIH
         if (result && !readChunk(rf, chunk, "MBIH", 4)) result = false;
         if (result) result = meshTree.readFromFile(rf);
+        if (result) buildTrianglePackets();
 
         // write liquid data
         if (result && !readChunk(rf, chunk, "LIQU", 4)) result = false;
@@ -371,11 +537,37 @@ namespace VMAP
         bool hit;
     };
 
-    bool GroupModel::IntersectRay(const G3D::Ray &ray, float &distance, bool stopAtFirstHit) const
+#ifdef VMAP_TRIANGLE_PACKETS
+    struct GModelPacketRayCallback : public BIHLeafRayCallback
+    {
+        GModelPacketRayCallback(const std::vector<float> &packets, uint32 packetStride):
+            data(&packets[0]), stride(packetStride), hit(false) { }
+        bool IntersectLeaf(const G3D::Ray& ray, uint32 first, uint32 count, float& distance, bool pStopAtFirstHit)
+        {
+            if (IntersectTrianglePackets(data, stride, first, count, ray, distance, pStopAtFirstHit))
+                hit = true;
+            return hit;
+        }
+        float const* data;
+        uint32 stride;
+        bool hit;
+    };
+#endif
+
+    bool GroupModel::IntersectRay(const G3D::Ray &ray, float &distance, bool stopAtFirstHit, bool usePackets) const
     {
         if (triangles.empty())
             return false;
 
+#ifdef VMAP_TRIANGLE_PACKETS
+        if (usePackets && !trianglePackets.empty())
+        {
+            GModelPacketRayCallback callback(trianglePackets, trianglePacketStride);
+            meshTree.intersectRay(ray, callback, distance, stopAtFirstHit);
+            return callback.hit;
+        }
+#endif
+
         GModelRayCallback callback(triangles, vertices);
         meshTree.intersectRay(ray, callback, distance, stopAtFirstHit);
         return callback.hit;
@@ -419,25 +611,26 @@ namespace VMAP
 
     struct WModelRayCallBack
     {
-        WModelRayCallBack(const std::vector<GroupModel> &mod): models(mod.begin()), hit(false) { }
+        WModelRayCallBack(const std::vector<GroupModel> &mod, bool packets): models(mod.begin()), hit(false), usePackets(packets) { }
         bool operator()(const G3D::Ray& ray, uint32 entry, float& distance, bool pStopAtFirstHit)
         {
-            bool result = models[entry].IntersectRay(ray, distance, pStopAtFirstHit);
+            bool result = models[entry].IntersectRay(ray, distance, pStopAtFirstHit, usePackets);
             if (result)  hit=true;
             return hit;
         }
         std::vector<GroupModel>::const_iterator models;
         bool hit;
+        bool usePackets;
     };
 
-    bool WorldModel::IntersectRay(const G3D::Ray &ray, float &distance, bool stopAtFirstHit) const
+    bool WorldModel::IntersectRay(const G3D::Ray &ray, float &distance, bool stopAtFirstHit, bool usePackets) const
     {
         // small M2 workaround, maybe better make separate class with virtual intersection funcs
         // in any case, there's no need to use a bound tree if we only have one submodel
         if (groupModels.size() == 1)
-            return groupModels[0].IntersectRay(ray, distance, stopAtFirstHit);
+            return groupModels[0].IntersectRay(ray, distance, stopAtFirstHit, usePackets);
 
-        WModelRayCallBack isc(groupModels);
+        WModelRayCallBack isc(groupModels, usePackets);
         groupTree.intersectRay(ray, isc, distance, stopAtFirstHit);
         return isc.hit;
     }
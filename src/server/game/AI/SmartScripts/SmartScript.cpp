@@ -61,15 +61,18 @@ SmartScript::~SmartScript()
 
     delete mTargetStorage;
     mCounterList.clear();
+
+    for (ObjectList* targets : mFreeTargetLists)
+        delete targets;
 }
 
 void SmartScript::OnReset()
 {
     SetPhase(0);
     ResetBaseObject();
-    for (SmartAIEventList::iterator i = mEvents.begin(); i != mEvents.end(); ++i)
+    for (SmartEventStateList::iterator i = mEvents.begin(); i != mEvents.end(); ++i)
     {
-        if (!((*i).event.event_flags & SMART_EVENT_FLAG_DONT_RESET))
+        if (!(i->holder->event.event_flags & SMART_EVENT_FLAG_DONT_RESET))
         {
             InitTimer((*i));
             (*i).runOnce = false;
@@ -82,25 +85,28 @@ void SmartScript::OnReset()
 
 void SmartScript::ProcessEventsFor(SMART_EVENT e, Unit* unit, uint32 var0, uint32 var1, bool bvar, const SpellInfo* spell, GameObject* gob)
 {
-    for (SmartAIEventList::iterator i = mEvents.begin(); i != mEvents.end(); ++i)
+    if (e == SMART_EVENT_LINK)//special handling
+        return;
+
+    // mEvents does not change while events are processed, new events are only installed from OnUpdate
+    std::vector<std::pair<uint32, uint32> >::const_iterator itr = std::lower_bound(mEventIndex.begin(), mEventIndex.end(), std::make_pair(uint32(e), uint32(0)));
+    for (; itr != mEventIndex.end() && itr->first == uint32(e); ++itr)
     {
-        SMART_EVENT eventType = SMART_EVENT(i->GetEventType());
-        if (eventType == SMART_EVENT_LINK)//special handling
-            continue;
+        SmartEventState& state = mEvents[itr->second];
+        SmartScriptHolder const& holder = *state.holder;
 
-        if (eventType == e /*&& (!i->event.event_phase_mask || IsInPhase(i->event.event_phase_mask)) && !(i->event.event_flags & SMART_EVENT_FLAG_NOT_REPEATABLE && i->runOnce)*/)
-        {
-            ConditionList conds = sConditionMgr->GetConditionsForSmartEvent(i->entryOrGuid, i->event_id, i->source_type);
-            ConditionSourceInfo info = ConditionSourceInfo(unit, GetBaseObject());
+        ConditionList conds = sConditionMgr->GetConditionsForSmartEvent(holder.entryOrGuid, holder.event_id, holder.source_type);
+        ConditionSourceInfo info = ConditionSourceInfo(unit, GetBaseObject());
 
-            if (sConditionMgr->IsObjectMeetToConditions(info, conds))
-                ProcessEvent(*i, unit, var0, var1, bvar, spell, gob);
-        }
+        if (sConditionMgr->IsObjectMeetToConditions(info, conds))
+            ProcessEvent(state, unit, var0, var1, bvar, spell, gob);
     }
 }
 
-void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, uint32 var1, bool bvar, const SpellInfo* spell, GameObject* gob)
+void SmartScript::ProcessAction(SmartEventState& state, Unit* unit, uint32 var0, uint32 var1, bool bvar, const SpellInfo* spell, GameObject* gob)
 {
+    SmartScriptHolder const& e = *state.holder;
+
     //calc random
     if (e.GetEventType() != SMART_EVENT_LINK && e.event.event_chance < 100 && e.event.event_chance)
     {
@@ -108,7 +114,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
         if (e.event.event_chance <= rnd)
             return;
     }
-    e.runOnce = true;//used for repeat check
+    state.runOnce = true;//used for repeat check
 
     if (unit)
         mLastInvoker = unit->GetGUID();
@@ -139,7 +145,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     }
                 }
 
-                delete targets;
+                ReleaseTargetList(targets);
             }
 
             if (!talker)
@@ -178,7 +184,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                         (*itr)->GetName().c_str(), (*itr)->GetGUIDLow(), uint8(e.action.talk.textGroupID));
                 }
 
-                delete targets;
+                ReleaseTargetList(targets);
             }
             break;
         }
@@ -197,7 +203,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     }
                 }
 
-                delete targets;
+                ReleaseTargetList(targets);
             }
             break;
         }
@@ -216,7 +222,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     }
                 }
 
-                delete targets;
+                ReleaseTargetList(targets);
             }
             break;
         }
@@ -250,7 +256,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     }
                 }
 
-                delete targets;
+                ReleaseTargetList(targets);
             }
             break;
         }
@@ -294,7 +300,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 }
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_FAIL_QUEST:
@@ -313,7 +319,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 }
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_ADD_QUEST:
@@ -335,7 +341,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 }
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_SET_REACT_STATE:
@@ -352,7 +358,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 (*itr)->ToCreature()->SetReactState(ReactStates(e.action.react.state));
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_RANDOM_EMOTE:
@@ -381,7 +387,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
 
             if (count == 0)
             {
-                delete targets;
+                ReleaseTargetList(targets);
                 break;
             }
 
@@ -396,7 +402,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 }
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_THREAT_ALL_PCT:
@@ -435,7 +441,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 }
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_CALL_AREAEXPLOREDOREVENTHAPPENS:
@@ -462,7 +468,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 }
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_CAST:
@@ -513,7 +519,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     TC_LOG_DEBUG("scripts.ai", "Spell %u not cast because it has flag SMARTCAST_AURA_NOT_PRESENT and the target (%s) already has the aura", e.action.cast.spell, (*itr)->GetGUID().ToString().c_str());
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_INVOKER_CAST:
@@ -544,7 +550,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     TC_LOG_DEBUG("scripts.ai", "Spell %u not cast because it has flag SMARTCAST_AURA_NOT_PRESENT and the target (%s) already has the aura", e.action.cast.spell, (*itr)->GetGUID().ToString().c_str());
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_ADD_AURA:
@@ -563,7 +569,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 }
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_ACTIVATE_GOBJECT:
@@ -584,7 +590,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 }
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_RESET_GOBJECT:
@@ -603,7 +609,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 }
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_SET_EMOTE_STATE:
@@ -622,7 +628,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 }
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_SET_UNIT_FLAG:
@@ -650,7 +656,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 }
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_REMOVE_UNIT_FLAG:
@@ -678,7 +684,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 }
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_AUTO_ATTACK:
@@ -802,7 +808,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     (*itr)->GetGUIDLow(), e.action.removeAura.spell);
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_FOLLOW:
@@ -828,7 +834,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 }
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_RANDOM_PHASE:
@@ -909,7 +915,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                                     player->KilledMonsterCredit(e.action.killedMonster.creature);
                 }
 
-                delete targets;
+                ReleaseTargetList(targets);
             }
             break;
         }
@@ -958,7 +964,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
             TC_LOG_DEBUG("scripts.ai", "SmartScript::ProcessAction: SMART_ACTION_SET_INST_DATA64: Field: %u, data: %s",
                 e.action.setInstanceData64.field, targets->front()->GetGUID().ToString().c_str());
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_UPDATE_TEMPLATE:
@@ -972,7 +978,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 if (IsCreature(*itr))
                     (*itr)->ToCreature()->UpdateEntry(e.action.updateTemplate.creature);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_DIE:
@@ -1038,7 +1044,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     (*itr)->ToCreature()->DespawnOrUnsummon(e.action.forceDespawn.delay);
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_SET_INGAME_PHASE_ID:
@@ -1051,7 +1057,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
             for (ObjectList::const_iterator itr = targets->begin(); itr != targets->end(); ++itr)
                 (*itr)->SetInPhase(e.action.ingamePhaseId.id, true, e.action.ingamePhaseId.apply == 1);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_SET_INGAME_PHASE_GROUP:
@@ -1067,7 +1073,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 for (auto phase : phases)
                     (*itr)->SetInPhase(phase, true, e.action.ingamePhaseGroup.apply == 1);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_MOUNT_TO_ENTRY_OR_MODEL:
@@ -1095,7 +1101,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     (*itr)->ToUnit()->Dismount();
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_SET_INVINCIBILITY_HP_LEVEL:
@@ -1129,7 +1135,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     (*itr)->ToGameObject()->AI()->SetData(e.action.setData.field, e.action.setData.data);
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_MOVE_FORWARD:
@@ -1173,7 +1179,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 }
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_SUMMON_CREATURE:
@@ -1194,7 +1200,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                             summon->AI()->AttackStart((*itr)->ToUnit());
                 }
 
-                delete targets;
+                ReleaseTargetList(targets);
             }
 
             if (e.GetTargetType() != SMART_TARGET_POSITION)
@@ -1227,7 +1233,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     GetBaseObject()->SummonGameObject(e.action.summonGO.entry, x, y, z, o, 0, 0, 0, 0, e.action.summonGO.despawnTime);
                 }
 
-                delete targets;
+                ReleaseTargetList(targets);
             }
 
             if (e.GetTargetType() != SMART_TARGET_POSITION)
@@ -1250,7 +1256,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 (*itr)->ToUnit()->Kill((*itr)->ToUnit());
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_INSTALL_AI_TEMPLATE:
@@ -1272,7 +1278,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 (*itr)->ToPlayer()->AddItem(e.action.item.entry, e.action.item.count);
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_REMOVE_ITEM:
@@ -1289,13 +1295,14 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 (*itr)->ToPlayer()->DestroyItemCount(e.action.item.entry, e.action.item.count, true);
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_STORE_TARGET_LIST:
         {
             ObjectList* targets = GetTargets(e, unit);
             StoreTargetList(targets, e.action.storeTargets.id);
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_TELEPORT:
@@ -1312,7 +1319,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     (*itr)->ToCreature()->NearTeleportTo(e.target.x, e.target.y, e.target.z, e.target.o);
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_SET_FLY:
@@ -1361,7 +1368,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     }
                 }
 
-                delete targets;
+                ReleaseTargetList(targets);
             }
             else
                 StoreCounter(e.action.setCounter.counterId, e.action.setCounter.value, e.action.setCounter.reset);
@@ -1378,6 +1385,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
             bool repeat = e.action.wpStart.repeat != 0;
             ObjectList* targets = GetTargets(e, unit);
             StoreTargetList(targets, SMART_ESCORT_TARGETS);
+            ReleaseTargetList(targets);
             me->SetReactState((ReactStates)e.action.wpStart.reactState);
             ENSURE_AI(SmartAI, me->AI())->StartPath(run, entry, repeat, unit);
 
@@ -1429,7 +1437,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 if (!targets->empty())
                     me->SetFacingToObject(*targets->begin());
 
-                delete targets;
+                ReleaseTargetList(targets);
             }
 
             break;
@@ -1448,7 +1456,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 (*itr)->ToPlayer()->SendMovieStart(e.action.movie.entry);
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_MOVE_TO_POS:
@@ -1470,7 +1478,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     break;
 
                 target = targets->front();
-                delete targets;
+                ReleaseTargetList(targets);
             }
 
             if (!target)
@@ -1500,7 +1508,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     (*itr)->ToGameObject()->SetRespawnTime(e.action.RespawnTarget.goRespawnTime);
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_CLOSE_GOSSIP:
@@ -1513,7 +1521,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 if (IsPlayer(*itr))
                     (*itr)->ToPlayer()->PlayerTalkClass->SendCloseGossip();
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_EQUIP:
@@ -1557,7 +1565,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 }
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_CREATE_TIMED_EVENT:
@@ -1585,8 +1593,11 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
             ev.event_id = e.action.timeEvent.id;
             ev.target = e.target;
             ev.action = ac;
-            InitTimer(ev);
-            mStoredEvents.push_back(ev);
+            mOwnedEvents.push_back(ev);
+
+            SmartEventState evState(&mOwnedEvents.back());
+            InitTimer(evState);
+            mStoredEvents.push_back(evState);
             break;
         }
         case SMART_ACTION_TRIGGER_TIMED_EVENT:
@@ -1625,7 +1636,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 }
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_RESET_SCRIPT_BASE_OBJECT:
@@ -1651,7 +1662,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                             if (ENSURE_AI(SmartAI, target->AI())->CanCombatMove())
                                 target->GetMotionMaster()->MoveChase(target->GetVictim(), attackDistance, attackAngle);
 
-                delete targets;
+                ReleaseTargetList(targets);
             }
             break;
         }
@@ -1679,7 +1690,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     }
                 }
 
-                delete targets;
+                ReleaseTargetList(targets);
             }
             break;
         }
@@ -1693,7 +1704,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 if (IsCreature(*itr))
                     (*itr)->ToUnit()->SetUInt32Value(UNIT_NPC_FLAGS, e.action.unitFlag.flag);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_ADD_NPC_FLAG:
@@ -1706,7 +1717,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 if (IsCreature(*itr))
                     (*itr)->ToUnit()->SetFlag(UNIT_NPC_FLAGS, e.action.unitFlag.flag);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_REMOVE_NPC_FLAG:
@@ -1719,7 +1730,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 if (IsCreature(*itr))
                     (*itr)->ToUnit()->RemoveFlag(UNIT_NPC_FLAGS, e.action.unitFlag.flag);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_CROSS_CAST:
@@ -1731,7 +1742,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
             ObjectList* targets = GetTargets(e, unit);
             if (!targets)
             {
-                delete casters; // casters already validated, delete now
+                ReleaseTargetList(casters); // casters already validated, release now
                 break;
             }
 
@@ -1764,8 +1775,8 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 }
             }
 
-            delete targets;
-            delete casters;
+            ReleaseTargetList(targets);
+            ReleaseTargetList(casters);
             break;
         }
         case SMART_ACTION_CALL_RANDOM_TIMED_ACTIONLIST:
@@ -1815,7 +1826,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     }
                 }
 
-                delete targets;
+                ReleaseTargetList(targets);
             }
             break;
         }
@@ -1845,7 +1856,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     }
                 }
 
-                delete targets;
+                ReleaseTargetList(targets);
             }
             break;
         }
@@ -1859,7 +1870,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 if (IsPlayer(*itr))
                     (*itr)->ToPlayer()->ActivateTaxiPathTo(e.action.taxi.id);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_RANDOM_MOVE:
@@ -1891,7 +1902,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     me->GetMotionMaster()->MoveIdle();
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_SET_UNIT_FIELD_BYTES_1:
@@ -1903,7 +1914,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 if (IsUnit(*itr))
                     (*itr)->ToUnit()->SetByteFlag(UNIT_FIELD_BYTES_1, e.action.setunitByte.type, e.action.setunitByte.byte1);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_REMOVE_UNIT_FIELD_BYTES_1:
@@ -1916,7 +1927,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 if (IsUnit(*itr))
                     (*itr)->ToUnit()->RemoveByteFlag(UNIT_FIELD_BYTES_1, e.action.delunitByte.type, e.action.delunitByte.byte1);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_INTERRUPT_SPELL:
@@ -1929,7 +1940,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 if (IsUnit(*itr))
                     (*itr)->ToUnit()->InterruptNonMeleeSpells(e.action.interruptSpellCasting.withDelayed != 0, e.action.interruptSpellCasting.spell_id, e.action.interruptSpellCasting.withInstant != 0);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_SEND_GO_CUSTOM_ANIM:
@@ -1942,7 +1953,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 if (IsGameObject(*itr))
                     (*itr)->ToGameObject()->SendCustomAnim(e.action.sendGoCustomAnim.anim);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_SET_DYNAMIC_FLAG:
@@ -1955,7 +1966,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 if (IsUnit(*itr))
                     (*itr)->ToUnit()->SetUInt32Value(UNIT_DYNAMIC_FLAGS, e.action.unitFlag.flag);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_ADD_DYNAMIC_FLAG:
@@ -1968,7 +1979,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 if (IsUnit(*itr))
                     (*itr)->ToUnit()->SetFlag(UNIT_DYNAMIC_FLAGS, e.action.unitFlag.flag);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_REMOVE_DYNAMIC_FLAG:
@@ -1981,7 +1992,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 if (IsUnit(*itr))
                     (*itr)->ToUnit()->RemoveFlag(UNIT_DYNAMIC_FLAGS, e.action.unitFlag.flag);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_JUMP_TO_POS:
@@ -2000,7 +2011,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
             }
             /// @todo Resume path when reached jump location
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_GO_SET_LOOT_STATE:
@@ -2014,7 +2025,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 if (IsGameObject(*itr))
                     (*itr)->ToGameObject()->SetLootState((LootState)e.action.setGoLootState.state);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_SEND_TARGET_TO_TARGET:
@@ -2026,7 +2037,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
             ObjectList* storedTargets = GetTargetList(e.action.sendTargetToTarget.id);
             if (!storedTargets)
             {
-                delete targets;
+                ReleaseTargetList(targets);
                 break;
             }
 
@@ -2035,20 +2046,20 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 if (IsCreature(*itr))
                 {
                     if (SmartAI* ai = CAST_AI(SmartAI, (*itr)->ToCreature()->AI()))
-                        ai->GetScript()->StoreTargetList(new ObjectList(*storedTargets), e.action.sendTargetToTarget.id);   // store a copy of target list
+                        ai->GetScript()->StoreTargetList(storedTargets, e.action.sendTargetToTarget.id);   // stores a copy of target list
                     else
                         TC_LOG_ERROR("sql.sql", "SmartScript: Action target for SMART_ACTION_SEND_TARGET_TO_TARGET is not using SmartAI, skipping");
                 }
                 else if (IsGameObject(*itr))
                 {
                     if (SmartGameObjectAI* ai = CAST_AI(SmartGameObjectAI, (*itr)->ToGameObject()->AI()))
-                        ai->GetScript()->StoreTargetList(new ObjectList(*storedTargets), e.action.sendTargetToTarget.id);   // store a copy of target list
+                        ai->GetScript()->StoreTargetList(storedTargets, e.action.sendTargetToTarget.id);   // stores a copy of target list
                     else
                         TC_LOG_ERROR("sql.sql", "SmartScript: Action target for SMART_ACTION_SEND_TARGET_TO_TARGET is not using SmartGameObjectAI, skipping");
                 }
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_SEND_GOSSIP_MENU:
@@ -2076,7 +2087,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 }
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_SET_HOME_POS:
@@ -2107,7 +2118,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 }
             }
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_SET_HEALTH_REGEN:
@@ -2120,7 +2131,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 if (IsCreature(*itr))
                     (*itr)->ToCreature()->setRegeneratingHealth(e.action.setHealthRegen.regenHealth != 0);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_SET_ROOT:
@@ -2133,7 +2144,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 if (IsCreature(*itr))
                     (*itr)->ToCreature()->SetControlled(e.action.setRoot.root != 0, UNIT_STATE_ROOT);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_SET_GO_FLAG:
@@ -2146,7 +2157,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 if (IsGameObject(*itr))
                     (*itr)->ToGameObject()->SetUInt32Value(GAMEOBJECT_FLAGS, e.action.goFlag.flag);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_ADD_GO_FLAG:
@@ -2159,7 +2170,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 if (IsGameObject(*itr))
                     (*itr)->ToGameObject()->SetFlag(GAMEOBJECT_FLAGS, e.action.goFlag.flag);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_REMOVE_GO_FLAG:
@@ -2172,7 +2183,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 if (IsGameObject(*itr))
                     (*itr)->ToGameObject()->RemoveFlag(GAMEOBJECT_FLAGS, e.action.goFlag.flag);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_SUMMON_CREATURE_GROUP:
@@ -2195,7 +2206,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     if (IsUnit(*itr))
                         (*itr)->ToUnit()->SetPower(Powers(e.action.power.powerType), e.action.power.newPower);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_ADD_POWER:
@@ -2207,7 +2218,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     if (IsUnit(*itr))
                         (*itr)->ToUnit()->SetPower(Powers(e.action.power.powerType), (*itr)->ToUnit()->GetPower(Powers(e.action.power.powerType)) + e.action.power.newPower);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_REMOVE_POWER:
@@ -2219,7 +2230,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     if (IsUnit(*itr))
                         (*itr)->ToUnit()->SetPower(Powers(e.action.power.powerType), (*itr)->ToUnit()->GetPower(Powers(e.action.power.powerType)) - e.action.power.newPower);
 
-            delete targets;
+            ReleaseTargetList(targets);
             break;
         }
         case SMART_ACTION_GAME_EVENT_STOP:
@@ -2298,7 +2309,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     }
                 }
 
-                delete targets;
+                ReleaseTargetList(targets);
             }
             break;
         }
@@ -2309,23 +2320,23 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
 
     if (e.link && e.link != e.event_id)
     {
-        SmartScriptHolder& linked = SmartAIMgr::FindLinkedEvent(mEvents, e.link);
-        if (linked)
-            ProcessEvent(linked, unit, var0, var1, bvar, spell, gob);
+        if (SmartEventState* linked = FindLinkedEvent(e.link))
+            ProcessEvent(*linked, unit, var0, var1, bvar, spell, gob);
         else
             TC_LOG_DEBUG("sql.sql", "SmartScript::ProcessAction: Entry %d SourceType %u, Event %u, Link Event %u not found or invalid, skipped.", e.entryOrGuid, e.GetScriptType(), e.event_id, e.link);
     }
 }
 
-void SmartScript::ProcessTimedAction(SmartScriptHolder& e, uint32 const& min, uint32 const& max, Unit* unit, uint32 var0, uint32 var1, bool bvar, const SpellInfo* spell, GameObject* gob)
+void SmartScript::ProcessTimedAction(SmartEventState& state, uint32 const& min, uint32 const& max, Unit* unit, uint32 var0, uint32 var1, bool bvar, const SpellInfo* spell, GameObject* gob)
 {
+    SmartScriptHolder const& e = *state.holder;
     ConditionList const conds = sConditionMgr->GetConditionsForSmartEvent(e.entryOrGuid, e.event_id, e.source_type);
     ConditionSourceInfo info = ConditionSourceInfo(unit, GetBaseObject());
 
     if (sConditionMgr->IsObjectMeetToConditions(info, conds))
-        ProcessAction(e, unit, var0, var1, bvar, spell, gob);
+        ProcessAction(state, unit, var0, var1, bvar, spell, gob);
 
-    RecalcTimer(e, min, max);
+    RecalcTimer(state, min, max);
 }
 
 void SmartScript::InstallTemplate(SmartScriptHolder const& e)
@@ -2433,7 +2444,6 @@ SmartScriptHolder SmartScript::CreateEvent(SMART_EVENT e, uint32 event_flags, ui
     script.target.raw.param3 = target_param3;
 
     script.source_type = SMART_SCRIPT_TYPE_CREATURE;
-    InitTimer(script);
     return script;
 }
 
@@ -2447,7 +2457,7 @@ ObjectList* SmartScript::GetTargets(SmartScriptHolder const& e, Unit* invoker /*
 
     WorldObject* baseObject = GetBaseObject();
 
-    ObjectList* l = new ObjectList();
+    ObjectList* l = AcquireTargetList();
     switch (e.GetTargetType())
     {
         case SMART_TARGET_SELF:
@@ -2522,7 +2532,7 @@ ObjectList* SmartScript::GetTargets(SmartScriptHolder const& e, Unit* invoker /*
                     l->push_back(*itr);
             }
 
-            delete units;
+            ReleaseTargetList(units);
             break;
         }
         case SMART_TARGET_CREATURE_DISTANCE:
@@ -2541,7 +2551,7 @@ ObjectList* SmartScript::GetTargets(SmartScriptHolder const& e, Unit* invoker /*
                     l->push_back(*itr);
             }
 
-            delete units;
+            ReleaseTargetList(units);
             break;
         }
         case SMART_TARGET_GAMEOBJECT_DISTANCE:
@@ -2560,7 +2570,7 @@ ObjectList* SmartScript::GetTargets(SmartScriptHolder const& e, Unit* invoker /*
                     l->push_back(*itr);
             }
 
-            delete units;
+            ReleaseTargetList(units);
             break;
         }
         case SMART_TARGET_GAMEOBJECT_RANGE:
@@ -2579,7 +2589,7 @@ ObjectList* SmartScript::GetTargets(SmartScriptHolder const& e, Unit* invoker /*
                     l->push_back(*itr);
             }
 
-            delete units;
+            ReleaseTargetList(units);
             break;
         }
         case SMART_TARGET_CREATURE_GUID:
@@ -2617,7 +2627,7 @@ ObjectList* SmartScript::GetTargets(SmartScriptHolder const& e, Unit* invoker /*
                     if (IsPlayer(*itr) && baseObject->IsInRange(*itr, (float)e.target.playerRange.minDist, (float)e.target.playerRange.maxDist))
                         l->push_back(*itr);
 
-            delete units;
+            ReleaseTargetList(units);
             break;
         }
         case SMART_TARGET_PLAYER_DISTANCE:
@@ -2628,7 +2638,7 @@ ObjectList* SmartScript::GetTargets(SmartScriptHolder const& e, Unit* invoker /*
                 if (IsPlayer(*itr))
                     l->push_back(*itr);
 
-            delete units;
+            ReleaseTargetList(units);
             break;
         }
         case SMART_TARGET_STORED:
@@ -2708,52 +2718,90 @@ ObjectList* SmartScript::GetTargets(SmartScriptHolder const& e, Unit* invoker /*
 
     if (l->empty())
     {
-        delete l;
+        ReleaseTargetList(l);
         l = NULL;
     }
 
     return l;
 }
 
+// WorldObjectListSearcher only fills a std::list, this appends to the reused target lists instead
+class WorldObjectInRangeCollector
+{
+    public:
+        WorldObjectInRangeCollector(WorldObject const* object, float range, ObjectList& objects) : _object(object), _range(range), _objects(objects) { }
+
+        void operator()(WorldObject* object) const
+        {
+            if (_object->IsWithinDist(object, _range, false))
+                _objects.push_back(object);
+        }
+
+    private:
+        WorldObject const* _object;
+        float _range;
+        ObjectList& _objects;
+};
+
 ObjectList* SmartScript::GetWorldObjectsInDist(float dist)
 {
-    ObjectList* targets = new ObjectList();
+    ObjectList* targets = AcquireTargetList();
     WorldObject* obj = GetBaseObject();
     if (obj)
     {
-        Trinity::AllWorldObjectsInRange u_check(obj, dist);
-        Trinity::WorldObjectListSearcher<Trinity::AllWorldObjectsInRange> searcher(obj, *targets, u_check);
-        obj->VisitNearbyObject(dist, searcher);
+        WorldObjectInRangeCollector collector(obj, dist, *targets);
+        Trinity::WorldObjectWorker<WorldObjectInRangeCollector> worker(obj, collector);
+        obj->VisitNearbyObject(dist, worker);
     }
     return targets;
 }
 
-void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, uint32 var1, bool bvar, const SpellInfo* spell, GameObject* gob)
+ObjectList* SmartScript::AcquireTargetList()
+{
+    if (mFreeTargetLists.empty())
+        return new ObjectList();
+
+    ObjectList* targets = mFreeTargetLists.back();
+    mFreeTargetLists.pop_back();
+    return targets;
+}
+
+void SmartScript::ReleaseTargetList(ObjectList* targets)
 {
-    if (!e.active && e.GetEventType() != SMART_EVENT_LINK)
+    if (!targets)
         return;
 
-    if ((e.event.event_phase_mask && !IsInPhase(e.event.event_phase_mask)) || ((e.event.event_flags & SMART_EVENT_FLAG_NOT_REPEATABLE) && e.runOnce))
+    targets->clear();
+    mFreeTargetLists.push_back(targets);
+}
+
+void SmartScript::ProcessEvent(SmartEventState& state, Unit* unit, uint32 var0, uint32 var1, bool bvar, const SpellInfo* spell, GameObject* gob)
+{
+    SmartScriptHolder const& e = *state.holder;
+    if (!state.active && e.GetEventType() != SMART_EVENT_LINK)
+        return;
+
+    if ((e.event.event_phase_mask && !IsInPhase(e.event.event_phase_mask)) || ((e.event.event_flags & SMART_EVENT_FLAG_NOT_REPEATABLE) && state.runOnce))
         return;
 
     switch (e.GetEventType())
     {
         case SMART_EVENT_LINK://special handling
-            ProcessAction(e, unit, var0, var1, bvar, spell, gob);
+            ProcessAction(state, unit, var0, var1, bvar, spell, gob);
             break;
         //called from Update tick
         case SMART_EVENT_UPDATE:
-            ProcessTimedAction(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
+            ProcessTimedAction(state, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
             break;
         case SMART_EVENT_UPDATE_OOC:
             if (me && me->IsInCombat())
                 return;
-            ProcessTimedAction(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
+            ProcessTimedAction(state, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
             break;
         case SMART_EVENT_UPDATE_IC:
             if (!me || !me->IsInCombat())
                 return;
-            ProcessTimedAction(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
+            ProcessTimedAction(state, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
             break;
         case SMART_EVENT_HEALT_PCT:
         {
@@ -2762,7 +2810,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             uint32 perc = (uint32)me->GetHealthPct();
             if (perc > e.event.minMaxRepeat.max || perc < e.event.minMaxRepeat.min)
                 return;
-            ProcessTimedAction(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
+            ProcessTimedAction(state, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
             break;
         }
         case SMART_EVENT_TARGET_HEALTH_PCT:
@@ -2772,7 +2820,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             uint32 perc = (uint32)me->EnsureVictim()->GetHealthPct();
             if (perc > e.event.minMaxRepeat.max || perc < e.event.minMaxRepeat.min)
                 return;
-            ProcessTimedAction(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax, me->GetVictim());
+            ProcessTimedAction(state, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax, me->GetVictim());
             break;
         }
         case SMART_EVENT_MANA_PCT:
@@ -2782,7 +2830,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             uint32 perc = uint32(100.0f * me->GetPower(POWER_MANA) / me->GetMaxPower(POWER_MANA));
             if (perc > e.event.minMaxRepeat.max || perc < e.event.minMaxRepeat.min)
                 return;
-            ProcessTimedAction(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
+            ProcessTimedAction(state, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
             break;
         }
         case SMART_EVENT_TARGET_MANA_PCT:
@@ -2792,7 +2840,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             uint32 perc = uint32(100.0f * me->EnsureVictim()->GetPower(POWER_MANA) / me->EnsureVictim()->GetMaxPower(POWER_MANA));
             if (perc > e.event.minMaxRepeat.max || perc < e.event.minMaxRepeat.min)
                 return;
-            ProcessTimedAction(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax, me->GetVictim());
+            ProcessTimedAction(state, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax, me->GetVictim());
             break;
         }
         case SMART_EVENT_RANGE:
@@ -2801,7 +2849,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                 return;
 
             if (me->IsInRange(me->GetVictim(), (float)e.event.minMaxRepeat.min, (float)e.event.minMaxRepeat.max))
-                ProcessTimedAction(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax, me->GetVictim());
+                ProcessTimedAction(state, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax, me->GetVictim());
             break;
         }
         case SMART_EVENT_VICTIM_CASTING:
@@ -2819,7 +2867,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                     if (currSpell->m_spellInfo->Id != e.event.targetCasting.spellId)
                         return;
 
-            ProcessTimedAction(e, e.event.targetCasting.repeatMin, e.event.targetCasting.repeatMax, me->GetVictim());
+            ProcessTimedAction(state, e.event.targetCasting.repeatMin, e.event.targetCasting.repeatMax, me->GetVictim());
             break;
         }
         case SMART_EVENT_FRIENDLY_HEALTH:
@@ -2830,7 +2878,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             Unit* target = DoSelectLowestHpFriendly((float)e.event.friendlyHealth.radius, e.event.friendlyHealth.hpDeficit);
             if (!target || !target->IsInCombat())
                 return;
-            ProcessTimedAction(e, e.event.friendlyHealth.repeatMin, e.event.friendlyHealth.repeatMax, target);
+            ProcessTimedAction(state, e.event.friendlyHealth.repeatMin, e.event.friendlyHealth.repeatMax, target);
             break;
         }
         case SMART_EVENT_FRIENDLY_IS_CC:
@@ -2842,7 +2890,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             DoFindFriendlyCC(pList, (float)e.event.friendlyCC.radius);
             if (pList.empty())
                 return;
-            ProcessTimedAction(e, e.event.friendlyCC.repeatMin, e.event.friendlyCC.repeatMax, *pList.begin());
+            ProcessTimedAction(state, e.event.friendlyCC.repeatMin, e.event.friendlyCC.repeatMax, *pList.begin());
             break;
         }
         case SMART_EVENT_FRIENDLY_MISSING_BUFF:
@@ -2853,7 +2901,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             if (pList.empty())
                 return;
 
-            ProcessTimedAction(e, e.event.missingBuff.repeatMin, e.event.missingBuff.repeatMax, *pList.begin());
+            ProcessTimedAction(state, e.event.missingBuff.repeatMin, e.event.missingBuff.repeatMax, *pList.begin());
             break;
         }
         case SMART_EVENT_HAS_AURA:
@@ -2862,7 +2910,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                 return;
             uint32 count = me->GetAuraCount(e.event.aura.spell);
             if ((!e.event.aura.count && !count) || (e.event.aura.count && count >= e.event.aura.count))
-                ProcessTimedAction(e, e.event.aura.repeatMin, e.event.aura.repeatMax);
+                ProcessTimedAction(state, e.event.aura.repeatMin, e.event.aura.repeatMax);
             break;
         }
         case SMART_EVENT_TARGET_BUFFED:
@@ -2872,7 +2920,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             uint32 count = me->EnsureVictim()->GetAuraCount(e.event.aura.spell);
             if (count < e.event.aura.count)
                 return;
-            ProcessTimedAction(e, e.event.aura.repeatMin, e.event.aura.repeatMax);
+            ProcessTimedAction(state, e.event.aura.repeatMin, e.event.aura.repeatMax);
             break;
         }
         //no params
@@ -2897,7 +2945,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         case SMART_EVENT_GOSSIP_HELLO:
         case SMART_EVENT_FOLLOW_COMPLETED:
         case SMART_EVENT_ON_SPELLCLICK:
-            ProcessAction(e, unit, var0, var1, bvar, spell, gob);
+            ProcessAction(state, unit, var0, var1, bvar, spell, gob);
             break;
         case SMART_EVENT_IS_BEHIND_TARGET:
             {
@@ -2907,15 +2955,15 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                 if (Unit* victim = me->GetVictim())
                 {
                     if (!victim->HasInArc(static_cast<float>(M_PI), me))
-                        ProcessTimedAction(e, e.event.behindTarget.cooldownMin, e.event.behindTarget.cooldownMax, victim);
+                        ProcessTimedAction(state, e.event.behindTarget.cooldownMin, e.event.behindTarget.cooldownMax, victim);
                 }
                 break;
             }
         case SMART_EVENT_RECEIVE_EMOTE:
             if (e.event.emote.emote == var0)
             {
-                ProcessAction(e, unit);
-                RecalcTimer(e, e.event.emote.cooldownMin, e.event.emote.cooldownMax);
+                ProcessAction(state, unit);
+                RecalcTimer(state, e.event.emote.cooldownMin, e.event.emote.cooldownMax);
             }
             break;
         case SMART_EVENT_KILL:
@@ -2926,8 +2974,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                 return;
             if (e.event.kill.creature && unit->GetEntry() != e.event.kill.creature)
                 return;
-            ProcessAction(e, unit);
-            RecalcTimer(e, e.event.kill.cooldownMin, e.event.kill.cooldownMax);
+            ProcessAction(state, unit);
+            RecalcTimer(state, e.event.kill.cooldownMin, e.event.kill.cooldownMax);
             break;
         }
         case SMART_EVENT_SPELLHIT_TARGET:
@@ -2938,8 +2986,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             if ((!e.event.spellHit.spell || spell->Id == e.event.spellHit.spell) &&
                 (!e.event.spellHit.school || (spell->SchoolMask & e.event.spellHit.school)))
                 {
-                    ProcessAction(e, unit, 0, 0, bvar, spell);
-                    RecalcTimer(e, e.event.spellHit.cooldownMin, e.event.spellHit.cooldownMax);
+                    ProcessAction(state, unit, 0, 0, bvar, spell);
+                    RecalcTimer(state, e.event.spellHit.cooldownMin, e.event.spellHit.cooldownMax);
                 }
             break;
         }
@@ -2957,8 +3005,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                 if ((e.event.los.noHostile && !me->IsHostileTo(unit)) ||
                     (!e.event.los.noHostile && me->IsHostileTo(unit)))
                 {
-                    ProcessAction(e, unit);
-                    RecalcTimer(e, e.event.los.cooldownMin, e.event.los.cooldownMax);
+                    ProcessAction(state, unit);
+                    RecalcTimer(state, e.event.los.cooldownMin, e.event.los.cooldownMax);
                 }
             }
             break;
@@ -2977,8 +3025,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                 if ((e.event.los.noHostile && !me->IsHostileTo(unit)) ||
                     (!e.event.los.noHostile && me->IsHostileTo(unit)))
                 {
-                    ProcessAction(e, unit);
-                    RecalcTimer(e, e.event.los.cooldownMin, e.event.los.cooldownMax);
+                    ProcessAction(state, unit);
+                    RecalcTimer(state, e.event.los.cooldownMin, e.event.los.cooldownMax);
                 }
             }
             break;
@@ -2991,7 +3039,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                 return;
             if (e.event.respawn.type == SMART_SCRIPT_RESPAWN_CONDITION_AREA && GetBaseObject()->GetZoneId() != e.event.respawn.area)
                 return;
-            ProcessAction(e);
+            ProcessAction(state);
             break;
         }
         case SMART_EVENT_SUMMONED_UNIT:
@@ -3000,8 +3048,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                 return;
             if (e.event.summoned.creature && unit->GetEntry() != e.event.summoned.creature)
                 return;
-            ProcessAction(e, unit);
-            RecalcTimer(e, e.event.summoned.cooldownMin, e.event.summoned.cooldownMax);
+            ProcessAction(state, unit);
+            RecalcTimer(state, e.event.summoned.cooldownMin, e.event.summoned.cooldownMax);
             break;
         }
         case SMART_EVENT_RECEIVE_HEAL:
@@ -3010,15 +3058,15 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (var0 > e.event.minMaxRepeat.max || var0 < e.event.minMaxRepeat.min)
                 return;
-            ProcessAction(e, unit);
-            RecalcTimer(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
+            ProcessAction(state, unit);
+            RecalcTimer(state, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
             break;
         }
         case SMART_EVENT_MOVEMENTINFORM:
         {
             if ((e.event.movementInform.type && var0 != e.event.movementInform.type) || (e.event.movementInform.id && var1 != e.event.movementInform.id))
                 return;
-            ProcessAction(e, unit, var0, var1);
+            ProcessAction(state, unit, var0, var1);
             break;
         }
         case SMART_EVENT_TRANSPORT_RELOCATE:
@@ -3026,7 +3074,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (e.event.waypoint.pathID && var0 != e.event.waypoint.pathID)
                 return;
-            ProcessAction(e, unit, var0);
+            ProcessAction(state, unit, var0);
             break;
         }
         case SMART_EVENT_WAYPOINT_REACHED:
@@ -3037,7 +3085,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (!me || (e.event.waypoint.pointID && var0 != e.event.waypoint.pointID) || (e.event.waypoint.pathID && GetPathId() != e.event.waypoint.pathID))
                 return;
-            ProcessAction(e, unit);
+            ProcessAction(state, unit);
             break;
         }
         case SMART_EVENT_SUMMON_DESPAWNED:
@@ -3045,8 +3093,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (e.event.instancePlayerEnter.team && var0 != e.event.instancePlayerEnter.team)
                 return;
-            ProcessAction(e, unit, var0);
-            RecalcTimer(e, e.event.instancePlayerEnter.cooldownMin, e.event.instancePlayerEnter.cooldownMax);
+            ProcessAction(state, unit, var0);
+            RecalcTimer(state, e.event.instancePlayerEnter.cooldownMin, e.event.instancePlayerEnter.cooldownMax);
             break;
         }
         case SMART_EVENT_ACCEPTED_QUEST:
@@ -3054,36 +3102,36 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (e.event.quest.quest && var0 != e.event.quest.quest)
                 return;
-            ProcessAction(e, unit, var0);
+            ProcessAction(state, unit, var0);
             break;
         }
         case SMART_EVENT_TRANSPORT_ADDCREATURE:
         {
             if (e.event.transportAddCreature.creature && var0 != e.event.transportAddCreature.creature)
                 return;
-            ProcessAction(e, unit, var0);
+            ProcessAction(state, unit, var0);
             break;
         }
         case SMART_EVENT_AREATRIGGER_ONTRIGGER:
         {
             if (e.event.areatrigger.id && var0 != e.event.areatrigger.id)
                 return;
-            ProcessAction(e, unit, var0);
+            ProcessAction(state, unit, var0);
             break;
         }
         case SMART_EVENT_TEXT_OVER:
         {
             if (var0 != e.event.textOver.textGroupID || (e.event.textOver.creatureEntry && e.event.textOver.creatureEntry != var1))
                 return;
-            ProcessAction(e, unit, var0);
+            ProcessAction(state, unit, var0);
             break;
         }
         case SMART_EVENT_DATA_SET:
         {
             if (e.event.dataSet.id != var0 || e.event.dataSet.value != var1)
                 return;
-            ProcessAction(e, unit, var0, var1);
-            RecalcTimer(e, e.event.dataSet.cooldownMin, e.event.dataSet.cooldownMax);
+            ProcessAction(state, unit, var0, var1);
+            RecalcTimer(state, e.event.dataSet.cooldownMin, e.event.dataSet.cooldownMax);
             break;
         }
         case SMART_EVENT_PASSENGER_REMOVED:
@@ -3091,14 +3139,14 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (!unit)
                 return;
-            ProcessAction(e, unit);
-            RecalcTimer(e, e.event.minMax.repeatMin, e.event.minMax.repeatMax);
+            ProcessAction(state, unit);
+            RecalcTimer(state, e.event.minMax.repeatMin, e.event.minMax.repeatMax);
             break;
         }
         case SMART_EVENT_TIMED_EVENT_TRIGGERED:
         {
             if (e.event.timedEvent.id == var0)
-                ProcessAction(e, unit);
+                ProcessAction(state, unit);
             break;
         }
         case SMART_EVENT_GOSSIP_SELECT:
@@ -3106,14 +3154,14 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             TC_LOG_DEBUG("scripts.ai", "SmartScript: Gossip Select:  menu %u action %u", var0, var1);//little help for scripters
             if (e.event.gossip.sender != var0 || e.event.gossip.action != var1)
                 return;
-            ProcessAction(e, unit, var0, var1);
+            ProcessAction(state, unit, var0, var1);
             break;
         }
         case SMART_EVENT_DUMMY_EFFECT:
         {
             if (e.event.dummy.spell != var0 || e.event.dummy.effIndex != var1)
                 return;
-            ProcessAction(e, unit, var0, var1);
+            ProcessAction(state, unit, var0, var1);
             break;
         }
         case SMART_EVENT_GAME_EVENT_START:
@@ -3121,28 +3169,28 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (e.event.gameEvent.gameEventId != var0)
                 return;
-            ProcessAction(e, NULL, var0);
+            ProcessAction(state, NULL, var0);
             break;
         }
         case SMART_EVENT_GO_STATE_CHANGED:
         {
             if (e.event.goStateChanged.state != var0)
                 return;
-            ProcessAction(e, unit, var0, var1);
+            ProcessAction(state, unit, var0, var1);
             break;
         }
         case SMART_EVENT_GO_EVENT_INFORM:
         {
             if (e.event.eventInform.eventId != var0)
                 return;
-            ProcessAction(e, NULL, var0);
+            ProcessAction(state, NULL, var0);
             break;
         }
         case SMART_EVENT_ACTION_DONE:
         {
             if (e.event.doAction.eventId != var0)
                 return;
-            ProcessAction(e, unit, var0);
+            ProcessAction(state, unit, var0);
             break;
         }
         case SMART_EVENT_FRIENDLY_HEALTH_PCT:
@@ -3186,12 +3234,12 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                 }
             }
 
-            delete _targets;
+            ReleaseTargetList(_targets);
 
             if (!target)
                 return;
 
-            ProcessTimedAction(e, e.event.friendlyHealthPct.repeatMin, e.event.friendlyHealthPct.repeatMax, target);
+            ProcessTimedAction(state, e.event.friendlyHealthPct.repeatMin, e.event.friendlyHealthPct.repeatMax, target);
             break;
         }
         case SMART_EVENT_DISTANCE_CREATURE:
@@ -3221,7 +3269,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             }
 
             if (creature)
-                ProcessTimedAction(e, e.event.distance.repeat, e.event.distance.repeat);
+                ProcessTimedAction(state, e.event.distance.repeat, e.event.distance.repeat);
 
             break;
         }
@@ -3252,13 +3300,13 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             }
 
             if (gameobject)
-                ProcessTimedAction(e, e.event.distance.repeat, e.event.distance.repeat);
+                ProcessTimedAction(state, e.event.distance.repeat, e.event.distance.repeat);
 
             break;
         }
         case SMART_EVENT_COUNTER_SET:
             if (GetCounterId(e.event.counter.id) != 0 && GetCounterValue(e.event.counter.id) == e.event.counter.value)
-                ProcessTimedAction(e, e.event.counter.cooldownMin, e.event.counter.cooldownMax);
+                ProcessTimedAction(state, e.event.counter.cooldownMin, e.event.counter.cooldownMax);
             break;
         default:
             TC_LOG_ERROR("sql.sql", "SmartScript::ProcessEvent: Unhandled Event type %u", e.GetEventType());
@@ -3266,34 +3314,36 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
     }
 }
 
-void SmartScript::InitTimer(SmartScriptHolder& e)
+void SmartScript::InitTimer(SmartEventState& state)
 {
+    SmartScriptHolder const& e = *state.holder;
     switch (e.GetEventType())
     {
         //set only events which have initial timers
         case SMART_EVENT_UPDATE:
         case SMART_EVENT_UPDATE_IC:
         case SMART_EVENT_UPDATE_OOC:
-            RecalcTimer(e, e.event.minMaxRepeat.min, e.event.minMaxRepeat.max);
+            RecalcTimer(state, e.event.minMaxRepeat.min, e.event.minMaxRepeat.max);
             break;
         case SMART_EVENT_DISTANCE_CREATURE:
         case SMART_EVENT_DISTANCE_GAMEOBJECT:
-            RecalcTimer(e, e.event.distance.repeat, e.event.distance.repeat);
+            RecalcTimer(state, e.event.distance.repeat, e.event.distance.repeat);
             break;
         default:
-            e.active = true;
+            state.active = true;
             break;
     }
 }
-void SmartScript::RecalcTimer(SmartScriptHolder& e, uint32 min, uint32 max)
+void SmartScript::RecalcTimer(SmartEventState& state, uint32 min, uint32 max)
 {
     // min/max was checked at loading!
-    e.timer = urand(min, max);
-    e.active = e.timer ? false : true;
+    state.timer = urand(min, max);
+    state.active = state.timer ? false : true;
 }
 
-void SmartScript::UpdateTimer(SmartScriptHolder& e, uint32 const diff)
+void SmartScript::UpdateTimer(SmartEventState& state, uint32 const diff)
 {
+    SmartScriptHolder const& e = *state.holder;
     if (e.GetEventType() == SMART_EVENT_LINK)
         return;
 
@@ -3306,7 +3356,7 @@ void SmartScript::UpdateTimer(SmartScriptHolder& e, uint32 const diff)
     if (e.GetEventType() == SMART_EVENT_UPDATE_OOC && (me && me->IsInCombat())) //can be used with me=NULL (go script)
         return;
 
-    if (e.timer < diff)
+    if (state.timer < diff)
     {
         // delay spell cast event if another spell is being cast
         if (e.GetActionType() == SMART_ACTION_CAST)
@@ -3315,13 +3365,13 @@ void SmartScript::UpdateTimer(SmartScriptHolder& e, uint32 const diff)
             {
                 if (me && me->HasUnitState(UNIT_STATE_CASTING))
                 {
-                    e.timer = 1;
+                    state.timer = 1;
                     return;
                 }
             }
         }
 
-        e.active = true;//activate events with cooldown
+        state.active = true;//activate events with cooldown
         switch (e.GetEventType())//process ONLY timed events
         {
             case SMART_EVENT_UPDATE:
@@ -3343,14 +3393,14 @@ void SmartScript::UpdateTimer(SmartScriptHolder& e, uint32 const diff)
             case SMART_EVENT_DISTANCE_CREATURE:
             case SMART_EVENT_DISTANCE_GAMEOBJECT:
             {
-                ProcessEvent(e);
+                ProcessEvent(state);
                 if (e.GetScriptType() == SMART_SCRIPT_TYPE_TIMED_ACTIONLIST)
                 {
-                    e.enableTimed = false;//disable event if it is in an ActionList and was processed once
-                    for (SmartAIEventList::iterator i = mTimedActionList.begin(); i != mTimedActionList.end(); ++i)
+                    state.enableTimed = false;//disable event if it is in an ActionList and was processed once
+                    for (SmartEventStateList::iterator i = mTimedActionList.begin(); i != mTimedActionList.end(); ++i)
                     {
                         //find the first event which is not the current one and enable it
-                        if (i->event_id > e.event_id)
+                        if (i->holder->event_id > e.event_id)
                         {
                             i->enableTimed = true;
                             break;
@@ -3362,12 +3412,12 @@ void SmartScript::UpdateTimer(SmartScriptHolder& e, uint32 const diff)
         }
     }
     else
-        e.timer -= diff;
+        state.timer -= diff;
 }
 
-bool SmartScript::CheckTimer(SmartScriptHolder const& e) const
+bool SmartScript::CheckTimer(SmartEventState const& state) const
 {
-    return e.active;
+    return state.active;
 }
 
 void SmartScript::InstallEvents()
@@ -3375,12 +3425,38 @@ void SmartScript::InstallEvents()
     if (!mInstallEvents.empty())
     {
         for (SmartAIEventList::iterator i = mInstallEvents.begin(); i != mInstallEvents.end(); ++i)
-            mEvents.push_back(*i);//must be before UpdateTimers
+        {
+            mOwnedEvents.push_back(*i);
+            mEvents.push_back(SmartEventState(&mOwnedEvents.back()));//must be before UpdateTimers
+            InitTimer(mEvents.back());
+        }
 
         mInstallEvents.clear();
+        BuildEventIndex();
     }
 }
 
+void SmartScript::BuildEventIndex()
+{
+    mEventIndex.clear();
+    mEventIndex.reserve(mEvents.size());
+    for (uint32 i = 0; i < mEvents.size(); ++i)
+        mEventIndex.push_back(std::make_pair(mEvents[i].holder->GetEventType(), i));
+
+    // keeps the events of one type in script order
+    std::sort(mEventIndex.begin(), mEventIndex.end());
+}
+
+SmartEventState* SmartScript::FindLinkedEvent(uint32 link)
+{
+    std::vector<std::pair<uint32, uint32> >::const_iterator itr = std::lower_bound(mEventIndex.begin(), mEventIndex.end(), std::make_pair(uint32(SMART_EVENT_LINK), uint32(0)));
+    for (; itr != mEventIndex.end() && itr->first == SMART_EVENT_LINK; ++itr)
+        if (mEvents[itr->second].holder->event_id == link)
+            return &mEvents[itr->second];
+
+    return NULL;
+}
+
 void SmartScript::OnUpdate(uint32 const diff)
 {
     if ((mScriptType == SMART_SCRIPT_TYPE_CREATURE || mScriptType == SMART_SCRIPT_TYPE_GAMEOBJECT) && !GetBaseObject())
@@ -3388,18 +3464,18 @@ void SmartScript::OnUpdate(uint32 const diff)
 
     InstallEvents();//before UpdateTimers
 
-    for (SmartAIEventList::iterator i = mEvents.begin(); i != mEvents.end(); ++i)
+    for (SmartEventStateList::iterator i = mEvents.begin(); i != mEvents.end(); ++i)
         UpdateTimer(*i, diff);
 
-    if (!mStoredEvents.empty())
-        for (SmartAIEventList::iterator i = mStoredEvents.begin(); i != mStoredEvents.end(); ++i)
-             UpdateTimer(*i, diff);
+    // by index, a stored event may create another one
+    for (size_t i = 0; i < mStoredEvents.size(); ++i)
+        UpdateTimer(mStoredEvents[i], diff);
 
     bool needCleanup = true;
     if (!mTimedActionList.empty())
     {
         isProcessingTimedActionList = true;
-        for (SmartAIEventList::iterator i = mTimedActionList.begin(); i != mTimedActionList.end(); ++i)
+        for (SmartEventStateList::iterator i = mTimedActionList.begin(); i != mTimedActionList.end(); ++i)
         {
             if ((*i).enableTimed)
             {
@@ -3411,7 +3487,10 @@ void SmartScript::OnUpdate(uint32 const diff)
         isProcessingTimedActionList = false;
     }
     if (needCleanup)
+    {
         mTimedActionList.clear();
+        mTimedActionHolders.clear();
+    }
 
     if (!mRemIDs.empty())
     {
@@ -3435,9 +3514,9 @@ void SmartScript::OnUpdate(uint32 const diff)
     }
 }
 
-void SmartScript::FillScript(SmartAIEventList e, WorldObject* obj, AreaTriggerEntry const* at)
+void SmartScript::FillScript(SmartAIEventListPtr const& script, WorldObject* obj, AreaTriggerEntry const* at)
 {
-    if (e.empty())
+    if (!script || script->empty())
     {
         if (obj)
             TC_LOG_DEBUG("scripts.ai", "SmartScript: EventMap for Entry %u is empty but is using SmartScript.", obj->GetEntry());
@@ -3445,7 +3524,8 @@ void SmartScript::FillScript(SmartAIEventList e, WorldObject* obj, AreaTriggerEn
             TC_LOG_DEBUG("scripts.ai", "SmartScript: EventMap for AreaTrigger %u is empty but is using SmartScript.", at->id);
         return;
     }
-    for (SmartAIEventList::iterator i = e.begin(); i != e.end(); ++i)
+    mScript = script;
+    for (SmartAIEventList::const_iterator i = script->begin(); i != script->end(); ++i)
     {
         #ifndef TRINITY_DEBUG
             if ((*i).event.event_flags & SMART_EVENT_FLAG_DEBUG_ONLY)
@@ -3458,13 +3538,15 @@ void SmartScript::FillScript(SmartAIEventList e, WorldObject* obj, AreaTriggerEn
             {
                 if ((1 << (obj->GetMap()->GetSpawnMode()+1)) & (*i).event.event_flags)
                 {
-                    mEvents.push_back((*i));
+                    mEvents.push_back(SmartEventState(&*i));
                 }
             }
             continue;
         }
-        mEvents.push_back((*i));//NOTE: 'world(0)' events still get processed in ANY instance mode
+        mEvents.push_back(SmartEventState(&*i));//NOTE: 'world(0)' events still get processed in ANY instance mode
     }
+
+    BuildEventIndex();
     if (mEvents.empty() && obj)
         TC_LOG_ERROR("sql.sql", "SmartScript: Entry %u has events but no events added to list because of instance flags.", obj->GetEntry());
     if (mEvents.empty() && at)
@@ -3473,18 +3555,18 @@ void SmartScript::FillScript(SmartAIEventList e, WorldObject* obj, AreaTriggerEn
 
 void SmartScript::GetScript()
 {
-    SmartAIEventList e;
+    SmartAIEventListPtr e;
     if (me)
     {
         e = sSmartScriptMgr->GetScript(-((int32)me->GetDBTableGUIDLow()), mScriptType);
-        if (e.empty())
+        if (!e)
             e = sSmartScriptMgr->GetScript((int32)me->GetEntry(), mScriptType);
         FillScript(e, me, NULL);
     }
     else if (go)
     {
         e = sSmartScriptMgr->GetScript(-((int32)go->GetDBTableGUIDLow()), mScriptType);
-        if (e.empty())
+        if (!e)
             e = sSmartScriptMgr->GetScript((int32)go->GetEntry(), mScriptType);
         FillScript(e, go, NULL);
     }
@@ -3529,7 +3611,7 @@ void SmartScript::OnInitialize(WorldObject* obj, AreaTriggerEntry const* at)
 
     GetScript();//load copy of script
 
-    for (SmartAIEventList::iterator i = mEvents.begin(); i != mEvents.end(); ++i)
+    for (SmartEventStateList::iterator i = mEvents.begin(); i != mEvents.end(); ++i)
         InitTimer((*i));//calculate timers for first time use
 
     ProcessEventsFor(SMART_EVENT_AI_INIT);
@@ -3642,7 +3724,7 @@ Unit* SmartScript::DoFindClosestFriendlyInRange(float range, bool playerOnly)
     return unit;
 }
 
-void SmartScript::SetScript9(SmartScriptHolder& e, uint32 entry)
+void SmartScript::SetScript9(SmartScriptHolder const& e, uint32 entry)
 {
     //do NOT clear mTimedActionList if it's being iterated because it will invalidate the iterator and delete
     // any SmartScriptHolder contained like the "e" parameter passed to this function
@@ -3653,13 +3735,16 @@ void SmartScript::SetScript9(SmartScriptHolder& e, uint32 entry)
     }
 
     mTimedActionList.clear();
-    mTimedActionList = sSmartScriptMgr->GetScript(entry, SMART_SCRIPT_TYPE_TIMED_ACTIONLIST);
-    if (mTimedActionList.empty())
+    mTimedActionHolders.clear();
+    SmartAIEventListPtr actionList = sSmartScriptMgr->GetScript(entry, SMART_SCRIPT_TYPE_TIMED_ACTIONLIST);
+    if (!actionList)
         return;
-    for (SmartAIEventList::iterator i = mTimedActionList.begin(); i != mTimedActionList.end(); ++i)
-    {
-        i->enableTimed = i == mTimedActionList.begin();//enable processing only for the first action
 
+    // the event type is set by the caller, these are the only events that are copied
+    mTimedActionHolders = *actionList;
+    mTimedActionList.reserve(mTimedActionHolders.size());
+    for (SmartAIEventList::iterator i = mTimedActionHolders.begin(); i != mTimedActionHolders.end(); ++i)
+    {
         if (e.action.timedActionList.timerType == 0)
             i->event.type = SMART_EVENT_UPDATE_OOC;
         else if (e.action.timedActionList.timerType == 1)
@@ -3667,7 +3752,9 @@ void SmartScript::SetScript9(SmartScriptHolder& e, uint32 entry)
         else if (e.action.timedActionList.timerType > 1)
             i->event.type = SMART_EVENT_UPDATE;
 
-        InitTimer((*i));
+        mTimedActionList.push_back(SmartEventState(&*i));
+        mTimedActionList.back().enableTimed = i == mTimedActionHolders.begin();//enable processing only for the first action
+        InitTimer(mTimedActionList.back());
     }
 }
 
@@ -36,18 +36,20 @@ class SmartScript
 
         void OnInitialize(WorldObject* obj, AreaTriggerEntry const* at = NULL);
         void GetScript();
-        void FillScript(SmartAIEventList e, WorldObject* obj, AreaTriggerEntry const* at);
+        void FillScript(SmartAIEventListPtr const& script, WorldObject* obj, AreaTriggerEntry const* at);
 
         void ProcessEventsFor(SMART_EVENT e, Unit* unit = NULL, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, const SpellInfo* spell = NULL, GameObject* gob = NULL);
-        void ProcessEvent(SmartScriptHolder& e, Unit* unit = NULL, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, const SpellInfo* spell = NULL, GameObject* gob = NULL);
-        bool CheckTimer(SmartScriptHolder const& e) const;
-        void RecalcTimer(SmartScriptHolder& e, uint32 min, uint32 max);
-        void UpdateTimer(SmartScriptHolder& e, uint32 const diff);
-        void InitTimer(SmartScriptHolder& e);
-        void ProcessAction(SmartScriptHolder& e, Unit* unit = NULL, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, const SpellInfo* spell = NULL, GameObject* gob = NULL);
-        void ProcessTimedAction(SmartScriptHolder& e, uint32 const& min, uint32 const& max, Unit* unit = NULL, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, const SpellInfo* spell = NULL, GameObject* gob = NULL);
+        void ProcessEvent(SmartEventState& state, Unit* unit = NULL, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, const SpellInfo* spell = NULL, GameObject* gob = NULL);
+        bool CheckTimer(SmartEventState const& state) const;
+        void RecalcTimer(SmartEventState& state, uint32 min, uint32 max);
+        void UpdateTimer(SmartEventState& state, uint32 const diff);
+        void InitTimer(SmartEventState& state);
+        void ProcessAction(SmartEventState& state, Unit* unit = NULL, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, const SpellInfo* spell = NULL, GameObject* gob = NULL);
+        void ProcessTimedAction(SmartEventState& state, uint32 const& min, uint32 const& max, Unit* unit = NULL, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, const SpellInfo* spell = NULL, GameObject* gob = NULL);
+        // returned lists are owned by the script and must be given back with ReleaseTargetList
         ObjectList* GetTargets(SmartScriptHolder const& e, Unit* invoker = NULL);
         ObjectList* GetWorldObjectsInDist(float dist);
+        void ReleaseTargetList(ObjectList* targets);
         void InstallTemplate(SmartScriptHolder const& e);
         SmartScriptHolder CreateEvent(SMART_EVENT e, uint32 event_flags, uint32 event_param1, uint32 event_param2, uint32 event_param3, uint32 event_param4, SMART_ACTION action, uint32 action_param1, uint32 action_param2, uint32 action_param3, uint32 action_param4, uint32 action_param5, uint32 action_param6, SMARTAI_TARGETS t, uint32 target_param1, uint32 target_param2, uint32 target_param3, uint32 phaseMask = 0);
         void AddEvent(SMART_EVENT e, uint32 event_flags, uint32 event_param1, uint32 event_param2, uint32 event_param3, uint32 event_param4, SMART_ACTION action, uint32 action_param1, uint32 action_param2, uint32 action_param3, uint32 action_param4, uint32 action_param5, uint32 action_param6, SMARTAI_TARGETS t, uint32 target_param1, uint32 target_param2, uint32 target_param3, uint32 phaseMask = 0);
@@ -91,21 +93,22 @@ class SmartScript
         void DoFindFriendlyMissingBuff(std::list<Creature*>& list, float range, uint32 spellid);
         Unit* DoFindClosestFriendlyInRange(float range, bool playerOnly);
 
-        void StoreTargetList(ObjectList* targets, uint32 id)
+        void StoreTargetList(ObjectList const* targets, uint32 id)
         {
             if (!targets)
                 return;
 
-            if (mTargetStorage->find(id) != mTargetStorage->end())
-            {
-                // check if already stored
-                if ((*mTargetStorage)[id]->Equals(targets))
-                    return;
+            // copy before deleting the old entry, targets may be the list stored under the same id
+            ObjectGuidList* guidList = new ObjectGuidList(new ObjectList(*targets), GetBaseObject());
 
-                delete (*mTargetStorage)[id];
+            ObjectListMap::iterator itr = mTargetStorage->find(id);
+            if (itr != mTargetStorage->end())
+            {
+                delete itr->second;
+                itr->second = guidList;
             }
-
-            (*mTargetStorage)[id] = new ObjectGuidList(targets, GetBaseObject());
+            else
+                (*mTargetStorage)[id] = guidList;
         }
 
         bool IsSmart(Creature* c = NULL)
@@ -232,7 +235,7 @@ class SmartScript
         }
 
         //TIMED_ACTIONLIST (script type 9 aka script9)
-        void SetScript9(SmartScriptHolder& e, uint32 entry);
+        void SetScript9(SmartScriptHolder const& e, uint32 entry);
         Unit* GetLastInvoker();
         ObjectGuid mLastInvoker;
         typedef std::unordered_map<uint32, uint32> CounterMap;
@@ -258,10 +261,20 @@ class SmartScript
         bool IsInPhase(uint32 p) const { return ((1 << (mEventPhase - 1)) & p) != 0; }
         void SetPhase(uint32 p = 0) { mEventPhase = p; }
 
-        SmartAIEventList mEvents;
+        void BuildEventIndex();
+        SmartEventState* FindLinkedEvent(uint32 link);
+        ObjectList* AcquireTargetList();
+
+        SmartAIEventListPtr mScript;                        // shared events the states in mEvents point to
+        std::list<SmartScriptHolder> mOwnedEvents;          // events created by this object (templates, timed events)
+        SmartEventStateList mEvents;
+        // (event type, index in mEvents) ordered by type, ProcessEventsFor only visits the events of its type
+        std::vector<std::pair<uint32, uint32> > mEventIndex;
         SmartAIEventList mInstallEvents;
-        SmartAIEventList mTimedActionList;
+        SmartAIEventList mTimedActionHolders;               // copies, their event type depends on the action that started the list
+        SmartEventStateList mTimedActionList;
         bool isProcessingTimedActionList;
+        std::vector<ObjectList*> mFreeTargetLists;
         Creature* me;
         ObjectGuid meOrigGUID;
         GameObject* go;
@@ -271,7 +284,7 @@ class SmartScript
         uint32 mEventPhase;
 
         uint32 mPathId;
-        SmartAIEventList mStoredEvents;
+        std::deque<SmartEventState> mStoredEvents;          // stays valid while a stored event creates another one
         std::list<uint32>mRemIDs;
 
         uint32 mTextTimer;
@@ -286,11 +299,13 @@ class SmartScript
         {
             if (!mStoredEvents.empty())
             {
-                for (SmartAIEventList::iterator i = mStoredEvents.begin(); i != mStoredEvents.end(); ++i)
+                for (std::deque<SmartEventState>::iterator i = mStoredEvents.begin(); i != mStoredEvents.end(); ++i)
                 {
-                    if (i->event_id == id)
+                    if (i->holder->event_id == id)
                     {
+                        SmartScriptHolder const* holder = i->holder;
                         mStoredEvents.erase(i);
+                        mOwnedEvents.remove_if([holder](SmartScriptHolder const& owned) { return &owned == holder; });
                         return;
                     }
                 }
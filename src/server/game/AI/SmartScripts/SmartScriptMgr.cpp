@@ -245,14 +245,14 @@ void SmartAIMgr::LoadSmartAIFromDB()
             continue;
 
         // creature entry / guid not found in storage, create empty event list for it and increase counters
-        if (mEventMap[source_type].find(temp.entryOrGuid) == mEventMap[source_type].end())
+        std::shared_ptr<SmartAIEventList>& eventList = mEventMap[source_type][temp.entryOrGuid];
+        if (!eventList)
         {
             ++count;
-            SmartAIEventList eventList;
-            mEventMap[source_type][temp.entryOrGuid] = eventList;
+            eventList = std::make_shared<SmartAIEventList>();
         }
         // store the new event
-        mEventMap[source_type][temp.entryOrGuid].push_back(temp);
+        eventList->push_back(temp);
     }
     while (result->NextRow());
 
@@ -261,11 +261,11 @@ void SmartAIMgr::LoadSmartAIFromDB()
     {
         for (SmartAIEventMap::iterator itr = mEventMap[i].begin(); itr != mEventMap[i].end(); ++itr)
         {
-            for (SmartScriptHolder const& e : itr->second)
+            for (SmartScriptHolder const& e : *itr->second)
             {
                 if (e.link)
                 {
-                    if (!FindLinkedEvent(itr->second, e.link))
+                    if (!FindLinkedEvent(*itr->second, e.link))
                     {
                         TC_LOG_ERROR("sql.sql", "SmartAIMgr::LoadSmartAIFromDB: Entry %d SourceType %u, Event %u, Link Event %u not found or invalid.",
                             e.entryOrGuid, e.GetScriptType(), e.event_id, e.link);
@@ -274,7 +274,7 @@ void SmartAIMgr::LoadSmartAIFromDB()
 
                 if (e.GetEventType() == SMART_EVENT_LINK)
                 {
-                    if (!FindLinkedSourceEvent(itr->second, e.event_id))
+                    if (!FindLinkedSourceEvent(*itr->second, e.event_id))
                     {
                         TC_LOG_ERROR("sql.sql", "SmartAIMgr::LoadSmartAIFromDB: Entry %d SourceType %u, Event %u, Link Source Event not found or invalid. Event will never trigger.",
                             e.entryOrGuid, e.GetScriptType(), e.event_id);
@@ -1348,12 +1348,11 @@ enum SmartCastFlags
     SMARTCAST_COMBAT_MOVE            = 0x40                      //Prevents combat movement if cast successful. Allows movement on range, OOM, LOS
 };
 
-// one line in DB is one event
+// one line in DB is one event, loaded scripts are shared by every object running them
 struct SmartScriptHolder
 {
     SmartScriptHolder() : entryOrGuid(0), source_type(SMART_SCRIPT_TYPE_CREATURE)
-        , event_id(0), link(0), event(), action(), target(), timer(0), active(false), runOnce(false)
-        , enableTimed(false) { }
+        , event_id(0), link(0), event(), action(), target() { }
 
     int32 entryOrGuid;
     SmartScriptType source_type;
@@ -1369,17 +1368,24 @@ struct SmartScriptHolder
     uint32 GetActionType() const { return (uint32)action.type; }
     uint32 GetTargetType() const { return (uint32)target.type; }
 
+    operator bool() const { return entryOrGuid != 0; }
+};
+
+// per object state of an event, the only part of a script that is not shared
+struct SmartEventState
+{
+    explicit SmartEventState(SmartScriptHolder const* holder) : holder(holder), timer(0), active(false), runOnce(false), enableTimed(false) { }
+
+    SmartScriptHolder const* holder;
     uint32 timer;
     bool active;
     bool runOnce;
     bool enableTimed;
-
-    operator bool() const { return entryOrGuid != 0; }
 };
 
 typedef std::unordered_map<uint32, WayPoint*> WPPath;
 
-typedef std::list<WorldObject*> ObjectList;
+typedef std::vector<WorldObject*> ObjectList;
 
 class ObjectGuidList
 {
@@ -1420,11 +1426,6 @@ public:
         return m_objectList;
     }
 
-    bool Equals(ObjectList* objectList)
-    {
-        return m_objectList == objectList;
-    }
-
     ~ObjectGuidList()
     {
         delete m_objectList;
@@ -1461,9 +1462,13 @@ class SmartWaypointMgr
 
 // all events for a single entry
 typedef std::vector<SmartScriptHolder> SmartAIEventList;
+typedef std::shared_ptr<SmartAIEventList const> SmartAIEventListPtr;   // kept alive by the scripts using it across reloads
+
+// per object event states
+typedef std::vector<SmartEventState> SmartEventStateList;
 
 // all events for all entries / guids
-typedef std::unordered_map<int32, SmartAIEventList> SmartAIEventMap;
+typedef std::unordered_map<int32, std::shared_ptr<SmartAIEventList> > SmartAIEventMap;
 
 // Helper Stores
 typedef std::map<uint32 /*entry*/, std::pair<uint32 /*spellId*/, SpellEffIndex /*effIndex*/> > CacheSpellContainer;
@@ -1484,17 +1489,15 @@ class SmartAIMgr
 
         void LoadSmartAIFromDB();
 
-        SmartAIEventList GetScript(int32 entry, SmartScriptType type)
+        SmartAIEventListPtr GetScript(int32 entry, SmartScriptType type) const
         {
-            SmartAIEventList temp;
-            if (mEventMap[uint32(type)].find(entry) != mEventMap[uint32(type)].end())
-                return mEventMap[uint32(type)][entry];
-            else
-            {
-                if (entry > 0)//first search is for guid (negative), do not drop error if not found
-                    TC_LOG_DEBUG("scripts.ai", "SmartAIMgr::GetScript: Could not load Script for Entry %d ScriptType %u.", entry, uint32(type));
-                return temp;
-            }
+            SmartAIEventMap::const_iterator itr = mEventMap[uint32(type)].find(entry);
+            if (itr != mEventMap[uint32(type)].end())
+                return itr->second;
+
+            if (entry > 0)//first search is for guid (negative), do not drop error if not found
+                TC_LOG_DEBUG("scripts.ai", "SmartAIMgr::GetScript: Could not load Script for Entry %d ScriptType %u.", entry, uint32(type));
+            return SmartAIEventListPtr();
         }
 
         static SmartScriptHolder& FindLinkedSourceEvent(SmartAIEventList& list, uint32 eventId)
@@ -703,6 +703,26 @@ enum RBACPermissions
     RBAC_PERM_COMMAND_INSTANCE_GET_BOSS_STATE                = 796,
     RBAC_PERM_COMMAND_PVPSTATS                               = 797,
     RBAC_PERM_COMMAND_MODIFY_XP                              = 798,
+    RBAC_PERM_COMMAND_DEBUG_MAPUPDATER                       = 799,
+    RBAC_PERM_COMMAND_DEBUG_NETLATENCY                       = 800,
+    RBAC_PERM_COMMAND_DEBUG_COMPRESSION                      = 801,
+    RBAC_PERM_COMMAND_DEBUG_UPDATECACHE                      = 802,
+    RBAC_PERM_COMMAND_DEBUG_AUCTIONSEARCH                    = 803,
+    RBAC_PERM_COMMAND_DEBUG_MOVEMENTCODECS                   = 804,
+    RBAC_PERM_COMMAND_DEBUG_DBQUEUES                         = 805,
+    RBAC_PERM_COMMAND_DEBUG_PLAYERSAVE                       = 806,
+    RBAC_PERM_COMMAND_DEBUG_LOGBENCH                         = 807,
+    RBAC_PERM_COMMAND_DEBUG_VMAPBENCH                        = 808,
+    RBAC_PERM_COMMAND_DEBUG_COLLISIONCACHE                   = 809,
+    RBAC_PERM_COMMAND_DEBUG_ACHIEVEMENTSTATS                 = 810,
+    RBAC_PERM_COMMAND_DEBUG_OBJECTUPDATES                    = 811,
+    RBAC_PERM_COMMAND_DEBUG_GRIDPRELOAD                      = 812,
+    RBAC_PERM_COMMAND_DEBUG_TERRAINBENCH                     = 813,
+    RBAC_PERM_COMMAND_DEBUG_AURAMODBENCH                     = 814,
+    RBAC_PERM_COMMAND_DEBUG_SPELLALLOCBENCH                  = 815,
+    RBAC_PERM_COMMAND_DEBUG_REGIONBENCH                      = 816,
+    RBAC_PERM_COMMAND_DEBUG_LFGBENCH                         = 817,
+    RBAC_PERM_COMMAND_DEBUG_BROADCASTBENCH                   = 818,
 
     // custom permissions 1000+
     RBAC_PERM_MAX
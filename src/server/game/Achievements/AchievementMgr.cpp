@@ -474,7 +474,7 @@ void AchievementMgr<T>::ResetAchievementCriteria(AchievementCriteriaTypes type,
     if (GetOwner()->IsGameMaster())
         return;
 
-    AchievementCriteriaEntryList const& achievementCriteriaList = sAchievementMgr->GetAchievementCriteriaByType(type);
+    AchievementCriteriaEntryList const& achievementCriteriaList = sAchievementMgr->GetAchievementCriteriaForReset(type, miscValue1);
     for (AchievementCriteriaEntryList::const_iterator i = achievementCriteriaList.begin(); i != achievementCriteriaList.end(); ++i)
     {
         AchievementCriteriaEntry const* achievementCriteria = (*i);
@@ -1147,7 +1147,10 @@ void AchievementMgr<T>::UpdateAchievementCriteria(AchievementCriteriaTypes type,
     if (IsGuild<T>() && !sWorld->getBoolConfig(CONFIG_GUILD_LEVELING_ENABLED))
         return;
 
-    AchievementCriteriaEntryList const& achievementCriteriaList = sAchievementMgr->GetAchievementCriteriaByType(type, IsGuild<T>());
+    AchievementCriteriaEntryList const& achievementCriteriaList = sAchievementMgr->GetAchievementCriteriaForEvent(type, miscValue1, IsGuild<T>());
+    sAchievementMgr->AddCriteriaVisits(type, achievementCriteriaList.size(),
+        sAchievementMgr->GetAchievementCriteriaByType(type, IsGuild<T>()).size() - achievementCriteriaList.size());
+
     for (AchievementCriteriaEntryList::const_iterator i = achievementCriteriaList.begin(); i != achievementCriteriaList.end(); ++i)
     {
         AchievementCriteriaEntry const* achievementCriteria = (*i);
@@ -3133,6 +3136,54 @@ char const* AchievementGlobalMgr::GetCriteriaTypeString(AchievementCriteriaTypes
 template class AchievementMgr<Guild>;
 template class AchievementMgr<Player>;
 
+// How the asset of a criteria (first requirement field) relates to miscValue1 of UpdateAchievementCriteria
+enum CriteriaAssetMatch
+{
+    CRITERIA_ASSET_NONE,                                    // not compared, every criteria of the type is visited
+    CRITERIA_ASSET_REQUIRED,                                // must be equal to miscValue1
+    CRITERIA_ASSET_OPTIONAL                                 // must be equal to miscValue1 unless miscValue1 is 0
+};
+
+static CriteriaAssetMatch GetCriteriaAssetMatch(AchievementCriteriaTypes type)
+{
+    switch (type)
+    {
+        case ACHIEVEMENT_CRITERIA_TYPE_KILL_CREATURE:
+        case ACHIEVEMENT_CRITERIA_TYPE_KILLED_BY_CREATURE:
+        case ACHIEVEMENT_CRITERIA_TYPE_BE_SPELL_TARGET:
+        case ACHIEVEMENT_CRITERIA_TYPE_BE_SPELL_TARGET2:
+        case ACHIEVEMENT_CRITERIA_TYPE_CAST_SPELL:
+        case ACHIEVEMENT_CRITERIA_TYPE_CAST_SPELL2:
+        case ACHIEVEMENT_CRITERIA_TYPE_USE_ITEM:
+        case ACHIEVEMENT_CRITERIA_TYPE_LOOT_ITEM:
+        case ACHIEVEMENT_CRITERIA_TYPE_DO_EMOTE:
+        case ACHIEVEMENT_CRITERIA_TYPE_EQUIP_ITEM:
+        case ACHIEVEMENT_CRITERIA_TYPE_USE_GAMEOBJECT:
+        case ACHIEVEMENT_CRITERIA_TYPE_FISH_IN_GAMEOBJECT:
+        case ACHIEVEMENT_CRITERIA_TYPE_HK_CLASS:
+        case ACHIEVEMENT_CRITERIA_TYPE_HK_RACE:
+        case ACHIEVEMENT_CRITERIA_TYPE_BG_OBJECTIVE_CAPTURE:
+        case ACHIEVEMENT_CRITERIA_TYPE_HONORABLE_KILL_AT_AREA:
+        case ACHIEVEMENT_CRITERIA_TYPE_CURRENCY:
+        case ACHIEVEMENT_CRITERIA_TYPE_WIN_ARENA:
+            return CRITERIA_ASSET_REQUIRED;
+        case ACHIEVEMENT_CRITERIA_TYPE_REACH_SKILL_LEVEL:
+        case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SKILL_LEVEL:
+        case ACHIEVEMENT_CRITERIA_TYPE_COMPLETE_QUESTS_IN_ZONE:
+        case ACHIEVEMENT_CRITERIA_TYPE_COMPLETE_QUEST:
+        case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SPELL:
+        case ACHIEVEMENT_CRITERIA_TYPE_OWN_ITEM:
+        case ACHIEVEMENT_CRITERIA_TYPE_GAIN_REPUTATION:
+        case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SKILLLINE_SPELLS:
+        case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SKILL_LINE:
+            return CRITERIA_ASSET_OPTIONAL;
+        default:
+            return CRITERIA_ASSET_NONE;
+    }
+}
+
+static AchievementCriteriaEntryList const EmptyCriteriaList;
+
 //==========================================================
 void AchievementGlobalMgr::LoadAchievementCriteriaList()
 {
@@ -3156,11 +3207,29 @@ void AchievementGlobalMgr::LoadAchievementCriteriaList()
 
         m_AchievementCriteriaListByAchievement[criteria->achievement].push_back(criteria);
 
-        if (achievement && achievement->flags & ACHIEVEMENT_FLAG_GUILD)
+        bool guild = achievement && achievement->flags & ACHIEVEMENT_FLAG_GUILD;
+        if (guild)
             ++guildCriterias, m_GuildAchievementCriteriasByType[criteria->type].push_back(criteria);
         else
             ++criterias, m_AchievementCriteriasByType[criteria->type].push_back(criteria);
 
+        if (GetCriteriaAssetMatch(AchievementCriteriaTypes(criteria->type)) != CRITERIA_ASSET_NONE)
+            (guild ? m_GuildAchievementCriteriasByAsset : m_AchievementCriteriasByAsset)[criteria->type][criteria->raw.field3].push_back(criteria);
+
+        if (!guild)
+        {
+            for (uint8 j = 0; j < MAX_CRITERIA_REQUIREMENTS; ++j)
+            {
+                uint32 requirementType = criteria->additionalRequirements[j].additionalRequirement_type;
+                if (!requirementType)
+                    continue;
+
+                AchievementCriteriaEntryList& list = m_AchievementCriteriasByRequirement[criteria->type][requirementType];
+                if (list.empty() || list.back() != criteria)
+                    list.push_back(criteria);
+            }
+        }
+
         if (criteria->timeLimit)
             m_AchievementCriteriasByTimedType[criteria->timedCriteriaStartType].push_back(criteria);
     }
@@ -3168,6 +3237,44 @@ void AchievementGlobalMgr::LoadAchievementCriteriaList()
     TC_LOG_INFO("server.loading", ">> Loaded %u achievement criteria and %u guild achievement crieteria in %u ms", criterias, guildCriterias, GetMSTimeDiffToNow(oldMSTime));
 }
 
+AchievementCriteriaEntryList const& AchievementGlobalMgr::GetAchievementCriteriaForEvent(AchievementCriteriaTypes type, uint64 miscValue1, bool guild /*= false*/) const
+{
+    switch (GetCriteriaAssetMatch(type))
+    {
+        case CRITERIA_ASSET_OPTIONAL:
+            // 0 updates all criteria of the type (login, skill or reputation refresh)
+            if (!miscValue1)
+                break;
+            // no break
+        case CRITERIA_ASSET_REQUIRED:
+        {
+            if (miscValue1 > std::numeric_limits<uint32>::max())
+                return EmptyCriteriaList;
+
+            AchievementCriteriaListByAsset const& criteriaByAsset = guild ? m_GuildAchievementCriteriasByAsset[type] : m_AchievementCriteriasByAsset[type];
+            AchievementCriteriaListByAsset::const_iterator itr = criteriaByAsset.find(uint32(miscValue1));
+            return itr != criteriaByAsset.end() ? itr->second : EmptyCriteriaList;
+        }
+        default:
+            break;
+    }
+
+    return GetAchievementCriteriaByType(type, guild);
+}
+
+AchievementCriteriaEntryList const& AchievementGlobalMgr::GetAchievementCriteriaForReset(AchievementCriteriaTypes type, uint64 miscValue1) const
+{
+    // 0 matches every criteria with a free requirement slot, keep walking all of them
+    if (!miscValue1)
+        return GetAchievementCriteriaByType(type);
+
+    if (miscValue1 > std::numeric_limits<uint32>::max())
+        return EmptyCriteriaList;
+
+    AchievementCriteriaListByAsset::const_iterator itr = m_AchievementCriteriasByRequirement[type].find(uint32(miscValue1));
+    return itr != m_AchievementCriteriasByRequirement[type].end() ? itr->second : EmptyCriteriaList;
+}
+
 void AchievementGlobalMgr::LoadAchievementReferenceList()
 {
     uint32 oldMSTime = getMSTime();
@@ -19,6 +19,7 @@
 #ifndef __TRINITY_ACHIEVEMENTMGR_H
 #define __TRINITY_ACHIEVEMENTMGR_H
 
+#include <atomic>
 #include <map>
 #include <string>
 
@@ -26,6 +27,7 @@
 #include "DatabaseEnv.h"
 #include "DBCEnums.h"
 #include "DBCStores.h"
+#include "FlatHashMap.h"
 #include "ObjectGuid.h"
 
 class Unit;
@@ -37,6 +39,7 @@ typedef std::vector<AchievementEntry const*>         AchievementEntryList;
 
 typedef std::unordered_map<uint32, AchievementCriteriaEntryList> AchievementCriteriaListByAchievement;
 typedef std::unordered_map<uint32, AchievementEntryList>         AchievementListByReferencedId;
+typedef std::unordered_map<uint32, AchievementCriteriaEntryList> AchievementCriteriaListByAsset;
 
 struct CriteriaProgress
 {
@@ -238,7 +241,7 @@ struct CompletedAchievementData
     bool changed;
 };
 
-typedef std::unordered_map<uint32, CriteriaProgress> CriteriaProgressMap;
+typedef FlatHashMap<CriteriaProgress> CriteriaProgressMap;
 typedef std::unordered_map<uint32, CompletedAchievementData> CompletedAchievementMap;
 
 enum ProgressType
@@ -300,10 +303,17 @@ class AchievementMgr
 
 class AchievementGlobalMgr
 {
-        AchievementGlobalMgr() { }
+        AchievementGlobalMgr() { ResetCriteriaStats(); }
         ~AchievementGlobalMgr() { }
 
     public:
+        struct CriteriaStats
+        {
+            uint64 Events;      // calls of UpdateAchievementCriteria that looked at criteria
+            uint64 Visited;     // criteria checked by those calls
+            uint64 Skipped;     // criteria of the same type left out by the asset index
+        };
+
         static char const* GetCriteriaTypeString(AchievementCriteriaTypes type);
         static char const* GetCriteriaTypeString(uint32 type);
 
@@ -318,6 +328,38 @@ class AchievementGlobalMgr
             return guild ? m_GuildAchievementCriteriasByType[type] : m_AchievementCriteriasByType[type];
         }
 
+        // criteria of the type that can match miscValue1, criteria requiring a different creature, spell, item... are left out
+        AchievementCriteriaEntryList const& GetAchievementCriteriaForEvent(AchievementCriteriaTypes type, uint64 miscValue1, bool guild = false) const;
+
+        // criteria of the type having an additional requirement of type miscValue1
+        AchievementCriteriaEntryList const& GetAchievementCriteriaForReset(AchievementCriteriaTypes type, uint64 miscValue1) const;
+
+        void AddCriteriaVisits(AchievementCriteriaTypes type, size_t visited, size_t skipped)
+        {
+            _criteriaStats[type].Events.fetch_add(1, std::memory_order_relaxed);
+            _criteriaStats[type].Visited.fetch_add(visited, std::memory_order_relaxed);
+            _criteriaStats[type].Skipped.fetch_add(skipped, std::memory_order_relaxed);
+        }
+
+        CriteriaStats GetCriteriaStats(AchievementCriteriaTypes type) const
+        {
+            CriteriaStats stats;
+            stats.Events = _criteriaStats[type].Events.load(std::memory_order_relaxed);
+            stats.Visited = _criteriaStats[type].Visited.load(std::memory_order_relaxed);
+            stats.Skipped = _criteriaStats[type].Skipped.load(std::memory_order_relaxed);
+            return stats;
+        }
+
+        void ResetCriteriaStats()
+        {
+            for (uint32 i = 0; i < ACHIEVEMENT_CRITERIA_TYPE_TOTAL; ++i)
+            {
+                _criteriaStats[i].Events.store(0, std::memory_order_relaxed);
+                _criteriaStats[i].Visited.store(0, std::memory_order_relaxed);
+                _criteriaStats[i].Skipped.store(0, std::memory_order_relaxed);
+            }
+        }
+
         AchievementCriteriaEntryList const& GetTimedAchievementCriteriaByType(AchievementCriteriaTimedTypes type) const
         {
             return m_AchievementCriteriasByTimedType[type];
@@ -409,6 +451,13 @@ class AchievementGlobalMgr
         AchievementCriteriaEntryList m_AchievementCriteriasByType[ACHIEVEMENT_CRITERIA_TYPE_TOTAL];
         AchievementCriteriaEntryList m_GuildAchievementCriteriasByType[ACHIEVEMENT_CRITERIA_TYPE_TOTAL];
 
+        // same criteria keyed by their main requirement, for the types where it must match miscValue1
+        AchievementCriteriaListByAsset m_AchievementCriteriasByAsset[ACHIEVEMENT_CRITERIA_TYPE_TOTAL];
+        AchievementCriteriaListByAsset m_GuildAchievementCriteriasByAsset[ACHIEVEMENT_CRITERIA_TYPE_TOTAL];
+
+        // criteria keyed by the types of their additional requirements, used to reset them
+        AchievementCriteriaListByAsset m_AchievementCriteriasByRequirement[ACHIEVEMENT_CRITERIA_TYPE_TOTAL];
+
         AchievementCriteriaEntryList m_AchievementCriteriasByTimedType[ACHIEVEMENT_TIMED_TYPE_MAX];
 
         // store achievement criterias by achievement to speed up lookup
@@ -422,6 +471,15 @@ class AchievementGlobalMgr
 
         AchievementRewards m_achievementRewards;
         AchievementRewardLocales m_achievementRewardLocales;
+
+        struct AtomicCriteriaStats
+        {
+            std::atomic<uint64> Events;
+            std::atomic<uint64> Visited;
+            std::atomic<uint64> Skipped;
+        };
+
+        AtomicCriteriaStats _criteriaStats[ACHIEVEMENT_CRITERIA_TYPE_TOTAL];
 };
 
 #define sAchievementMgr AchievementGlobalMgr::instance()
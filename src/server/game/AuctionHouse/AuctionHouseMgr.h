@@ -22,6 +22,7 @@
 #include "Common.h"
 #include "DatabaseEnv.h"
 #include "DBCStructure.h"
+#include "AuctionHouseSearchIndex.h"
 
 class Item;
 class Player;
@@ -130,6 +131,7 @@ class AuctionHouseObject
 
   private:
     AuctionEntryMap AuctionsMap;
+    AuctionHouseSearchIndex _searchIndex;
 };
 
 class AuctionHouseMgr
@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2008-2015 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AuctionHouseSearchIndex.h"
+#include "AuctionHouseMgr.h"
+#include "DBCStores.h"
+#include "ObjectMgr.h"
+#include "Util.h"
+
+AuctionHouseSearchIndex::AuctionHouseSearchIndex() { }
+
+AuctionHouseSearchIndex::~AuctionHouseSearchIndex() { }
+
+bool AuctionHouseSearchIndex::BuildSearchName(ItemTemplate const* proto, int32 randomPropertyId, int locIdx, int locdbcIdx, std::wstring& wname)
+{
+    std::string name = proto->Name1;
+    if (name.empty())
+        return false;
+
+    // local name
+    if (locIdx >= 0)
+        if (ItemLocale const* il = sObjectMgr->GetItemLocale(proto->ItemId))
+            ObjectMgr::GetLocaleString(il->Name, locIdx, name);
+
+    // DO NOT use GetItemEnchantMod(proto->RandomProperty) as it may return a result
+    //  that matches the search but it may not equal item->GetItemRandomPropertyId()
+    //  used in BuildAuctionInfo() which then causes wrong items to be listed
+    if (randomPropertyId)
+    {
+        // Append the suffix to the name (ie: of the Monkey) if one exists
+        // These are found in ItemRandomSuffix.dbc and ItemRandomProperties.dbc
+        //  even though the DBC names seem misleading
+
+        char* suffix = nullptr;
+
+        if (randomPropertyId < 0)
+        {
+            const ItemRandomSuffixEntry* itemRandSuffix = sItemRandomSuffixStore.LookupEntry(-randomPropertyId);
+            if (itemRandSuffix)
+                suffix = itemRandSuffix->nameSuffix;
+        }
+        else
+        {
+            const ItemRandomPropertiesEntry* itemRandProp = sItemRandomPropertiesStore.LookupEntry(randomPropertyId);
+            if (itemRandProp)
+                suffix = itemRandProp->nameSuffix;
+        }
+
+        // dbc local name
+        if (suffix)
+        {
+            // Append the suffix (ie: of the Monkey) to the name using localization
+            // or default enUS if localization is invalid
+            name += ' ';
+            name += suffix[locdbcIdx >= 0 ? locdbcIdx : LOCALE_enUS];
+        }
+    }
+
+    if (!Utf8toWStr(name, wname))
+        return false;
+
+    wstrToLower(wname);
+    return true;
+}
+
+uint64 AuctionHouseSearchIndex::MakeTrigramKey(std::wstring const& str, size_t pos)
+{
+    // 21 bits cover every unicode code point, colliding keys only make the candidate list longer
+    return (uint64(uint32(str[pos]) & 0x1FFFFF) << 42) | (uint64(uint32(str[pos + 1]) & 0x1FFFFF) << 21) | uint64(uint32(str[pos + 2]) & 0x1FFFFF);
+}
+
+void AuctionHouseSearchIndex::InsertId(AuctionIdList& list, uint32 auctionId)
+{
+    // auction ids are handed out incrementally, appending is the common case
+    if (list.empty() || list.back() < auctionId)
+    {
+        list.push_back(auctionId);
+        return;
+    }
+
+    AuctionIdList::iterator itr = std::lower_bound(list.begin(), list.end(), auctionId);
+    if (itr == list.end() || *itr != auctionId)
+        list.insert(itr, auctionId);
+}
+
+static void EraseFromList(std::vector<uint32>& list, uint32 auctionId)
+{
+    std::vector<uint32>::iterator itr = std::lower_bound(list.begin(), list.end(), auctionId);
+    if (itr != list.end() && *itr == auctionId)
+        list.erase(itr);
+}
+
+template<class ListMap>
+void AuctionHouseSearchIndex::EraseId(ListMap& lists, typename ListMap::key_type key, uint32 auctionId)
+{
+    typename ListMap::iterator itr = lists.find(key);
+    if (itr == lists.end())
+        return;
+
+    EraseFromList(itr->second, auctionId);
+    if (itr->second.empty())
+        lists.erase(itr);
+}
+
+void AuctionHouseSearchIndex::AddAuction(AuctionEntry* auction, ItemTemplate const* proto, int32 randomPropertyId)
+{
+    ASSERT(auction && proto);
+
+    if (_auctions.count(auction->Id))
+        RemoveAuction(auction->Id);
+
+    IndexedAuction& indexed = _auctions[auction->Id];
+    indexed.Auction = auction;
+    indexed.Proto = proto;
+    indexed.RandomPropertyId = randomPropertyId;
+    indexed.ItemClass = proto->Class;
+    indexed.ItemSubClass = proto->SubClass;
+    indexed.InventoryType = proto->InventoryType;
+    indexed.Quality = proto->Quality;
+    indexed.RequiredLevel = proto->RequiredLevel;
+
+    InsertId(_allAuctions, auction->Id);
+    InsertId(_byClass[indexed.ItemClass], auction->Id);
+    InsertId(_bySubClass[MakeSubClassKey(indexed.ItemClass, indexed.ItemSubClass)], auction->Id);
+    InsertId(_byInventoryType[indexed.InventoryType], auction->Id);
+    InsertId(_byQuality[indexed.Quality], auction->Id);
+
+    for (uint8 dbLocale = 0; dbLocale < TOTAL_LOCALES; ++dbLocale)
+        for (uint8 dbcLocale = 0; dbcLocale < TOTAL_LOCALES; ++dbcLocale)
+            if (NameIndex* nameIndex = _nameIndexes[dbLocale][dbcLocale].get())
+                AddToNameIndex(*nameIndex, indexed, LocaleConstant(dbLocale), LocaleConstant(dbcLocale));
+}
+
+void AuctionHouseSearchIndex::RemoveAuction(uint32 auctionId)
+{
+    std::unordered_map<uint32, IndexedAuction>::iterator itr = _auctions.find(auctionId);
+    if (itr == _auctions.end())
+        return;
+
+    IndexedAuction const& indexed = itr->second;
+
+    EraseFromList(_allAuctions, auctionId);
+    EraseId(_byClass, indexed.ItemClass, auctionId);
+    EraseId(_bySubClass, MakeSubClassKey(indexed.ItemClass, indexed.ItemSubClass), auctionId);
+    EraseId(_byInventoryType, indexed.InventoryType, auctionId);
+    EraseId(_byQuality, indexed.Quality, auctionId);
+
+    for (uint8 dbLocale = 0; dbLocale < TOTAL_LOCALES; ++dbLocale)
+        for (uint8 dbcLocale = 0; dbcLocale < TOTAL_LOCALES; ++dbcLocale)
+            if (NameIndex* nameIndex = _nameIndexes[dbLocale][dbcLocale].get())
+                RemoveFromNameIndex(*nameIndex, auctionId);
+
+    _auctions.erase(itr);
+}
+
+AuctionHouseSearchIndex::NameIndex& AuctionHouseSearchIndex::GetNameIndex(LocaleConstant dbLocale, LocaleConstant dbcLocale)
+{
+    std::unique_ptr<NameIndex>& nameIndex = _nameIndexes[dbLocale][dbcLocale];
+    if (!nameIndex)
+    {
+        nameIndex = Trinity::make_unique<NameIndex>();
+        for (AuctionIdList::const_iterator itr = _allAuctions.begin(); itr != _allAuctions.end(); ++itr)
+            AddToNameIndex(*nameIndex, _auctions[*itr], dbLocale, dbcLocale);
+    }
+
+    return *nameIndex;
+}
+
+void AuctionHouseSearchIndex::AddToNameIndex(NameIndex& index, IndexedAuction const& auction, LocaleConstant dbLocale, LocaleConstant dbcLocale)
+{
+    std::wstring wname;
+    if (!BuildSearchName(auction.Proto, auction.RandomPropertyId, dbLocale, dbcLocale, wname))
+        return;
+
+    uint32 auctionId = auction.Auction->Id;
+    if (wname.length() >= 3)
+    {
+        std::vector<uint64> trigrams;
+        trigrams.reserve(wname.length() - 2);
+        for (size_t i = 0; i + 2 < wname.length(); ++i)
+            trigrams.push_back(MakeTrigramKey(wname, i));
+
+        std::sort(trigrams.begin(), trigrams.end());
+        trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+        for (std::vector<uint64>::const_iterator itr = trigrams.begin(); itr != trigrams.end(); ++itr)
+            InsertId(index.Trigrams[*itr], auctionId);
+    }
+
+    index.Names[auctionId].swap(wname);
+}
+
+void AuctionHouseSearchIndex::RemoveFromNameIndex(NameIndex& index, uint32 auctionId)
+{
+    std::unordered_map<uint32, std::wstring>::iterator itr = index.Names.find(auctionId);
+    if (itr == index.Names.end())
+        return;
+
+    std::wstring const& wname = itr->second;
+    for (size_t i = 0; i + 2 < wname.length(); ++i)
+        EraseId(index.Trigrams, MakeTrigramKey(wname, i), auctionId);
+
+    index.Names.erase(itr);
+}
+
+bool AuctionHouseSearchIndex::MatchesTemplate(IndexedAuction const& auction, AuctionSearchFilters const& filters) const
+{
+    if (filters.ItemClass != 0xffffffff && auction.ItemClass != filters.ItemClass)
+        return false;
+
+    if (filters.ItemSubClass != 0xffffffff && auction.ItemSubClass != filters.ItemSubClass)
+        return false;
+
+    if (filters.InventoryType != 0xffffffff && auction.InventoryType != filters.InventoryType)
+        return false;
+
+    if (filters.Quality != 0xffffffff && auction.Quality != filters.Quality)
+        return false;
+
+    if (filters.LevelMin != 0x00 && (auction.RequiredLevel < filters.LevelMin || (filters.LevelMax != 0x00 && auction.RequiredLevel > filters.LevelMax)))
+        return false;
+
+    return true;
+}
+
+void AuctionHouseSearchIndex::Search(AuctionSearchFilters const& filters, std::vector<AuctionEntry*>& result)
+{
+    static AuctionIdList const emptyList;
+
+    // pick the shortest list every match has to be part of, everything else is checked per auction
+    AuctionIdList const* candidates = &_allAuctions;
+    auto narrow = [&candidates](AuctionIdListMap const& lists, uint32 key)
+    {
+        AuctionIdListMap::const_iterator itr = lists.find(key);
+        if (itr == lists.end())
+            candidates = &emptyList;
+        else if (itr->second.size() < candidates->size())
+            candidates = &itr->second;
+    };
+
+    if (filters.ItemClass != 0xffffffff)
+    {
+        if (filters.ItemSubClass != 0xffffffff)
+            narrow(_bySubClass, MakeSubClassKey(filters.ItemClass, filters.ItemSubClass));
+        else
+            narrow(_byClass, filters.ItemClass);
+    }
+
+    if (filters.InventoryType != 0xffffffff)
+        narrow(_byInventoryType, filters.InventoryType);
+
+    if (filters.Quality != 0xffffffff)
+        narrow(_byQuality, filters.Quality);
+
+    if (candidates->empty())
+        return;
+
+    NameIndex const* nameIndex = nullptr;
+    std::wstring const& wsearchedname = filters.SearchedName;
+    if (!wsearchedname.empty())
+    {
+        nameIndex = &GetNameIndex(filters.DbLocale, filters.DbcLocale);
+        for (size_t i = 0; i + 2 < wsearchedname.length() && !candidates->empty(); ++i)
+        {
+            std::unordered_map<uint64, AuctionIdList>::const_iterator itr = nameIndex->Trigrams.find(MakeTrigramKey(wsearchedname, i));
+            if (itr == nameIndex->Trigrams.end())
+                return;
+
+            if (itr->second.size() < candidates->size())
+                candidates = &itr->second;
+        }
+    }
+
+    for (AuctionIdList::const_iterator itr = candidates->begin(); itr != candidates->end(); ++itr)
+    {
+        IndexedAuction const& auction = _auctions[*itr];
+        if (!MatchesTemplate(auction, filters))
+            continue;
+
+        if (nameIndex)
+        {
+            // Allow search by suffix (ie: of the Monkey) or partial name (ie: Monkey)
+            std::unordered_map<uint32, std::wstring>::const_iterator name = nameIndex->Names.find(*itr);
+            if (name == nameIndex->Names.end() || name->second.find(wsearchedname) == std::wstring::npos)
+                continue;
+        }
+
+        result.push_back(auction.Auction);
+    }
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2008-2015 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _AUCTION_HOUSE_SEARCH_INDEX_H
+#define _AUCTION_HOUSE_SEARCH_INDEX_H
+
+#include "Common.h"
+#include <memory>
+#include <unordered_map>
+
+struct AuctionEntry;
+struct ItemTemplate;
+
+/// Filters of a CMSG_AUCTION_LIST_ITEMS search that only depend on the item template and name
+struct AuctionSearchFilters
+{
+    AuctionSearchFilters() : LevelMin(0), LevelMax(0), InventoryType(0xFFFFFFFF), ItemClass(0xFFFFFFFF),
+        ItemSubClass(0xFFFFFFFF), Quality(0xFFFFFFFF), DbLocale(LOCALE_enUS), DbcLocale(LOCALE_enUS) { }
+
+    std::wstring SearchedName;                              // already lower case
+    uint8 LevelMin;
+    uint8 LevelMax;
+    uint32 InventoryType;
+    uint32 ItemClass;
+    uint32 ItemSubClass;
+    uint32 Quality;
+    LocaleConstant DbLocale;
+    LocaleConstant DbcLocale;
+};
+
+/// Secondary indexes over the auctions of one auction house.
+/// Auctions are bucketed by item class, class/subclass, inventory type and quality,
+/// and item names are kept normalized (lower case, random suffix appended) per locale
+/// together with a trigram index, so a search only has to look at the auctions of its
+/// most selective bucket instead of converting every item name in the house.
+/// All lists are sorted by auction id, which keeps search results in AuctionsMap order.
+class AuctionHouseSearchIndex
+{
+public:
+    AuctionHouseSearchIndex();
+    ~AuctionHouseSearchIndex();
+
+    void AddAuction(AuctionEntry* auction, ItemTemplate const* proto, int32 randomPropertyId);
+    void RemoveAuction(uint32 auctionId);
+
+    /// Collects (in ascending auction id order) all auctions matching the template and name filters.
+    /// Expiration, item existence and usability still have to be checked by the caller.
+    void Search(AuctionSearchFilters const& filters, std::vector<AuctionEntry*>& result);
+
+    uint32 GetSize() const { return uint32(_allAuctions.size()); }
+
+    /// Builds the name an auction is searched by: localized item name followed by the random property suffix.
+    /// Returns false if the item has no name, such items never match a name search
+    static bool BuildSearchName(ItemTemplate const* proto, int32 randomPropertyId, int locIdx, int locdbcIdx, std::wstring& wname);
+
+private:
+    typedef std::vector<uint32> AuctionIdList;
+    typedef std::unordered_map<uint32, AuctionIdList> AuctionIdListMap;
+
+    struct IndexedAuction
+    {
+        AuctionEntry* Auction;
+        ItemTemplate const* Proto;
+        int32 RandomPropertyId;
+        uint32 ItemClass;
+        uint32 ItemSubClass;
+        uint32 InventoryType;
+        uint32 Quality;
+        uint32 RequiredLevel;
+    };
+
+    struct NameIndex
+    {
+        std::unordered_map<uint32, std::wstring> Names;     // auction id -> normalized name, absent for unnamed items
+        std::unordered_map<uint64, AuctionIdList> Trigrams;
+    };
+
+    static uint64 MakeTrigramKey(std::wstring const& str, size_t pos);
+    static uint32 MakeSubClassKey(uint32 itemClass, uint32 itemSubClass) { return (itemClass << 16) | (itemSubClass & 0xFFFF); }
+    static void InsertId(AuctionIdList& list, uint32 auctionId);
+    template<class ListMap>
+    static void EraseId(ListMap& lists, typename ListMap::key_type key, uint32 auctionId);
+
+    NameIndex& GetNameIndex(LocaleConstant dbLocale, LocaleConstant dbcLocale);
+    void AddToNameIndex(NameIndex& index, IndexedAuction const& auction, LocaleConstant dbLocale, LocaleConstant dbcLocale);
+    void RemoveFromNameIndex(NameIndex& index, uint32 auctionId);
+
+    bool MatchesTemplate(IndexedAuction const& auction, AuctionSearchFilters const& filters) const;
+
+    std::unordered_map<uint32, IndexedAuction> _auctions;
+    AuctionIdList _allAuctions;
+    AuctionIdListMap _byClass;
+    AuctionIdListMap _bySubClass;
+    AuctionIdListMap _byInventoryType;
+    AuctionIdListMap _byQuality;
+
+    // built on first name search in a given db/dbc locale combination, maintained afterwards
+    std::unique_ptr<NameIndex> _nameIndexes[TOTAL_LOCALES][TOTAL_LOCALES];
+};
+
+#endif
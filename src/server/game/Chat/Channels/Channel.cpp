@@ -722,18 +722,20 @@ void Channel::SetOwner(ObjectGuid guid, bool exclaim)
 
 void Channel::SendToAll(WorldPacket* data, ObjectGuid guid)
 {
+    PacketBroadcaster broadcaster(data);
     for (PlayerContainer::const_iterator i = playersStore.begin(); i != playersStore.end(); ++i)
         if (Player* player = ObjectAccessor::FindConnectedPlayer(i->first))
             if (!guid || !player->GetSocial()->HasIgnore(guid.GetCounter()))
-                player->GetSession()->SendPacket(data);
+                broadcaster.SendTo(player->GetSession());
 }
 
 void Channel::SendToAllButOne(WorldPacket* data, ObjectGuid who)
 {
+    PacketBroadcaster broadcaster(data);
     for (PlayerContainer::const_iterator i = playersStore.begin(); i != playersStore.end(); ++i)
         if (i->first != who)
             if (Player* player = ObjectAccessor::FindConnectedPlayer(i->first))
-                player->GetSession()->SendPacket(data);
+                broadcaster.SendTo(player->GetSession());
 }
 
 void Channel::SendToOne(WorldPacket* data, ObjectGuid who)
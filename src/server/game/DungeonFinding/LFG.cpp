@@ -102,4 +102,49 @@ std::string GetStateString(LfgState state)
     return std::string(sObjectMgr->GetTrinityStringForDBCLocale(entry));
 }
 
+LfgRoleCounts::LfgRoleCounts(LfgRolesMap const& roles)
+{
+    memset(counts, 0, sizeof(counts));
+    for (LfgRolesMap::const_iterator itr = roles.begin(); itr != roles.end(); ++itr)
+        AddRoles(itr->second);
+}
+
+LfgRoleCounts& LfgRoleCounts::operator+=(LfgRoleCounts const& right)
+{
+    for (uint8 i = 0; i < 8; ++i)
+        counts[i] += right.counts[i];
+
+    return *this;
+}
+
+bool LfgRoleCounts::CanFillGroup() const
+{
+    // Players without any role can never be assigned one
+    if (counts[0])
+        return false;
+
+    // Every player gets exactly one role, which is possible as long as no subset of
+    // roles is wanted by more players than it has free slots (Hall's marriage theorem)
+    for (uint8 roles = 1; roles < 8; ++roles)
+    {
+        uint8 slots = 0;
+        if (roles & (PLAYER_ROLE_TANK >> 1))
+            slots += LFG_TANKS_NEEDED;
+        if (roles & (PLAYER_ROLE_HEALER >> 1))
+            slots += LFG_HEALERS_NEEDED;
+        if (roles & (PLAYER_ROLE_DAMAGE >> 1))
+            slots += LFG_DPS_NEEDED;
+
+        uint32 players = 0;
+        for (uint8 wanted = 1; wanted < 8; ++wanted)
+            if ((wanted & roles) == wanted)
+                players += counts[wanted];
+
+        if (players > slots)
+            return false;
+    }
+
+    return true;
+}
+
 } // namespace lfg
@@ -28,7 +28,8 @@ enum LFGEnum
 {
     LFG_TANKS_NEEDED                             = 1,
     LFG_HEALERS_NEEDED                           = 1,
-    LFG_DPS_NEEDED                               = 3
+    LFG_DPS_NEEDED                               = 3,
+    LFG_GROUP_SIZE                               = LFG_TANKS_NEEDED + LFG_HEALERS_NEEDED + LFG_DPS_NEEDED
 };
 
 enum LfgRoles
@@ -115,6 +116,21 @@ typedef std::map<ObjectGuid, LfgLockMap> LfgLockPartyMap;
 typedef std::map<ObjectGuid, uint8> LfgRolesMap;
 typedef std::map<ObjectGuid, ObjectGuid> LfgGroupsMap;
 
+/// Number of players for each combination of tank, healer and damage roles.
+/// Counts can be summed for several queued groups and tell whether the players
+/// can fill a group without having to try every role assignment.
+struct LfgRoleCounts
+{
+    LfgRoleCounts() { memset(counts, 0, sizeof(counts)); }
+    explicit LfgRoleCounts(LfgRolesMap const& roles);
+
+    void AddRoles(uint8 roles) { ++counts[(roles & (PLAYER_ROLE_TANK | PLAYER_ROLE_HEALER | PLAYER_ROLE_DAMAGE)) >> 1]; }
+    LfgRoleCounts& operator+=(LfgRoleCounts const& right);
+    bool CanFillGroup() const;
+
+    uint8 counts[8];
+};
+
 std::string ConcatenateDungeons(LfgDungeonSet const& dungeons);
 std::string GetRolesString(uint8 roles);
 std::string GetStateString(LfgState state);
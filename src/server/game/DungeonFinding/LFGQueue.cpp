@@ -51,6 +51,74 @@ std::string ConcatenateGuids(GuidList const& check)
     return o.str();
 }
 
+LfgCompatibilityKey::LfgCompatibilityKey(GuidList const& guids) : _size(0)
+{
+    // need the guids in order to avoid duplicates
+    for (GuidList::const_iterator itr = guids.begin(); itr != guids.end() && _size < LFG_GROUP_SIZE; ++itr)
+    {
+        uint64 guid = itr->GetRawValue();
+        uint8 pos = 0;
+        while (pos < _size && _guids[pos] < guid)
+            ++pos;
+
+        if (pos < _size && _guids[pos] == guid)
+            continue;
+
+        for (uint8 i = _size; i > pos; --i)
+            _guids[i] = _guids[i - 1];
+
+        _guids[pos] = guid;
+        ++_size;
+    }
+}
+
+bool LfgCompatibilityKey::Contains(ObjectGuid guid) const
+{
+    for (uint8 i = 0; i < _size; ++i)
+        if (_guids[i] == guid.GetRawValue())
+            return true;
+
+    return false;
+}
+
+std::string LfgCompatibilityKey::ToString() const
+{
+    std::ostringstream o;
+    for (uint8 i = 0; i < _size; ++i)
+    {
+        if (i)
+            o << '|';
+        o << _guids[i];
+    }
+
+    return o.str();
+}
+
+bool LfgCompatibilityKey::operator==(LfgCompatibilityKey const& right) const
+{
+    if (_size != right._size)
+        return false;
+
+    for (uint8 i = 0; i < _size; ++i)
+        if (_guids[i] != right._guids[i])
+            return false;
+
+    return true;
+}
+
+std::size_t LfgCompatibilityKey::GetHash() const
+{
+    // FNV-1a over the guids
+    uint64 hash = UI64LIT(14695981039346656037);
+    for (uint8 i = 0; i < _size; ++i)
+    {
+        hash ^= _guids[i];
+        hash *= UI64LIT(1099511628211);
+    }
+
+    return std::size_t(hash ^ (hash >> 32));
+}
+
 char const* GetCompatibleString(LfgCompatibility compatibles)
 {
     switch (compatibles)
@@ -98,17 +166,13 @@ void LFGQueue::RemoveFromQueue(ObjectGuid guid)
     RemoveFromCurrentQueue(guid);
     RemoveFromCompatibles(guid);
 
-    std::ostringstream o;
-    o << guid.GetRawValue();
-    std::string sguid = o.str();
-
     LfgQueueDataContainer::iterator itDelete = QueueDataStore.end();
     for (LfgQueueDataContainer::iterator itr = QueueDataStore.begin(); itr != QueueDataStore.end(); ++itr)
         if (itr->first != guid)
         {
-            if (std::string::npos != itr->second.bestCompatible.find(sguid))
+            if (itr->second.bestCompatible.Contains(guid))
             {
-                itr->second.bestCompatible.clear();
+                itr->second.bestCompatible.Clear();
                 FindBestCompatibleInQueue(itr);
             }
         }
@@ -187,43 +251,57 @@ void LFGQueue::UpdateWaitTimeDps(int32 waitTime, uint32 dungeonId)
 */
 void LFGQueue::RemoveFromCompatibles(ObjectGuid guid)
 {
-    std::stringstream out;
-    out << guid.GetRawValue();
-    std::string strGuid = out.str();
-
     TC_LOG_DEBUG("lfg.queue.data.compatibles.remove", "Removing %s", guid.ToString().c_str());
-    for (LfgCompatibleContainer::iterator itNext = CompatibleMapStore.begin(); itNext != CompatibleMapStore.end();)
-    {
-        LfgCompatibleContainer::iterator it = itNext++;
-        if (std::string::npos != it->first.find(strGuid))
-            CompatibleMapStore.erase(it);
-    }
+
+    LfgCompatibleKeysContainer::iterator itKeys = CompatibleKeysStore.find(guid);
+    if (itKeys == CompatibleKeysStore.end())
+        return;
+
+    // keys of other guids are left behind, erasing them again later is harmless
+    for (std::vector<LfgCompatibilityKey>::const_iterator it = itKeys->second.begin(); it != itKeys->second.end(); ++it)
+        CompatibleMapStore.erase(*it);
+
+    CompatibleKeysStore.erase(itKeys);
+}
+
+/**
+   Returns the cached compatibility of a list of guids, adding an empty one if missing
+
+   @param[in]     key Sorted guids
+*/
+LfgCompatibilityData& LFGQueue::AddCompatibles(LfgCompatibilityKey const& key)
+{
+    std::pair<LfgCompatibleContainer::iterator, bool> itr = CompatibleMapStore.insert(LfgCompatibleContainer::value_type(key, LfgCompatibilityData()));
+    if (itr.second)
+        for (uint8 i = 0; i < key.GetSize(); ++i)
+            CompatibleKeysStore[key.GetGuid(i)].push_back(key);
+
+    return itr.first->second;
 }
 
 /**
    Stores the compatibility of a list of guids
 
-   @param[in]     key String concatenation of guids (| used as separator)
+   @param[in]     key Sorted guids
    @param[in]     compatibles type of compatibility
 */
-void LFGQueue::SetCompatibles(std::string const& key, LfgCompatibility compatibles)
+void LFGQueue::SetCompatibles(LfgCompatibilityKey const& key, LfgCompatibility compatibles)
 {
-    LfgCompatibilityData& data = CompatibleMapStore[key];
-    data.compatibility = compatibles;
+    AddCompatibles(key).compatibility = compatibles;
 }
 
-void LFGQueue::SetCompatibilityData(std::string const& key, LfgCompatibilityData const& data)
+void LFGQueue::SetCompatibilityData(LfgCompatibilityKey const& key, LfgCompatibilityData const& data)
 {
-    CompatibleMapStore[key] = data;
+    AddCompatibles(key) = data;
 }
 
 /**
    Get the compatibility of a group of guids
 
-   @param[in]     key String concatenation of guids (| used as separator)
+   @param[in]     key Sorted guids
    @return LfgCompatibility type of compatibility
 */
-LfgCompatibility LFGQueue::GetCompatibles(std::string const& key)
+LfgCompatibility LFGQueue::GetCompatibles(LfgCompatibilityKey const& key)
 {
     LfgCompatibleContainer::iterator itr = CompatibleMapStore.find(key);
     if (itr != CompatibleMapStore.end())
@@ -232,7 +310,7 @@ LfgCompatibility LFGQueue::GetCompatibles(std::string const& key)
     return LFG_COMPATIBILITY_PENDING;
 }
 
-LfgCompatibilityData* LFGQueue::GetCompatibilityData(std::string const& key)
+LfgCompatibilityData* LFGQueue::GetCompatibilityData(LfgCompatibilityKey const& key)
 {
     LfgCompatibleContainer::iterator itr = CompatibleMapStore.find(key);
     if (itr != CompatibleMapStore.end())
@@ -275,17 +353,20 @@ uint8 LFGQueue::FindGroups()
 */
 LfgCompatibility LFGQueue::FindNewGroups(GuidList& check, GuidList& all)
 {
-    std::string strGuids = ConcatenateGuids(check);
-    LfgCompatibility compatibles = GetCompatibles(strGuids);
+    if (check.size() > LFG_GROUP_SIZE)
+        return LFG_INCOMPATIBLES_WRONG_GROUP_SIZE;
 
-    TC_LOG_DEBUG("lfg.queue.match.check", "Guids: (%s): %s - all(%s)", strGuids.c_str(), GetCompatibleString(compatibles), ConcatenateGuids(all).c_str());
+    LfgCompatibilityKey key(check);
+    LfgCompatibility compatibles = GetCompatibles(key);
+
+    TC_LOG_DEBUG("lfg.queue.match.check", "Guids: (%s): %s - all(%s)", key.ToString().c_str(), GetCompatibleString(compatibles), ConcatenateGuids(all).c_str());
     if (compatibles == LFG_COMPATIBILITY_PENDING) // Not previously cached, calculate
         compatibles = CheckCompatibility(check);
 
-    if (compatibles == LFG_COMPATIBLES_BAD_STATES && sLFGMgr->AllQueued(check))
+    if (compatibles == LFG_COMPATIBLES_BAD_STATES && (_simulated || sLFGMgr->AllQueued(check)))
     {
-        TC_LOG_DEBUG("lfg.queue.match.check", "Guids: (%s) compatibles (cached) changed from bad states to match", strGuids.c_str());
-        SetCompatibles(strGuids, LFG_COMPATIBLES_MATCH);
+        TC_LOG_DEBUG("lfg.queue.match.check", "Guids: (%s) compatibles (cached) changed from bad states to match", key.ToString().c_str());
+        SetCompatibles(key, LFG_COMPATIBLES_MATCH);
         return LFG_COMPATIBLES_MATCH;
     }
 
@@ -313,19 +394,21 @@ LfgCompatibility LFGQueue::FindNewGroups(GuidList& check, GuidList& all)
 */
 LfgCompatibility LFGQueue::CheckCompatibility(GuidList check)
 {
-    std::string strGuids = ConcatenateGuids(check);
     LfgProposal proposal;
     LfgDungeonSet proposalDungeons;
     LfgGroupsMap proposalGroups;
     LfgRolesMap proposalRoles;
+    LfgRoleCounts proposalRoleCounts;
 
     // Check for correct size
     if (check.size() > MAXGROUPSIZE || check.empty())
     {
-        TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s): Size wrong - Not compatibles", strGuids.c_str());
+        TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s): Size wrong - Not compatibles", ConcatenateGuids(check).c_str());
         return LFG_INCOMPATIBLES_WRONG_GROUP_SIZE;
     }
 
+    LfgCompatibilityKey key(check);
+
     // Check all-but-new compatiblitity
     if (check.size() > 2)
     {
@@ -336,8 +419,8 @@ LfgCompatibility LFGQueue::CheckCompatibility(GuidList check)
         LfgCompatibility child_compatibles = CheckCompatibility(check);
         if (child_compatibles < LFG_COMPATIBLES_WITH_LESS_PLAYERS) // Group not compatible
         {
-            TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) child %s not compatibles", strGuids.c_str(), ConcatenateGuids(check).c_str());
-            SetCompatibles(strGuids, child_compatibles);
+            TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) child %s not compatibles", key.ToString().c_str(), ConcatenateGuids(check).c_str());
+            SetCompatibles(key, child_compatibles);
             return child_compatibles;
         }
         check.push_front(frontGuid);
@@ -362,6 +445,7 @@ LfgCompatibility LFGQueue::CheckCompatibility(GuidList check)
             proposalGroups[it2->first] = itQueue->first.IsGroup() ? itQueue->first : ObjectGuid::Empty;
 
         numPlayers += itQueue->second.roles.size();
+        proposalRoleCounts += itQueue->second.roleCounts;
 
         if (sLFGMgr->IsLfgGroup(guid))
         {
@@ -374,29 +458,29 @@ LfgCompatibility LFGQueue::CheckCompatibility(GuidList check)
     // Group with less that MAXGROUPSIZE members always compatible
     if (check.size() == 1 && numPlayers != MAXGROUPSIZE)
     {
-        TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) single group. Compatibles", strGuids.c_str());
+        TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) single group. Compatibles", key.ToString().c_str());
         LfgQueueDataContainer::iterator itQueue = QueueDataStore.find(check.front());
 
         LfgCompatibilityData data(LFG_COMPATIBLES_WITH_LESS_PLAYERS);
         data.roles = itQueue->second.roles;
         LFGMgr::CheckGroupRoles(data.roles);
 
-        UpdateBestCompatibleInQueue(itQueue, strGuids, data.roles);
-        SetCompatibilityData(strGuids, data);
+        UpdateBestCompatibleInQueue(itQueue, key, data.roles);
+        SetCompatibilityData(key, data);
         return LFG_COMPATIBLES_WITH_LESS_PLAYERS;
     }
 
     if (numLfgGroups > 1)
     {
-        TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) More than one Lfggroup (%u)", strGuids.c_str(), numLfgGroups);
-        SetCompatibles(strGuids, LFG_INCOMPATIBLES_MULTIPLE_LFG_GROUPS);
+        TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) More than one Lfggroup (%u)", key.ToString().c_str(), numLfgGroups);
+        SetCompatibles(key, LFG_INCOMPATIBLES_MULTIPLE_LFG_GROUPS);
         return LFG_INCOMPATIBLES_MULTIPLE_LFG_GROUPS;
     }
 
     if (numPlayers > MAXGROUPSIZE)
     {
-        TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) Too much players (%u)", strGuids.c_str(), numPlayers);
-        SetCompatibles(strGuids, LFG_INCOMPATIBLES_TOO_MUCH_PLAYERS);
+        TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) Too much players (%u)", key.ToString().c_str(), numPlayers);
+        SetCompatibles(key, LFG_INCOMPATIBLES_TOO_MUCH_PLAYERS);
         return LFG_INCOMPATIBLES_TOO_MUCH_PLAYERS;
     }
 
@@ -423,20 +507,21 @@ LfgCompatibility LFGQueue::CheckCompatibility(GuidList check)
 
         if (uint8 playersize = numPlayers - proposalRoles.size())
         {
-            TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) not compatible, %u players are ignoring each other", strGuids.c_str(), playersize);
-            SetCompatibles(strGuids, LFG_INCOMPATIBLES_HAS_IGNORES);
+            TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) not compatible, %u players are ignoring each other", key.ToString().c_str(), playersize);
+            SetCompatibles(key, LFG_INCOMPATIBLES_HAS_IGNORES);
             return LFG_INCOMPATIBLES_HAS_IGNORES;
         }
 
+        // Role counts reject impossible combinations without trying every role assignment
         LfgRolesMap debugRoles = proposalRoles;
-        if (!LFGMgr::CheckGroupRoles(proposalRoles))
+        if (!proposalRoleCounts.CanFillGroup() || !LFGMgr::CheckGroupRoles(proposalRoles))
         {
             std::ostringstream o;
             for (LfgRolesMap::const_iterator it = debugRoles.begin(); it != debugRoles.end(); ++it)
                 o << ", " << it->first.GetRawValue() << ": " << GetRolesString(it->second);
 
-            TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) Roles not compatible%s", strGuids.c_str(), o.str().c_str());
-            SetCompatibles(strGuids, LFG_INCOMPATIBLES_NO_ROLES);
+            TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) Roles not compatible%s", key.ToString().c_str(), o.str().c_str());
+            SetCompatibles(key, LFG_INCOMPATIBLES_NO_ROLES);
             return LFG_INCOMPATIBLES_NO_ROLES;
         }
 
@@ -455,8 +540,8 @@ LfgCompatibility LFGQueue::CheckCompatibility(GuidList check)
 
         if (proposalDungeons.empty())
         {
-            TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) No compatible dungeons%s", strGuids.c_str(), o.str().c_str());
-            SetCompatibles(strGuids, LFG_INCOMPATIBLES_NO_DUNGEONS);
+            TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) No compatible dungeons%s", key.ToString().c_str(), o.str().c_str());
+            SetCompatibles(key, LFG_INCOMPATIBLES_NO_DUNGEONS);
             return LFG_INCOMPATIBLES_NO_DUNGEONS;
         }
     }
@@ -472,14 +557,14 @@ LfgCompatibility LFGQueue::CheckCompatibility(GuidList check)
     // Enough players?
     if (numPlayers != MAXGROUPSIZE)
     {
-        TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) Compatibles but not enough players(%u)", strGuids.c_str(), numPlayers);
+        TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) Compatibles but not enough players(%u)", key.ToString().c_str(), numPlayers);
         LfgCompatibilityData data(LFG_COMPATIBLES_WITH_LESS_PLAYERS);
         data.roles = proposalRoles;
 
         for (GuidList::const_iterator itr = check.begin(); itr != check.end(); ++itr)
-            UpdateBestCompatibleInQueue(QueueDataStore.find(*itr), strGuids, data.roles);
+            UpdateBestCompatibleInQueue(QueueDataStore.find(*itr), key, data.roles);
 
-        SetCompatibilityData(strGuids, data);
+        SetCompatibilityData(key, data);
         return LFG_COMPATIBLES_WITH_LESS_PLAYERS;
     }
 
@@ -487,10 +572,10 @@ LfgCompatibility LFGQueue::CheckCompatibility(GuidList check)
     proposal.queues = check;
     proposal.isNew = numLfgGroups != 1 || sLFGMgr->GetOldState(gguid) != LFG_STATE_DUNGEON;
 
-    if (!sLFGMgr->AllQueued(check))
+    if (!_simulated && !sLFGMgr->AllQueued(check))
     {
-        TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) Group MATCH but can't create proposal!", strGuids.c_str());
-        SetCompatibles(strGuids, LFG_COMPATIBLES_BAD_STATES);
+        TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) Group MATCH but can't create proposal!", key.ToString().c_str());
+        SetCompatibles(key, LFG_COMPATIBLES_BAD_STATES);
         return LFG_COMPATIBLES_BAD_STATES;
     }
 
@@ -529,10 +614,19 @@ LfgCompatibility LFGQueue::CheckCompatibility(GuidList check)
         RemoveFromCurrentQueue(guid);
     }
 
-    sLFGMgr->AddProposal(proposal);
+    TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) MATCH! Group formed", key.ToString().c_str());
+
+    // Simulated players accept at once, nobody is asked
+    if (_simulated)
+    {
+        ++_simulatedGroups;
+        for (GuidList::const_iterator itQueue = proposal.queues.begin(); itQueue != proposal.queues.end(); ++itQueue)
+            RemoveFromQueue(*itQueue);
+        return LFG_COMPATIBLES_MATCH;
+    }
 
-    TC_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) MATCH! Group formed", strGuids.c_str());
-    SetCompatibles(strGuids, LFG_COMPATIBLES_MATCH);
+    sLFGMgr->AddProposal(proposal);
+    SetCompatibles(key, LFG_COMPATIBLES_MATCH);
     return LFG_COMPATIBLES_MATCH;
 }
 
@@ -574,7 +668,7 @@ void LFGQueue::UpdateQueueTimers(uint8 queueId, time_t currTime)
                 break;
         }
 
-        if (queueinfo.bestCompatible.empty())
+        if (queueinfo.bestCompatible.IsEmpty())
             FindBestCompatibleInQueue(itQueue);
 
         LfgQueueStatusData queueData(queueId, dungeonId, queueinfo.joinTime, waitTime, wtAvg, wtTank, wtHealer, wtDps, queuedTime, queueinfo.tanks, queueinfo.healers, queueinfo.dps);
@@ -627,7 +721,7 @@ std::string LFGQueue::DumpCompatibleInfo(bool full /* = false */) const
     o << "Compatible Map size: " << CompatibleMapStore.size() << "\n";
     if (full)
         for (LfgCompatibleContainer::const_iterator itr = CompatibleMapStore.begin(); itr != CompatibleMapStore.end(); ++itr)
-            o << "(" << itr->first << "): " << GetCompatibleString(itr->second.compatibility) << "\n";
+            o << "(" << itr->first.ToString() << "): " << GetCompatibleString(itr->second.compatibility) << "\n";
 
     return o.str();
 }
@@ -635,32 +729,38 @@ std::string LFGQueue::DumpCompatibleInfo(bool full /* = false */) const
 void LFGQueue::FindBestCompatibleInQueue(LfgQueueDataContainer::iterator itrQueue)
 {
     TC_LOG_DEBUG("lfg.queue.compatibles.find", "%s", itrQueue->first.ToString().c_str());
-    std::ostringstream o;
-    o << itrQueue->first.GetRawValue();
-    std::string sguid = o.str();
 
-    for (LfgCompatibleContainer::const_iterator itr = CompatibleMapStore.begin(); itr != CompatibleMapStore.end(); ++itr)
-        if (itr->second.compatibility == LFG_COMPATIBLES_WITH_LESS_PLAYERS &&
-            std::string::npos != itr->first.find(sguid))
+    LfgCompatibleKeysContainer::iterator itKeys = CompatibleKeysStore.find(itrQueue->first);
+    if (itKeys == CompatibleKeysStore.end())
+        return;
+
+    // also drop the keys removed together with other guids
+    std::vector<LfgCompatibilityKey>& keys = itKeys->second;
+    for (std::size_t i = 0; i < keys.size();)
+    {
+        LfgCompatibleContainer::const_iterator itr = CompatibleMapStore.find(keys[i]);
+        if (itr == CompatibleMapStore.end())
         {
-            UpdateBestCompatibleInQueue(itrQueue, itr->first, itr->second.roles);
+            keys[i] = keys.back();
+            keys.pop_back();
+            continue;
         }
+
+        if (itr->second.compatibility == LFG_COMPATIBLES_WITH_LESS_PLAYERS)
+            UpdateBestCompatibleInQueue(itrQueue, itr->first, itr->second.roles);
+        ++i;
+    }
 }
 
-void LFGQueue::UpdateBestCompatibleInQueue(LfgQueueDataContainer::iterator itrQueue, std::string const& key, LfgRolesMap const& roles)
+void LFGQueue::UpdateBestCompatibleInQueue(LfgQueueDataContainer::iterator itrQueue, LfgCompatibilityKey const& key, LfgRolesMap const& roles)
 {
     LfgQueueData& queueData = itrQueue->second;
 
-    uint8 storedSize = queueData.bestCompatible.empty() ? 0 :
-        std::count(queueData.bestCompatible.begin(), queueData.bestCompatible.end(), '|') + 1;
-
-    uint8 size = std::count(key.begin(), key.end(), '|') + 1;
-
-    if (size <= storedSize)
+    if (key.GetSize() <= queueData.bestCompatible.GetSize())
         return;
 
     TC_LOG_DEBUG("lfg.queue.compatibles.update", "Changed (%s) to (%s) as best compatible group for %s",
-        queueData.bestCompatible.c_str(), key.c_str(), itrQueue->first.ToString().c_str());
+        queueData.bestCompatible.ToString().c_str(), key.ToString().c_str(), itrQueue->first.ToString().c_str());
 
     queueData.bestCompatible = key;
     queueData.tanks = LFG_TANKS_NEEDED;
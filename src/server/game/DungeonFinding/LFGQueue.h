@@ -37,6 +37,36 @@ enum LfgCompatibility
     LFG_COMPATIBLES_MATCH                                  // Must be the last one
 };
 
+/// Sorted set of queue guids (players or groups) used as key of the compatibility cache
+class LfgCompatibilityKey
+{
+    public:
+        LfgCompatibilityKey() : _size(0) { }
+        explicit LfgCompatibilityKey(GuidList const& guids);
+
+        uint8 GetSize() const { return _size; }
+        bool IsEmpty() const { return _size == 0; }
+        bool Contains(ObjectGuid guid) const;
+        ObjectGuid GetGuid(uint8 index) const { return ObjectGuid(_guids[index]); }
+        void Clear() { _size = 0; }
+
+        /// Guids concatenated with | as delimiter, for logging
+        std::string ToString() const;
+
+        bool operator==(LfgCompatibilityKey const& right) const;
+        bool operator!=(LfgCompatibilityKey const& right) const { return !(*this == right); }
+        std::size_t GetHash() const;
+
+    private:
+        uint64 _guids[LFG_GROUP_SIZE];
+        uint8 _size;
+};
+
+struct LfgCompatibilityKeyHash
+{
+    std::size_t operator()(LfgCompatibilityKey const& key) const { return key.GetHash(); }
+};
+
 struct LfgCompatibilityData
 {
     LfgCompatibilityData(): compatibility(LFG_COMPATIBILITY_PENDING) { }
@@ -57,7 +87,7 @@ struct LfgQueueData
 
     LfgQueueData(time_t _joinTime, LfgDungeonSet const& _dungeons, LfgRolesMap const& _roles):
         joinTime(_joinTime), tanks(LFG_TANKS_NEEDED), healers(LFG_HEALERS_NEEDED),
-        dps(LFG_DPS_NEEDED), dungeons(_dungeons), roles(_roles)
+        dps(LFG_DPS_NEEDED), dungeons(_dungeons), roles(_roles), roleCounts(_roles)
         { }
 
     time_t joinTime;                                       ///< Player queue join time (to calculate wait times)
@@ -66,7 +96,8 @@ struct LfgQueueData
     uint8 dps;                                             ///< Dps needed
     LfgDungeonSet dungeons;                                ///< Selected Player/Group Dungeon/s
     LfgRolesMap roles;                                     ///< Selected Player Role/s
-    std::string bestCompatible;                            ///< Best compatible combination of people queued
+    LfgRoleCounts roleCounts;                              ///< Selected Player Role/s, counted per role combination
+    LfgCompatibilityKey bestCompatible;                    ///< Best compatible combination of people queued
 };
 
 struct LfgWaitTime
@@ -77,7 +108,8 @@ struct LfgWaitTime
 };
 
 typedef std::map<uint32, LfgWaitTime> LfgWaitTimesContainer;
-typedef std::map<std::string, LfgCompatibilityData> LfgCompatibleContainer;
+typedef std::unordered_map<LfgCompatibilityKey, LfgCompatibilityData, LfgCompatibilityKeyHash> LfgCompatibleContainer;
+typedef std::unordered_map<ObjectGuid, std::vector<LfgCompatibilityKey>> LfgCompatibleKeysContainer;
 typedef std::map<ObjectGuid, LfgQueueData> LfgQueueDataContainer;
 
 /**
@@ -86,6 +118,13 @@ typedef std::map<ObjectGuid, LfgQueueData> LfgQueueDataContainer;
 class LFGQueue
 {
     public:
+        LFGQueue(): _simulated(false), _simulatedGroups(0) { }
+
+        /// Load tests only: match without the player states of LFGMgr and remove matched guids instead of creating proposals
+        void SetSimulated(bool simulated) { _simulated = simulated; }
+        uint32 GetSimulatedGroups() const { return _simulatedGroups; }
+        uint32 GetQueuedCount() const { return uint32(QueueDataStore.size()); }
+        uint32 GetCompatibleCount() const { return uint32(CompatibleMapStore.size()); }
 
         // Add/Remove from queue
         void AddToQueue(ObjectGuid guid);
@@ -111,21 +150,21 @@ class LFGQueue
         std::string DumpCompatibleInfo(bool full = false) const;
 
     private:
-        void SetQueueUpdateData(std::string const& strGuids, LfgRolesMap const& proposalRoles);
 
         void AddToNewQueue(ObjectGuid guid);
         void AddToCurrentQueue(ObjectGuid guid);
         void RemoveFromNewQueue(ObjectGuid guid);
         void RemoveFromCurrentQueue(ObjectGuid guid);
 
-        void SetCompatibles(std::string const& key, LfgCompatibility compatibles);
-        LfgCompatibility GetCompatibles(std::string const& key);
+        LfgCompatibilityData& AddCompatibles(LfgCompatibilityKey const& key);
+        void SetCompatibles(LfgCompatibilityKey const& key, LfgCompatibility compatibles);
+        LfgCompatibility GetCompatibles(LfgCompatibilityKey const& key);
         void RemoveFromCompatibles(ObjectGuid guid);
 
-        void SetCompatibilityData(std::string const& key, LfgCompatibilityData const& compatibles);
-        LfgCompatibilityData* GetCompatibilityData(std::string const& key);
+        void SetCompatibilityData(LfgCompatibilityKey const& key, LfgCompatibilityData const& compatibles);
+        LfgCompatibilityData* GetCompatibilityData(LfgCompatibilityKey const& key);
         void FindBestCompatibleInQueue(LfgQueueDataContainer::iterator itrQueue);
-        void UpdateBestCompatibleInQueue(LfgQueueDataContainer::iterator itrQueue, std::string const& key, LfgRolesMap const& roles);
+        void UpdateBestCompatibleInQueue(LfgQueueDataContainer::iterator itrQueue, LfgCompatibilityKey const& key, LfgRolesMap const& roles);
 
         LfgCompatibility FindNewGroups(GuidList& check, GuidList& all);
         LfgCompatibility CheckCompatibility(GuidList check);
@@ -133,6 +172,7 @@ class LFGQueue
         // Queue
         LfgQueueDataContainer QueueDataStore;              ///< Queued groups
         LfgCompatibleContainer CompatibleMapStore;         ///< Compatible dungeons
+        LfgCompatibleKeysContainer CompatibleKeysStore;    ///< Compatible dungeons keys each guid is part of (may contain already removed keys)
 
         LfgWaitTimesContainer waitTimesAvgStore;           ///< Average wait time to find a group queuing as multiple roles
         LfgWaitTimesContainer waitTimesTankStore;          ///< Average wait time to find a group queuing as tank
@@ -140,6 +180,9 @@ class LFGQueue
         LfgWaitTimesContainer waitTimesDpsStore;           ///< Average wait time to find a group queuing as dps
         GuidList currentQueueStore;                        ///< Ordered list. Used to find groups
         GuidList newToQueueStore;                          ///< New groups to add to queue
+
+        bool _simulated;                                   ///< Queue of a load test, see SetSimulated
+        uint32 _simulatedGroups;                           ///< Groups matched while simulated
 };
 
 } // namespace lfg
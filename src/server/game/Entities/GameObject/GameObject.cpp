@@ -2186,6 +2186,10 @@ void GameObject::EnableCollision(bool enable)
         GetMap()->InsertGameObjectModel(*m_model);*/
 
     m_model->enable(enable ? GetPhaseMask() : 0);
+
+    // cached collision results of the map include this model
+    if (IsInWorld())
+        GetMap()->InvalidateGameObjectModels();
 }
 
 void GameObject::UpdateModel()
@@ -2255,114 +2259,102 @@ bool GameObject::IsLootAllowedFor(Player const* player) const
     return true;
 }
 
-void GameObject::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target) const
+void GameObject::BuildValuesUpdateMask(uint8 updateType, uint32 visibleFlag, Player const* /*target*/, UpdateMask& updateMask) const
 {
-    if (!target)
-        return;
+    updateMask.SetCount(m_valuesCount);
 
-    bool isStoppableTransport = GetGoType() == GAMEOBJECT_TYPE_TRANSPORT && !m_goValue.Transport.StopFrames->empty();
-    bool forcedFlags = GetGoType() == GAMEOBJECT_TYPE_CHEST && GetGOInfo()->chest.groupLootRules && HasLootRecipient();
-    bool targetIsGM = target->IsGameMaster();
+    GameObjectUpdateFieldFlagMasks.SetFieldsWithFlags(visibleFlag, updateMask);
+    FilterVisibleFields(updateType, updateMask);
+    GameObjectUpdateFieldFlagMasks.SetFieldsWithFlags(_fieldNotifyFlags, updateMask);
 
-    ByteBuffer fieldBuffer;
+    if (GetGoType() == GAMEOBJECT_TYPE_CHEST && GetGOInfo()->chest.groupLootRules && HasLootRecipient())
+        updateMask.SetBit(GAMEOBJECT_FLAGS);
+}
 
-    UpdateMask updateMask;
-    updateMask.SetCount(m_valuesCount);
+bool GameObject::IsUpdateFieldTargetDependent(uint32 index) const
+{
+    return index == GAMEOBJECT_DYNAMIC || index == GAMEOBJECT_FLAGS;
+}
 
-    uint32* flags = GameObjectUpdateFieldFlags;
-    uint32 visibleFlag = UF_FLAG_PUBLIC;
-    if (GetOwnerGUID() == target->GetGUID())
-        visibleFlag |= UF_FLAG_OWNER;
+uint32 GameObject::GetUpdateFieldValueForTarget(uint32 index, Player* target) const
+{
+    bool isStoppableTransport = GetGoType() == GAMEOBJECT_TYPE_TRANSPORT && !m_goValue.Transport.StopFrames->empty();
+    bool targetIsGM = target->IsGameMaster();
 
-    for (uint16 index = 0; index < m_valuesCount; ++index)
+    if (index == GAMEOBJECT_DYNAMIC)
     {
-        if (_fieldNotifyFlags & flags[index] ||
-            ((updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index]) && (flags[index] & visibleFlag)) ||
-            (index == GAMEOBJECT_FLAGS && forcedFlags))
+        uint16 dynFlags = 0;
+        int16 pathProgress = -1;
+        switch (GetGoType())
         {
-            updateMask.SetBit(index);
-
-            if (index == GAMEOBJECT_DYNAMIC)
+            case GAMEOBJECT_TYPE_QUESTGIVER:
+                if (ActivateToQuest(target))
+                    dynFlags |= GO_DYNFLAG_LO_ACTIVATE;
+                break;
+            case GAMEOBJECT_TYPE_CHEST:
+            case GAMEOBJECT_TYPE_GOOBER:
+                if (ActivateToQuest(target))
+                    dynFlags |= GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE;
+                else if (targetIsGM)
+                    dynFlags |= GO_DYNFLAG_LO_ACTIVATE;
+                break;
+            case GAMEOBJECT_TYPE_GENERIC:
+                if (ActivateToQuest(target))
+                    dynFlags |= GO_DYNFLAG_LO_SPARKLE;
+                break;
+            case GAMEOBJECT_TYPE_TRANSPORT:
             {
-                uint16 dynFlags = 0;
-                int16 pathProgress = -1;
-                switch (GetGoType())
-                {
-                    case GAMEOBJECT_TYPE_QUESTGIVER:
-                        if (ActivateToQuest(target))
-                            dynFlags |= GO_DYNFLAG_LO_ACTIVATE;
-                        break;
-                    case GAMEOBJECT_TYPE_CHEST:
-                    case GAMEOBJECT_TYPE_GOOBER:
-                        if (ActivateToQuest(target))
-                            dynFlags |= GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE;
-                        else if (targetIsGM)
-                            dynFlags |= GO_DYNFLAG_LO_ACTIVATE;
-                        break;
-                    case GAMEOBJECT_TYPE_GENERIC:
-                        if (ActivateToQuest(target))
-                            dynFlags |= GO_DYNFLAG_LO_SPARKLE;
-                        break;
-                    case GAMEOBJECT_TYPE_TRANSPORT:
-                    {
-                        float timer = float(m_goValue.Transport.PathProgress % GetTransportPeriod());
-                        pathProgress = int16(timer / float(GetTransportPeriod()) * 65535.0f);
-                        break;
-                    }
-                    case GAMEOBJECT_TYPE_MO_TRANSPORT:
-                    {
-                        if (uint32 transportPeriod = GetTransportPeriod())
-                        {
-                            float timer = float(m_goValue.Transport.PathProgress % transportPeriod);
-                            pathProgress = int16(timer / float(transportPeriod) * 65535.0f);
-                        }
-                        break;
-                    }
-                    default:
-                        break;
-                }
-
-                fieldBuffer << uint16(dynFlags);
-                fieldBuffer << int16(pathProgress);
+                float timer = float(m_goValue.Transport.PathProgress % GetTransportPeriod());
+                pathProgress = int16(timer / float(GetTransportPeriod()) * 65535.0f);
+                break;
             }
-            else if (index == GAMEOBJECT_FLAGS)
+            case GAMEOBJECT_TYPE_MO_TRANSPORT:
             {
-                uint32 goFlags = m_uint32Values[GAMEOBJECT_FLAGS];
-                if (GetGoType() == GAMEOBJECT_TYPE_CHEST)
-                    if (GetGOInfo()->chest.groupLootRules && !IsLootAllowedFor(target))
-                        goFlags |= GO_FLAG_LOCKED | GO_FLAG_NOT_SELECTABLE;
-
-                fieldBuffer << goFlags;
-            }
-            else if (index == GAMEOBJECT_LEVEL)
-            {
-                if (isStoppableTransport)
-                    fieldBuffer << uint32(m_goValue.Transport.PathProgress);
-                else
-                    fieldBuffer << m_uint32Values[index];
-            }
-            else if (index == GAMEOBJECT_BYTES_1)
-            {
-                uint32 bytes1 = m_uint32Values[index];
-                if (isStoppableTransport && GetGoState() == GO_STATE_TRANSPORT_ACTIVE)
+                if (uint32 transportPeriod = GetTransportPeriod())
                 {
-                    if ((m_goValue.Transport.StateUpdateTimer / 20000) & 1)
-                    {
-                        bytes1 &= 0xFFFFFF00;
-                        bytes1 |= GO_STATE_TRANSPORT_STOPPED;
-                    }
+                    float timer = float(m_goValue.Transport.PathProgress % transportPeriod);
+                    pathProgress = int16(timer / float(transportPeriod) * 65535.0f);
                 }
-
-                fieldBuffer << bytes1;
+                break;
             }
-            else
-                fieldBuffer << m_uint32Values[index];                // other cases
+            default:
+                break;
         }
+
+        return uint32(dynFlags) | (uint32(uint16(pathProgress)) << 16);
     }
+    else if (index == GAMEOBJECT_FLAGS)
+    {
+        uint32 goFlags = m_uint32Values[GAMEOBJECT_FLAGS];
+        if (GetGoType() == GAMEOBJECT_TYPE_CHEST)
+            if (GetGOInfo()->chest.groupLootRules && !IsLootAllowedFor(target))
+                goFlags |= GO_FLAG_LOCKED | GO_FLAG_NOT_SELECTABLE;
 
-    *data << uint8(updateMask.GetBlockCount());
-    updateMask.AppendToPacket(data);
-    data->append(fieldBuffer);
+        return goFlags;
+    }
+    else if (index == GAMEOBJECT_LEVEL)
+    {
+        if (isStoppableTransport)
+            return uint32(m_goValue.Transport.PathProgress);
+        else
+            return m_uint32Values[index];
+    }
+    else if (index == GAMEOBJECT_BYTES_1)
+    {
+        uint32 bytes1 = m_uint32Values[index];
+        if (isStoppableTransport && GetGoState() == GO_STATE_TRANSPORT_ACTIVE)
+        {
+            if ((m_goValue.Transport.StateUpdateTimer / 20000) & 1)
+            {
+                bytes1 &= 0xFFFFFF00;
+                bytes1 |= GO_STATE_TRANSPORT_STOPPED;
+            }
+        }
+
+        return bytes1;
+    }
+    else
+        return m_uint32Values[index];                // other cases
 }
 
 void GameObject::GetRespawnPosition(float &x, float &y, float &z, float* ori /* = NULL*/) const
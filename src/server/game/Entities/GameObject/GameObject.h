@@ -660,7 +660,9 @@ class GameObject : public WorldObject, public GridObject<GameObject>, public Map
         explicit GameObject();
         ~GameObject();
 
-        void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, Player* target) const override;
+        void BuildValuesUpdateMask(uint8 updateType, uint32 visibleFlag, Player const* target, UpdateMask& updateMask) const override;
+        bool IsUpdateFieldTargetDependent(uint32 index) const override;
+        uint32 GetUpdateFieldValueForTarget(uint32 index, Player* target) const override;
 
         void AddToWorld() override;
         void RemoveFromWorld() override;
@@ -1099,6 +1099,13 @@ void Item::BuildUpdate(UpdateDataMapType& data_map)
     ClearUpdateMask(false);
 }
 
+Map* Item::GetObjectUpdateMap() const
+{
+    if (Player* owner = GetOwner())
+        return owner->FindMap();
+    return NULL;
+}
+
 void Item::SaveRefundDataToDB()
 {
     SQLTransaction trans = CharacterDatabase.BeginTransaction();
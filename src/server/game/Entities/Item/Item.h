@@ -357,6 +357,7 @@ class Item : public Object
         bool CheckSoulboundTradeExpire();
 
         void BuildUpdate(UpdateDataMapType&) override;
+        Map* GetObjectUpdateMap() const override;
 
         uint32 GetScriptId() const { return GetTemplate()->ScriptId; }
 
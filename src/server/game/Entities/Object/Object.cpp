@@ -53,6 +53,10 @@
 #include "Battleground.h"
 #include "Chat.h"
 
+std::atomic<uint64> ValuesUpdateBlockCache::_built;
+std::atomic<uint64> ValuesUpdateBlockCache::_reused;
+std::atomic<uint64> ValuesUpdateBlockCache::_patchedFields;
+
 Object::Object() : m_PackGUID(sizeof(uint64)+1)
 {
     m_objectTypeId      = TYPEID_OBJECT;
@@ -65,6 +69,8 @@ Object::Object() : m_PackGUID(sizeof(uint64)+1)
 
     m_inWorld           = false;
     m_objectUpdated     = false;
+    _updateQueueMap     = NULL;
+    _updateQueueIndex   = 0;
 }
 
 WorldObject::~WorldObject()
@@ -97,7 +103,7 @@ Object::~Object()
     {
         TC_LOG_FATAL("misc", "Object::~Object %s deleted but still in update list!!", GetGUID().ToString().c_str());
         ASSERT(false);
-        sObjectAccessor->RemoveUpdateObject(this);
+        RemoveFromObjectUpdate();
     }
 
     delete [] m_uint32Values;
@@ -257,6 +263,46 @@ void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) c
     data->AddUpdateBlock(buf);
 }
 
+void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target, ValuesUpdateBlockCache& cache) const
+{
+    uint32 visibleFlag = GetUpdateFieldData(target);
+    if (ValuesUpdateBlockCache::Entry* entry = cache.Find(visibleFlag))
+    {
+        ++ValuesUpdateBlockCache::_reused;
+
+        for (std::pair<uint32, uint32> const& field : entry->TargetDependentFields)
+            entry->Block.put<uint32>(field.first, GetUpdateFieldValueForTarget(field.second, target));
+
+        ValuesUpdateBlockCache::_patchedFields += entry->TargetDependentFields.size();
+        data->AddUpdateBlock(entry->Block);
+        return;
+    }
+
+    ++ValuesUpdateBlockCache::_built;
+
+    ValuesUpdateBlockCache::Entry& entry = cache.Add(visibleFlag);
+    ByteBuffer& buf = entry.Block;
+
+    buf << uint8(UPDATETYPE_VALUES);
+    buf << GetPackGUID();
+
+    UpdateMask updateMask;
+    BuildValuesUpdateMask(UPDATETYPE_VALUES, visibleFlag, target, updateMask);
+
+    buf << uint8(updateMask.GetBlockCount());
+    updateMask.AppendToPacket(&buf);
+
+    for (uint32 index = updateMask.FindNextSetBit(0); index < updateMask.GetCount(); index = updateMask.FindNextSetBit(index + 1))
+    {
+        if (IsUpdateFieldTargetDependent(index))
+            entry.TargetDependentFields.push_back(std::make_pair(uint32(buf.wpos()), index));
+
+        buf << GetUpdateFieldValueForTarget(index, target);
+    }
+
+    data->AddUpdateBlock(buf);
+}
+
 void Object::BuildOutOfRangeUpdateBlock(UpdateData* data) const
 {
     data->AddOutOfRangeGUID(GetGUID());
@@ -669,27 +715,39 @@ void Object::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* targe
     if (!target)
         return;
 
-    ByteBuffer fieldBuffer;
     UpdateMask updateMask;
-    updateMask.SetCount(m_valuesCount);
+    BuildValuesUpdateMask(updateType, GetUpdateFieldData(target), target, updateMask);
+
+    *data << uint8(updateMask.GetBlockCount());
+    updateMask.AppendToPacket(data);
 
-    uint32* flags = NULL;
-    uint32 visibleFlag = GetUpdateFieldData(target, flags);
-    ASSERT(flags);
+    for (uint32 index = updateMask.FindNextSetBit(0); index < updateMask.GetCount(); index = updateMask.FindNextSetBit(index + 1))
+        *data << GetUpdateFieldValueForTarget(index, target);
+}
+
+void Object::BuildValuesUpdateMask(uint8 updateType, uint32 visibleFlag, Player const* /*target*/, UpdateMask& updateMask) const
+{
+    UpdateFieldFlagMasks const* flagMasks = GetUpdateFieldFlagMasks();
+    ASSERT(flagMasks);
 
-    for (uint16 index = 0; index < m_valuesCount; ++index)
+    updateMask.SetCount(m_valuesCount);
+    flagMasks->SetFieldsWithFlags(visibleFlag, updateMask);
+    FilterVisibleFields(updateType, updateMask);
+    flagMasks->SetFieldsWithFlags(_fieldNotifyFlags, updateMask);
+}
+
+void Object::FilterVisibleFields(uint8 updateType, UpdateMask& updateMask) const
+{
+    // values updates only send changed fields, create updates only send fields with a value
+    if (updateType == UPDATETYPE_VALUES)
     {
-        if (_fieldNotifyFlags & flags[index] ||
-            ((updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index]) && (flags[index] & visibleFlag)))
-        {
-            updateMask.SetBit(index);
-            fieldBuffer << m_uint32Values[index];
-        }
+        updateMask &= _changesMask;
+        return;
     }
 
-    *data << uint8(updateMask.GetBlockCount());
-    updateMask.AppendToPacket(data);
-    data->append(fieldBuffer);
+    for (uint32 index = updateMask.FindNextSetBit(0); index < updateMask.GetCount(); index = updateMask.FindNextSetBit(index + 1))
+        if (!m_uint32Values[index])
+            updateMask.UnsetBit(index);
 }
 
 void Object::ClearUpdateMask(bool remove)
@@ -699,11 +757,30 @@ void Object::ClearUpdateMask(bool remove)
     if (m_objectUpdated)
     {
         if (remove)
-            sObjectAccessor->RemoveUpdateObject(this);
+            RemoveFromObjectUpdate();
         m_objectUpdated = false;
     }
 }
 
+void Object::AddToObjectUpdateIfNeeded()
+{
+    if (!m_inWorld || m_objectUpdated)
+        return;
+
+    // not flagged without a map, the next changed field tries again
+    if (Map* map = GetObjectUpdateMap())
+    {
+        map->AddUpdateObject(this);
+        m_objectUpdated = true;
+    }
+}
+
+void Object::RemoveFromObjectUpdate()
+{
+    if (Map* map = _updateQueueMap)
+        map->RemoveUpdateObject(this);
+}
+
 void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map) const
 {
     UpdateDataMapType::iterator iter = data_map.find(player);
@@ -718,7 +795,21 @@ void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map) cons
     BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
 }
 
-uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
+void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map, ValuesUpdateBlockCache& cache) const
+{
+    UpdateDataMapType::iterator iter = data_map.find(player);
+
+    if (iter == data_map.end())
+    {
+        std::pair<UpdateDataMapType::iterator, bool> p = data_map.emplace(player, UpdateData(player->GetMapId()));
+        ASSERT(p.second);
+        iter = p.first;
+    }
+
+    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first, cache);
+}
+
+uint32 Object::GetUpdateFieldData(Player const* target) const
 {
     uint32 visibleFlag = UF_FLAG_PUBLIC;
 
@@ -729,7 +820,6 @@ uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
     {
         case TYPEID_ITEM:
         case TYPEID_CONTAINER:
-            flags = ItemUpdateFieldFlags;
             if (((Item const*)this)->GetOwnerGUID() == target->GetGUID())
                 visibleFlag |= UF_FLAG_OWNER | UF_FLAG_ITEM_OWNER;
             break;
@@ -737,7 +827,6 @@ uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
         case TYPEID_PLAYER:
         {
             Player* plr = ToUnit()->GetCharmerOrOwnerPlayerOrPlayerItself();
-            flags = UnitUpdateFieldFlags;
             if (ToUnit()->GetOwnerGUID() == target->GetGUID())
                 visibleFlag |= UF_FLAG_OWNER;
 
@@ -750,23 +839,18 @@ uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
             break;
         }
         case TYPEID_GAMEOBJECT:
-            flags = GameObjectUpdateFieldFlags;
             if (ToGameObject()->GetOwnerGUID() == target->GetGUID())
                 visibleFlag |= UF_FLAG_OWNER;
             break;
         case TYPEID_DYNAMICOBJECT:
-            flags = DynamicObjectUpdateFieldFlags;
             if (ToDynObject()->GetCasterGUID() == target->GetGUID())
                 visibleFlag |= UF_FLAG_OWNER;
             break;
         case TYPEID_CORPSE:
-            flags = CorpseUpdateFieldFlags;
             if (ToCorpse()->GetOwnerGUID() == target->GetGUID())
                 visibleFlag |= UF_FLAG_OWNER;
             break;
         case TYPEID_AREATRIGGER:
-            flags = AreaTriggerUpdateFieldFlags;
-            break;
         case TYPEID_OBJECT:
             break;
     }
@@ -774,6 +858,29 @@ uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
     return visibleFlag;
 }
 
+UpdateFieldFlagMasks const* Object::GetUpdateFieldFlagMasks() const
+{
+    switch (GetTypeId())
+    {
+        case TYPEID_ITEM:
+        case TYPEID_CONTAINER:
+            return &ItemUpdateFieldFlagMasks;
+        case TYPEID_UNIT:
+        case TYPEID_PLAYER:
+            return &UnitUpdateFieldFlagMasks;
+        case TYPEID_GAMEOBJECT:
+            return &GameObjectUpdateFieldFlagMasks;
+        case TYPEID_DYNAMICOBJECT:
+            return &DynamicObjectUpdateFieldFlagMasks;
+        case TYPEID_CORPSE:
+            return &CorpseUpdateFieldFlagMasks;
+        case TYPEID_AREATRIGGER:
+            return &AreaTriggerUpdateFieldFlagMasks;
+        default:
+            return NULL;
+    }
+}
+
 void Object::_LoadIntoDataField(std::string const& data, uint32 startOffset, uint32 count)
 {
     if (data.empty())
@@ -800,11 +907,7 @@ void Object::SetInt32Value(uint16 index, int32 value)
         m_int32Values[index] = value;
         _changesMask.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -817,11 +920,7 @@ void Object::SetUInt32Value(uint16 index, uint32 value)
         m_uint32Values[index] = value;
         _changesMask.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -843,11 +942,7 @@ void Object::SetUInt64Value(uint16 index, uint64 value)
         _changesMask.SetBit(index);
         _changesMask.SetBit(index + 1);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -860,11 +955,7 @@ bool Object::AddGuidValue(uint16 index, ObjectGuid value)
         _changesMask.SetBit(index);
         _changesMask.SetBit(index + 1);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
 
         return true;
     }
@@ -882,11 +973,7 @@ bool Object::RemoveGuidValue(uint16 index, ObjectGuid value)
         _changesMask.SetBit(index);
         _changesMask.SetBit(index + 1);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
 
         return true;
     }
@@ -903,11 +990,7 @@ void Object::SetFloatValue(uint16 index, float value)
         m_floatValues[index] = value;
         _changesMask.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -927,11 +1010,7 @@ void Object::SetByteValue(uint16 index, uint8 offset, uint8 value)
         m_uint32Values[index] |= uint32(uint32(value) << (offset * 8));
         _changesMask.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -951,11 +1030,7 @@ void Object::SetUInt16Value(uint16 index, uint8 offset, uint16 value)
         m_uint32Values[index] |= uint32(uint32(value) << (offset * 16));
         _changesMask.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -968,11 +1043,7 @@ void Object::SetGuidValue(uint16 index, ObjectGuid value)
         _changesMask.SetBit(index);
         _changesMask.SetBit(index + 1);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1042,11 +1113,7 @@ void Object::SetFlag(uint16 index, uint32 newFlag)
         m_uint32Values[index] = newval;
         _changesMask.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1063,11 +1130,7 @@ void Object::RemoveFlag(uint16 index, uint32 oldFlag)
         m_uint32Values[index] = newval;
         _changesMask.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1107,11 +1170,7 @@ void Object::SetByteFlag(uint16 index, uint8 offset, uint8 newFlag)
         m_uint32Values[index] |= uint32(uint32(newFlag) << (offset * 8));
         _changesMask.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1130,11 +1189,7 @@ void Object::RemoveByteFlag(uint16 index, uint8 offset, uint8 oldFlag)
         m_uint32Values[index] &= ~uint32(uint32(oldFlag) << (offset * 8));
         _changesMask.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1931,11 +1986,7 @@ bool WorldObject::CanDetectStealthOf(WorldObject const* obj, bool checkAlert) co
 void Object::ForceValuesUpdateAtIndex(uint32 i)
 {
     _changesMask.SetBit(i);
-    if (m_inWorld && !m_objectUpdated)
-    {
-        sObjectAccessor->AddUpdateObject(this);
-        m_objectUpdated = true;
-    }
+    AddToObjectUpdateIfNeeded();
 }
 
 void WorldObject::SendMessageToSet(WorldPacket* data, bool self)
@@ -2813,6 +2864,7 @@ struct WorldObjectChangeAccumulator
     UpdateDataMapType& i_updateDatas;
     WorldObject& i_object;
     GuidSet plr_list;
+    ValuesUpdateBlockCache i_blockCache;
     WorldObjectChangeAccumulator(WorldObject &obj, UpdateDataMapType &d) : i_updateDatas(d), i_object(obj) { }
     void Visit(PlayerMapType &m)
     {
@@ -2870,7 +2922,7 @@ struct WorldObjectChangeAccumulator
         // Only send update once to a player
         if (plr_list.find(player->GetGUID()) == plr_list.end() && player->HaveAtClient(&i_object))
         {
-            i_object.BuildFieldsUpdate(player, i_updateDatas);
+            i_object.BuildFieldsUpdate(player, i_updateDatas, i_blockCache);
             plr_list.insert(player->GetGUID());
         }
     }
@@ -26,9 +26,11 @@
 #include "ObjectDefines.h"
 #include "Map.h"
 
+#include <atomic>
 #include <set>
 #include <string>
 #include <sstream>
+#include <vector>
 
 #define CONTACT_DISTANCE            0.5f
 #define INTERACTION_DISTANCE        5.0f
@@ -81,17 +83,62 @@ class CreatureAI;
 class DynamicObject;
 class GameObject;
 class InstanceScript;
+class Map;
 class Player;
 class TempSummon;
 class Transport;
 class Unit;
 class UpdateData;
+class UpdateFieldFlagMasks;
 class WorldObject;
 class WorldPacket;
 class ZoneScript;
 
 typedef std::unordered_map<Player*, UpdateData> UpdateDataMapType;
 
+/// Values update blocks of a single object built during one BuildUpdate call.
+/// Receivers with the same visibility flags get the same block, only fields depending on the receiver are rewritten
+class ValuesUpdateBlockCache
+{
+    public:
+        struct Entry
+        {
+            Entry(uint32 visibleFlag) : VisibleFlag(visibleFlag), Block(500) { }
+
+            uint32 VisibleFlag;
+            ByteBuffer Block;
+            std::vector<std::pair<uint32 /*offset*/, uint32 /*field*/>> TargetDependentFields;
+        };
+
+        Entry* Find(uint32 visibleFlag)
+        {
+            for (Entry& entry : _entries)
+                if (entry.VisibleFlag == visibleFlag)
+                    return &entry;
+
+            return NULL;
+        }
+
+        Entry& Add(uint32 visibleFlag)
+        {
+            _entries.emplace_back(visibleFlag);
+            return _entries.back();
+        }
+
+        static uint64 GetBuiltCount() { return _built; }
+        static uint64 GetReusedCount() { return _reused; }
+        static uint64 GetPatchedFieldCount() { return _patchedFields; }
+
+    private:
+        friend class Object;
+
+        std::vector<Entry> _entries;
+
+        static std::atomic<uint64> _built;
+        static std::atomic<uint64> _reused;
+        static std::atomic<uint64> _patchedFields;
+};
+
 class Object
 {
     public:
@@ -120,6 +167,7 @@ class Object
         void SendUpdateToPlayer(Player* player);
 
         void BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const;
+        void BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target, ValuesUpdateBlockCache& cache) const;
         void BuildOutOfRangeUpdateBlock(UpdateData* data) const;
 
         virtual void DestroyForPlayer(Player* target, bool onDeath = false) const;
@@ -178,7 +226,10 @@ class Object
         virtual bool hasQuest(uint32 /* quest_id */) const { return false; }
         virtual bool hasInvolvedQuest(uint32 /* quest_id */) const { return false; }
         virtual void BuildUpdate(UpdateDataMapType&) { }
+        // map whose update queue sends the changed fields of this object, see Map::SendObjectUpdates
+        virtual Map* GetObjectUpdateMap() const { return NULL; }
         void BuildFieldsUpdate(Player*, UpdateDataMapType &) const;
+        void BuildFieldsUpdate(Player*, UpdateDataMapType &, ValuesUpdateBlockCache& cache) const;
 
         void SetFieldNotifyFlag(uint16 flag) { _fieldNotifyFlags |= flag; }
         void RemoveFieldNotifyFlag(uint16 flag) { _fieldNotifyFlags &= uint16(~flag); }
@@ -215,10 +266,19 @@ class Object
         std::string _ConcatFields(uint16 startIndex, uint16 size) const;
         void _LoadIntoDataField(std::string const& data, uint32 startOffset, uint32 count);
 
-        uint32 GetUpdateFieldData(Player const* target, uint32*& flags) const;
+        /// Visibility flags (UF_FLAG_*) of fields target is allowed to see
+        uint32 GetUpdateFieldData(Player const* target) const;
+        UpdateFieldFlagMasks const* GetUpdateFieldFlagMasks() const;
+        /// Removes fields that are not sent for given update type from a mask of visible fields
+        void FilterVisibleFields(uint8 updateType, UpdateMask& updateMask) const;
 
         void BuildMovementUpdate(ByteBuffer* data, uint16 flags) const;
-        virtual void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, Player* target) const;
+        void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, Player* target) const;
+        /// Selects fields sent to target, visibleFlag is the value returned by GetUpdateFieldData for that target
+        virtual void BuildValuesUpdateMask(uint8 updateType, uint32 visibleFlag, Player const* target, UpdateMask& updateMask) const;
+        /// Fields whose sent value can differ between targets with the same visibility flags
+        virtual bool IsUpdateFieldTargetDependent(uint32 /*index*/) const { return false; }
+        virtual uint32 GetUpdateFieldValueForTarget(uint32 index, Player* /*target*/) const { return m_uint32Values[index]; }
 
         uint16 m_objectType;
 
@@ -238,11 +298,19 @@ class Object
 
         uint16 _fieldNotifyFlags;
 
-        bool m_objectUpdated;
+        bool m_objectUpdated;                               // queued in the update queue of a map
+
+        void AddToObjectUpdateIfNeeded();
+        void RemoveFromObjectUpdate();
 
     private:
+        friend class Map;                                   // maintains the update queue slot
+
         bool m_inWorld;
 
+        Map* _updateQueueMap;                               // NULL while not queued, or while the queue is being sent
+        uint32 _updateQueueIndex;
+
         PackedGuid m_PackGUID;
 
         // for output helpfull error messages from asserts
@@ -563,6 +631,7 @@ class WorldObject : public Object, public WorldLocation
         virtual void ResetMap();
         Map* GetMap() const { ASSERT(m_currMap); return m_currMap; }
         Map* FindMap() const { return m_currMap; }
+        Map* GetObjectUpdateMap() const override { return m_currMap; }
         //used to check all object's GetMap() calls when object is not in world!
 
         //this function should be removed in nearest time...
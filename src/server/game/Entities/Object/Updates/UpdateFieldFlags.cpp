@@ -1656,3 +1656,28 @@ uint32 AreaTriggerUpdateFieldFlags[AREATRIGGER_END] =
     UF_FLAG_PUBLIC,                                         // AREATRIGGER_FINAL_POS+1
     UF_FLAG_PUBLIC,                                         // AREATRIGGER_FINAL_POS+2
 };
+
+UpdateFieldFlagMasks::UpdateFieldFlagMasks(uint32 const* flags, uint32 count)
+{
+    for (uint32 flag = 0; flag < UF_FLAG_BIT_COUNT; ++flag)
+    {
+        _masks[flag].SetCount(count);
+        for (uint32 index = 0; index < count; ++index)
+            if (flags[index] & (1 << flag))
+                _masks[flag].SetBit(index);
+    }
+}
+
+void UpdateFieldFlagMasks::SetFieldsWithFlags(uint32 flags, UpdateMask& mask) const
+{
+    for (uint32 flag = 0; flag < UF_FLAG_BIT_COUNT; ++flag)
+        if (flags & (1 << flag))
+            mask |= _masks[flag];
+}
+
+UpdateFieldFlagMasks const ItemUpdateFieldFlagMasks(ItemUpdateFieldFlags, CONTAINER_END);
+UpdateFieldFlagMasks const UnitUpdateFieldFlagMasks(UnitUpdateFieldFlags, PLAYER_END);
+UpdateFieldFlagMasks const GameObjectUpdateFieldFlagMasks(GameObjectUpdateFieldFlags, GAMEOBJECT_END);
+UpdateFieldFlagMasks const DynamicObjectUpdateFieldFlagMasks(DynamicObjectUpdateFieldFlags, DYNAMICOBJECT_END);
+UpdateFieldFlagMasks const CorpseUpdateFieldFlagMasks(CorpseUpdateFieldFlags, CORPSE_END);
+UpdateFieldFlagMasks const AreaTriggerUpdateFieldFlagMasks(AreaTriggerUpdateFieldFlags, AREATRIGGER_END);
@@ -19,6 +19,7 @@
 #define _UPDATEFIELDFLAGS_H
 
 #include "UpdateFields.h"
+#include "UpdateMask.h"
 #include "Define.h"
 
 enum UpdatefieldFlags
@@ -32,7 +33,9 @@ enum UpdatefieldFlags
     UF_FLAG_SPECIAL_INFO = 0x020,
     UF_FLAG_PARTY_MEMBER = 0x040,
     UF_FLAG_UNUSED2      = 0x080,
-    UF_FLAG_DYNAMIC      = 0x100
+    UF_FLAG_DYNAMIC      = 0x100,
+
+    UF_FLAG_BIT_COUNT    = 9
 };
 
 extern uint32 ItemUpdateFieldFlags[CONTAINER_END];
@@ -42,4 +45,24 @@ extern uint32 DynamicObjectUpdateFieldFlags[DYNAMICOBJECT_END];
 extern uint32 CorpseUpdateFieldFlags[CORPSE_END];
 extern uint32 AreaTriggerUpdateFieldFlags[AREATRIGGER_END];
 
+/// Bitmasks of update fields having given visibility flag, used to select fields for values updates one mask block at a time
+class UpdateFieldFlagMasks
+{
+    public:
+        UpdateFieldFlagMasks(uint32 const* flags, uint32 count);
+
+        /// Sets bits of all fields having at least one of the given flags, fields past mask.GetCount() are ignored
+        void SetFieldsWithFlags(uint32 flags, UpdateMask& mask) const;
+
+    private:
+        UpdateMask _masks[UF_FLAG_BIT_COUNT];
+};
+
+extern UpdateFieldFlagMasks const ItemUpdateFieldFlagMasks;
+extern UpdateFieldFlagMasks const UnitUpdateFieldFlagMasks;
+extern UpdateFieldFlagMasks const GameObjectUpdateFieldFlagMasks;
+extern UpdateFieldFlagMasks const DynamicObjectUpdateFieldFlagMasks;
+extern UpdateFieldFlagMasks const CorpseUpdateFieldFlagMasks;
+extern UpdateFieldFlagMasks const AreaTriggerUpdateFieldFlagMasks;
+
 #endif // _UPDATEFIELDFLAGS_H
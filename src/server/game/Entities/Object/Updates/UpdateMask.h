@@ -22,6 +22,11 @@
 #include "UpdateFields.h"
 #include "Errors.h"
 #include "ByteBuffer.h"
+#include <algorithm>
+
+#if COMPILER == COMPILER_MICROSOFT
+#include <intrin.h>
+#endif
 
 class UpdateMask
 {
@@ -34,31 +39,43 @@ class UpdateMask
             CLIENT_UPDATE_MASK_BITS = sizeof(ClientUpdateMaskType) * 8,
         };
 
-        UpdateMask() : _fieldCount(0), _blockCount(0), _bits(NULL) { }
+        UpdateMask() : _fieldCount(0), _blockCount(0), _blocks(NULL) { }
 
-        UpdateMask(UpdateMask const& right) : _bits(NULL)
+        UpdateMask(UpdateMask const& right) : _fieldCount(0), _blockCount(0), _blocks(NULL)
         {
             SetCount(right.GetCount());
-            memcpy(_bits, right._bits, sizeof(uint8) * _blockCount * 32);
+            memcpy(_blocks, right._blocks, sizeof(ClientUpdateMaskType) * _blockCount);
         }
 
-        ~UpdateMask() { delete[] _bits; }
+        ~UpdateMask() { delete[] _blocks; }
 
-        void SetBit(uint32 index) { _bits[index] = 1; }
-        void UnsetBit(uint32 index) { _bits[index] = 0; }
-        bool GetBit(uint32 index) const { return _bits[index] != 0; }
+        void SetBit(uint32 index) { _blocks[index / CLIENT_UPDATE_MASK_BITS] |= ClientUpdateMaskType(1) << (index % CLIENT_UPDATE_MASK_BITS); }
+        void UnsetBit(uint32 index) { _blocks[index / CLIENT_UPDATE_MASK_BITS] &= ~(ClientUpdateMaskType(1) << (index % CLIENT_UPDATE_MASK_BITS)); }
+        bool GetBit(uint32 index) const { return (_blocks[index / CLIENT_UPDATE_MASK_BITS] & (ClientUpdateMaskType(1) << (index % CLIENT_UPDATE_MASK_BITS))) != 0; }
 
-        void AppendToPacket(ByteBuffer* data)
+        /// Returns index of the first set bit at or after index, GetCount() if there is none
+        uint32 FindNextSetBit(uint32 index) const
         {
-            for (uint32 i = 0; i < GetBlockCount(); ++i)
+            uint32 block = index / CLIENT_UPDATE_MASK_BITS;
+            if (block >= _blockCount)
+                return _fieldCount;
+
+            ClientUpdateMaskType bits = _blocks[block] & (~ClientUpdateMaskType(0) << (index % CLIENT_UPDATE_MASK_BITS));
+            while (!bits)
             {
-                ClientUpdateMaskType maskPart = 0;
-                for (uint32 j = 0; j < CLIENT_UPDATE_MASK_BITS; ++j)
-                    if (_bits[CLIENT_UPDATE_MASK_BITS * i + j])
-                        maskPart |= 1 << j;
+                if (++block >= _blockCount)
+                    return _fieldCount;
 
-                *data << maskPart;
+                bits = _blocks[block];
             }
+
+            return block * CLIENT_UPDATE_MASK_BITS + CountTrailingZeroes(bits);
+        }
+
+        void AppendToPacket(ByteBuffer* data)
+        {
+            for (uint32 i = 0; i < GetBlockCount(); ++i)
+                *data << _blocks[i];
         }
 
         uint32 GetBlockCount() const { return _blockCount; }
@@ -66,19 +83,19 @@ class UpdateMask
 
         void SetCount(uint32 valuesCount)
         {
-            delete[] _bits;
+            delete[] _blocks;
 
             _fieldCount = valuesCount;
             _blockCount = (valuesCount + CLIENT_UPDATE_MASK_BITS - 1) / CLIENT_UPDATE_MASK_BITS;
 
-            _bits = new uint8[_blockCount * CLIENT_UPDATE_MASK_BITS];
-            memset(_bits, 0, sizeof(uint8) * _blockCount * CLIENT_UPDATE_MASK_BITS);
+            _blocks = new ClientUpdateMaskType[_blockCount];
+            memset(_blocks, 0, sizeof(ClientUpdateMaskType) * _blockCount);
         }
 
         void Clear()
         {
-            if (_bits)
-                memset(_bits, 0, sizeof(uint8) * _blockCount * CLIENT_UPDATE_MASK_BITS);
+            if (_blocks)
+                memset(_blocks, 0, sizeof(ClientUpdateMaskType) * _blockCount);
         }
 
         UpdateMask& operator=(UpdateMask const& right)
@@ -87,25 +104,32 @@ class UpdateMask
                 return *this;
 
             SetCount(right.GetCount());
-            memcpy(_bits, right._bits, sizeof(uint8) * _blockCount * CLIENT_UPDATE_MASK_BITS);
+            memcpy(_blocks, right._blocks, sizeof(ClientUpdateMaskType) * _blockCount);
             return *this;
         }
 
+        /// Masks may have different sizes, fields missing in right are treated as not set
         UpdateMask& operator&=(UpdateMask const& right)
         {
-            ASSERT(right.GetCount() <= GetCount());
-            for (uint32 i = 0; i < _fieldCount; ++i)
-                _bits[i] &= right._bits[i];
+            uint32 blockCount = std::min(_blockCount, right._blockCount);
+            for (uint32 i = 0; i < blockCount; ++i)
+                _blocks[i] &= right._blocks[i];
 
+            for (uint32 i = blockCount; i < _blockCount; ++i)
+                _blocks[i] = 0;
+
+            ClearUnusedBits();
             return *this;
         }
 
+        /// Masks may have different sizes, fields of right past GetCount() are ignored
         UpdateMask& operator|=(UpdateMask const& right)
         {
-            ASSERT(right.GetCount() <= GetCount());
-            for (uint32 i = 0; i < _fieldCount; ++i)
-                _bits[i] |= right._bits[i];
+            uint32 blockCount = std::min(_blockCount, right._blockCount);
+            for (uint32 i = 0; i < blockCount; ++i)
+                _blocks[i] |= right._blocks[i];
 
+            ClearUnusedBits();
             return *this;
         }
 
@@ -117,9 +141,36 @@ class UpdateMask
         }
 
     private:
+        /// keeps bits past _fieldCount zeroed, FindNextSetBit relies on it
+        void ClearUnusedBits()
+        {
+            if (uint32 usedBits = _fieldCount % CLIENT_UPDATE_MASK_BITS)
+                _blocks[_blockCount - 1] &= ~(~ClientUpdateMaskType(0) << usedBits);
+        }
+
+        static uint32 CountTrailingZeroes(ClientUpdateMaskType bits)
+        {
+#if COMPILER == COMPILER_GNU
+            return __builtin_ctz(bits);
+#elif COMPILER == COMPILER_MICROSOFT
+            unsigned long index;
+            _BitScanForward(&index, bits);
+            return index;
+#else
+            uint32 index = 0;
+            while (!(bits & 1))
+            {
+                bits >>= 1;
+                ++index;
+            }
+
+            return index;
+#endif
+        }
+
         uint32 _fieldCount;
         uint32 _blockCount;
-        uint8* _bits;
+        ClientUpdateMaskType* _blocks;
 };
 
 #endif
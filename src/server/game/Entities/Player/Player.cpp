@@ -81,7 +81,7 @@
 #include "World.h"
 #include "WorldPacket.h"
 #include "WorldSession.h"
-#include "MovementStructures.h"
+#include "MovementStatusCodec.h"
 #include "GameObjectAI.h"
 
 #define ZONE_UPDATE_INTERVAL (1*IN_MILLISECONDS)
@@ -718,6 +718,11 @@ Player::Player(WorldSession* session): Unit(true)
     m_needsZoneUpdate = false;
 
     m_nextSave = sWorld->getIntConfig(CONFIG_INTERVAL_SAVE);
+    m_autoSaveSlot = std::numeric_limits<uint32>::max();
+    m_saveSectionsChanged = PLAYER_SAVE_SECTION_ALL;
+    m_savedBGDataHash = 0;
+    m_savedAurasHash = 0;
+    m_savedStatsHash = 0;
 
     _resurrectionData = NULL;
 
@@ -956,6 +961,9 @@ Player::~Player()
 
     ClearResurrectRequestData();
 
+    if (m_autoSaveSlot != std::numeric_limits<uint32>::max())
+        sWorld->ReleaseAutoSaveSlot(m_autoSaveSlot);
+
     sWorld->DecreasePlayerCount();
 }
 
@@ -1808,7 +1816,7 @@ void Player::Update(uint32 p_time)
         if (p_time >= m_nextSave)
         {
             // m_nextSave reset in SaveToDB call
-            SaveToDB();
+            SaveToDB(false, true);
             TC_LOG_DEBUG("entities.player", "Player '%s' (GUID: %u) saved", GetName().c_str(), GetGUIDLow());
         }
         else
@@ -1868,7 +1876,10 @@ void Player::Update(uint32 p_time)
         for (InstanceTimeMap::iterator itr = _instanceResetTimes.begin(); itr != _instanceResetTimes.end();)
         {
             if (itr->second < now)
+            {
                 _instanceResetTimes.erase(itr++);
+                SetSaveSectionChanged(PLAYER_SAVE_SECTION_INSTANCE_TIMES);
+            }
             else
                 ++itr;
         }
@@ -17576,9 +17587,11 @@ bool Player::LoadFromDB(ObjectGuid guid, SQLQueryHolder *holder)
     SetMap(map);
     StoreRaidMapDifficulty();
 
-    // randomize first save time in range [CONFIG_INTERVAL_SAVE] around [CONFIG_INTERVAL_SAVE]
-    // this must help in case next save after mass player load after server startup
-    m_nextSave = urand(m_nextSave/2, m_nextSave*3/2);
+    // spread autosaves evenly over CONFIG_INTERVAL_SAVE, random delays still bunch up
+    // after a mass player load at server startup
+    if (m_autoSaveSlot == std::numeric_limits<uint32>::max())
+        m_autoSaveSlot = sWorld->AssignAutoSaveSlot();
+    m_nextSave = sWorld->GetAutoSaveDelay(m_autoSaveSlot);
 
     SaveRecallPosition();
 
@@ -19246,7 +19259,10 @@ bool Player::CheckInstanceCount(uint32 instanceId) const
 void Player::AddInstanceEnterTime(uint32 instanceId, time_t enterTime)
 {
     if (_instanceResetTimes.find(instanceId) == _instanceResetTimes.end())
+    {
         _instanceResetTimes.insert(InstanceTimeMap::value_type(instanceId, enterTime + HOUR));
+        SetSaveSectionChanged(PLAYER_SAVE_SECTION_INSTANCE_TIMES);
+    }
 }
 
 bool Player::_LoadHomeBind(PreparedQueryResult result)
@@ -19313,10 +19329,13 @@ bool Player::_LoadHomeBind(PreparedQueryResult result)
 /***                   SAVE SYSTEM                     ***/
 /*********************************************************/
 
-void Player::SaveToDB(bool create /*=false*/)
+void Player::SaveToDB(bool create /*=false*/, bool autosave /*=false*/)
 {
-    // delay auto save at any saves (manual, in code, or autosave)
-    m_nextSave = sWorld->getIntConfig(CONFIG_INTERVAL_SAVE);
+    // delay auto save at any saves (manual, in code, or autosave), keeping it in the assigned slot
+    if (m_autoSaveSlot != std::numeric_limits<uint32>::max())
+        m_nextSave = sWorld->GetAutoSaveDelay(m_autoSaveSlot);
+    else
+        m_nextSave = sWorld->getIntConfig(CONFIG_INTERVAL_SAVE);
 
     //lets allow only players in world to be saved
     if (IsBeingTeleportedFar())
@@ -19596,9 +19615,14 @@ void Player::SaveToDB(bool create /*=false*/)
     if (m_mailsUpdated)                                     //save mails only when needed
         _SaveMail(trans);
 
-    _SaveBGData(trans);
+    // sections that are rewritten as a whole are skipped when unchanged,
+    // everything else only writes the elements marked as changed
+    uint32 skippedSections = 0;
+    if (!_SaveBGData(trans))
+        ++skippedSections;
     _SaveInventory(trans);
-    _SaveVoidStorage(trans);
+    if (!_SaveVoidStorage(trans))
+        ++skippedSections;
     _SaveQuestStatus(trans);
     _SaveDailyQuestStatus(trans);
     _SaveWeeklyQuestStatus(trans);
@@ -19606,23 +19630,41 @@ void Player::SaveToDB(bool create /*=false*/)
     _SaveMonthlyQuestStatus(trans);
     _SaveTalents(trans);
     _SaveSpells(trans);
-    GetSpellHistory()->SaveToDB<Player>(trans);
+    if (GetSpellHistory()->HasUnsavedCooldowns())
+        GetSpellHistory()->SaveToDB<Player>(trans);
+    else
+        ++skippedSections;
     _SaveActions(trans);
-    _SaveAuras(trans);
+    if (!_SaveAuras(trans, !autosave))
+        ++skippedSections;
     _SaveSkills(trans);
     m_achievementMgr->SaveToDB(trans);
     m_reputationMgr->SaveToDB(trans);
     _SaveEquipmentSets(trans);
     GetSession()->SaveTutorialsData(trans);                 // changed only while character in game
-    _SaveGlyphs(trans);
-    _SaveInstanceTimeRestrictions(trans);
+    if (!_SaveGlyphs(trans))
+        ++skippedSections;
+    if (!_SaveInstanceTimeRestrictions(trans))
+        ++skippedSections;
     _SaveCurrency(trans);
-    _SaveCUFProfiles(trans);
+    if (!_SaveCUFProfiles(trans))
+        ++skippedSections;
 
     // check if stats should only be saved on logout
     // save stats can be out of transaction
     if (m_session->isLogingOut() || !sWorld->getBoolConfig(CONFIG_STATS_SAVE_ONLY_ON_LOGOUT))
-        _SaveStats(trans);
+        if (!_SaveStats(trans))
+            ++skippedSections;
+
+    PlayerSaveStats& stats = GetSaveStats(autosave);
+    uint32 statements = uint32(trans->GetSize());
+    ++stats.Saves;
+    stats.Statements += statements;
+    stats.Bytes += trans->GetDataSize();
+    stats.SkippedSections += skippedSections;
+    uint32 maxStatements = stats.MaxStatements.load(std::memory_order_relaxed);
+    while (statements > maxStatements && !stats.MaxStatements.compare_exchange_weak(maxStatements, statements, std::memory_order_relaxed))
+        ;
 
     CharacterDatabase.CommitTransaction(trans);
 
@@ -19631,6 +19673,13 @@ void Player::SaveToDB(bool create /*=false*/)
         pet->SavePetToDB(PET_SAVE_AS_CURRENT);
 }
 
+static PlayerSaveStats SaveStats[2];
+
+PlayerSaveStats& Player::GetSaveStats(bool autosave)
+{
+    return SaveStats[autosave ? 1 : 0];
+}
+
 // fast save function for item/money cheating preventing - save only inventory and money state
 void Player::SaveInventoryAndGoldToDB(SQLTransaction& trans)
 {
@@ -19695,12 +19744,14 @@ void Player::_SaveActions(SQLTransaction& trans)
     }
 }
 
-void Player::_SaveAuras(SQLTransaction& trans)
+bool Player::_SaveAuras(SQLTransaction& trans, bool force)
 {
-    PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHAR_AURA);
-    stmt->setUInt32(0, GetGUIDLow());
-    trans->Append(stmt);
+    // remaining durations change all the time, unless forced the auras are only rewritten
+    // when the parameters of any row other than the remaining duration changed
+    std::vector<PreparedStatement*> statements;
+    uint64 hash = UI64LIT(14695981039346656037);            // never matches the initial m_savedAurasHash, even without auras
 
+    PreparedStatement* stmt = NULL;
     for (AuraMap::const_iterator itr = m_ownedAuras.begin(); itr != m_ownedAuras.end(); ++itr)
     {
         if (!itr->second->CanBeSaved())
@@ -19745,10 +19796,31 @@ void Player::_SaveAuras(SQLTransaction& trans)
         stmt->setInt32(index++, baseDamage[1]);
         stmt->setInt32(index++, baseDamage[2]);
         stmt->setInt32(index++, itr->second->GetMaxDuration());
-        stmt->setInt32(index++, itr->second->GetDuration());
+        stmt->setInt32(index++, 0);
         stmt->setUInt8(index, itr->second->GetCharges());
-        trans->Append(stmt);
+        hash = hash * UI64LIT(31) + stmt->GetParametersHash();
+
+        stmt->setInt32(index - 1, itr->second->GetDuration());
+        statements.push_back(stmt);
     }
+
+    if (!force && hash == m_savedAurasHash)
+    {
+        for (PreparedStatement* unchanged : statements)
+            delete unchanged;
+        return false;
+    }
+
+    m_savedAurasHash = hash;
+
+    stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHAR_AURA);
+    stmt->setUInt32(0, GetGUIDLow());
+    trans->Append(stmt);
+
+    for (PreparedStatement* aura : statements)
+        trans->Append(aura);
+
+    return true;
 }
 
 void Player::_SaveInventory(SQLTransaction& trans)
@@ -19871,13 +19943,19 @@ void Player::_SaveInventory(SQLTransaction& trans)
     m_itemUpdateQueue.clear();
 }
 
-void Player::_SaveVoidStorage(SQLTransaction& trans)
+bool Player::_SaveVoidStorage(SQLTransaction& trans)
 {
+    if (_voidStorageChangedSlots.none())
+        return false;
+
     PreparedStatement* stmt = NULL;
     uint32 lowGuid = GetGUIDLow();
 
     for (uint8 i = 0; i < VOID_STORAGE_MAX_SLOT; ++i)
     {
+        if (!_voidStorageChangedSlots[i])
+            continue;
+
         if (!_voidStorageItems[i]) // unused item
         {
             // DELETE FROM void_storage WHERE slot = ? AND playerGuid = ?
@@ -19900,11 +19978,17 @@ void Player::_SaveVoidStorage(SQLTransaction& trans)
 
         trans->Append(stmt);
     }
+
+    _voidStorageChangedSlots.reset();
+    return true;
 }
 
 
-void Player::_SaveCUFProfiles(SQLTransaction& trans)
+bool Player::_SaveCUFProfiles(SQLTransaction& trans)
 {
+    if (!(m_saveSectionsChanged & PLAYER_SAVE_SECTION_CUF_PROFILES))
+        return false;
+
     PreparedStatement* stmt = NULL;
     uint32 lowGuid = GetGUIDLow();
 
@@ -19939,6 +20023,9 @@ void Player::_SaveCUFProfiles(SQLTransaction& trans)
 
         trans->Append(stmt);
     }
+
+    m_saveSectionsChanged &= ~PLAYER_SAVE_SECTION_CUF_PROFILES;
+    return true;
 }
 
 
@@ -20299,21 +20386,15 @@ void Player::_SaveSpells(SQLTransaction& trans)
 
 // save player stats -- only for external usage
 // real stats will be recalculated on player login
-void Player::_SaveStats(SQLTransaction& trans)
+bool Player::_SaveStats(SQLTransaction& trans)
 {
     // check if stat saving is enabled and if char level is high enough
     if (!sWorld->getIntConfig(CONFIG_MIN_LEVEL_STAT_SAVE) || getLevel() < sWorld->getIntConfig(CONFIG_MIN_LEVEL_STAT_SAVE))
-        return;
-
-    PreparedStatement* stmt = NULL;
-
-    stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHAR_STATS);
-    stmt->setUInt32(0, GetGUIDLow());
-    trans->Append(stmt);
+        return false;
 
     uint8 index = 0;
 
-    stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_CHAR_STATS);
+    PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_CHAR_STATS);
     stmt->setUInt32(index++, GetGUIDLow());
     stmt->setUInt32(index++, GetMaxHealth());
 
@@ -20337,7 +20418,20 @@ void Player::_SaveStats(SQLTransaction& trans)
     stmt->setUInt32(index++, GetBaseSpellPowerBonus());
     stmt->setUInt32(index++, GetUInt32Value(PLAYER_FIELD_COMBAT_RATING_1 + CR_RESILIENCE_PLAYER_DAMAGE_TAKEN));
 
+    uint64 hash = stmt->GetParametersHash();
+    if (hash == m_savedStatsHash)
+    {
+        delete stmt;
+        return false;
+    }
+
+    m_savedStatsHash = hash;
+
+    PreparedStatement* del = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHAR_STATS);
+    del->setUInt32(0, GetGUIDLow());
+    trans->Append(del);
     trans->Append(stmt);
+    return true;
 }
 
 void Player::outDebugValues() const
@@ -24817,6 +24911,7 @@ void Player::SetGlyph(uint8 slot, uint32 glyph)
 {
     _talentMgr->SpecInfo[GetActiveSpec()].Glyphs[slot] = glyph;
     SetUInt32Value(PLAYER_FIELD_GLYPHS_1 + slot, glyph);
+    SetSaveSectionChanged(PLAYER_SAVE_SECTION_GLYPHS);
 }
 
 bool Player::isTotalImmune()
@@ -26193,13 +26288,10 @@ void Player::_SaveEquipmentSets(SQLTransaction& trans)
     }
 }
 
-void Player::_SaveBGData(SQLTransaction& trans)
+bool Player::_SaveBGData(SQLTransaction& trans)
 {
-    PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_PLAYER_BGDATA);
-    stmt->setUInt32(0, GetGUIDLow());
-    trans->Append(stmt);
     /* guid, bgInstanceID, bgTeam, x, y, z, o, map, taxi[0], taxi[1], mountSpell */
-    stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_PLAYER_BGDATA);
+    PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_PLAYER_BGDATA);
     stmt->setUInt32(0, GetGUIDLow());
     stmt->setUInt32(1, m_bgData.bgInstanceID);
     stmt->setUInt16(2, m_bgData.bgTeam);
@@ -26211,7 +26303,22 @@ void Player::_SaveBGData(SQLTransaction& trans)
     stmt->setUInt16(8, m_bgData.taxiPath[0]);
     stmt->setUInt16(9, m_bgData.taxiPath[1]);
     stmt->setUInt16(10, m_bgData.mountSpell);
+
+    // m_bgData is modified from too many places to mark it, compare with the last written row instead
+    uint64 hash = stmt->GetParametersHash();
+    if (hash == m_savedBGDataHash)
+    {
+        delete stmt;
+        return false;
+    }
+
+    m_savedBGDataHash = hash;
+
+    PreparedStatement* del = CharacterDatabase.GetPreparedStatement(CHAR_DEL_PLAYER_BGDATA);
+    del->setUInt32(0, GetGUIDLow());
+    trans->Append(del);
     trans->Append(stmt);
+    return true;
 }
 
 void Player::DeleteEquipmentSet(uint64 setGuid)
@@ -26282,8 +26389,11 @@ void Player::_LoadGlyphs(PreparedQueryResult result)
     while (result->NextRow());
 }
 
-void Player::_SaveGlyphs(SQLTransaction& trans)
+bool Player::_SaveGlyphs(SQLTransaction& trans)
 {
+    if (!(m_saveSectionsChanged & PLAYER_SAVE_SECTION_GLYPHS))
+        return false;
+
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHAR_GLYPHS);
     stmt->setUInt32(0, GetGUIDLow());
     trans->Append(stmt);
@@ -26303,6 +26413,9 @@ void Player::_SaveGlyphs(SQLTransaction& trans)
 
         trans->Append(stmt);
     }
+
+    m_saveSectionsChanged &= ~PLAYER_SAVE_SECTION_GLYPHS;
+    return true;
 }
 
 void Player::_LoadTalents(PreparedQueryResult result)
@@ -26952,10 +27065,10 @@ void Player::_LoadInstanceTimeRestrictions(PreparedQueryResult result)
     } while (result->NextRow());
 }
 
-void Player::_SaveInstanceTimeRestrictions(SQLTransaction& trans)
+bool Player::_SaveInstanceTimeRestrictions(SQLTransaction& trans)
 {
-    if (_instanceResetTimes.empty())
-        return;
+    if (!(m_saveSectionsChanged & PLAYER_SAVE_SECTION_INSTANCE_TIMES) || _instanceResetTimes.empty())
+        return false;
 
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_ACCOUNT_INSTANCE_LOCK_TIMES);
     stmt->setUInt32(0, GetSession()->GetAccountId());
@@ -26969,6 +27082,9 @@ void Player::_SaveInstanceTimeRestrictions(SQLTransaction& trans)
         stmt->setUInt64(2, itr->second);
         trans->Append(stmt);
     }
+
+    m_saveSectionsChanged &= ~PLAYER_SAVE_SECTION_INSTANCE_TIMES;
+    return true;
 }
 
 bool Player::IsInWhisperWhiteList(ObjectGuid guid)
@@ -27012,6 +27128,7 @@ uint8 Player::AddVoidStorageItem(const VoidStorageItem& item)
 
     _voidStorageItems[slot] = new VoidStorageItem(item.ItemId, item.ItemEntry,
         item.CreatorGuid, item.ItemRandomPropertyId, item.ItemSuffixFactor);
+    _voidStorageChangedSlots.set(slot);
     return slot;
 }
 
@@ -27032,6 +27149,7 @@ void Player::AddVoidStorageItemAtSlot(uint8 slot, const VoidStorageItem& item)
 
     _voidStorageItems[slot] = new VoidStorageItem(item.ItemId, item.ItemId,
         item.CreatorGuid, item.ItemRandomPropertyId, item.ItemSuffixFactor);
+    _voidStorageChangedSlots.set(slot);
 }
 
 void Player::DeleteVoidStorageItem(uint8 slot)
@@ -27044,6 +27162,7 @@ void Player::DeleteVoidStorageItem(uint8 slot)
 
     delete _voidStorageItems[slot];
     _voidStorageItems[slot] = NULL;
+    _voidStorageChangedSlots.set(slot);
 }
 
 bool Player::SwapVoidStorageItem(uint8 oldSlot, uint8 newSlot)
@@ -27052,6 +27171,8 @@ bool Player::SwapVoidStorageItem(uint8 oldSlot, uint8 newSlot)
         return false;
 
     std::swap(_voidStorageItems[newSlot], _voidStorageItems[oldSlot]);
+    _voidStorageChangedSlots.set(newSlot);
+    _voidStorageChangedSlots.set(oldSlot);
     return true;
 }
 
@@ -27281,218 +27402,19 @@ bool Player::CanUseMastery() const
 
 void Player::ReadMovementInfo(WorldPacket& data, MovementInfo* mi, Movement::ExtraMovementStatusElement* extras /*= NULL*/)
 {
-    MovementStatusElements const* sequence = GetMovementStatusElementsSequence(data.GetOpcode());
-    if (!sequence)
+    Movement::MovementStatusCodec const* codec = Movement::GetMovementStatusCodec(data.GetOpcode());
+    if (!codec)
     {
         TC_LOG_ERROR("network", "Player::ReadMovementInfo: No movement sequence found for opcode %s", GetOpcodeNameForLogging(data.GetOpcode()).c_str());
         return;
     }
 
-    bool hasMovementFlags = false;
-    bool hasMovementFlags2 = false;
-    bool hasTimestamp = false;
-    bool hasOrientation = false;
-    bool hasTransportData = false;
-    bool hasTransportTime2 = false;
-    bool hasTransportVehicleId = false;
-    bool hasPitch = false;
-    bool hasFallData = false;
-    bool hasFallDirection = false;
-    bool hasSplineElevation = false;
-
-    ObjectGuid guid;
-    ObjectGuid tguid;
-
-    for (; *sequence != MSEEnd; ++sequence)
-    {
-        MovementStatusElements const& element = *sequence;
-
-        switch (element)
-        {
-            case MSEHasGuidByte0:
-            case MSEHasGuidByte1:
-            case MSEHasGuidByte2:
-            case MSEHasGuidByte3:
-            case MSEHasGuidByte4:
-            case MSEHasGuidByte5:
-            case MSEHasGuidByte6:
-            case MSEHasGuidByte7:
-                guid[element - MSEHasGuidByte0] = data.ReadBit();
-                break;
-            case MSEHasTransportGuidByte0:
-            case MSEHasTransportGuidByte1:
-            case MSEHasTransportGuidByte2:
-            case MSEHasTransportGuidByte3:
-            case MSEHasTransportGuidByte4:
-            case MSEHasTransportGuidByte5:
-            case MSEHasTransportGuidByte6:
-            case MSEHasTransportGuidByte7:
-                if (hasTransportData)
-                    tguid[element - MSEHasTransportGuidByte0] = data.ReadBit();
-                break;
-            case MSEGuidByte0:
-            case MSEGuidByte1:
-            case MSEGuidByte2:
-            case MSEGuidByte3:
-            case MSEGuidByte4:
-            case MSEGuidByte5:
-            case MSEGuidByte6:
-            case MSEGuidByte7:
-                data.ReadByteSeq(guid[element - MSEGuidByte0]);
-                break;
-            case MSETransportGuidByte0:
-            case MSETransportGuidByte1:
-            case MSETransportGuidByte2:
-            case MSETransportGuidByte3:
-            case MSETransportGuidByte4:
-            case MSETransportGuidByte5:
-            case MSETransportGuidByte6:
-            case MSETransportGuidByte7:
-                if (hasTransportData)
-                    data.ReadByteSeq(tguid[element - MSETransportGuidByte0]);
-                break;
-            case MSEHasMovementFlags:
-                hasMovementFlags = !data.ReadBit();
-                break;
-            case MSEHasMovementFlags2:
-                hasMovementFlags2 = !data.ReadBit();
-                break;
-            case MSEHasTimestamp:
-                hasTimestamp = !data.ReadBit();
-                break;
-            case MSEHasOrientation:
-                hasOrientation = !data.ReadBit();
-                break;
-            case MSEHasTransportData:
-                hasTransportData = data.ReadBit();
-                break;
-            case MSEHasTransportTime2:
-                if (hasTransportData)
-                    hasTransportTime2 = data.ReadBit();
-                break;
-            case MSEHasTransportTime3:
-                if (hasTransportData)
-                    hasTransportVehicleId = data.ReadBit();
-                break;
-            case MSEHasPitch:
-                hasPitch = !data.ReadBit();
-                break;
-            case MSEHasFallData:
-                hasFallData = data.ReadBit();
-                break;
-            case MSEHasFallDirection:
-                if (hasFallData)
-                    hasFallDirection = data.ReadBit();
-                break;
-            case MSEHasSplineElevation:
-                hasSplineElevation = !data.ReadBit();
-                break;
-            case MSEHasSpline:
-                data.ReadBit();
-                break;
-            case MSEMovementFlags:
-                if (hasMovementFlags)
-                    mi->flags = data.ReadBits(30);
-                break;
-            case MSEMovementFlags2:
-                if (hasMovementFlags2)
-                    mi->flags2 = data.ReadBits(12);
-                break;
-            case MSETimestamp:
-                if (hasTimestamp)
-                    data >> mi->time;
-                break;
-            case MSEPositionX:
-                data >> mi->pos.m_positionX;
-                break;
-            case MSEPositionY:
-                data >> mi->pos.m_positionY;
-                break;
-            case MSEPositionZ:
-                data >> mi->pos.m_positionZ;
-                break;
-            case MSEOrientation:
-                if (hasOrientation)
-                    mi->pos.SetOrientation(data.read<float>());
-                break;
-            case MSETransportPositionX:
-                if (hasTransportData)
-                    data >> mi->transport.pos.m_positionX;
-                break;
-            case MSETransportPositionY:
-                if (hasTransportData)
-                    data >> mi->transport.pos.m_positionY;
-                break;
-            case MSETransportPositionZ:
-                if (hasTransportData)
-                    data >> mi->transport.pos.m_positionZ;
-                break;
-            case MSETransportOrientation:
-                if (hasTransportData)
-                    mi->transport.pos.SetOrientation(data.read<float>());
-                break;
-            case MSETransportSeat:
-                if (hasTransportData)
-                    data >> mi->transport.seat;
-                break;
-            case MSETransportTime:
-                if (hasTransportData)
-                    data >> mi->transport.time;
-                break;
-            case MSETransportTime2:
-                if (hasTransportData && hasTransportTime2)
-                    data >> mi->transport.time2;
-                break;
-            case MSETransportVehicleId:
-                if (hasTransportData && hasTransportVehicleId)
-                    data >> mi->transport.vehicleId;
-                break;
-            case MSEPitch:
-                if (hasPitch)
-                    mi->pitch = G3D::wrap(data.read<float>(), float(-M_PI), float(M_PI));
-                break;
-            case MSEFallTime:
-                if (hasFallData)
-                    data >> mi->jump.fallTime;
-                break;
-            case MSEFallVerticalSpeed:
-                if (hasFallData)
-                    data >> mi->jump.zspeed;
-                break;
-            case MSEFallCosAngle:
-                if (hasFallData && hasFallDirection)
-                    data >> mi->jump.cosAngle;
-                break;
-            case MSEFallSinAngle:
-                if (hasFallData && hasFallDirection)
-                    data >> mi->jump.sinAngle;
-                break;
-            case MSEFallHorizontalSpeed:
-                if (hasFallData && hasFallDirection)
-                    data >> mi->jump.xyspeed;
-                break;
-            case MSESplineElevation:
-                if (hasSplineElevation)
-                    data >> mi->splineElevation;
-                break;
-            case MSECounter:
-                data.read_skip<uint32>();   /// @TODO: Maybe compare it with m_movementCounter to verify that packets are sent & received in order?
-                break;
-            case MSEZeroBit:
-            case MSEOneBit:
-                data.ReadBit();
-                break;
-            case MSEExtraElement:
-                extras->ReadNextElement(data);
-                break;
-            default:
-                ASSERT(Movement::PrintInvalidSequenceElement(element, __FUNCTION__));
-                break;
-        }
-    }
+    Movement::MovementStatusState state;
+    codec->Read(data, *mi, state, extras);
 
-    mi->guid = guid;
-    mi->transport.guid = tguid;
+    bool hasFallData = state.Has(Movement::MSS_HAS_FALL_DATA);
+    bool hasFallDirection = state.Has(Movement::MSS_HAS_FALL_DIRECTION);
+    bool hasSplineElevation = state.Has(Movement::MSS_HAS_SPLINE_ELEVATION);
 
     //! Anti-cheat checks. Please keep them in seperate if () blocks to maintain a clear overview.
     //! Might be subject to latency, so just remove improper flags.
@@ -31,6 +31,8 @@
 #include "Opcodes.h"
 #include "WorldSession.h"
 
+#include <atomic>
+#include <bitset>
 #include <limits>
 #include <string>
 #include <vector>
@@ -911,6 +913,36 @@ enum PlayerDelayedOperations
     DELAYED_END
 };
 
+/// Parts of the character that SaveToDB rewrites as a whole, they are only written after being marked as changed
+enum PlayerSaveSection
+{
+    PLAYER_SAVE_SECTION_GLYPHS          = 0x01,
+    PLAYER_SAVE_SECTION_INSTANCE_TIMES  = 0x02,
+    PLAYER_SAVE_SECTION_CUF_PROFILES    = 0x04,
+    PLAYER_SAVE_SECTION_ALL             = 0x07
+};
+
+/// Statements and bytes written by Player::SaveToDB, autosaves and other saves are counted separately
+struct PlayerSaveStats
+{
+    PlayerSaveStats() { Reset(); }
+
+    void Reset()
+    {
+        Saves = 0;
+        Statements = 0;
+        Bytes = 0;
+        MaxStatements = 0;
+        SkippedSections = 0;
+    }
+
+    std::atomic<uint64> Saves;
+    std::atomic<uint64> Statements;
+    std::atomic<uint64> Bytes;
+    std::atomic<uint32> MaxStatements;
+    std::atomic<uint64> SkippedSections;                    ///< Unchanged sections that were not rewritten
+};
+
 // Player summoning auto-decline time (in secs)
 #define MAX_PLAYER_SUMMON_DELAY                   (2*MINUTE)
 // Maximum money amount : 2^31 - 1
@@ -1646,7 +1678,7 @@ class Player : public Unit, public GridObject<Player>
         void AddTimedQuest(uint32 questId) { m_timedquests.insert(questId); }
         void RemoveTimedQuest(uint32 questId) { m_timedquests.erase(questId); }
 
-        void SaveCUFProfile(uint8 id, CUFProfile* profile) { delete _CUFProfiles[id]; _CUFProfiles[id] = profile; } ///> Replaces a CUF profile at position 0-4
+        void SaveCUFProfile(uint8 id, CUFProfile* profile) { delete _CUFProfiles[id]; _CUFProfiles[id] = profile; SetSaveSectionChanged(PLAYER_SAVE_SECTION_CUF_PROFILES); } ///> Replaces a CUF profile at position 0-4
         CUFProfile* GetCUFProfile(uint8 id) const { return _CUFProfiles[id]; } ///> Retrieves a CUF profile at position 0-4
         uint8 GetCUFProfilesCount() const
         {
@@ -1682,7 +1714,8 @@ class Player : public Unit, public GridObject<Player>
         /***                   SAVE SYSTEM                     ***/
         /*********************************************************/
 
-        void SaveToDB(bool create = false);
+        /// Autosaves skip auras whose remaining duration is the only change, other saves write them
+        void SaveToDB(bool create = false, bool autosave = false);
         void SaveInventoryAndGoldToDB(SQLTransaction& trans);                    // fast save function for item/money cheating preventing
         void SaveGoldToDB(SQLTransaction& trans);
 
@@ -1698,6 +1731,9 @@ class Player : public Unit, public GridObject<Player>
         bool m_mailsLoaded;
         bool m_mailsUpdated;
 
+        void SetSaveSectionChanged(PlayerSaveSection section) { m_saveSectionsChanged |= section; }
+        static PlayerSaveStats& GetSaveStats(bool autosave);
+
         void SetBindPoint(ObjectGuid guid);
         void SendTalentWipeConfirm(ObjectGuid guid);
         void ResetPetTalents();
@@ -1813,7 +1849,7 @@ class Player : public Unit, public GridObject<Player>
         uint8 GetActiveSpec() const { return _talentMgr->ActiveSpec; }
         void SetActiveSpec(uint8 spec){ _talentMgr->ActiveSpec = spec; }
         uint8 GetSpecsCount() const { return _talentMgr->SpecsCount; }
-        void SetSpecsCount(uint8 count) { _talentMgr->SpecsCount = count; }
+        void SetSpecsCount(uint8 count) { _talentMgr->SpecsCount = count; SetSaveSectionChanged(PLAYER_SAVE_SECTION_GLYPHS); }
 
         bool ResetTalents(bool no_cost = false);
         uint32 GetNextResetTalentsCost() const;
@@ -2624,10 +2660,11 @@ class Player : public Unit, public GridObject<Player>
         /***                   SAVE SYSTEM                     ***/
         /*********************************************************/
 
+        // functions returning bool return false when the section did not change and nothing was written
         void _SaveActions(SQLTransaction& trans);
-        void _SaveAuras(SQLTransaction& trans);
+        bool _SaveAuras(SQLTransaction& trans, bool force);
         void _SaveInventory(SQLTransaction& trans);
-        void _SaveVoidStorage(SQLTransaction& trans);
+        bool _SaveVoidStorage(SQLTransaction& trans);
         void _SaveMail(SQLTransaction& trans);
         void _SaveQuestStatus(SQLTransaction& trans);
         void _SaveDailyQuestStatus(SQLTransaction& trans);
@@ -2637,13 +2674,13 @@ class Player : public Unit, public GridObject<Player>
         void _SaveSkills(SQLTransaction& trans);
         void _SaveSpells(SQLTransaction& trans);
         void _SaveEquipmentSets(SQLTransaction& trans);
-        void _SaveBGData(SQLTransaction& trans);
-        void _SaveGlyphs(SQLTransaction& trans);
+        bool _SaveBGData(SQLTransaction& trans);
+        bool _SaveGlyphs(SQLTransaction& trans);
         void _SaveTalents(SQLTransaction& trans);
-        void _SaveStats(SQLTransaction& trans);
-        void _SaveInstanceTimeRestrictions(SQLTransaction& trans);
+        bool _SaveStats(SQLTransaction& trans);
+        bool _SaveInstanceTimeRestrictions(SQLTransaction& trans);
         void _SaveCurrency(SQLTransaction& trans);
-        void _SaveCUFProfiles(SQLTransaction& trans);
+        bool _SaveCUFProfiles(SQLTransaction& trans);
 
         /*********************************************************/
         /***              ENVIRONMENTAL SYSTEM                 ***/
@@ -2664,6 +2701,11 @@ class Player : public Unit, public GridObject<Player>
 
         uint32 m_team;
         uint32 m_nextSave;
+        uint32 m_autoSaveSlot;
+        uint32 m_saveSectionsChanged;                       // PlayerSaveSection mask
+        uint64 m_savedBGDataHash;                           // parameter hashes of the last written rows
+        uint64 m_savedAurasHash;
+        uint64 m_savedStatsHash;
         time_t m_speakTime;
         uint32 m_speakCount;
         Difficulty m_dungeonDifficulty;
@@ -2697,6 +2739,7 @@ class Player : public Unit, public GridObject<Player>
         void UpdateConquestCurrencyCap(uint32 currency);
 
         VoidStorageItem* _voidStorageItems[VOID_STORAGE_MAX_SLOT];
+        std::bitset<VOID_STORAGE_MAX_SLOT> _voidStorageChangedSlots;
 
         std::vector<Item*> m_itemUpdateQueue;
         bool m_itemUpdateQueueBlocked;
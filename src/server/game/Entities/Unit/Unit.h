@@ -26,6 +26,7 @@
 #include "HostileRefManager.h"
 #include "MotionMaster.h"
 #include "Object.h"
+#include "AuraEffectIndex.h"
 #include "SpellAuraDefines.h"
 #include "ThreatManager.h"
 #include "MoveSplineInit.h"
@@ -1238,7 +1239,7 @@ class Unit : public WorldObject
         typedef std::multimap<AuraStateType,  AuraApplication*> AuraStateAurasMap;
         typedef std::pair<AuraStateAurasMap::const_iterator, AuraStateAurasMap::const_iterator> AuraStateAurasMapBounds;
 
-        typedef std::list<AuraEffect*> AuraEffectList;
+        typedef AuraEffectIndex::EffectList AuraEffectList;
         typedef std::list<Aura*> AuraList;
         typedef std::list<AuraApplication *> AuraApplicationList;
         typedef std::list<DiminishingReturn> Diminishing;
@@ -1738,7 +1739,9 @@ class Unit : public WorldObject
         void _RemoveAllAuraStatMods();
         void _ApplyAllAuraStatMods();
 
-        AuraEffectList const& GetAuraEffectsByType(AuraType type) const { return m_modAuras[type]; }
+        AuraEffectList const& GetAuraEffectsByType(AuraType type) const { return m_modAuras.GetEffects(type); }
+        // the amount of an aura effect of this type changed, see AuraEffectIndex
+        void InvalidateAuraModifiers(AuraType type) { m_modAuras.Invalidate(type); }
         AuraList      & GetSingleCastAuras()       { return m_scAuras; }
         AuraList const& GetSingleCastAuras() const { return m_scAuras; }
 
@@ -2147,7 +2150,9 @@ class Unit : public WorldObject
     protected:
         explicit Unit (bool isWorldObject);
 
-        void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, Player* target) const override;
+        void BuildValuesUpdateMask(uint8 updateType, uint32 visibleFlag, Player const* target, UpdateMask& updateMask) const override;
+        bool IsUpdateFieldTargetDependent(uint32 index) const override;
+        uint32 GetUpdateFieldValueForTarget(uint32 index, Player* target) const override;
 
         UnitAI* i_AI, *i_disabledAI;
 
@@ -2185,7 +2190,7 @@ class Unit : public WorldObject
         AuraMap::iterator m_auraUpdateIterator;
         uint32 m_removedAurasCount;
 
-        AuraEffectList m_modAuras[TOTAL_AURAS];
+        AuraEffectIndex m_modAuras;
         AuraList m_scAuras;                        // cast singlecast auras
         AuraApplicationList m_interruptableAuras;  // auras which have interrupt mask applied on unit
         AuraStateAurasMap m_auraStateAuras;        // Used for improve performance of aura state checks on aura apply/remove
@@ -125,7 +125,7 @@ namespace Trinity
     struct MessageDistDeliverer
     {
         WorldObject* i_source;
-        WorldPacket* i_message;
+        PacketBroadcaster i_message;
         float i_distSq;
         uint32 team;
         Player const* skipped_receiver;
@@ -154,7 +154,7 @@ namespace Trinity
                 return;
 
             if (WorldSession* session = player->GetSession())
-                session->SendPacket(i_message);
+                i_message.SendTo(session);
         }
     };
 
@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2008-2015 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GridPreloader.h"
+#include "DetourAlloc.h"
+#include "DisableMgr.h"
+#include "Log.h"
+#include "Map.h"
+#include "MMapFactory.h"
+#include "Timer.h"
+#include "VMapFactory.h"
+#include "VMapManager2.h"
+#include "World.h"
+
+#include <chrono>
+
+// grids queued at once, requests over the limit are dropped and loaded synchronously if entered
+static size_t const MAX_QUEUED_GRIDS = 32;
+// prefetched grids that were not loaded within this time are freed again
+static uint32 const PRELOADED_GRID_EXPIRY = 60 * IN_MILLISECONDS;
+
+PreloadedGrid::~PreloadedGrid()
+{
+    delete Terrain;
+
+    if (MMapTile)
+        dtFree(MMapTile);
+
+    if (!VMapModels.empty())
+        if (VMAP::VMapManager2* vmgr = dynamic_cast<VMAP::VMapManager2*>(VMAP::VMapFactory::createOrGetVMapManager()))
+            vmgr->releaseModelInstances(VMapModels);
+}
+
+GridPreloader::GridPreloader() : _active(false), _cancelationToken(false)
+{
+    ResetStats();
+}
+
+GridPreloader::~GridPreloader()
+{
+    Stop();
+}
+
+void GridPreloader::Start()
+{
+    if (_active)
+        return;
+
+    _cancelationToken = false;
+    _active = true;
+    _thread = std::thread(&GridPreloader::WorkerThread, this);
+}
+
+void GridPreloader::Stop()
+{
+    if (!_active)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _cancelationToken = true;
+    }
+
+    _wakeUp.notify_all();
+    _thread.join();
+    _active = false;
+
+    _queue.clear();
+    _pending.clear();
+    _ready.clear();
+}
+
+void GridPreloader::Request(uint32 mapId, uint32 gx, uint32 gy)
+{
+    uint32 key = MakeKey(mapId, gx, gy);
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        if (_pending.count(key) || _ready.count(key))
+            return;
+
+        ++_stats.Requests;
+        if (_queue.size() >= MAX_QUEUED_GRIDS)
+        {
+            ++_stats.Dropped;
+            return;
+        }
+
+        _queue.push_back(key);
+        _pending.insert(key);
+    }
+
+    _wakeUp.notify_one();
+}
+
+std::unique_ptr<PreloadedGrid> GridPreloader::Take(uint32 mapId, uint32 gx, uint32 gy)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    auto itr = _ready.find(MakeKey(mapId, gx, gy));
+    if (itr == _ready.end())
+        return nullptr;
+
+    std::unique_ptr<PreloadedGrid> grid = std::move(itr->second);
+    _ready.erase(itr);
+    return grid;
+}
+
+void GridPreloader::RecordLoad(bool prefetched, uint64 time)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    if (prefetched)
+    {
+        ++_stats.PrefetchedLoads;
+        _stats.PrefetchedLoadTime += time;
+    }
+    else
+    {
+        ++_stats.SyncLoads;
+        _stats.SyncLoadTime += time;
+    }
+}
+
+void GridPreloader::Update()
+{
+    // freed outside of the lock, releasing vmap models may unload them
+    std::vector<std::unique_ptr<PreloadedGrid>> expired;
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        for (auto itr = _ready.begin(); itr != _ready.end();)
+        {
+            if (GetMSTimeDiffToNow(itr->second->ReadyTime) > PRELOADED_GRID_EXPIRY)
+            {
+                expired.push_back(std::move(itr->second));
+                itr = _ready.erase(itr);
+                ++_stats.Expired;
+            }
+            else
+                ++itr;
+        }
+    }
+}
+
+GridPreloader::Stats GridPreloader::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _stats;
+}
+
+void GridPreloader::ResetStats()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    _stats = Stats();
+}
+
+void GridPreloader::WorkerThread()
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    for (;;)
+    {
+        _wakeUp.wait(lock, [this]() { return !_queue.empty() || _cancelationToken; });
+        if (_cancelationToken)
+            return;
+
+        uint32 key = _queue.front();
+        _queue.pop_front();
+        lock.unlock();
+
+        std::chrono::steady_clock::time_point readStart = std::chrono::steady_clock::now();
+
+        std::unique_ptr<PreloadedGrid> grid = ReadGrid(key >> 12, (key >> 6) & (MAX_NUMBER_OF_GRIDS - 1), key & (MAX_NUMBER_OF_GRIDS - 1));
+
+        uint64 elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - readStart).count();
+
+        lock.lock();
+        _pending.erase(key);
+        _ready[key] = std::move(grid);
+        ++_stats.Prefetched;
+        _stats.PrefetchTime += elapsed;
+    }
+}
+
+std::unique_ptr<PreloadedGrid> GridPreloader::ReadGrid(uint32 mapId, uint32 gx, uint32 gy) const
+{
+    std::unique_ptr<PreloadedGrid> grid(new PreloadedGrid());
+
+    // same files as Map::LoadMap, Map::LoadVMap and Map::LoadMMap
+    int len = sWorld->GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
+    std::vector<char> fileName(len);
+    snprintf(fileName.data(), len, (sWorld->GetDataPath() + "maps/%03u%02u%02u.map").c_str(), mapId, gx, gy);
+
+    grid->Terrain = new GridMap();
+    if (!grid->Terrain->loadData(fileName.data()))
+    {
+        // loaded (and reported) again by the map
+        delete grid->Terrain;
+        grid->Terrain = NULL;
+    }
+
+    VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+    if (vmgr->isMapLoadingEnabled())
+        if (VMAP::VMapManager2* vmgr2 = dynamic_cast<VMAP::VMapManager2*>(vmgr))
+            vmgr2->preloadMapTile((sWorld->GetDataPath() + "vmaps").c_str(), mapId, gx, gy, grid->VMapModels);
+
+    // mapped tiles cost next to nothing to load, the map maps them itself
+    if (DisableMgr::IsPathfindingEnabled(mapId) && !sWorld->getBoolConfig(CONFIG_MEMORY_MAPPED_DATA_FILES))
+        grid->MMapTile = MMAP::MMapFactory::createOrGetMMapManager()->readTileData(mapId, gx, gy, grid->MMapTileSize);
+
+    grid->ReadyTime = getMSTime();
+
+    TC_LOG_DEBUG("maps", "GridPreloader: read grid [%u, %u] of map %u ahead", gx, gy, mapId);
+    return grid;
+}
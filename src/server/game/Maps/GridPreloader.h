@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2008-2015 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_GRIDPRELOADER_H
+#define TRINITY_GRIDPRELOADER_H
+
+#include "Define.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class GridMap;
+
+/// Terrain data of one grid read ahead of time, whatever the map did not link is freed with it
+struct PreloadedGrid
+{
+    PreloadedGrid() : Terrain(NULL), MMapTile(NULL), MMapTileSize(0), ReadyTime(0) { }
+    ~PreloadedGrid();
+
+    GridMap* Terrain;                                       // decoded .map file, NULL if it could not be read
+    unsigned char* MMapTile;                                // .mmtile data allocated with dtAlloc
+    uint32 MMapTileSize;
+    std::vector<std::string> VMapModels;                    // models of the vmap tile, one reference held on each
+    uint32 ReadyTime;                                       // getMSTime() when the data was read
+
+private:
+    PreloadedGrid(PreloadedGrid const& right) = delete;
+    PreloadedGrid& operator=(PreloadedGrid const& right) = delete;
+};
+
+/*
+ * Reads the terrain, vmap models and mmap tile of grids that players are about to enter on a
+ * background thread. Maps request the grids predicted from the movement of their players
+ * (Map::PreloadGridsAhead), Map::LoadMapAndVMap takes the data once the grid is created and only
+ * links it. Creatures and gameobjects are still spawned on the map thread when the grid loads.
+ */
+class GridPreloader
+{
+    public:
+        struct Stats
+        {
+            uint32 Requests;
+            uint32 Dropped;                                 // requests over the queue limit
+            uint32 Prefetched;                              // grids read by the thread
+            uint32 Expired;                                 // prefetched grids no map loaded in time
+            uint32 PrefetchedLoads;                         // grid loads that found their data prefetched
+            uint32 SyncLoads;                               // grid loads that read the files on the map thread
+            uint64 PrefetchTime;                            // microseconds spent reading on the thread
+            uint64 PrefetchedLoadTime;                      // microseconds spent on map threads linking prefetched grids
+            uint64 SyncLoadTime;                            // microseconds spent on map threads reading grids
+        };
+
+        GridPreloader();
+        ~GridPreloader();
+
+        void Start();
+        void Stop();
+        bool IsActive() const { return _active; }
+
+        // map threads
+        void Request(uint32 mapId, uint32 gx, uint32 gy);
+        std::unique_ptr<PreloadedGrid> Take(uint32 mapId, uint32 gx, uint32 gy);
+        void RecordLoad(bool prefetched, uint64 time);
+
+        // world thread, frees prefetched grids that were not loaded in time
+        void Update();
+
+        Stats GetStats() const;
+        void ResetStats();
+
+    private:
+        static uint32 MakeKey(uint32 mapId, uint32 gx, uint32 gy) { return (mapId << 12) | (gx << 6) | gy; }
+
+        void WorkerThread();
+        std::unique_ptr<PreloadedGrid> ReadGrid(uint32 mapId, uint32 gx, uint32 gy) const;
+
+        std::thread _thread;
+        bool _active;
+        bool _cancelationToken;
+
+        mutable std::mutex _lock;
+        std::condition_variable _wakeUp;
+        std::deque<uint32> _queue;
+        std::unordered_set<uint32> _pending;                // queued or being read
+        std::unordered_map<uint32, std::unique_ptr<PreloadedGrid>> _ready;
+
+        Stats _stats;
+
+        GridPreloader(GridPreloader const& right) = delete;
+        GridPreloader& operator=(GridPreloader const& right) = delete;
+};
+
+#endif
@@ -24,10 +24,14 @@
 #include "DynamicTree.h"
 #include "GridNotifiers.h"
 #include "GridNotifiersImpl.h"
+#include "GridPreloader.h"
 #include "GridStates.h"
 #include "Group.h"
 #include "InstanceScript.h"
 #include "MapInstanced.h"
+#include "MapManager.h"
+#include "MappedFile.h"
+#include "MoveSpline.h"
 #include "ObjectAccessor.h"
 #include "ObjectMgr.h"
 #include "Pet.h"
@@ -36,8 +40,15 @@
 #include "Vehicle.h"
 #include "VMapFactory.h"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+
 u_map_magic MapMagic        = { {'M','A','P','S'} };
-u_map_magic MapVersionMagic = { {'v','1','.','3'} };
+u_map_magic MapVersionMagic = { {'v','1','.','4'} };
+u_map_magic MapVersionMagicUnaligned = { {'v','1','.','3'} };   // same layout without aligned sections, read but never mapped
 u_map_magic MapAreaMagic    = { {'A','R','E','A'} };
 u_map_magic MapHeightMagic  = { {'M','H','G','T'} };
 u_map_magic MapLiquidMagic  = { {'M','L','I','Q'} };
@@ -88,7 +99,8 @@ bool Map::ExistMap(uint32 mapid, int gx, int gy)
         map_fileheader header;
         if (fread(&header, sizeof(header), 1, pf) == 1)
         {
-            if (header.mapMagic.asUInt != MapMagic.asUInt || header.versionMagic.asUInt != MapVersionMagic.asUInt)
+            if (header.mapMagic.asUInt != MapMagic.asUInt ||
+                (header.versionMagic.asUInt != MapVersionMagic.asUInt && header.versionMagic.asUInt != MapVersionMagicUnaligned.asUInt))
                 TC_LOG_ERROR("maps", "Map file '%s' is from an incompatible map version (%.*s %.*s), %.*s %.*s is expected. Please recreate using the mapextractor.",
                     fileName, 4, header.mapMagic.asChar, 4, header.versionMagic.asChar, 4, MapMagic.asChar, 4, MapVersionMagic.asChar);
             else
@@ -121,12 +133,19 @@ bool Map::ExistVMap(uint32 mapid, int gx, int gy)
     return true;
 }
 
-void Map::LoadMMap(int gx, int gy)
+void Map::LoadMMap(int gx, int gy, PreloadedGrid* preloaded)
 {
     if (!DisableMgr::IsPathfindingEnabled(GetId()))
         return;
 
-    bool mmapLoadResult = MMAP::MMapFactory::createOrGetMMapManager()->loadMap((sWorld->GetDataPath() + "mmaps").c_str(), GetId(), gx, gy);
+    bool mmapLoadResult;
+    if (preloaded && preloaded->MMapTile)
+    {
+        mmapLoadResult = MMAP::MMapFactory::createOrGetMMapManager()->loadMapTile(GetId(), gx, gy, preloaded->MMapTile, preloaded->MMapTileSize);
+        preloaded->MMapTile = NULL;
+    }
+    else
+        mmapLoadResult = MMAP::MMapFactory::createOrGetMMapManager()->loadMap((sWorld->GetDataPath() + "mmaps").c_str(), GetId(), gx, gy);
 
     if (mmapLoadResult)
         TC_LOG_DEBUG("maps", "MMAP loaded name:%s, id:%d, x:%d, y:%d (mmap rep.: x:%d, y:%d)", GetMapName(), GetId(), gx, gy, gx, gy);
@@ -154,7 +173,7 @@ void Map::LoadVMap(int gx, int gy)
     }
 }
 
-void Map::LoadMap(int gx, int gy, bool reload)
+void Map::LoadMap(int gx, int gy, bool reload, PreloadedGrid* preloaded)
 {
     if (i_InstanceId != 0)
     {
@@ -183,6 +202,16 @@ void Map::LoadMap(int gx, int gy, bool reload)
         GridMaps[gx][gy]=NULL;
     }
 
+    if (preloaded && preloaded->Terrain)
+    {
+        TC_LOG_DEBUG("maps", "Linking preloaded map %03u%02u%02u", GetId(), gx, gy);
+        GridMaps[gx][gy] = preloaded->Terrain;
+        preloaded->Terrain = NULL;
+
+        sScriptMgr->OnLoadGridMap(this, GridMaps[gx][gy], gx, gy);
+        return;
+    }
+
     // map file name
     char* tmp = NULL;
     int len = sWorld->GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
@@ -200,12 +229,27 @@ void Map::LoadMap(int gx, int gy, bool reload)
 
 void Map::LoadMapAndVMap(int gx, int gy)
 {
-    LoadMap(gx, gy);
+    if (_collisionCache)
+        _collisionCache->InvalidateStatic();
+
+    // instances link the grids of their parent, which takes the preloaded data
+    GridPreloader* preloader = sMapMgr->GetGridPreloader();
+    std::unique_ptr<PreloadedGrid> preloaded;
+    if (i_InstanceId == 0 && preloader->IsActive())
+        preloaded = preloader->Take(GetId(), gx, gy);
+
+    std::chrono::steady_clock::time_point loadStart = std::chrono::steady_clock::now();
+
+    LoadMap(gx, gy, false, preloaded.get());
    // Only load the data for the base map
     if (i_InstanceId == 0)
     {
+        // the preloaded models are found already loaded, their extra references are released with preloaded
         LoadVMap(gx, gy);
-        LoadMMap(gx, gy);
+        LoadMMap(gx, gy, preloaded.get());
+
+        if (preloader->IsActive())
+            preloader->RecordLoad(preloaded != nullptr, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - loadStart).count());
     }
 }
 
@@ -225,16 +269,42 @@ void Map::DeleteStateMachine()
     delete si_GridStates[GRID_STATE_REMOVAL];
 }
 
+float Map::_maxSpellReach = 0.0f;
+
+void Map::InitMaxSpellReach()
+{
+    float range = 0.0f;
+    for (uint32 i = 0; i < sSpellRangeStore.GetNumRows(); ++i)
+    {
+        if (SpellRangeEntry const* entry = sSpellRangeStore.LookupEntry(i))
+        {
+            range = std::max(range, entry->maxRangeHostile);
+            range = std::max(range, entry->maxRangeFriend);
+        }
+    }
+
+    float radius = 0.0f;
+    for (uint32 i = 0; i < sSpellRadiusStore.GetNumRows(); ++i)
+        if (SpellRadiusEntry const* entry = sSpellRadiusStore.LookupEntry(i))
+            radius = std::max(radius, entry->RadiusMax);
+
+    _maxSpellReach = range + radius;
+
+    if (sWorld->getBoolConfig(CONFIG_MAP_REGION_UPDATE))
+        TC_LOG_INFO("server.loading", "MapUpdate.Regions: spells reach up to %.1f yards, maps whose margin is smaller are updated as a single region", _maxSpellReach);
+}
+
 Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode, Map* _parent):
 _creatureToMoveLock(false), _gameObjectsToMoveLock(false), _dynamicObjectsToMoveLock(false),
 i_mapEntry(sMapStore.LookupEntry(id)), i_spawnMode(SpawnMode), i_InstanceId(InstanceId),
 m_unloadTimer(0), m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE),
 m_VisibilityNotifyPeriod(DEFAULT_VISIBILITY_NOTIFY_PERIOD),
 m_activeNonPlayersIter(m_activeNonPlayers.end()), _transportsUpdateIter(_transports.end()),
-i_gridExpiry(expiry),
+i_gridExpiry(expiry), _updateCost(0), _regionUpdateInProgress(false),
 i_scriptLock(false), _defaultLight(GetDefaultMapLight(id))
 {
     m_parentMap = (_parent ? _parent : this);
+    ResetObjectUpdateStats();
     for (unsigned int idx=0; idx < MAX_NUMBER_OF_GRIDS; ++idx)
     {
         for (unsigned int j=0; j < MAX_NUMBER_OF_GRIDS; ++j)
@@ -248,6 +318,9 @@ i_scriptLock(false), _defaultLight(GetDefaultMapLight(id))
     //lets initialize visibility distance for map
     Map::InitVisibilityDistance();
 
+    if (uint32 collisionCacheSize = sWorld->getIntConfig(CONFIG_VMAP_COLLISION_CACHE_SIZE))
+        _collisionCache = Trinity::make_unique<MapCollisionCache>(collisionCacheSize);
+
     sScriptMgr->OnCreateMap(this);
 }
 
@@ -401,7 +474,6 @@ template<>
 void Map::DeleteFromWorld(Player* player)
 {
     sObjectAccessor->RemoveObject(player);
-    sObjectAccessor->RemoveUpdateObject(player); /// @todo I do not know why we need this, it should be removed in ~Object anyway
     delete player;
 }
 
@@ -531,6 +603,8 @@ void Map::InitializeObject(GameObject* obj)
 template<class T>
 bool Map::AddToMap(T* obj)
 {
+    std::unique_lock<std::recursive_mutex> lock = LockForRegionUpdate();
+
     /// @todo Needs clean up. An object should not be added to map twice.
     if (obj->IsInWorld())
     {
@@ -660,40 +734,61 @@ void Map::Update(const uint32 t_diff)
             session->Update(t_diff, updater);
         }
     }
+
+    if (sMapMgr->GetGridPreloader()->IsActive())
+        PreloadGridsAhead();
     /// update active cells around players and active objects
     resetMarkedCells();
 
-    Trinity::ObjectUpdater updater(t_diff);
-    // for creature
-    TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
-    // for pets
-    TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
-
-    // the player iterator is stored in the map object
-    // to make sure calls to Map::Remove don't invalidate it
-    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+    if (sWorld->getBoolConfig(CONFIG_MAP_REGION_UPDATE) && sMapMgr->GetMapUpdater()->activated())
     {
-        Player* player = m_mapRefIter->GetSource();
+        // players are updated first and serially, only the objects in their cells are split into regions
+        for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+        {
+            Player* player = m_mapRefIter->GetSource();
 
-        if (!player || !player->IsInWorld())
-            continue;
+            if (!player || !player->IsInWorld())
+                continue;
 
-        // update players at tick
-        player->Update(t_diff);
+            player->Update(t_diff);
+        }
 
-        VisitNearbyCellsOf(player, grid_object_update, world_object_update);
+        UpdateRegions(t_diff);
     }
-
-    // non-player active objects, increasing iterator in the loop in case of object removal
-    for (m_activeNonPlayersIter = m_activeNonPlayers.begin(); m_activeNonPlayersIter != m_activeNonPlayers.end();)
+    else
     {
-        WorldObject* obj = *m_activeNonPlayersIter;
-        ++m_activeNonPlayersIter;
+        Trinity::ObjectUpdater updater(t_diff);
+        // for creature
+        TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
+        // for pets
+        TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
 
-        if (!obj || !obj->IsInWorld())
-            continue;
+        // the player iterator is stored in the map object
+        // to make sure calls to Map::Remove don't invalidate it
+        for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+        {
+            Player* player = m_mapRefIter->GetSource();
+
+            if (!player || !player->IsInWorld())
+                continue;
+
+            // update players at tick
+            player->Update(t_diff);
+
+            VisitNearbyCellsOf(player, grid_object_update, world_object_update);
+        }
+
+        // non-player active objects, increasing iterator in the loop in case of object removal
+        for (m_activeNonPlayersIter = m_activeNonPlayers.begin(); m_activeNonPlayersIter != m_activeNonPlayers.end();)
+        {
+            WorldObject* obj = *m_activeNonPlayersIter;
+            ++m_activeNonPlayersIter;
 
-        VisitNearbyCellsOf(obj, grid_object_update, world_object_update);
+            if (!obj || !obj->IsInWorld())
+                continue;
+
+            VisitNearbyCellsOf(obj, grid_object_update, world_object_update);
+        }
     }
 
     for (_transportsUpdateIter = _transports.begin(); _transportsUpdateIter != _transports.end();)
@@ -722,6 +817,455 @@ void Map::Update(const uint32 t_diff)
         ProcessRelocationNotifies(t_diff);
 
     sScriptMgr->OnMapUpdate(this, t_diff);
+
+    SendObjectUpdates();
+}
+
+void Map::PreloadGridsAhead()
+{
+    float lookahead = float(sWorld->getIntConfig(CONFIG_GRID_PRELOAD_LOOKAHEAD));
+    GridPreloader* preloader = sMapMgr->GetGridPreloader();
+
+    for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+    {
+        Player* player = itr->GetSource();
+        if (!player || !player->IsInWorld() || player->GetTransport())
+            continue;
+
+        float x = player->GetPositionX();
+        float y = player->GetPositionY();
+        float predictedX, predictedY;
+
+        if (!player->movespline->Finalized())
+        {
+            // taxi flights and other spline movement: the path point reached after the lookahead
+            if (player->movespline->onTransport)
+                continue;
+
+            Movement::MoveSpline::MySpline const& spline = player->movespline->_Spline();
+            int32 index = player->movespline->_currentSplineIdx();
+            int32 time = spline.length(index) + int32(lookahead * IN_MILLISECONDS);
+            while (index < spline.last() && spline.length(index) < time)
+                ++index;
+
+            predictedX = spline.getPoint(index).x;
+            predictedY = spline.getPoint(index).y;
+        }
+        else
+        {
+            // client controlled movement: straight on with the current speed
+            float forward = player->HasUnitMovementFlag(MOVEMENTFLAG_FORWARD) ? 1.0f : player->HasUnitMovementFlag(MOVEMENTFLAG_BACKWARD) ? -1.0f : 0.0f;
+            float left = player->HasUnitMovementFlag(MOVEMENTFLAG_STRAFE_LEFT) ? 1.0f : player->HasUnitMovementFlag(MOVEMENTFLAG_STRAFE_RIGHT) ? -1.0f : 0.0f;
+            if (!forward && !left)
+                continue;
+
+            float angle = player->GetOrientation() + std::atan2(left, forward);
+            float distance = player->GetSpeed(player->IsFlying() ? MOVE_FLIGHT : MOVE_RUN) * lookahead;
+            predictedX = x + std::cos(angle) * distance;
+            predictedY = y + std::sin(angle) * distance;
+        }
+
+        // every grid crossed on the way, sampled each half grid
+        float dx = predictedX - x;
+        float dy = predictedY - y;
+        uint32 steps = uint32(std::sqrt(dx * dx + dy * dy) / (SIZE_OF_GRIDS / 2)) + 1;
+        for (uint32 step = 1; step <= steps; ++step)
+        {
+            float sampleX = x + dx * step / steps;
+            float sampleY = y + dy * step / steps;
+            if (!Trinity::IsValidMapCoord(sampleX, sampleY))
+                break;
+
+            GridCoord p = Trinity::ComputeGridCoord(sampleX, sampleY);
+            int gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
+            int gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
+            // instances link the terrain of their parent, which is the map taking the preloaded data.
+            // A stale read only costs a request that is dropped or a grid loaded without preloading
+            if (!m_parentMap->GridMaps[gx][gy])
+                preloader->Request(GetId(), gx, gy);
+        }
+    }
+}
+
+void Map::AddUpdateObject(Object* obj)
+{
+    std::lock_guard<std::mutex> lock(_updateObjectsLock);
+    ASSERT(!obj->_updateQueueMap);
+
+    obj->_updateQueueMap = this;
+    obj->_updateQueueIndex = uint32(_updateObjects.size());
+    _updateObjects.push_back(obj);
+}
+
+void Map::RemoveUpdateObject(Object* obj)
+{
+    std::lock_guard<std::mutex> lock(_updateObjectsLock);
+
+    // already taken by SendObjectUpdates
+    if (obj->_updateQueueMap != this)
+        return;
+
+    ASSERT(obj->_updateQueueIndex < _updateObjects.size() && _updateObjects[obj->_updateQueueIndex] == obj);
+
+    Object* last = _updateObjects.back();
+    _updateObjects[obj->_updateQueueIndex] = last;
+    last->_updateQueueIndex = obj->_updateQueueIndex;
+    _updateObjects.pop_back();
+
+    obj->_updateQueueMap = NULL;
+}
+
+void Map::SendObjectUpdates()
+{
+    {
+        std::lock_guard<std::mutex> lock(_updateObjectsLock);
+        if (_updateObjects.empty())
+            return;
+
+        // objects changed while the packets are built are queued again and sent by the next flush
+        _sendingUpdateObjects.swap(_updateObjects);
+        for (Object* obj : _sendingUpdateObjects)
+            obj->_updateQueueMap = NULL;
+    }
+
+    std::chrono::steady_clock::time_point buildStart = std::chrono::steady_clock::now();
+
+    UpdateDataMapType update_players;
+    for (Object* obj : _sendingUpdateObjects)
+    {
+        ASSERT(obj && obj->IsInWorld());
+        obj->BuildUpdate(update_players);
+    }
+
+    std::chrono::steady_clock::time_point sendStart = std::chrono::steady_clock::now();
+
+    WorldPacket packet;                                     // here we allocate a std::vector with a size of 0x10000
+    for (UpdateDataMapType::iterator iter = update_players.begin(); iter != update_players.end(); ++iter)
+    {
+        iter->second.BuildPacket(&packet);
+        iter->first->GetSession()->SendPacket(&packet);
+        packet.clear();                                     // clean the string
+    }
+
+    std::chrono::steady_clock::time_point sendEnd = std::chrono::steady_clock::now();
+
+    uint64 buildTime = std::chrono::duration_cast<std::chrono::microseconds>(sendStart - buildStart).count();
+    uint64 sendTime = std::chrono::duration_cast<std::chrono::microseconds>(sendEnd - sendStart).count();
+    {
+        std::lock_guard<std::mutex> lock(_objectUpdateStatsLock);
+        _objectUpdateStats.BuildTime += buildTime;
+        _objectUpdateStats.SendTime += sendTime;
+        _objectUpdateStats.Objects += _sendingUpdateObjects.size();
+        _objectUpdateStats.Packets += update_players.size();
+        ++_objectUpdateStats.Flushes;
+        _objectUpdateStats.MaxTime = std::max(_objectUpdateStats.MaxTime, uint32(std::min<uint64>(buildTime + sendTime, std::numeric_limits<uint32>::max())));
+    }
+
+    _sendingUpdateObjects.clear();
+}
+
+Map::ObjectUpdateStats Map::GetObjectUpdateStats() const
+{
+    std::lock_guard<std::mutex> lock(_objectUpdateStatsLock);
+    return _objectUpdateStats;
+}
+
+void Map::ResetObjectUpdateStats()
+{
+    std::lock_guard<std::mutex> lock(_objectUpdateStatsLock);
+    _objectUpdateStats = ObjectUpdateStats();
+}
+
+namespace
+{
+    struct MapRegionUpdate
+    {
+        MapRegionUpdate() : NextRegion(0), FinishedRegions(0) { }
+
+        std::vector<std::vector<uint32>> Regions;
+        std::atomic<size_t> NextRegion;
+        std::atomic<size_t> FinishedRegions;
+        std::mutex Lock;
+        std::condition_variable Finished;
+    };
+
+    // pairs of units in combat with or controlling each other, their regions are merged whatever the distance
+    class RegionLinkCollector
+    {
+        public:
+            explicit RegionLinkCollector(std::vector<std::pair<Unit*, Unit*>>& links) : _links(links) { }
+
+            void Visit(CreatureMapType& m) { CollectAll<Creature>(m); }
+            void Visit(PlayerMapType& m) { CollectAll<Player>(m); }
+            template<class SKIP> void Visit(GridRefManager<SKIP>&) { }
+
+        private:
+            template<class T>
+            void CollectAll(GridRefManager<T>& m)
+            {
+                for (typename GridRefManager<T>::iterator itr = m.begin(); itr != m.end(); ++itr)
+                    Collect(itr->GetSource());
+            }
+
+            void Collect(Unit* unit)
+            {
+                if (Unit* owner = unit->GetCharmerOrOwner())
+                    _links.push_back(std::make_pair(unit, owner));
+
+                if (!unit->IsInCombat())
+                    return;
+
+                if (Unit* victim = unit->GetVictim())
+                    _links.push_back(std::make_pair(unit, victim));
+
+                for (Unit* attacker : unit->getAttackers())
+                    _links.push_back(std::make_pair(unit, attacker));
+
+                for (HostileReference* ref : unit->getThreatManager().getThreatList())
+                    _links.push_back(std::make_pair(unit, ref->getTarget()));
+
+                for (HostileReference* ref = unit->getHostileRefManager().getFirst(); ref; ref = ref->next())
+                    _links.push_back(std::make_pair(unit, ref->GetSource()->GetOwner()));
+            }
+
+            std::vector<std::pair<Unit*, Unit*>>& _links;
+    };
+}
+
+uint32 Map::GetRegionMargin() const
+{
+    // cells of different regions are more than margin cells apart, so objects in them are at least margin cells apart
+    uint32 minimum = uint32(std::ceil(GetVisibilityRange() / SIZE_OF_GRID_CELL));
+    return std::max(sWorld->getIntConfig(CONFIG_MAP_REGION_UPDATE_MARGIN), minimum);
+}
+
+uint32 Map::UpdateRegionsForBenchmark(uint32 diff, uint32 maxThreads)
+{
+    resetMarkedCells();
+    return UpdateRegions(diff, maxThreads);
+}
+
+uint32 Map::UpdateRegions(uint32 diff, uint32 maxThreads)
+{
+    // collect the cells around players and active objects, same area as VisitNearbyCellsOf
+    std::vector<uint32> cells;
+    auto collectCells = [this, &cells](WorldObject* obj)
+    {
+        if (!obj->IsPositionValid())
+            return;
+
+        CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), obj->GetGridActivationRange());
+        for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+        {
+            for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+            {
+                uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
+                if (isCellMarked(cell_id))
+                    continue;
+
+                markCell(cell_id);
+                cells.push_back(cell_id);
+            }
+        }
+    };
+
+    for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+        if (Player* player = itr->GetSource())
+            if (player->IsInWorld())
+                collectCells(player);
+
+    for (ActiveNonPlayers::const_iterator itr = m_activeNonPlayers.begin(); itr != m_activeNonPlayers.end(); ++itr)
+        if ((*itr)->IsInWorld())
+            collectCells(*itr);
+
+    if (cells.empty())
+        return 0;
+
+    int32 const margin = int32(GetRegionMargin());
+
+    // a spell cast in one region could reach into another one, nothing can be updated in parallel
+    if (_maxSpellReach > float(margin) * SIZE_OF_GRID_CELL)
+    {
+        UpdateRegionCells(cells, diff);
+        return 1;
+    }
+
+    // flood fill the marked cells into regions, cells closer than the margin end up in the same region
+    std::sort(cells.begin(), cells.end());
+    uint32 const unassigned = std::numeric_limits<uint32>::max();
+    std::vector<uint32> cellRegions(cells.size(), unassigned);
+    uint32 regionCount = 0;
+
+    for (size_t i = 0; i < cells.size(); ++i)
+    {
+        if (cellRegions[i] != unassigned)
+            continue;
+
+        std::vector<size_t> open(1, i);
+        cellRegions[i] = regionCount;
+
+        while (!open.empty())
+        {
+            uint32 cell_id = cells[open.back()];
+            open.pop_back();
+
+            int32 cx = int32(cell_id % TOTAL_NUMBER_OF_CELLS_PER_MAP);
+            int32 cy = int32(cell_id / TOTAL_NUMBER_OF_CELLS_PER_MAP);
+            for (int32 y = std::max(cy - margin, 0); y <= std::min(cy + margin, int32(TOTAL_NUMBER_OF_CELLS_PER_MAP) - 1); ++y)
+            {
+                for (int32 x = std::max(cx - margin, 0); x <= std::min(cx + margin, int32(TOTAL_NUMBER_OF_CELLS_PER_MAP) - 1); ++x)
+                {
+                    uint32 neighbour = uint32(y) * TOTAL_NUMBER_OF_CELLS_PER_MAP + uint32(x);
+                    if (!isCellMarked(neighbour))
+                        continue;
+
+                    size_t index = std::lower_bound(cells.begin(), cells.end(), neighbour) - cells.begin();
+                    if (cellRegions[index] == unassigned)
+                    {
+                        cellRegions[index] = regionCount;
+                        open.push_back(index);
+                    }
+                }
+            }
+        }
+
+        ++regionCount;
+    }
+
+    if (regionCount > 1)
+    {
+        // units fighting or controlling each other touch each other's state however far apart they are,
+        // merge their regions. Combat and ownership only change while objects are updated, not now
+        std::vector<std::pair<Unit*, Unit*>> links;
+        RegionLinkCollector collector(links);
+        TypeContainerVisitor<RegionLinkCollector, GridTypeMapContainer> gridLinks(collector);
+        TypeContainerVisitor<RegionLinkCollector, WorldTypeMapContainer> worldLinks(collector);
+        for (uint32 cell_id : cells)
+        {
+            Cell cell(CellCoord(cell_id % TOTAL_NUMBER_OF_CELLS_PER_MAP, cell_id / TOTAL_NUMBER_OF_CELLS_PER_MAP));
+            cell.SetNoCreate();
+            Visit(cell, gridLinks);
+            Visit(cell, worldLinks);
+        }
+
+        auto regionOf = [this, &cells, &cellRegions, unassigned](Unit* unit) -> uint32
+        {
+            if (!unit->IsInWorld() || unit->GetMap() != this)
+                return unassigned;
+
+            uint32 cell_id = Trinity::ComputeCellCoord(unit->GetPositionX(), unit->GetPositionY()).GetId();
+            std::vector<uint32>::const_iterator itr = std::lower_bound(cells.begin(), cells.end(), cell_id);
+            return itr != cells.end() && *itr == cell_id ? cellRegions[itr - cells.begin()] : unassigned;
+        };
+
+        std::vector<uint32> mergedInto(regionCount);
+        for (uint32 i = 0; i < regionCount; ++i)
+            mergedInto[i] = i;
+
+        auto findRegion = [&mergedInto](uint32 region) -> uint32
+        {
+            while (mergedInto[region] != region)
+                region = mergedInto[region] = mergedInto[mergedInto[region]];
+            return region;
+        };
+
+        for (std::pair<Unit*, Unit*> const& link : links)
+        {
+            uint32 first = regionOf(link.first);
+            uint32 second = regionOf(link.second);
+            if (first == unassigned || second == unassigned)
+                continue;
+
+            first = findRegion(first);
+            second = findRegion(second);
+            if (first != second)
+                mergedInto[std::max(first, second)] = std::min(first, second);
+        }
+
+        for (uint32& region : cellRegions)
+            region = findRegion(region);
+    }
+
+    std::shared_ptr<MapRegionUpdate> update = std::make_shared<MapRegionUpdate>();
+    std::vector<uint32> regionIndexes(regionCount, unassigned);
+    for (size_t i = 0; i < cells.size(); ++i)
+    {
+        uint32& index = regionIndexes[cellRegions[i]];
+        if (index == unassigned)
+        {
+            index = uint32(update->Regions.size());
+            update->Regions.push_back(std::vector<uint32>());
+        }
+
+        update->Regions[index].push_back(cells[i]);
+    }
+
+    if (update->Regions.size() == 1 || maxThreads == 1)
+    {
+        for (std::vector<uint32> const& region : update->Regions)
+            UpdateRegionCells(region, diff);
+        return uint32(update->Regions.size());
+    }
+
+    // biggest regions first, they are the ones that decide how long the parallel phase takes
+    std::sort(update->Regions.begin(), update->Regions.end(), [](std::vector<uint32> const& left, std::vector<uint32> const& right)
+    {
+        return left.size() > right.size();
+    });
+
+    _regionUpdateInProgress = true;
+
+    // helpers hold a reference to the update so jobs picked up after all regions finished do nothing
+    auto work = [this, update, diff]()
+    {
+        size_t index;
+        while ((index = update->NextRegion++) < update->Regions.size())
+        {
+            UpdateRegionCells(update->Regions[index], diff);
+            if (++update->FinishedRegions == update->Regions.size())
+            {
+                std::lock_guard<std::mutex> lock(update->Lock);
+                update->Finished.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = update->Regions.size() - 1;
+    if (maxThreads)
+        helpers = std::min<size_t>(helpers, maxThreads - 1);
+    for (size_t i = 0; i < helpers; ++i)
+        sMapMgr->GetMapUpdater()->schedule_job(work);
+
+    // this thread takes regions too, so the update completes even when no other worker is free
+    work();
+
+    // regions taken by helpers are already being updated, waiting here is bounded by the slowest one
+    {
+        std::unique_lock<std::mutex> lock(update->Lock);
+        update->Finished.wait(lock, [&update]() { return update->FinishedRegions == update->Regions.size(); });
+    }
+
+    _regionUpdateInProgress = false;
+
+    TC_LOG_DEBUG("maps", "Map::UpdateRegions: map %u instance %u updated %u cells in %u regions",
+        GetId(), GetInstanceId(), uint32(cells.size()), uint32(update->Regions.size()));
+    return uint32(update->Regions.size());
+}
+
+void Map::UpdateRegionCells(std::vector<uint32> const& cells, uint32 diff)
+{
+    Trinity::ObjectUpdater updater(diff);
+    TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
+    TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
+
+    for (uint32 cell_id : cells)
+    {
+        CellCoord pair(cell_id % TOTAL_NUMBER_OF_CELLS_PER_MAP, cell_id / TOTAL_NUMBER_OF_CELLS_PER_MAP);
+        Cell cell(pair);
+        cell.SetNoCreate();
+        Visit(cell, grid_object_update);
+        Visit(cell, world_object_update);
+    }
 }
 
 struct ResetNotifier
@@ -833,6 +1377,8 @@ void Map::RemovePlayerFromMap(Player* player, bool remove)
 template<class T>
 void Map::RemoveFromMap(T *obj, bool remove)
 {
+    std::unique_lock<std::recursive_mutex> lock = LockForRegionUpdate();
+
     obj->RemoveFromWorld();
     if (obj->isActiveObject())
         RemoveFromActive(obj);
@@ -1027,6 +1573,8 @@ void Map::DynamicObjectRelocation(DynamicObject* dynObj, float x, float y, float
 
 void Map::AddCreatureToMoveList(Creature* c, float x, float y, float z, float ang)
 {
+    std::unique_lock<std::recursive_mutex> lock = LockForRegionUpdate();
+
     if (_creatureToMoveLock) //can this happen?
         return;
 
@@ -1037,6 +1585,8 @@ void Map::AddCreatureToMoveList(Creature* c, float x, float y, float z, float an
 
 void Map::RemoveCreatureFromMoveList(Creature* c)
 {
+    std::unique_lock<std::recursive_mutex> lock = LockForRegionUpdate();
+
     if (_creatureToMoveLock) //can this happen?
         return;
 
@@ -1046,6 +1596,8 @@ void Map::RemoveCreatureFromMoveList(Creature* c)
 
 void Map::AddGameObjectToMoveList(GameObject* go, float x, float y, float z, float ang)
 {
+    std::unique_lock<std::recursive_mutex> lock = LockForRegionUpdate();
+
     if (_gameObjectsToMoveLock) //can this happen?
         return;
 
@@ -1056,6 +1608,8 @@ void Map::AddGameObjectToMoveList(GameObject* go, float x, float y, float z, flo
 
 void Map::RemoveGameObjectFromMoveList(GameObject* go)
 {
+    std::unique_lock<std::recursive_mutex> lock = LockForRegionUpdate();
+
     if (_gameObjectsToMoveLock) //can this happen?
         return;
 
@@ -1065,6 +1619,8 @@ void Map::RemoveGameObjectFromMoveList(GameObject* go)
 
 void Map::AddDynamicObjectToMoveList(DynamicObject* dynObj, float x, float y, float z, float ang)
 {
+    std::unique_lock<std::recursive_mutex> lock = LockForRegionUpdate();
+
     if (_dynamicObjectsToMoveLock) //can this happen?
         return;
 
@@ -1075,6 +1631,8 @@ void Map::AddDynamicObjectToMoveList(DynamicObject* dynObj, float x, float y, fl
 
 void Map::RemoveDynamicObjectFromMoveList(DynamicObject* dynObj)
 {
+    std::unique_lock<std::recursive_mutex> lock = LockForRegionUpdate();
+
     if (_dynamicObjectsToMoveLock) //can this happen?
         return;
 
@@ -1533,6 +2091,8 @@ bool Map::UnloadGrid(NGridType& ngrid, bool unloadAll)
             ((MapInstanced*)m_parentMap)->RemoveGridMapReference(GridCoord(gx, gy));
 
         GridMaps[gx][gy] = NULL;
+        if (_collisionCache)
+            _collisionCache->InvalidateStatic();
     }
     TC_LOG_DEBUG("maps", "Unloading grid[%u, %u] for map %u finished", x, y, GetId());
     return true;
@@ -1602,6 +2162,7 @@ GridMap::GridMap()
     _liquidEntry = NULL;
     _liquidFlags = NULL;
     _liquidMap  = NULL;
+    _mappedFile = NULL;
 }
 
 GridMap::~GridMap()
@@ -1610,10 +2171,55 @@ GridMap::~GridMap()
 }
 
 bool GridMap::loadData(const char* filename)
+{
+    return loadData(filename, sWorld->getBoolConfig(CONFIG_MEMORY_MAPPED_DATA_FILES));
+}
+
+bool GridMap::loadData(const char* filename, bool memoryMapped)
 {
     // Unload old data if exist
     unloadData();
 
+    if (memoryMapped)
+    {
+        MappedFile* file = new MappedFile();
+        // Not return error if file not found
+        if (!file->Open(filename))
+        {
+            delete file;
+            return true;
+        }
+
+        map_fileheader header;
+        if (file->GetSize() >= sizeof(header))
+        {
+            memcpy(&header, file->GetData(), sizeof(header));
+            if (header.mapMagic.asUInt == MapMagic.asUInt && header.versionMagic.asUInt == MapVersionMagic.asUInt)
+            {
+                _mappedFile = file;
+                if (header.areaMapOffset && !loadAreaData(*file, header.areaMapOffset))
+                {
+                    TC_LOG_ERROR("maps", "Error loading map area data\n");
+                    return false;
+                }
+                if (header.heightMapOffset && !loadHeightData(*file, header.heightMapOffset))
+                {
+                    TC_LOG_ERROR("maps", "Error loading map height data\n");
+                    return false;
+                }
+                if (header.liquidMapOffset && !loadLiquidData(*file, header.liquidMapOffset))
+                {
+                    TC_LOG_ERROR("maps", "Error loading map liquids data\n");
+                    return false;
+                }
+                return true;
+            }
+        }
+
+        // files without aligned sections are read into buffers below, which also reports bad ones
+        delete file;
+    }
+
     map_fileheader header;
     // Not return error if file not found
     FILE* in = fopen(filename, "rb");
@@ -1626,7 +2232,8 @@ bool GridMap::loadData(const char* filename)
         return false;
     }
 
-    if (header.mapMagic.asUInt == MapMagic.asUInt && header.versionMagic.asUInt == MapVersionMagic.asUInt)
+    if (header.mapMagic.asUInt == MapMagic.asUInt &&
+        (header.versionMagic.asUInt == MapVersionMagic.asUInt || header.versionMagic.asUInt == MapVersionMagicUnaligned.asUInt))
     {
         // load up area data
         if (header.areaMapOffset && !loadAreaData(in, header.areaMapOffset, header.areaMapSize))
@@ -1661,12 +2268,21 @@ bool GridMap::loadData(const char* filename)
 
 void GridMap::unloadData()
 {
-    delete[] _areaMap;
-    delete[] m_V9;
-    delete[] m_V8;
-    delete[] _liquidEntry;
-    delete[] _liquidFlags;
-    delete[] _liquidMap;
+    if (_mappedFile)
+    {
+        delete _mappedFile;
+        _mappedFile = NULL;
+    }
+    else
+    {
+        delete[] _areaMap;
+        delete[] m_V9;
+        delete[] m_V8;
+        delete[] _liquidEntry;
+        delete[] _liquidFlags;
+        delete[] _liquidMap;
+    }
+
     _areaMap = NULL;
     m_V9 = NULL;
     m_V8 = NULL;
@@ -1774,6 +2390,111 @@ bool GridMap::loadLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
     return true;
 }
 
+// copies the section header at offset out of the mapped file
+template<class Header>
+static bool ReadMappedHeader(MappedFile const& file, uint32 offset, Header& header)
+{
+    if (offset > file.GetSize() || file.GetSize() - offset < sizeof(Header))
+        return false;
+
+    memcpy(&header, file.GetData() + offset, sizeof(Header));
+    return true;
+}
+
+// points array to count elements at offset in the mapped file, fails if they are out of bounds or misaligned
+template<class T>
+static bool MapFileArray(MappedFile const& file, uint32 offset, uint32 count, T*& array)
+{
+    if (offset > file.GetSize() || (file.GetSize() - offset) / sizeof(T) < count)
+        return false;
+
+    uint8* data = file.GetData() + offset;
+    if (reinterpret_cast<uintptr_t>(data) % sizeof(T))
+        return false;
+
+    array = reinterpret_cast<T*>(data);
+    return true;
+}
+
+bool GridMap::loadAreaData(MappedFile const& file, uint32 offset)
+{
+    map_areaHeader header;
+    if (!ReadMappedHeader(file, offset, header) || header.fourcc != MapAreaMagic.asUInt)
+        return false;
+
+    _gridArea = header.gridArea;
+    if (!(header.flags & MAP_AREA_NO_AREA))
+        return MapFileArray(file, offset + sizeof(header), 16*16, _areaMap);
+
+    return true;
+}
+
+bool GridMap::loadHeightData(MappedFile const& file, uint32 offset)
+{
+    map_heightHeader header;
+    if (!ReadMappedHeader(file, offset, header) || header.fourcc != MapHeightMagic.asUInt)
+        return false;
+
+    _gridHeight = header.gridHeight;
+    offset += sizeof(header);
+    if (!(header.flags & MAP_HEIGHT_NO_HEIGHT))
+    {
+        if ((header.flags & MAP_HEIGHT_AS_INT16))
+        {
+            if (!MapFileArray(file, offset, 129*129, m_uint16_V9) ||
+                !MapFileArray(file, offset + 129*129 * sizeof(uint16), 128*128, m_uint16_V8))
+                return false;
+            _gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 65535;
+            _gridGetHeight = &GridMap::getHeightFromUint16;
+        }
+        else if ((header.flags & MAP_HEIGHT_AS_INT8))
+        {
+            if (!MapFileArray(file, offset, 129*129, m_uint8_V9) ||
+                !MapFileArray(file, offset + 129*129 * sizeof(uint8), 128*128, m_uint8_V8))
+                return false;
+            _gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 255;
+            _gridGetHeight = &GridMap::getHeightFromUint8;
+        }
+        else
+        {
+            if (!MapFileArray(file, offset, 129*129, m_V9) ||
+                !MapFileArray(file, offset + 129*129 * sizeof(float), 128*128, m_V8))
+                return false;
+            _gridGetHeight = &GridMap::getHeightFromFloat;
+        }
+    }
+    else
+        _gridGetHeight = &GridMap::getHeightFromFlat;
+    return true;
+}
+
+bool GridMap::loadLiquidData(MappedFile const& file, uint32 offset)
+{
+    map_liquidHeader header;
+    if (!ReadMappedHeader(file, offset, header) || header.fourcc != MapLiquidMagic.asUInt)
+        return false;
+
+    _liquidType   = header.liquidType;
+    _liquidOffX  = header.offsetX;
+    _liquidOffY  = header.offsetY;
+    _liquidWidth = header.width;
+    _liquidHeight = header.height;
+    _liquidLevel  = header.liquidLevel;
+
+    offset += sizeof(header);
+    if (!(header.flags & MAP_LIQUID_NO_TYPE))
+    {
+        if (!MapFileArray(file, offset, 16*16, _liquidEntry) ||
+            !MapFileArray(file, offset + 16*16 * sizeof(uint16), 16*16, _liquidFlags))
+            return false;
+        offset += 16*16 * (sizeof(uint16) + sizeof(uint8));
+    }
+    if (!(header.flags & MAP_LIQUID_NO_HEIGHT))
+        return MapFileArray(file, offset, uint32(_liquidWidth) * uint32(_liquidHeight), _liquidMap);
+
+    return true;
+}
+
 uint16 GridMap::getArea(float x, float y) const
 {
     if (!_areaMap)
@@ -2439,8 +3160,25 @@ void Map::GetZoneAndAreaIdByAreaFlag(uint32& zoneid, uint32& areaid, uint16 area
 
 bool Map::isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask) const
 {
-    return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2)
-        && _dynamicTree.isInLineOfSight(x1, y1, z1, x2, y2, z2, phasemask);
+    boost::shared_lock<boost::shared_mutex> lock = LockDynamicTreeForRead();
+
+    if (!_collisionCache)
+        return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2)
+            && _dynamicTree.isInLineOfSight(x1, y1, z1, x2, y2, z2, phasemask);
+
+    MapCollisionCache::Lookup lookup(MapCollisionCache::MakeLineOfSightKey(x1, y1, z1, x2, y2, z2, phasemask), _dynamicTree.getGeneration());
+    MapCollisionCache::LookupResult cached = _collisionCache->Find(lookup);
+    if (cached == MapCollisionCache::LOOKUP_MISS)
+        lookup.StaticResult = VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2) ? 1.0f : 0.0f;
+
+    if (cached != MapCollisionCache::LOOKUP_HIT)
+    {
+        // as without cache, GameObjects are not checked if static geometry already blocks
+        lookup.DynamicResult = lookup.StaticResult != 0.0f && _dynamicTree.isInLineOfSight(x1, y1, z1, x2, y2, z2, phasemask) ? 1.0f : 0.0f;
+        _collisionCache->Store(lookup);
+    }
+
+    return lookup.StaticResult != 0.0f && lookup.DynamicResult != 0.0f;
 }
 
 bool Map::getObjectHitPos(uint32 phasemask, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float modifyDist)
@@ -2449,6 +3187,7 @@ bool Map::getObjectHitPos(uint32 phasemask, float x1, float y1, float z1, float
     G3D::Vector3 dstPos(x2, y2, z2);
 
     G3D::Vector3 resultPos;
+    boost::shared_lock<boost::shared_mutex> lock = LockDynamicTreeForRead();
     bool result = _dynamicTree.getObjectHitPos(phasemask, startPos, dstPos, resultPos, modifyDist);
 
     rx = resultPos.x;
@@ -2459,7 +3198,23 @@ bool Map::getObjectHitPos(uint32 phasemask, float x1, float y1, float z1, float
 
 float Map::GetHeight(uint32 phasemask, float x, float y, float z, bool vmap/*=true*/, float maxSearchDist/*=DEFAULT_HEIGHT_SEARCH*/) const
 {
-    return std::max<float>(GetHeight(x, y, z, vmap, maxSearchDist), _dynamicTree.getHeight(x, y, z, maxSearchDist, phasemask));
+    boost::shared_lock<boost::shared_mutex> lock = LockDynamicTreeForRead();
+
+    if (!_collisionCache)
+        return std::max<float>(GetHeight(x, y, z, vmap, maxSearchDist), _dynamicTree.getHeight(x, y, z, maxSearchDist, phasemask));
+
+    MapCollisionCache::Lookup lookup(MapCollisionCache::MakeHeightKey(x, y, z, vmap, maxSearchDist, phasemask), _dynamicTree.getGeneration());
+    MapCollisionCache::LookupResult cached = _collisionCache->Find(lookup);
+    if (cached == MapCollisionCache::LOOKUP_MISS)
+        lookup.StaticResult = GetHeight(x, y, z, vmap, maxSearchDist);
+
+    if (cached != MapCollisionCache::LOOKUP_HIT)
+    {
+        lookup.DynamicResult = _dynamicTree.getHeight(x, y, z, maxSearchDist, phasemask);
+        _collisionCache->Store(lookup);
+    }
+
+    return std::max<float>(lookup.StaticResult, lookup.DynamicResult);
 }
 
 bool Map::IsInWater(float x, float y, float pZ, LiquidData* data) const
@@ -2615,6 +3370,9 @@ void Map::DelayedUpdate(const uint32 t_diff)
 
     RemoveAllObjectsInRemoveList();
 
+    // changes made after Map::Update (instance scripts, transports, world thread) still go out this tick
+    SendObjectUpdates();
+
     // Don't unload grids if it's battleground, since we may have manually added GOs, creatures, those doesn't load from DB at grid re-load !
     // This isn't really bother us, since as soon as we have instanced BG-s, the whole map unloads as the BG gets ended
     if (!IsBattlegroundOrArena())
@@ -2632,6 +3390,8 @@ void Map::DelayedUpdate(const uint32 t_diff)
 
 void Map::AddObjectToRemoveList(WorldObject* obj)
 {
+    std::unique_lock<std::recursive_mutex> lock = LockForRegionUpdate();
+
     ASSERT(obj->GetMapId() == GetId() && obj->GetInstanceId() == GetInstanceId());
 
     obj->CleanupsBeforeDelete(false);                            // remove or simplify at least cross referenced links
@@ -2642,6 +3402,8 @@ void Map::AddObjectToRemoveList(WorldObject* obj)
 
 void Map::AddObjectToSwitchList(WorldObject* obj, bool on)
 {
+    std::unique_lock<std::recursive_mutex> lock = LockForRegionUpdate();
+
     ASSERT(obj->GetMapId() == GetId() && obj->GetInstanceId() == GetInstanceId());
     // i_objectsToSwitch is iterated only in Map::RemoveAllObjectsInRemoveList() and it uses
     // the contained objects only if GetTypeId() == TYPEID_UNIT , so we can return in all other cases
@@ -3370,7 +4132,10 @@ void Map::SaveCreatureRespawnTime(uint32 dbGuid, time_t respawnTime)
         return;
     }
 
-    _creatureRespawnTimes[dbGuid] = respawnTime;
+    {
+        std::unique_lock<std::recursive_mutex> lock = LockForRegionUpdate();
+        _creatureRespawnTimes[dbGuid] = respawnTime;
+    }
 
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_REP_CREATURE_RESPAWN);
     stmt->setUInt32(0, dbGuid);
@@ -3382,7 +4147,10 @@ void Map::SaveCreatureRespawnTime(uint32 dbGuid, time_t respawnTime)
 
 void Map::RemoveCreatureRespawnTime(uint32 dbGuid)
 {
-    _creatureRespawnTimes.erase(dbGuid);
+    {
+        std::unique_lock<std::recursive_mutex> lock = LockForRegionUpdate();
+        _creatureRespawnTimes.erase(dbGuid);
+    }
 
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CREATURE_RESPAWN);
     stmt->setUInt32(0, dbGuid);
@@ -3400,7 +4168,10 @@ void Map::SaveGORespawnTime(uint32 dbGuid, time_t respawnTime)
         return;
     }
 
-    _goRespawnTimes[dbGuid] = respawnTime;
+    {
+        std::unique_lock<std::recursive_mutex> lock = LockForRegionUpdate();
+        _goRespawnTimes[dbGuid] = respawnTime;
+    }
 
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_REP_GO_RESPAWN);
     stmt->setUInt32(0, dbGuid);
@@ -3412,7 +4183,10 @@ void Map::SaveGORespawnTime(uint32 dbGuid, time_t respawnTime)
 
 void Map::RemoveGORespawnTime(uint32 dbGuid)
 {
-    _goRespawnTimes.erase(dbGuid);
+    {
+        std::unique_lock<std::recursive_mutex> lock = LockForRegionUpdate();
+        _goRespawnTimes.erase(dbGuid);
+    }
 
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_GO_RESPAWN);
     stmt->setUInt32(0, dbGuid);
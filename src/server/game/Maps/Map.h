@@ -30,10 +30,15 @@
 #include "MapRefManager.h"
 #include "DynamicTree.h"
 #include "GameObjectModel.h"
+#include "MapCollisionCache.h"
 #include "ObjectGuid.h"
 
+#include <boost/thread/shared_mutex.hpp>
+
 #include <bitset>
 #include <list>
+#include <mutex>
+#include <vector>
 
 class Unit;
 class WorldPacket;
@@ -53,6 +58,8 @@ class MapInstanced;
 class BattlegroundMap;
 class InstanceMap;
 class Transport;
+class MappedFile;
+struct PreloadedGrid;
 namespace Trinity { struct ObjectUpdater; }
 
 struct ScriptAction
@@ -184,10 +191,15 @@ class GridMap
     uint8 _liquidWidth;
     uint8 _liquidHeight;
 
+    // set when the arrays above point into the mapped file instead of buffers of their own
+    MappedFile* _mappedFile;
 
     bool loadAreaData(FILE* in, uint32 offset, uint32 size);
     bool loadHeightData(FILE* in, uint32 offset, uint32 size);
     bool loadLiquidData(FILE* in, uint32 offset, uint32 size);
+    bool loadAreaData(MappedFile const& file, uint32 offset);
+    bool loadHeightData(MappedFile const& file, uint32 offset);
+    bool loadLiquidData(MappedFile const& file, uint32 offset);
 
     // Get height functions and pointers
     typedef float (GridMap::*GetHeightPtr) (float x, float y) const;
@@ -201,7 +213,9 @@ public:
     GridMap();
     ~GridMap();
     bool loadData(const char* filename);
+    bool loadData(const char* filename, bool memoryMapped);
     void unloadData();
+    bool isMapped() const { return _mappedFile != NULL; }
 
     uint16 getArea(float x, float y) const;
     inline float getHeight(float x, float y) const {return (this->*_gridGetHeight)(x, y);}
@@ -319,6 +333,8 @@ class Map : public GridRefManager<NGridType>
 
         static void InitStateMachine();
         static void DeleteStateMachine();
+        // largest spell range plus the largest spell radius, must be called after the DBC stores are loaded
+        static void InitMaxSpellReach();
 
         Map const* GetParent() const { return m_parentMap; }
 
@@ -371,6 +387,34 @@ class Map : public GridRefManager<NGridType>
         bool CheckGridIntegrity(Creature* c, bool moved) const;
 
         uint32 GetInstanceId() const { return i_InstanceId; }
+        // duration of the previous update in microseconds, MapUpdater starts the most expensive maps first
+        uint32 GetUpdateCost() const { return _updateCost; }
+        void SetUpdateCost(uint32 cost) { _updateCost = cost; }
+
+        // objects with changed fields, sent to the players around them by SendObjectUpdates at the end of the map update
+        void AddUpdateObject(Object* obj);
+        void RemoveUpdateObject(Object* obj);
+        void SendObjectUpdates();
+
+        struct ObjectUpdateStats
+        {
+            uint64 BuildTime;   // microseconds spent in Object::BuildUpdate
+            uint64 SendTime;    // microseconds spent building and sending the packets
+            uint64 Objects;
+            uint64 Packets;
+            uint32 Flushes;     // flushes that had at least one object queued
+            uint32 MaxTime;     // microseconds, slowest flush
+        };
+
+        ObjectUpdateStats GetObjectUpdateStats() const;
+
+        // MapUpdate.Regions.Margin, raised to cover the visibility range. The map is not split at all
+        // if a spell reaches further than the margin
+        uint32 GetRegionMargin() const;
+        static float GetMaxSpellReach() { return _maxSpellReach; }
+        // one update of the active cells split into regions, players and map wide lists are left alone, for .debug regionbench
+        uint32 UpdateRegionsForBenchmark(uint32 diff, uint32 maxThreads);
+        void ResetObjectUpdateStats();
         uint8 GetSpawnMode() const { return (i_spawnMode); }
         virtual bool CanEnter(Player* /*player*/) { return true; }
         const char* GetMapName() const;
@@ -461,9 +505,26 @@ class Map : public GridRefManager<NGridType>
         float GetHeight(uint32 phasemask, float x, float y, float z, bool vmap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const;
         bool isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask) const;
         void Balance() { _dynamicTree.balance(); }
-        void RemoveGameObjectModel(const GameObjectModel& model) { _dynamicTree.remove(model); }
-        void InsertGameObjectModel(const GameObjectModel& model) { _dynamicTree.insert(model); }
-        bool ContainsGameObjectModel(const GameObjectModel& model) const { return _dynamicTree.contains(model);}
+        void RemoveGameObjectModel(const GameObjectModel& model)
+        {
+            boost::unique_lock<boost::shared_mutex> lock = LockDynamicTreeForWrite();
+            _dynamicTree.remove(model);
+        }
+
+        void InsertGameObjectModel(const GameObjectModel& model)
+        {
+            boost::unique_lock<boost::shared_mutex> lock = LockDynamicTreeForWrite();
+            _dynamicTree.insert(model);
+        }
+
+        bool ContainsGameObjectModel(const GameObjectModel& model) const
+        {
+            boost::shared_lock<boost::shared_mutex> lock = LockDynamicTreeForRead();
+            return _dynamicTree.contains(model);
+        }
+
+        void InvalidateGameObjectModels() { _dynamicTree.invalidate(); }
+        MapCollisionCache* GetCollisionCache() const { return _collisionCache.get(); }
         bool getObjectHitPos(uint32 phasemask, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float &ry, float& rz, float modifyDist);
 
         virtual uint32 GetOwnerGuildId(uint32 /*team*/ = TEAM_OTHER) const { return 0; }
@@ -473,6 +534,7 @@ class Map : public GridRefManager<NGridType>
         time_t GetLinkedRespawnTime(ObjectGuid guid) const;
         time_t GetCreatureRespawnTime(uint32 dbGuid) const
         {
+            std::unique_lock<std::recursive_mutex> lock = LockForRegionUpdate();
             std::unordered_map<uint32 /*dbGUID*/, time_t>::const_iterator itr = _creatureRespawnTimes.find(dbGuid);
             if (itr != _creatureRespawnTimes.end())
                 return itr->second;
@@ -482,6 +544,7 @@ class Map : public GridRefManager<NGridType>
 
         time_t GetGORespawnTime(uint32 dbGuid) const
         {
+            std::unique_lock<std::recursive_mutex> lock = LockForRegionUpdate();
             std::unordered_map<uint32 /*dbGUID*/, time_t>::const_iterator itr = _goRespawnTimes.find(dbGuid);
             if (itr != _goRespawnTimes.end())
                 return itr->second;
@@ -512,8 +575,8 @@ class Map : public GridRefManager<NGridType>
     private:
         void LoadMapAndVMap(int gx, int gy);
         void LoadVMap(int gx, int gy);
-        void LoadMap(int gx, int gy, bool reload = false);
-        void LoadMMap(int gx, int gy);
+        void LoadMap(int gx, int gy, bool reload = false, PreloadedGrid* preloaded = NULL);
+        void LoadMMap(int gx, int gy, PreloadedGrid* preloaded = NULL);
         GridMap* GetGrid(float x, float y);
 
         void SetTimer(uint32 t) { i_gridExpiry = t < MIN_GRID_DELAY ? MIN_GRID_DELAY : t; }
@@ -575,6 +638,14 @@ class Map : public GridRefManager<NGridType>
         uint32 m_unloadTimer;
         float m_VisibleDistance;
         DynamicMapTree _dynamicTree;
+        std::unique_ptr<MapCollisionCache> _collisionCache; // NULL unless vmap.collisionCacheSize is set
+
+        // Object::_updateQueueIndex is the position in _updateObjects, removal swaps with the last element
+        std::vector<Object*> _updateObjects;
+        std::vector<Object*> _sendingUpdateObjects;
+        std::mutex _updateObjectsLock;                      // objects of other maps (and regions) may queue from their threads
+        ObjectUpdateStats _objectUpdateStats;
+        mutable std::mutex _objectUpdateStatsLock;          // the stats are read by commands running on the world thread
 
         MapRefManager m_mapRefManager;
         MapRefManager::iterator m_mapRefIter;
@@ -601,6 +672,7 @@ class Map : public GridRefManager<NGridType>
         GameObject* _FindGameObject(WorldObject* pWorldObject, uint32 guid) const;
 
         time_t i_gridExpiry;
+        uint32 _updateCost;
 
         //used for fast base_map (e.g. MapInstanced class object) search for
         //InstanceMaps and BattlegroundMaps...
@@ -614,6 +686,49 @@ class Map : public GridRefManager<NGridType>
         //visibility calculations. Highly optimized for massive calculations
         void ProcessRelocationNotifies(const uint32 diff);
 
+        // requests the grids moving players reach within GridPreload.Lookahead seconds from the GridPreloader
+        void PreloadGridsAhead();
+
+        // Parallel region update (MapUpdate.Regions.Enable)
+        // Active cells are split into regions separated by at least GetRegionMargin() inactive cells and
+        // units in combat with or controlling each other are kept in one region, objects of different regions
+        // cannot reach each other so every region is updated on its own thread.
+        // Map wide containers (move lists, remove list, active objects, grids, respawn times, script schedule)
+        // are still shared and only touched under _regionUpdateLock while the regions are updated,
+        // scripts started meanwhile run after the regions finished. _dynamicTree has its own lock.
+        // returns the number of regions, maxThreads = 0 uses as many threads as there are regions
+        uint32 UpdateRegions(uint32 diff, uint32 maxThreads = 0);
+        void UpdateRegionCells(std::vector<uint32> const& cells, uint32 diff);
+        std::unique_lock<std::recursive_mutex> LockForRegionUpdate() const
+        {
+            if (!_regionUpdateInProgress)
+                return std::unique_lock<std::recursive_mutex>();
+
+            return std::unique_lock<std::recursive_mutex>(_regionUpdateLock);
+        }
+
+        // _dynamicTree is read by every region while GameObjects of any region insert or remove their models
+        boost::shared_lock<boost::shared_mutex> LockDynamicTreeForRead() const
+        {
+            if (!_regionUpdateInProgress)
+                return boost::shared_lock<boost::shared_mutex>();
+
+            return boost::shared_lock<boost::shared_mutex>(_dynamicTreeLock);
+        }
+
+        boost::unique_lock<boost::shared_mutex> LockDynamicTreeForWrite()
+        {
+            if (!_regionUpdateInProgress)
+                return boost::unique_lock<boost::shared_mutex>();
+
+            return boost::unique_lock<boost::shared_mutex>(_dynamicTreeLock);
+        }
+
+        mutable std::recursive_mutex _regionUpdateLock;
+        mutable boost::shared_mutex _dynamicTreeLock;
+        bool _regionUpdateInProgress;
+        static float _maxSpellReach;
+
         bool i_scriptLock;
         std::set<WorldObject*> i_objectsToRemove;
         std::map<WorldObject*, bool> i_objectsToSwitch;
@@ -631,11 +746,13 @@ class Map : public GridRefManager<NGridType>
 
         void AddToActiveHelper(WorldObject* obj)
         {
+            std::unique_lock<std::recursive_mutex> lock = LockForRegionUpdate();
             m_activeNonPlayers.insert(obj);
         }
 
         void RemoveFromActiveHelper(WorldObject* obj)
         {
+            std::unique_lock<std::recursive_mutex> lock = LockForRegionUpdate();
             // Map::Update for active object in proccess
             if (m_activeNonPlayersIter != m_activeNonPlayers.end())
             {
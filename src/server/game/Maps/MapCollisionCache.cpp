@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2008-2015 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapCollisionCache.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+static float const COLLISION_CACHE_CELLS_PER_YARD = 8.0f;
+
+static int32 Quantize(float value)
+{
+    value = std::floor(value * COLLISION_CACHE_CELLS_PER_YARD);
+    // also catches NaN, those never match anything valid
+    if (!(std::fabs(value) < float(std::numeric_limits<int32>::max() / 2)))
+        return std::numeric_limits<int32>::max();
+    return int32(value);
+}
+
+bool MapCollisionCache::Key::operator==(Key const& right) const
+{
+    return Type == right.Type && PhaseMask == right.PhaseMask && memcmp(Coords, right.Coords, sizeof(Coords)) == 0;
+}
+
+MapCollisionCache::MapCollisionCache(uint32 size) : _shardMask(0), _staticGeneration(0)
+{
+    uint32 entriesPerShard = 1;
+    while (entriesPerShard * SHARD_COUNT < size && entriesPerShard < 0x10000)
+        entriesPerShard <<= 1;
+
+    _shardMask = entriesPerShard - 1;
+    for (uint32 i = 0; i < SHARD_COUNT; ++i)
+        _shards[i].Entries.reset(new Entry[entriesPerShard]);
+}
+
+MapCollisionCache::Key MapCollisionCache::MakeLineOfSightKey(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phaseMask)
+{
+    Key key;
+    key.Coords[0] = Quantize(x1);
+    key.Coords[1] = Quantize(y1);
+    key.Coords[2] = Quantize(z1);
+    key.Coords[3] = Quantize(x2);
+    key.Coords[4] = Quantize(y2);
+    key.Coords[5] = Quantize(z2);
+    key.PhaseMask = phaseMask;
+    key.Type = QUERY_LINE_OF_SIGHT;
+    return key;
+}
+
+MapCollisionCache::Key MapCollisionCache::MakeHeightKey(float x, float y, float z, bool vmap, float maxSearchDist, uint32 phaseMask)
+{
+    Key key;
+    key.Coords[0] = Quantize(x);
+    key.Coords[1] = Quantize(y);
+    key.Coords[2] = Quantize(z);
+    key.Coords[3] = Quantize(maxSearchDist);
+    key.Coords[4] = vmap ? 1 : 0;
+    key.Coords[5] = 0;
+    key.PhaseMask = phaseMask;
+    key.Type = QUERY_HEIGHT;
+    return key;
+}
+
+uint64 MapCollisionCache::HashKey(Key const& key)
+{
+    uint64 hash = UI64LIT(14695981039346656037);
+    for (uint32 i = 0; i < 6; ++i)
+        hash = (hash ^ uint32(key.Coords[i])) * UI64LIT(1099511628211);
+
+    hash = (hash ^ key.PhaseMask) * UI64LIT(1099511628211);
+    hash = (hash ^ key.Type) * UI64LIT(1099511628211);
+    return hash ^ (hash >> 29);
+}
+
+MapCollisionCache::LookupResult MapCollisionCache::Find(Lookup& lookup)
+{
+    uint64 hash = HashKey(lookup.QueryKey);
+    Shard& shard = _shards[hash >> 60];
+    lookup.StaticGeneration = _staticGeneration.load(std::memory_order_acquire);
+
+    std::lock_guard<std::mutex> lock(shard.Lock);
+    Entry const& entry = shard.Entries[uint32(hash) & _shardMask];
+    if (entry.StaticGeneration != lookup.StaticGeneration || !(entry.EntryKey == lookup.QueryKey))
+    {
+        ++shard.ShardStats.Misses;
+        return LOOKUP_MISS;
+    }
+
+    lookup.StaticResult = entry.StaticResult;
+    if (entry.DynamicGeneration != lookup.DynamicGeneration)
+    {
+        ++shard.ShardStats.StaticHits;
+        return LOOKUP_STATIC_HIT;
+    }
+
+    lookup.DynamicResult = entry.DynamicResult;
+    ++shard.ShardStats.Hits;
+    return LOOKUP_HIT;
+}
+
+void MapCollisionCache::Store(Lookup const& lookup)
+{
+    uint64 hash = HashKey(lookup.QueryKey);
+    Shard& shard = _shards[hash >> 60];
+
+    std::lock_guard<std::mutex> lock(shard.Lock);
+    Entry& entry = shard.Entries[uint32(hash) & _shardMask];
+    entry.EntryKey = lookup.QueryKey;
+    // if grids changed while the result was computed, the old generation turns it into a miss
+    entry.StaticGeneration = lookup.StaticGeneration;
+    entry.DynamicGeneration = lookup.DynamicGeneration;
+    entry.StaticResult = lookup.StaticResult;
+    entry.DynamicResult = lookup.DynamicResult;
+}
+
+void MapCollisionCache::InvalidateStatic()
+{
+    ++_staticGeneration;
+}
+
+MapCollisionCache::Stats MapCollisionCache::GetStats()
+{
+    Stats stats;
+    for (uint32 i = 0; i < SHARD_COUNT; ++i)
+    {
+        std::lock_guard<std::mutex> lock(_shards[i].Lock);
+        stats.Hits += _shards[i].ShardStats.Hits;
+        stats.StaticHits += _shards[i].ShardStats.StaticHits;
+        stats.Misses += _shards[i].ShardStats.Misses;
+    }
+
+    return stats;
+}
+
+void MapCollisionCache::ResetStats()
+{
+    for (uint32 i = 0; i < SHARD_COUNT; ++i)
+    {
+        std::lock_guard<std::mutex> lock(_shards[i].Lock);
+        _shards[i].ShardStats = Stats();
+    }
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2008-2015 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MAP_COLLISION_CACHE_H_INCLUDED
+#define _MAP_COLLISION_CACHE_H_INCLUDED
+
+#include "Define.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+/*
+ * Bounded cache of the line of sight and ground height results of a map.
+ *
+ * Positions are quantized to 1/8 yard, queries falling into the same cells share
+ * one result. Every result is kept in two parts: the static one (grid height maps
+ * and vmaps), dropped when grids are loaded or unloaded, and the dynamic one
+ * (GameObject models), computed again when the map's DynamicMapTree changed since
+ * it was stored, so moving transports don't throw away the expensive vmap results.
+ *
+ * Entries are split into independently locked shards, regions of one map may be
+ * updated in parallel.
+ */
+class MapCollisionCache
+{
+    public:
+        enum QueryType
+        {
+            QUERY_NONE,
+            QUERY_LINE_OF_SIGHT,
+            QUERY_HEIGHT
+        };
+
+        enum LookupResult
+        {
+            LOOKUP_MISS,
+            LOOKUP_STATIC_HIT,                              // dynamic part has to be computed again
+            LOOKUP_HIT
+        };
+
+        struct Key
+        {
+            int32 Coords[6];
+            uint32 PhaseMask;
+            uint32 Type;
+
+            bool operator==(Key const& right) const;
+        };
+
+        struct Lookup
+        {
+            Lookup(Key const& key, uint32 dynamicGeneration)
+                : QueryKey(key), StaticGeneration(0), DynamicGeneration(dynamicGeneration), StaticResult(0.0f), DynamicResult(0.0f) { }
+
+            Key QueryKey;
+            uint32 StaticGeneration;
+            uint32 DynamicGeneration;
+            float StaticResult;                             // height, or 1.0f if the line of sight is clear
+            float DynamicResult;
+        };
+
+        struct Stats
+        {
+            Stats() : Hits(0), StaticHits(0), Misses(0) { }
+
+            uint64 Hits;
+            uint64 StaticHits;
+            uint64 Misses;
+        };
+
+        explicit MapCollisionCache(uint32 size);
+
+        static Key MakeLineOfSightKey(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phaseMask);
+        static Key MakeHeightKey(float x, float y, float z, bool vmap, float maxSearchDist, uint32 phaseMask);
+
+        /// Fills the results of lookup with what is cached, Store() must be called after computing the missing parts
+        LookupResult Find(Lookup& lookup);
+        void Store(Lookup const& lookup);
+
+        /// Grid maps or vmaps were loaded or unloaded
+        void InvalidateStatic();
+
+        uint32 GetSize() const { return SHARD_COUNT * (_shardMask + 1); }
+        uint32 GetStaticInvalidations() const { return _staticGeneration.load(std::memory_order_relaxed); }
+        Stats GetStats();
+        void ResetStats();
+
+    private:
+        static uint32 const SHARD_COUNT = 16;
+
+        struct Entry
+        {
+            Entry() : StaticGeneration(0), DynamicGeneration(0), StaticResult(0.0f), DynamicResult(0.0f)
+            {
+                EntryKey.Type = QUERY_NONE;
+            }
+
+            Key EntryKey;
+            uint32 StaticGeneration;
+            uint32 DynamicGeneration;
+            float StaticResult;
+            float DynamicResult;
+        };
+
+        struct Shard
+        {
+            std::mutex Lock;
+            std::unique_ptr<Entry[]> Entries;
+            Stats ShardStats;
+        };
+
+        static uint64 HashKey(Key const& key);
+
+        Shard _shards[SHARD_COUNT];
+        uint32 _shardMask;
+        std::atomic<uint32> _staticGeneration;
+
+        MapCollisionCache(MapCollisionCache const& right) = delete;
+        MapCollisionCache& operator=(MapCollisionCache const& right) = delete;
+};
+
+#endif //_MAP_COLLISION_CACHE_H_INCLUDED
@@ -49,11 +49,15 @@ MapManager::~MapManager() { }
 void MapManager::Initialize()
 {
     Map::InitStateMachine();
+    Map::InitMaxSpellReach();
 
     int num_threads(sWorld->getIntConfig(CONFIG_NUMTHREADS));
     // Start mtmaps if needed.
     if (num_threads > 0)
         m_updater.activate(num_threads);
+
+    if (sWorld->getIntConfig(CONFIG_GRID_PRELOAD_LOOKAHEAD))
+        _gridPreloader.Start();
 }
 
 void MapManager::InitializeVisibilityDistanceInfo()
@@ -237,20 +241,35 @@ void MapManager::Update(uint32 diff)
         return;
 
     MapMapType::iterator iter = i_maps.begin();
-    for (; iter != i_maps.end(); ++iter)
+    if (m_updater.activated())
     {
-        if (m_updater.activated())
-            m_updater.schedule_update(*iter->second, uint32(i_timer.GetCurrent()));
-        else
+        // schedule the maps that took longest last tick first so they do not end up queued behind cheap ones
+        std::vector<Map*> maps;
+        maps.reserve(i_maps.size());
+        for (; iter != i_maps.end(); ++iter)
+            maps.push_back(iter->second);
+
+        std::sort(maps.begin(), maps.end(), [](Map const* left, Map const* right)
+        {
+            return left->GetUpdateCost() > right->GetUpdateCost();
+        });
+
+        for (Map* map : maps)
+            m_updater.schedule_update(*map, uint32(i_timer.GetCurrent()));
+
+        m_updater.wait();
+    }
+    else
+    {
+        for (; iter != i_maps.end(); ++iter)
             iter->second->Update(uint32(i_timer.GetCurrent()));
     }
-    if (m_updater.activated())
-        m_updater.wait();
 
     for (iter = i_maps.begin(); iter != i_maps.end(); ++iter)
         iter->second->DelayedUpdate(uint32(i_timer.GetCurrent()));
 
-    sObjectAccessor->Update(uint32(i_timer.GetCurrent()));
+    if (_gridPreloader.IsActive())
+        _gridPreloader.Update();
 
     i_timer.SetCurrent(0);
 }
@@ -281,6 +300,9 @@ bool MapManager::IsValidMAP(uint32 mapid, bool startUp)
 
 void MapManager::UnloadAll()
 {
+    // releases the vmap models held by preloaded grids
+    _gridPreloader.Stop();
+
     for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end();)
     {
         iter->second->UnloadAll();
@@ -21,6 +21,7 @@
 
 #include "Object.h"
 #include "Map.h"
+#include "GridPreloader.h"
 #include "GridStates.h"
 #include "MapUpdater.h"
 
@@ -124,6 +125,7 @@ class MapManager
         void SetNextInstanceId(uint32 nextInstanceId) { _nextInstanceId = nextInstanceId; };
 
         MapUpdater * GetMapUpdater() { return &m_updater; }
+        GridPreloader* GetGridPreloader() { return &_gridPreloader; }
 
     private:
         typedef std::unordered_map<uint32, Map*> MapMapType;
@@ -149,6 +151,7 @@ class MapManager
         InstanceIds _instanceIds;
         uint32 _nextInstanceId;
         MapUpdater m_updater;
+        GridPreloader _gridPreloader;
 };
 #define sMapMgr MapManager::instance()
 #endif
@@ -19,36 +19,18 @@
 #include "MapUpdater.h"
 #include "Map.h"
 
-#include <mutex>
-
-
-class MapUpdateRequest
-{
-    private:
-
-        Map& m_map;
-        MapUpdater& m_updater;
-        uint32 m_diff;
-
-    public:
-
-        MapUpdateRequest(Map& m, MapUpdater& u, uint32 d)
-            : m_map(m), m_updater(u), m_diff(d)
-        {
-        }
-
-        void call()
-        {
-            m_map.Update (m_diff);
-            m_updater.update_finished();
-        }
-};
+#include <algorithm>
+#include <chrono>
+#include <limits>
 
 void MapUpdater::activate(size_t num_threads)
 {
+    for (size_t i = 0; i < num_threads; ++i)
+        _workers.push_back(std::unique_ptr<Worker>(new Worker()));
+
     for (size_t i = 0; i < num_threads; ++i)
     {
-        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
+        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this, i));
     }
 }
 
@@ -58,7 +40,10 @@ void MapUpdater::deactivate()
 
     wait();
 
-    _queue.Cancel();
+    {
+        std::lock_guard<std::mutex> lock(_sleepLock);
+        _sleepCondition.notify_all();
+    }
 
     for (auto& thread : _workerThreads)
     {
@@ -68,21 +53,58 @@ void MapUpdater::deactivate()
 
 void MapUpdater::wait()
 {
-    std::unique_lock<std::mutex> lock(_lock);
+    std::unique_lock<std::mutex> lock(_completionLock);
 
-    while (pending_requests > 0)
-        _condition.wait(lock);
-
-    lock.unlock();
+    _completionCondition.wait(lock, [this]() { return _pendingRequests == 0; });
 }
 
 void MapUpdater::schedule_update(Map& map, uint32 diff)
 {
-    std::lock_guard<std::mutex> lock(_lock);
+    Enqueue(MapUpdateRequest(&map, diff, map.GetUpdateCost()));
+}
+
+void MapUpdater::schedule_job(std::function<void()>&& job)
+{
+    Enqueue(MapUpdateRequest(std::move(job)));
+}
+
+void MapUpdater::Enqueue(MapUpdateRequest&& request)
+{
+    // pick the worker with the least amount of queued work, maps without a measured cost yet still count as one unit
+    Worker* target = nullptr;
+    uint64 targetCost = 0;
+    for (auto& worker : _workers)
+    {
+        uint64 queuedCost = worker->QueuedCost;
+        if (!target || queuedCost < targetCost)
+        {
+            target = worker.get();
+            targetCost = queuedCost;
+        }
+    }
+
+    ++_pendingRequests;
+    ++_queuedRequests;
+
+    {
+        std::lock_guard<std::mutex> lock(target->Lock);
+
+        auto itr = std::upper_bound(target->Queue.begin(), target->Queue.end(), request.m_cost, [](uint32 cost, MapUpdateRequest const& queued)
+        {
+            return cost > queued.m_cost;
+        });
+
+        // jobs are part of an update already running, they only take the queue position and do not add to the load
+        if (request.m_map)
+            target->QueuedCost += uint64(request.m_cost) + 1;
 
-    ++pending_requests;
+        target->Queue.insert(itr, std::move(request));
+    }
 
-    _queue.Push(new MapUpdateRequest(map, *this, diff));
+    {
+        std::lock_guard<std::mutex> lock(_sleepLock);
+        _sleepCondition.notify_one();
+    }
 }
 
 bool MapUpdater::activated()
@@ -90,28 +112,103 @@ bool MapUpdater::activated()
     return _workerThreads.size() > 0;
 }
 
-void MapUpdater::update_finished()
+std::vector<MapUpdater::WorkerStats> MapUpdater::GetWorkerStats() const
+{
+    std::vector<WorkerStats> stats;
+    stats.reserve(_workers.size());
+
+    for (auto const& worker : _workers)
+    {
+        WorkerStats workerStats;
+        workerStats.BusyTime = worker->BusyTime;
+        workerStats.IdleTime = worker->IdleTime;
+        workerStats.Updates = worker->Updates;
+        workerStats.Steals = worker->Steals;
+        stats.push_back(workerStats);
+    }
+
+    return stats;
+}
+
+bool MapUpdater::TryPop(size_t workerIndex, MapUpdateRequest& request)
+{
+    Worker& worker = *_workers[workerIndex];
+
+    std::lock_guard<std::mutex> lock(worker.Lock);
+    if (worker.Queue.empty())
+        return false;
+
+    request = std::move(worker.Queue.front());
+    worker.Queue.pop_front();
+    if (request.m_map)
+        worker.QueuedCost -= uint64(request.m_cost) + 1;
+    --_queuedRequests;
+    return true;
+}
+
+bool MapUpdater::TrySteal(size_t workerIndex, MapUpdateRequest& request)
 {
-    std::lock_guard<std::mutex> lock(_lock);
+    // thieves take the most expensive pending update too, a long update started late is what stretches the tick
+    for (size_t i = 1; i < _workers.size(); ++i)
+        if (TryPop((workerIndex + i) % _workers.size(), request))
+            return true;
+
+    return false;
+}
 
-    --pending_requests;
+void MapUpdater::update_finished()
+{
+    if (--_pendingRequests > 0)
+        return;
 
-    _condition.notify_all();
+    std::lock_guard<std::mutex> lock(_completionLock);
+    _completionCondition.notify_all();
 }
 
-void MapUpdater::WorkerThread()
+void MapUpdater::WorkerThread(size_t workerIndex)
 {
+    Worker& worker = *_workers[workerIndex];
+
     while (1)
     {
-        MapUpdateRequest* request = nullptr;
+        MapUpdateRequest request(nullptr, 0, 0);
+
+        if (!TryPop(workerIndex, request))
+        {
+            if (!TrySteal(workerIndex, request))
+            {
+                std::chrono::steady_clock::time_point idleStart = std::chrono::steady_clock::now();
+
+                {
+                    std::unique_lock<std::mutex> lock(_sleepLock);
+                    _sleepCondition.wait(lock, [this]() { return _queuedRequests > 0 || _cancelationToken; });
+                }
+
+                worker.IdleTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - idleStart).count();
+
+                if (_cancelationToken && _queuedRequests == 0)
+                    return;
+
+                continue;
+            }
+
+            ++worker.Steals;
+        }
+
+        std::chrono::steady_clock::time_point updateStart = std::chrono::steady_clock::now();
 
-        _queue.WaitAndPop(request);
+        if (request.m_map)
+            request.m_map->Update(request.m_diff);
+        else
+            request.m_job();
 
-        if (_cancelationToken)
-            return;
+        uint64 elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - updateStart).count();
+        if (request.m_map)
+            request.m_map->SetUpdateCost(uint32(std::min<uint64>(elapsed, std::numeric_limits<uint32>::max())));
 
-        request->call();
+        worker.BusyTime += elapsed;
+        ++worker.Updates;
 
-        delete request;
+        update_finished();
     }
 }
@@ -20,25 +20,46 @@
 #define _MAP_UPDATER_H_INCLUDED
 
 #include "Define.h"
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 #include <condition_variable>
-#include "ProducerConsumerQueue.h"
 
-class MapUpdateRequest;
 class Map;
 
+/*
+ * Schedules map updates on a pool of worker threads.
+ *
+ * Every worker owns a deque of pending updates kept sorted by the cost the map
+ * needed for its previous update, most expensive first. New updates go to the
+ * worker with the least queued cost and idle workers steal from the others,
+ * so one crowded continent no longer holds back maps queued behind it.
+ */
 class MapUpdater
 {
     public:
 
-        MapUpdater() : _cancelationToken(false), pending_requests(0) {}
-        ~MapUpdater() { };
+        struct WorkerStats
+        {
+            uint64 BusyTime;    // microseconds spent inside Map::Update
+            uint64 IdleTime;    // microseconds spent waiting for work
+            uint32 Updates;
+            uint32 Steals;
+        };
 
-        friend class MapUpdateRequest;
+        MapUpdater() : _cancelationToken(false), _pendingRequests(0), _queuedRequests(0) {}
+        ~MapUpdater() { };
 
         void schedule_update(Map& map, uint32 diff);
 
+        // queues a job ahead of all pending map updates, used by maps to spread their own work over idle workers
+        void schedule_job(std::function<void()>&& job);
+
         void wait();
 
         void activate(size_t num_threads);
@@ -47,20 +68,57 @@ class MapUpdater
 
         bool activated();
 
+        std::vector<WorkerStats> GetWorkerStats() const;
+
     private:
 
-        ProducerConsumerQueue<MapUpdateRequest*> _queue;
+        struct MapUpdateRequest
+        {
+            MapUpdateRequest(Map* map, uint32 diff, uint32 cost) : m_map(map), m_diff(diff), m_cost(cost) { }
+            MapUpdateRequest(std::function<void()>&& job) : m_map(nullptr), m_diff(0), m_cost(std::numeric_limits<uint32>::max()), m_job(std::move(job)) { }
+
+            Map* m_map;
+            uint32 m_diff;
+            uint32 m_cost;
+            std::function<void()> m_job;
+        };
 
+        struct Worker
+        {
+            Worker() : QueuedCost(0), BusyTime(0), IdleTime(0), Updates(0), Steals(0) { }
+
+            std::mutex Lock;
+            std::deque<MapUpdateRequest> Queue;
+            std::atomic<uint64> QueuedCost;
+
+            std::atomic<uint64> BusyTime;
+            std::atomic<uint64> IdleTime;
+            std::atomic<uint32> Updates;
+            std::atomic<uint32> Steals;
+        };
+
+        std::vector<std::unique_ptr<Worker>> _workers;
         std::vector<std::thread> _workerThreads;
         std::atomic<bool> _cancelationToken;
 
-        std::mutex _lock;
-        std::condition_variable _condition;
-        size_t pending_requests;
+        // number of scheduled updates not finished yet, wait() returns when it drops to 0
+        std::atomic<size_t> _pendingRequests;
+        // number of scheduled updates not picked up by any worker yet
+        std::atomic<size_t> _queuedRequests;
+
+        std::mutex _sleepLock;
+        std::condition_variable _sleepCondition;
+
+        std::mutex _completionLock;
+        std::condition_variable _completionCondition;
+
+        void Enqueue(MapUpdateRequest&& request);
+        bool TryPop(size_t workerIndex, MapUpdateRequest& request);
+        bool TrySteal(size_t workerIndex, MapUpdateRequest& request);
 
         void update_finished();
 
-        void WorkerThread();
+        void WorkerThread(size_t workerIndex);
 };
 
 #endif //_MAP_UPDATER_H_INCLUDED
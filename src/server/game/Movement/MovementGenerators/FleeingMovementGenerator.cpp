@@ -28,6 +28,7 @@
 
 #define MIN_QUIET_DISTANCE 28.0f
 #define MAX_QUIET_DISTANCE 43.0f
+#define FLEE_CANDIDATE_POINTS 4
 
 template<class T>
 void FleeingMovementGenerator<T>::_setTargetLocation(T* owner)
@@ -40,22 +41,34 @@ void FleeingMovementGenerator<T>::_setTargetLocation(T* owner)
 
     owner->AddUnitState(UNIT_STATE_FLEEING_MOVE);
 
-    float x, y, z;
-    _getPoint(owner, x, y, z);
-
-    // Add LOS check for target point
+    // Pick a few candidate points and trace them all in one go, the first one in LOS wins
     Position mypos = owner->GetPosition();
-    bool isInLOS = VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(owner->GetMapId(),
-                                                                                mypos.m_positionX,
-                                                                                mypos.m_positionY,
-                                                                                mypos.m_positionZ + 2.0f,
-                                                                                x, y, z + 2.0f);
-    if (!isInLOS)
+    VMAP::LineOfSightRay rays[FLEE_CANDIDATE_POINTS];
+    for (uint8 i = 0; i < FLEE_CANDIDATE_POINTS; ++i)
+    {
+        rays[i].X1 = mypos.m_positionX;
+        rays[i].Y1 = mypos.m_positionY;
+        rays[i].Z1 = mypos.m_positionZ + 2.0f;
+        _getPoint(owner, rays[i].X2, rays[i].Y2, rays[i].Z2);
+        rays[i].Z2 += 2.0f;
+    }
+
+    VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(owner->GetMapId(), rays, FLEE_CANDIDATE_POINTS);
+
+    uint8 candidate = 0;
+    while (candidate < FLEE_CANDIDATE_POINTS && !rays[candidate].Result)
+        ++candidate;
+
+    if (candidate == FLEE_CANDIDATE_POINTS)
     {
         i_nextCheckTime.Reset(200);
         return;
     }
 
+    float x = rays[candidate].X2;
+    float y = rays[candidate].Y2;
+    float z = rays[candidate].Z2 - 2.0f;
+
     PathGenerator path(owner);
     path.SetPathLengthLimit(30.0f);
     bool result = path.CalculatePath(x, y, z);
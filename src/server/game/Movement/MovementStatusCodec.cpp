@@ -0,0 +1,465 @@
+/*
+ * Copyright (C) 2008-2015 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MovementStatusCodec.h"
+#include "Log.h"
+#include <G3D/g3dmath.h>
+#include <map>
+#include <memory>
+
+namespace Movement
+{
+    /// Accessors of the MovementInfo members transferred as plain values
+    #define MOVEMENT_STATUS_FIELD(name, type, member) \
+        struct name \
+        { \
+            static type& Get(MovementInfo& mi) { return mi.member; } \
+            static type const& Get(MovementInfo const& mi) { return mi.member; } \
+        }
+
+    MOVEMENT_STATUS_FIELD(TimestampField, uint32, time);
+    MOVEMENT_STATUS_FIELD(PositionXField, float, pos.m_positionX);
+    MOVEMENT_STATUS_FIELD(PositionYField, float, pos.m_positionY);
+    MOVEMENT_STATUS_FIELD(PositionZField, float, pos.m_positionZ);
+    MOVEMENT_STATUS_FIELD(TransportPositionXField, float, transport.pos.m_positionX);
+    MOVEMENT_STATUS_FIELD(TransportPositionYField, float, transport.pos.m_positionY);
+    MOVEMENT_STATUS_FIELD(TransportPositionZField, float, transport.pos.m_positionZ);
+    MOVEMENT_STATUS_FIELD(TransportSeatField, int8, transport.seat);
+    MOVEMENT_STATUS_FIELD(TransportTimeField, uint32, transport.time);
+    MOVEMENT_STATUS_FIELD(TransportTime2Field, uint32, transport.time2);
+    MOVEMENT_STATUS_FIELD(TransportVehicleIdField, uint32, transport.vehicleId);
+    MOVEMENT_STATUS_FIELD(FallTimeField, uint32, jump.fallTime);
+    MOVEMENT_STATUS_FIELD(FallVerticalSpeedField, float, jump.zspeed);
+    MOVEMENT_STATUS_FIELD(FallCosAngleField, float, jump.cosAngle);
+    MOVEMENT_STATUS_FIELD(FallSinAngleField, float, jump.sinAngle);
+    MOVEMENT_STATUS_FIELD(FallHorizontalSpeedField, float, jump.xyspeed);
+    MOVEMENT_STATUS_FIELD(SplineElevationField, float, splineElevation);
+
+    #undef MOVEMENT_STATUS_FIELD
+
+    struct MovementStatusCodecHandlers
+    {
+        typedef MovementStatusCodec::Context Context;
+        typedef MovementStatusCodec::Step Step;
+
+        static void ReadBits(Context& ctx, Step const& step)
+        {
+            uint32 bits = ctx.Data.ReadBits(step.BitCount);
+            for (uint8 i = 0; i < step.BitCount; ++i)
+            {
+                uint8 target = step.ReadTargets[i];
+                ctx.Slots[target & ~MovementStatusCodec::SLOT_INVERTED] = uint8(((bits >> (step.BitCount - 1 - i)) & 1) ^ (target >> 7));
+            }
+        }
+
+        static void WriteBits(Context& ctx, Step const& step)
+        {
+            uint32 bits = 0;
+            for (uint8 i = 0; i < step.BitCount; ++i)
+            {
+                uint8 source = step.WriteSources[i];
+                bits = (bits << 1) | (uint32(ctx.Slots[source & ~MovementStatusCodec::SLOT_INVERTED] != 0) ^ (source >> 7));
+            }
+
+            ctx.Data.WriteBits(bits, step.BitCount);
+        }
+
+        static void ReadGuidByte(Context& ctx, Step const& step) { ctx.Data.ReadByteSeq(ctx.Slots[step.Arg]); }
+        static void WriteGuidByte(Context& ctx, Step const& step) { ctx.Data.WriteByteSeq(ctx.Slots[step.Arg]); }
+
+        static void ReadMovementFlags(Context& ctx, Step const& /*step*/) { ctx.ReadInfo->flags = ctx.Data.ReadBits(30); }
+        static void WriteMovementFlags(Context& ctx, Step const& /*step*/) { ctx.Data.WriteBits(ctx.WriteInfo->flags, 30); }
+        static void ReadMovementFlags2(Context& ctx, Step const& /*step*/) { ctx.ReadInfo->flags2 = ctx.Data.ReadBits(12); }
+        static void WriteMovementFlags2(Context& ctx, Step const& /*step*/) { ctx.Data.WriteBits(ctx.WriteInfo->flags2, 12); }
+
+        template<class Field>
+        static void ReadField(Context& ctx, Step const& /*step*/) { ctx.Data >> Field::Get(*ctx.ReadInfo); }
+        template<class Field>
+        static void WriteField(Context& ctx, Step const& /*step*/) { ctx.Data << Field::Get(*ctx.WriteInfo); }
+
+        static void ReadOrientation(Context& ctx, Step const& /*step*/) { ctx.ReadInfo->pos.SetOrientation(ctx.Data.read<float>()); }
+        static void WriteOrientation(Context& ctx, Step const& /*step*/) { ctx.Data << ctx.WriteInfo->pos.GetOrientation(); }
+        static void ReadTransportOrientation(Context& ctx, Step const& /*step*/) { ctx.ReadInfo->transport.pos.SetOrientation(ctx.Data.read<float>()); }
+        static void WriteTransportOrientation(Context& ctx, Step const& /*step*/) { ctx.Data << ctx.WriteInfo->transport.pos.GetOrientation(); }
+
+        static void ReadPitch(Context& ctx, Step const& /*step*/) { ctx.ReadInfo->pitch = G3D::wrap(ctx.Data.read<float>(), float(-M_PI), float(M_PI)); }
+        static void WritePitch(Context& ctx, Step const& /*step*/) { ctx.Data << ctx.WriteInfo->pitch; }
+
+        static void ReadCounter(Context& ctx, Step const& /*step*/) { ctx.Data.read_skip<uint32>(); }   /// @TODO: Maybe compare it with m_movementCounter to verify that packets are sent & received in order?
+        static void WriteCounter(Context& ctx, Step const& /*step*/) { ctx.Data << (*ctx.Counter)++; }
+
+        static void ReadExtraElement(Context& ctx, Step const& /*step*/) { ctx.Extras->ReadNextElement(ctx.Data); }
+        static void WriteExtraElement(Context& ctx, Step const& /*step*/) { ctx.Extras->WriteNextElement(ctx.Data); }
+    };
+}
+
+Movement::MovementStatusState::MovementStatusState()
+{
+    memset(Slots, 0, sizeof(Slots));
+    Slots[MSS_ALWAYS] = 1;
+}
+
+ObjectGuid Movement::MovementStatusState::GetGuid(MovementStatusSlot first) const
+{
+    ObjectGuid guid;
+    for (uint8 i = 0; i < 8; ++i)
+        guid[i] = Slots[first + i];
+
+    return guid;
+}
+
+void Movement::MovementStatusState::SetGuid(MovementStatusSlot first, ObjectGuid guid)
+{
+    for (uint8 i = 0; i < 8; ++i)
+        Slots[first + i] = guid[i];
+}
+
+Movement::MovementStatusCodec::MovementStatusCodec(MovementStatusElements const* sequence) : _sequence(sequence), _hasExtraElements(false)
+{
+    for (; *sequence != MSEEnd; ++sequence)
+    {
+        MovementStatusElements const element = *sequence;
+
+        uint8 condition, readTarget, writeSource;
+        if (GetBitSlots(element, condition, readTarget, writeSource))
+        {
+            // bits keep their order, a run only has to share its condition to be transferred at once
+            if (_steps.empty() || _steps.back().Reader != &MovementStatusCodecHandlers::ReadBits ||
+                _steps.back().Condition != condition || _steps.back().BitCount == MAX_BITS_PER_STEP)
+            {
+                Step step = Step();
+                step.Reader = &MovementStatusCodecHandlers::ReadBits;
+                step.Writer = &MovementStatusCodecHandlers::WriteBits;
+                step.Condition = condition;
+                _steps.push_back(step);
+            }
+
+            Step& step = _steps.back();
+            step.ReadTargets[step.BitCount] = readTarget;
+            step.WriteSources[step.BitCount] = writeSource;
+            ++step.BitCount;
+            continue;
+        }
+
+        Step step = Step();
+        step.Condition = MSS_ALWAYS;
+        if (!GetFieldHandlers(element, step))
+        {
+            ASSERT(PrintInvalidSequenceElement(element, __FUNCTION__));
+            continue;
+        }
+
+        if (element == MSEExtraElement)
+            _hasExtraElements = true;
+
+        _steps.push_back(step);
+    }
+}
+
+bool Movement::MovementStatusCodec::GetBitSlots(MovementStatusElements element, uint8& condition, uint8& readTarget, uint8& writeSource)
+{
+    condition = MSS_ALWAYS;
+    switch (element)
+    {
+        case MSEHasGuidByte0:
+        case MSEHasGuidByte1:
+        case MSEHasGuidByte2:
+        case MSEHasGuidByte3:
+        case MSEHasGuidByte4:
+        case MSEHasGuidByte5:
+        case MSEHasGuidByte6:
+        case MSEHasGuidByte7:
+            readTarget = writeSource = uint8(MSS_GUID + element - MSEHasGuidByte0);
+            return true;
+        case MSEHasTransportGuidByte0:
+        case MSEHasTransportGuidByte1:
+        case MSEHasTransportGuidByte2:
+        case MSEHasTransportGuidByte3:
+        case MSEHasTransportGuidByte4:
+        case MSEHasTransportGuidByte5:
+        case MSEHasTransportGuidByte6:
+        case MSEHasTransportGuidByte7:
+            condition = MSS_HAS_TRANSPORT_DATA;
+            readTarget = writeSource = uint8(MSS_TRANSPORT_GUID + element - MSEHasTransportGuidByte0);
+            return true;
+        case MSEHasMovementFlags:
+            readTarget = writeSource = MSS_HAS_MOVEMENT_FLAGS | SLOT_INVERTED;
+            return true;
+        case MSEHasMovementFlags2:
+            readTarget = writeSource = MSS_HAS_MOVEMENT_FLAGS2 | SLOT_INVERTED;
+            return true;
+        case MSEHasTimestamp:
+            readTarget = writeSource = MSS_HAS_TIMESTAMP | SLOT_INVERTED;
+            return true;
+        case MSEHasOrientation:
+            readTarget = writeSource = MSS_HAS_ORIENTATION | SLOT_INVERTED;
+            return true;
+        case MSEHasTransportData:
+            readTarget = writeSource = MSS_HAS_TRANSPORT_DATA;
+            return true;
+        case MSEHasTransportTime2:
+            condition = MSS_HAS_TRANSPORT_DATA;
+            readTarget = writeSource = MSS_HAS_TRANSPORT_TIME2;
+            return true;
+        case MSEHasTransportTime3:
+            condition = MSS_HAS_TRANSPORT_DATA;
+            readTarget = writeSource = MSS_HAS_TRANSPORT_VEHICLE_ID;
+            return true;
+        case MSEHasPitch:
+            readTarget = writeSource = MSS_HAS_PITCH | SLOT_INVERTED;
+            return true;
+        case MSEHasFallData:
+            readTarget = writeSource = MSS_HAS_FALL_DATA;
+            return true;
+        case MSEHasFallDirection:
+            condition = MSS_HAS_FALL_DATA;
+            readTarget = writeSource = MSS_HAS_FALL_DIRECTION;
+            return true;
+        case MSEHasSplineElevation:
+            readTarget = writeSource = MSS_HAS_SPLINE_ELEVATION | SLOT_INVERTED;
+            return true;
+        case MSEHasSpline:
+            readTarget = MSS_DISCARD;
+            writeSource = MSS_HAS_SPLINE;
+            return true;
+        case MSEZeroBit:
+            readTarget = MSS_DISCARD;
+            writeSource = MSS_ZERO;
+            return true;
+        case MSEOneBit:
+            readTarget = MSS_DISCARD;
+            writeSource = MSS_ZERO | SLOT_INVERTED;
+            return true;
+        default:
+            break;
+    }
+
+    return false;
+}
+
+bool Movement::MovementStatusCodec::GetFieldHandlers(MovementStatusElements element, Step& step)
+{
+    typedef MovementStatusCodecHandlers H;
+
+    switch (element)
+    {
+        case MSEGuidByte0:
+        case MSEGuidByte1:
+        case MSEGuidByte2:
+        case MSEGuidByte3:
+        case MSEGuidByte4:
+        case MSEGuidByte5:
+        case MSEGuidByte6:
+        case MSEGuidByte7:
+            step.Reader = &H::ReadGuidByte;
+            step.Writer = &H::WriteGuidByte;
+            step.Arg = uint8(MSS_GUID + element - MSEGuidByte0);
+            return true;
+        case MSETransportGuidByte0:
+        case MSETransportGuidByte1:
+        case MSETransportGuidByte2:
+        case MSETransportGuidByte3:
+        case MSETransportGuidByte4:
+        case MSETransportGuidByte5:
+        case MSETransportGuidByte6:
+        case MSETransportGuidByte7:
+            step.Reader = &H::ReadGuidByte;
+            step.Writer = &H::WriteGuidByte;
+            step.Condition = MSS_HAS_TRANSPORT_DATA;
+            step.Arg = uint8(MSS_TRANSPORT_GUID + element - MSETransportGuidByte0);
+            return true;
+        case MSEMovementFlags:
+            step.Reader = &H::ReadMovementFlags;
+            step.Writer = &H::WriteMovementFlags;
+            step.Condition = MSS_HAS_MOVEMENT_FLAGS;
+            return true;
+        case MSEMovementFlags2:
+            step.Reader = &H::ReadMovementFlags2;
+            step.Writer = &H::WriteMovementFlags2;
+            step.Condition = MSS_HAS_MOVEMENT_FLAGS2;
+            return true;
+        case MSETimestamp:
+            step.Reader = &H::ReadField<TimestampField>;
+            step.Writer = &H::WriteField<TimestampField>;
+            step.Condition = MSS_HAS_TIMESTAMP;
+            return true;
+        case MSEPositionX:
+            step.Reader = &H::ReadField<PositionXField>;
+            step.Writer = &H::WriteField<PositionXField>;
+            return true;
+        case MSEPositionY:
+            step.Reader = &H::ReadField<PositionYField>;
+            step.Writer = &H::WriteField<PositionYField>;
+            return true;
+        case MSEPositionZ:
+            step.Reader = &H::ReadField<PositionZField>;
+            step.Writer = &H::WriteField<PositionZField>;
+            return true;
+        case MSEOrientation:
+            step.Reader = &H::ReadOrientation;
+            step.Writer = &H::WriteOrientation;
+            step.Condition = MSS_HAS_ORIENTATION;
+            return true;
+        case MSETransportPositionX:
+            step.Reader = &H::ReadField<TransportPositionXField>;
+            step.Writer = &H::WriteField<TransportPositionXField>;
+            step.Condition = MSS_HAS_TRANSPORT_DATA;
+            return true;
+        case MSETransportPositionY:
+            step.Reader = &H::ReadField<TransportPositionYField>;
+            step.Writer = &H::WriteField<TransportPositionYField>;
+            step.Condition = MSS_HAS_TRANSPORT_DATA;
+            return true;
+        case MSETransportPositionZ:
+            step.Reader = &H::ReadField<TransportPositionZField>;
+            step.Writer = &H::WriteField<TransportPositionZField>;
+            step.Condition = MSS_HAS_TRANSPORT_DATA;
+            return true;
+        case MSETransportOrientation:
+            step.Reader = &H::ReadTransportOrientation;
+            step.Writer = &H::WriteTransportOrientation;
+            step.Condition = MSS_HAS_TRANSPORT_DATA;
+            return true;
+        case MSETransportSeat:
+            step.Reader = &H::ReadField<TransportSeatField>;
+            step.Writer = &H::WriteField<TransportSeatField>;
+            step.Condition = MSS_HAS_TRANSPORT_DATA;
+            return true;
+        case MSETransportTime:
+            step.Reader = &H::ReadField<TransportTimeField>;
+            step.Writer = &H::WriteField<TransportTimeField>;
+            step.Condition = MSS_HAS_TRANSPORT_DATA;
+            return true;
+        case MSETransportTime2:
+            // only ever set while transport data is present
+            step.Reader = &H::ReadField<TransportTime2Field>;
+            step.Writer = &H::WriteField<TransportTime2Field>;
+            step.Condition = MSS_HAS_TRANSPORT_TIME2;
+            return true;
+        case MSETransportVehicleId:
+            step.Reader = &H::ReadField<TransportVehicleIdField>;
+            step.Writer = &H::WriteField<TransportVehicleIdField>;
+            step.Condition = MSS_HAS_TRANSPORT_VEHICLE_ID;
+            return true;
+        case MSEPitch:
+            step.Reader = &H::ReadPitch;
+            step.Writer = &H::WritePitch;
+            step.Condition = MSS_HAS_PITCH;
+            return true;
+        case MSEFallTime:
+            step.Reader = &H::ReadField<FallTimeField>;
+            step.Writer = &H::WriteField<FallTimeField>;
+            step.Condition = MSS_HAS_FALL_DATA;
+            return true;
+        case MSEFallVerticalSpeed:
+            step.Reader = &H::ReadField<FallVerticalSpeedField>;
+            step.Writer = &H::WriteField<FallVerticalSpeedField>;
+            step.Condition = MSS_HAS_FALL_DATA;
+            return true;
+        case MSEFallCosAngle:
+            // fall direction is only ever set together with fall data
+            step.Reader = &H::ReadField<FallCosAngleField>;
+            step.Writer = &H::WriteField<FallCosAngleField>;
+            step.Condition = MSS_HAS_FALL_DIRECTION;
+            return true;
+        case MSEFallSinAngle:
+            step.Reader = &H::ReadField<FallSinAngleField>;
+            step.Writer = &H::WriteField<FallSinAngleField>;
+            step.Condition = MSS_HAS_FALL_DIRECTION;
+            return true;
+        case MSEFallHorizontalSpeed:
+            step.Reader = &H::ReadField<FallHorizontalSpeedField>;
+            step.Writer = &H::WriteField<FallHorizontalSpeedField>;
+            step.Condition = MSS_HAS_FALL_DIRECTION;
+            return true;
+        case MSESplineElevation:
+            step.Reader = &H::ReadField<SplineElevationField>;
+            step.Writer = &H::WriteField<SplineElevationField>;
+            step.Condition = MSS_HAS_SPLINE_ELEVATION;
+            return true;
+        case MSECounter:
+            step.Reader = &H::ReadCounter;
+            step.Writer = &H::WriteCounter;
+            return true;
+        case MSEExtraElement:
+            step.Reader = &H::ReadExtraElement;
+            step.Writer = &H::WriteExtraElement;
+            return true;
+        default:
+            break;
+    }
+
+    return false;
+}
+
+void Movement::MovementStatusCodec::Read(ByteBuffer& data, MovementInfo& mi, MovementStatusState& state, ExtraMovementStatusElement* extras) const
+{
+    Context ctx = { data, &mi, NULL, state.Slots, NULL, extras };
+    for (std::vector<Step>::const_iterator itr = _steps.begin(); itr != _steps.end(); ++itr)
+        if (state.Slots[itr->Condition])
+            itr->Reader(ctx, *itr);
+
+    mi.guid = state.GetGuid(MSS_GUID);
+    mi.transport.guid = state.GetGuid(MSS_TRANSPORT_GUID);
+}
+
+void Movement::MovementStatusCodec::Write(ByteBuffer& data, MovementInfo const& mi, MovementStatusState& state, uint32& counter, ExtraMovementStatusElement* extras) const
+{
+    Context ctx = { data, NULL, &mi, state.Slots, &counter, extras };
+    for (std::vector<Step>::const_iterator itr = _steps.begin(); itr != _steps.end(); ++itr)
+        if (state.Slots[itr->Condition])
+            itr->Writer(ctx, *itr);
+}
+
+namespace
+{
+    Movement::MovementStatusCodec const* MovementStatusCodecTable[NUM_OPCODE_HANDLERS];
+    std::vector<std::unique_ptr<Movement::MovementStatusCodec>> MovementStatusCodecStore;
+}
+
+void Movement::InitializeMovementStatusCodecs()
+{
+    memset(MovementStatusCodecTable, 0, sizeof(MovementStatusCodecTable));
+    MovementStatusCodecStore.clear();
+
+    // opcodes sharing a sequence share its codec
+    std::map<MovementStatusElements const*, MovementStatusCodec const*> codecs;
+    uint32 opcodeCount = 0;
+    for (uint32 opcode = 0; opcode < NUM_OPCODE_HANDLERS; ++opcode)
+    {
+        MovementStatusElements const* sequence = GetMovementStatusElementsSequence(Opcodes(opcode));
+        if (!sequence)
+            continue;
+
+        MovementStatusCodec const*& codec = codecs[sequence];
+        if (!codec)
+        {
+            MovementStatusCodecStore.push_back(Trinity::make_unique<MovementStatusCodec>(sequence));
+            codec = MovementStatusCodecStore.back().get();
+        }
+
+        MovementStatusCodecTable[opcode] = codec;
+        ++opcodeCount;
+    }
+
+    TC_LOG_INFO("server.loading", ">> Built %u movement status codecs for %u opcodes", uint32(MovementStatusCodecStore.size()), opcodeCount);
+}
+
+Movement::MovementStatusCodec const* Movement::GetMovementStatusCodec(uint32 opcode)
+{
+    return opcode < NUM_OPCODE_HANDLERS ? MovementStatusCodecTable[opcode] : NULL;
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2008-2015 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MOVEMENT_STATUS_CODEC_H
+#define _MOVEMENT_STATUS_CODEC_H
+
+#include "MovementStructures.h"
+#include <vector>
+
+namespace Movement
+{
+    struct MovementStatusCodecHandlers;
+
+    /// Values shared between the elements of one movement status block:
+    /// guid bytes and the presence bits controlling which optional fields follow
+    enum MovementStatusSlot
+    {
+        MSS_GUID                    = 0,    // 8 slots, one per guid byte
+        MSS_TRANSPORT_GUID          = 8,    // 8 slots, one per transport guid byte
+        MSS_HAS_MOVEMENT_FLAGS      = 16,
+        MSS_HAS_MOVEMENT_FLAGS2,
+        MSS_HAS_TIMESTAMP,
+        MSS_HAS_ORIENTATION,
+        MSS_HAS_TRANSPORT_DATA,
+        MSS_HAS_TRANSPORT_TIME2,
+        MSS_HAS_TRANSPORT_VEHICLE_ID,
+        MSS_HAS_PITCH,
+        MSS_HAS_FALL_DATA,
+        MSS_HAS_FALL_DIRECTION,
+        MSS_HAS_SPLINE_ELEVATION,
+        MSS_HAS_SPLINE,
+        MSS_ALWAYS,                         // constant 1, condition of unconditional elements
+        MSS_ZERO,                           // constant 0, source of MSEZeroBit/MSEOneBit when writing
+        MSS_DISCARD,                        // target of bits that are read and ignored
+        MAX_MOVEMENT_STATUS_SLOTS
+    };
+
+    struct MovementStatusState
+    {
+        MovementStatusState();
+
+        bool Has(MovementStatusSlot slot) const { return Slots[slot] != 0; }
+        void Set(MovementStatusSlot slot, bool value) { Slots[slot] = value ? 1 : 0; }
+
+        ObjectGuid GetGuid(MovementStatusSlot first) const;
+        void SetGuid(MovementStatusSlot first, ObjectGuid guid);
+
+        uint8 Slots[MAX_MOVEMENT_STATUS_SLOTS];
+    };
+
+    /// A MovementStatusElements sequence translated once into a list of steps.
+    /// Every element gets a dedicated read and write handler and a precomputed condition slot,
+    /// consecutive single bit elements sharing a condition are merged into one step
+    /// so they are transferred with a single ReadBits/WriteBits call.
+    class MovementStatusCodec
+    {
+        friend struct MovementStatusCodecHandlers;
+
+    public:
+        explicit MovementStatusCodec(MovementStatusElements const* sequence);
+
+        /// Reads the block into mi (guids included), state holds the presence bits afterwards
+        void Read(ByteBuffer& data, MovementInfo& mi, MovementStatusState& state, ExtraMovementStatusElement* extras) const;
+        /// Writes mi, state must contain guids and presence bits, counter is incremented when the block has a counter
+        void Write(ByteBuffer& data, MovementInfo const& mi, MovementStatusState& state, uint32& counter, ExtraMovementStatusElement* extras) const;
+
+        MovementStatusElements const* GetSequence() const { return _sequence; }
+        bool HasExtraElements() const { return _hasExtraElements; }
+        uint32 GetStepCount() const { return uint32(_steps.size()); }
+
+    private:
+        static uint8 const MAX_BITS_PER_STEP = 32;
+        static uint8 const SLOT_INVERTED = 0x80;
+
+        struct Step;
+
+        struct Context
+        {
+            ByteBuffer& Data;
+            MovementInfo* ReadInfo;
+            MovementInfo const* WriteInfo;
+            uint8* Slots;
+            uint32* Counter;
+            ExtraMovementStatusElement* Extras;
+        };
+
+        typedef void(*Handler)(Context& ctx, Step const& step);
+
+        struct Step
+        {
+            Handler Reader;
+            Handler Writer;
+            uint8 Condition;
+            uint8 Arg;
+            uint8 BitCount;
+            uint8 ReadTargets[MAX_BITS_PER_STEP];    // slot | SLOT_INVERTED
+            uint8 WriteSources[MAX_BITS_PER_STEP];   // slot | SLOT_INVERTED
+        };
+
+        static bool GetBitSlots(MovementStatusElements element, uint8& condition, uint8& readTarget, uint8& writeSource);
+        static bool GetFieldHandlers(MovementStatusElements element, Step& step);
+
+        std::vector<Step> _steps;
+        MovementStatusElements const* _sequence;
+        bool _hasExtraElements;
+    };
+
+    /// Builds the codecs of all opcodes with a movement status sequence, must be called once at startup
+    void InitializeMovementStatusCodecs();
+
+    /// Returns NULL if the opcode has no movement status block
+    MovementStatusCodec const* GetMovementStatusCodec(uint32 opcode);
+}
+
+#endif
@@ -43,7 +43,6 @@ PathGenerator::PathGenerator(const Unit* owner) :
     {
         MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
         _navMesh = mmap->GetNavMesh(mapId, _sourceUnit->GetTerrainSwaps());
-        _navMeshQuery = mmap->GetNavMeshQuery(mapId, _sourceUnit->GetInstanceId(), _sourceUnit->GetTerrainSwaps());
     }
 
     CreateFilter();
@@ -73,6 +72,10 @@ bool PathGenerator::CalculatePath(float destX, float destY, float destZ, bool fo
 
     TC_LOG_DEBUG("maps", "++ PathGenerator::CalculatePath() for %u \n", _sourceUnit->GetGUIDLow());
 
+    // queries belong to a thread, the owner may be updated on a different map update thread every tick
+    if (_navMesh)
+        _navMeshQuery = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQuery(_sourceUnit->GetMapId(), _sourceUnit->GetInstanceId(), _sourceUnit->GetTerrainSwaps());
+
     // make sure navMesh works - we can run on map w/o mmap
     // check if the start and end point have a .mmtile loaded (can we pass via not loaded tile on the way?)
     if (!_navMesh || !_navMeshQuery || _sourceUnit->HasUnitState(UNIT_STATE_IGNORE_PATHFINDING) ||
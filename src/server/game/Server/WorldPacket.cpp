@@ -19,8 +19,8 @@
 #include "WorldPacket.h"
 #include "World.h"
 
-//! Compresses packet in place
-void WorldPacket::Compress(z_stream* compressionStream)
+//! Compresses packet in place, compressed data is staged in the caller provided buffer which is grown as needed and can be reused
+void WorldPacket::Compress(z_stream* compressionStream, std::vector<uint8>& buffer)
 {
     Opcodes uncompressedOpcode = GetOpcode();
     if (uncompressedOpcode & COMPRESSED_OPCODE_MASK)
@@ -33,19 +33,20 @@ void WorldPacket::Compress(z_stream* compressionStream)
     uint32 size = wpos();
     uint32 destsize = compressBound(size);
 
-    std::vector<uint8> storage(destsize);
+    if (buffer.size() < destsize)
+        buffer.resize(destsize);
 
     _compressionStream = compressionStream;
-    Compress(static_cast<void*>(&storage[0]), &destsize, static_cast<const void*>(contents()), size);
+    Compress(static_cast<void*>(&buffer[0]), &destsize, static_cast<const void*>(contents()), size);
     if (destsize == 0)
         return;
 
     clear();
     reserve(destsize + sizeof(uint32));
     *this << uint32(size);
-    append(&storage[0], destsize);
+    append(&buffer[0], destsize);
     SetOpcode(opcode);
-    TC_LOG_INFO("network", "%s (len %u) successfully compressed to %04X (len %u)", GetOpcodeNameForLogging(uncompressedOpcode).c_str(), size, opcode, destsize);
+    TC_LOG_TRACE("network", "%s (len %u) successfully compressed to %04X (len %u)", GetOpcodeNameForLogging(uncompressedOpcode).c_str(), size, opcode, destsize);
 }
 
 //! Compresses another packet and stores it in self (source left intact)
@@ -77,7 +78,7 @@ void WorldPacket::Compress(z_stream* compressionStream, WorldPacket const* sourc
 
     SetOpcode(opcode);
 
-    TC_LOG_INFO("network", "%s (len %u) successfully compressed to %04X (len %u)", GetOpcodeNameForLogging(uncompressedOpcode).c_str(), size, opcode, destsize);
+    TC_LOG_TRACE("network", "%s (len %u) successfully compressed to %04X (len %u)", GetOpcodeNameForLogging(uncompressedOpcode).c_str(), size, opcode, destsize);
 }
 
 void WorldPacket::Compress(void* dst, uint32 *dst_size, const void* src, int src_size)
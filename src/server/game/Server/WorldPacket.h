@@ -66,7 +66,7 @@ class WorldPacket : public ByteBuffer
         Opcodes GetOpcode() const { return m_opcode; }
         void SetOpcode(Opcodes opcode) { m_opcode = opcode; }
         bool IsCompressed() const { return (m_opcode & COMPRESSED_OPCODE_MASK) != 0; }
-        void Compress(z_stream_s* compressionStream);
+        void Compress(z_stream_s* compressionStream, std::vector<uint8>& buffer);
         void Compress(z_stream_s* compressionStream, WorldPacket const* source);
 
     protected:
@@ -75,4 +75,7 @@ class WorldPacket : public ByteBuffer
         z_stream_s* _compressionStream;
 };
 
+/// Packet that is not modified anymore once built, sent to many sessions without copying its contents
+typedef std::shared_ptr<WorldPacket const> SharedWorldPacket;
+
 #endif
@@ -125,6 +125,8 @@ WorldSession::WorldSession(uint32 id, uint32 battlenetAccountId, std::shared_ptr
     _filterAddonMessages(false),
     recruiterId(recruiter),
     isRecruiter(isARecruiter),
+    _recvQueue(sWorld->getIntConfig(CONFIG_SESSION_RECV_QUEUE_SIZE)),
+    _recvQueueOverflow(false),
     _RBACData(NULL),
     expireTime(60000), // 1 min after socket loss, session is deleted
     forceExit(false),
@@ -140,16 +142,6 @@ WorldSession::WorldSession(uint32 id, uint32 battlenetAccountId, std::shared_ptr
     }
 
     InitializeQueryCallbackParameters();
-
-    _compressionStream = new z_stream();
-    _compressionStream->zalloc = (alloc_func)NULL;
-    _compressionStream->zfree = (free_func)NULL;
-    _compressionStream->opaque = (voidpf)NULL;
-    _compressionStream->avail_in = 0;
-    _compressionStream->next_in = NULL;
-    int32 z_res = deflateInit(_compressionStream, sWorld->getIntConfig(CONFIG_COMPRESSION));
-    if (z_res != Z_OK)
-        TC_LOG_ERROR("network", "Can't initialize packet compression (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
 }
 
 /// WorldSession destructor
@@ -174,13 +166,13 @@ WorldSession::~WorldSession()
     while (_recvQueue.next(packet))
         delete packet;
 
-    LoginDatabase.PExecute("UPDATE account SET online = 0 WHERE id = %u;", GetAccountId());     // One-time query
+    for (WorldPacket* delayedPacket : _delayedPackets)
+        delete delayedPacket;
 
-    int32 z_res = deflateEnd(_compressionStream);
-    if (z_res != Z_OK && z_res != Z_DATA_ERROR) // Z_DATA_ERROR signals that internal state was BUSY
-        TC_LOG_ERROR("network", "Can't close packet compression stream (zlib: deflateEnd) Error code: %i (%s)", z_res, zError(z_res));
+    TC_LOG_DEBUG("network", "Account %u receive queue high water mark: %u of %u packets",
+        GetAccountId(), uint32(_recvQueue.high_water_mark()), uint32(_recvQueue.capacity()));
 
-    delete _compressionStream;
+    LoginDatabase.PExecute("UPDATE account SET online = 0 WHERE id = %u;", GetAccountId());     // One-time query
 }
 
 std::string const & WorldSession::GetPlayerName() const
@@ -210,27 +202,58 @@ uint32 WorldSession::GetGuidLow() const
 /// Send a packet to the client
 void WorldSession::SendPacket(WorldPacket* packet, bool forced /*= false*/)
 {
-    if (!m_Socket)
+    if (!m_Socket || !PrepareSendPacket(*packet, forced))
         return;
 
-    if (packet->GetOpcode() == NULL_OPCODE)
+    m_Socket->SendPacket(*packet);
+}
+
+void WorldSession::SendSharedPacket(SharedWorldPacket const& packet)
+{
+    if (!m_Socket || !PrepareSendPacket(*packet, false))
+        return;
+
+    m_Socket->SendSharedPacket(packet);
+}
+
+void PacketBroadcaster::SendTo(WorldSession* session)
+{
+    if (_shareable < 0)
+        _shareable = WorldSocket::IsShareable(*_packet) ? 1 : 0;
+
+    if (!_shareable)
     {
-        TC_LOG_ERROR("network.opcode", "Prevented sending of NULL_OPCODE to %s", GetPlayerInfo().c_str());
+        session->SendPacket(_packet);
         return;
     }
-    else if (packet->GetOpcode() == UNKNOWN_OPCODE)
+
+    if (!_shared)
+        _shared = std::make_shared<WorldPacket const>(*_packet);
+
+    session->SendSharedPacket(_shared);
+}
+
+/// Checks whether the packet may be sent and runs the send hooks
+bool WorldSession::PrepareSendPacket(WorldPacket const& packet, bool forced)
+{
+    if (packet.GetOpcode() == NULL_OPCODE)
+    {
+        TC_LOG_ERROR("network.opcode", "Prevented sending of NULL_OPCODE to %s", GetPlayerInfo().c_str());
+        return false;
+    }
+    else if (packet.GetOpcode() == UNKNOWN_OPCODE)
     {
         TC_LOG_ERROR("network.opcode", "Prevented sending of UNKNOWN_OPCODE to %s", GetPlayerInfo().c_str());
-        return;
+        return false;
     }
 
     if (!forced)
     {
-        OpcodeHandler const* handler = opcodeTable[packet->GetOpcode()];
+        OpcodeHandler const* handler = opcodeTable[packet.GetOpcode()];
         if (!handler || handler->Status == STATUS_UNHANDLED)
         {
-            TC_LOG_ERROR("network.opcode", "Prevented sending disabled opcode %s to %s", GetOpcodeNameForLogging(packet->GetOpcode()).c_str(), GetPlayerInfo().c_str());
-            return;
+            TC_LOG_ERROR("network.opcode", "Prevented sending disabled opcode %s to %s", GetOpcodeNameForLogging(packet.GetOpcode()).c_str(), GetPlayerInfo().c_str());
+            return false;
         }
     }
 
@@ -250,10 +273,10 @@ void WorldSession::SendPacket(WorldPacket* packet, bool forced /*= false*/)
     if ((cur_time - lastTime) < 60)
     {
         sendPacketCount+=1;
-        sendPacketBytes+=packet->size();
+        sendPacketBytes+=packet.size();
 
         sendLastPacketCount+=1;
-        sendLastPacketBytes+=packet->size();
+        sendLastPacketBytes+=packet.size();
     }
     else
     {
@@ -264,20 +287,28 @@ void WorldSession::SendPacket(WorldPacket* packet, bool forced /*= false*/)
 
         lastTime = cur_time;
         sendLastPacketCount = 1;
-        sendLastPacketBytes = packet->wpos();               // wpos is real written size
+        sendLastPacketBytes = packet.wpos();                // wpos is real written size
     }
 #endif                                                      // !TRINITY_DEBUG
 
-    sScriptMgr->OnPacketSend(this, *packet);
+    sScriptMgr->OnPacketSend(this, packet);
 
-    TC_LOG_TRACE("network.opcode", "S->C: %s %s", GetPlayerInfo().c_str(), GetOpcodeNameForLogging(packet->GetOpcode()).c_str());
-    m_Socket->SendPacket(*packet);
+    TC_LOG_TRACE("network.opcode", "S->C: %s %s", GetPlayerInfo().c_str(), GetOpcodeNameForLogging(packet.GetOpcode()).c_str());
+    return true;
 }
 
-/// Add an incoming packet to the queue
+/// Add an incoming packet to the queue, takes ownership of the packet
 void WorldSession::QueuePacket(WorldPacket* new_packet)
 {
-    _recvQueue.add(new_packet);
+    if (_recvQueue.add(new_packet))
+        return;
+
+    // only log the first dropped packet, a flooding client would otherwise flood the log as well
+    if (!_recvQueueOverflow.exchange(true))
+        TC_LOG_WARN("network", "Receive queue of account %u, IP: %s is full (%u packets), dropping opcode %s",
+            GetAccountId(), GetRemoteAddress().c_str(), uint32(_recvQueue.capacity()), GetOpcodeNameForLogging(new_packet->GetOpcode()).c_str());
+
+    delete new_packet;
 }
 
 /// Logging helper for unexpected opcodes
@@ -314,17 +345,34 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
     WorldPacket* packet = NULL;
     //! Delete packet after processing by default
     bool deletePacket = true;
-    //! To prevent infinite loop
-    WorldPacket* firstDelayedPacket = NULL;
-    //! If _recvQueue.peek() == firstDelayedPacket it means that in this Update call, we've processed all
-    //! *properly timed* packets, and we're now at the part of the queue where we find
-    //! delayed packets that were re-enqueued due to improper timing. To prevent an infinite
-    //! loop caused by re-enqueueing the same packets over and over again, we stop updating this session
-    //! and continue updating others. The re-enqueued packets will be handled in the next Update call for this session.
+    //! Packets delayed by earlier updates are retried first. Packets delayed again during this call go back
+    //! to _delayedPackets and are only retried in the next Update call for this session, to prevent an infinite loop
+    std::deque<WorldPacket*> delayedPackets;
+    delayedPackets.swap(_delayedPackets);
+    auto nextPacket = [&]() -> bool
+    {
+        if (!delayedPackets.empty() && updater.Process(delayedPackets.front()))
+        {
+            packet = delayedPackets.front();
+            delayedPackets.pop_front();
+            return true;
+        }
+
+        return _recvQueue.next(packet, updater);
+    };
+
     uint32 processedPackets = 0;
     time_t currentTime = time(NULL);
 
-    while (m_Socket && !_recvQueue.empty() && _recvQueue.peek(true) != firstDelayedPacket && _recvQueue.next(packet, updater))
+    //! The socket may not be closed from the network thread that overflowed the queue, it is done here instead
+    if (_recvQueueOverflow && m_Socket && sWorld->getIntConfig(CONFIG_SESSION_RECV_QUEUE_OVERFLOW_POLICY) == RECV_QUEUE_OVERFLOW_KICK)
+    {
+        TC_LOG_WARN("network", "Account %u, IP: %s kicked for overflowing its receive queue", GetAccountId(), GetRemoteAddress().c_str());
+        KickPlayer();
+        _recvQueueOverflow = false;
+    }
+
+    while (m_Socket && nextPacket())
     {
         if (packet->GetOpcode() >= NUM_OPCODE_HANDLERS)
         {
@@ -344,15 +392,12 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
                         {
                             // skip STATUS_LOGGEDIN opcode unexpected errors if player logout sometime ago - this can be network lag delayed packets
                             //! If player didn't log out a while ago, it means packets are being sent while the server does not recognize
-                            //! the client to be in world yet. We will re-add the packets to the bottom of the queue and process them later.
+                            //! the client to be in world yet. We will keep the packets aside and process them later.
                             if (!m_playerRecentlyLogout)
                             {
-                                //! Prevent infinite loop
-                                if (!firstDelayedPacket)
-                                    firstDelayedPacket = packet;
                                 //! Because checking a bool is faster than reallocating memory
                                 deletePacket = false;
-                                QueuePacket(packet);
+                                _delayedPackets.push_back(packet);
                                 //! Log
                                 TC_LOG_DEBUG("network", "Re-enqueueing packet with opcode %s with with status STATUS_LOGGEDIN. "
                                     "Player is currently not in world yet.", GetOpcodeNameForLogging(packet->GetOpcode()).c_str());
@@ -442,6 +487,9 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
             break;
     }
 
+    //! Delayed packets not retried in this call keep their place before the ones delayed again
+    _delayedPackets.insert(_delayedPackets.begin(), delayedPackets.begin(), delayedPackets.end());
+
     if (m_Socket && m_Socket->IsOpen() && _warden)
         _warden->Update();
 
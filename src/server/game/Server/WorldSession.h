@@ -33,6 +33,7 @@
 #include "Cryptography/BigNumber.h"
 #include "Opcodes.h"
 #include "AccountMgr.h"
+#include "BoundedMPSCQueue.h"
 #include <unordered_set>
 
 class Creature;
@@ -178,6 +179,13 @@ public:
     virtual bool ProcessLogout() const override { return false; }
 };
 
+// action taken when a client sends packets faster than its receive queue is drained
+enum RecvQueueOverflowPolicy
+{
+    RECV_QUEUE_OVERFLOW_DROP    = 0,    // log and drop the packet
+    RECV_QUEUE_OVERFLOW_KICK    = 1     // log, drop the packet and kick the client
+};
+
 //class used to filer only thread-unsafe packets from queue
 //in order to update only be used in World::UpdateSessions()
 class WorldSessionFilter : public PacketFilter
@@ -268,6 +276,8 @@ class WorldSession
         bool IsAddonRegistered(const std::string& prefix) const;
 
         void SendPacket(WorldPacket* packet, bool forced = false);
+        /// Sends a packet built once for many receivers, the socket queues a reference instead of a copy
+        void SendSharedPacket(SharedWorldPacket const& packet);
         void SendNotification(const char *format, ...) ATTR_PRINTF(2, 3);
         void SendNotification(uint32 string_id, ...);
         void SendPetNameInvalid(uint32 error, std::string const& name, DeclinedName *declinedName);
@@ -322,6 +332,7 @@ class WorldSession
 
         void QueuePacket(WorldPacket* new_packet);
         bool Update(uint32 diff, PacketFilter& updater);
+        size_t GetRecvQueueHighWaterMark() const { return _recvQueue.high_water_mark(); }
 
         /// Handle the authentication waiting queue (to be completed)
         void SendAuthWaitQue(uint32 position);
@@ -439,8 +450,6 @@ class WorldSession
         uint32 GetRecruiterId() const { return recruiterId; }
         bool IsARecruiter() const { return isRecruiter; }
 
-        z_stream_s* GetCompressionStream() { return _compressionStream; }
-
     public:                                                 // opcodes handlers
 
         void Handle_NULL(WorldPacket& recvPacket);          // not used
@@ -1034,6 +1043,8 @@ class WorldSession
         void InitializeQueryCallbackParameters();
         void ProcessQueryCallbacks();
 
+        bool PrepareSendPacket(WorldPacket const& packet, bool forced);
+
         PreparedQueryResultFuture _charEnumCallback;
         PreparedQueryResultFuture _addIgnoreCallback;
         PreparedQueryResultFuture _stablePetCallback;
@@ -1129,8 +1140,11 @@ class WorldSession
         bool _filterAddonMessages;
         uint32 recruiterId;
         bool isRecruiter;
-        LockedQueue<WorldPacket*> _recvQueue;
-        z_stream_s* _compressionStream;
+        // filled by the network thread, drained by Update
+        BoundedMPSCQueue<WorldPacket*> _recvQueue;
+        std::atomic<bool> _recvQueueOverflow;
+        // packets that arrived before the player was in world, retried by Update. Kept out of _recvQueue so they can't overflow it
+        std::deque<WorldPacket*> _delayedPackets;
         rbac::RBACData* _RBACData;
         uint32 expireTime;
         bool forceExit;
@@ -1139,5 +1153,20 @@ class WorldSession
         WorldSession(WorldSession const& right) = delete;
         WorldSession& operator=(WorldSession const& right) = delete;
 };
+
+/// Sends the same packet to many sessions. Once it is worth it, the packet is copied a single
+/// time into a shared packet that every receiving socket queues by reference
+class PacketBroadcaster
+{
+    public:
+        explicit PacketBroadcaster(WorldPacket* packet) : _packet(packet), _shareable(-1) { }
+
+        void SendTo(WorldSession* session);
+
+    private:
+        WorldPacket* _packet;
+        SharedWorldPacket _shared;
+        int8 _shareable;
+};
 #endif
 /// @}
@@ -24,6 +24,7 @@
 #include "PacketLog.h"
 #include "BattlenetAccountMgr.h"
 #include <memory>
+#include <zlib.h>
 
 using boost::asio::ip::tcp;
 
@@ -32,10 +33,31 @@ std::string const WorldSocket::ServerConnectionInitialize("WORLD OF WARCRAFT CON
 std::string const WorldSocket::ClientConnectionInitialize("WORLD OF WARCRAFT CONNECTION - CLIENT TO SERVER");
 
 
+WorldSocket::CompressionStats WorldSocket::_compressionStats[NUM_OPCODE_HANDLERS];
+
 WorldSocket::WorldSocket(tcp::socket&& socket)
-    : Socket(std::move(socket)), _authSeed(rand32()), _OverSpeedPings(0), _worldSession(nullptr), _initialized(false)
+    : Socket(std::move(socket)), _authSeed(rand32()), _OverSpeedPings(0), _worldSession(nullptr), _initialized(false), _compressionPending(false)
 {
     _headerBuffer.Resize(2);
+
+    _compressionStream = new z_stream();
+    _compressionStream->zalloc = (alloc_func)NULL;
+    _compressionStream->zfree = (free_func)NULL;
+    _compressionStream->opaque = (voidpf)NULL;
+    _compressionStream->avail_in = 0;
+    _compressionStream->next_in = NULL;
+    int32 z_res = deflateInit(_compressionStream, sWorld->getIntConfig(CONFIG_COMPRESSION));
+    if (z_res != Z_OK)
+        TC_LOG_ERROR("network", "Can't initialize packet compression (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
+}
+
+WorldSocket::~WorldSocket()
+{
+    int32 z_res = deflateEnd(_compressionStream);
+    if (z_res != Z_OK && z_res != Z_DATA_ERROR) // Z_DATA_ERROR signals that internal state was BUSY
+        TC_LOG_ERROR("network", "Can't close packet compression stream (zlib: deflateEnd) Error code: %i (%s)", z_res, zError(z_res));
+
+    delete _compressionStream;
 }
 
 void WorldSocket::Start()
@@ -289,13 +311,58 @@ void WorldSocket::SendPacket(WorldPacket& packet)
     if (sPacketLog->CanLogPacket())
         sPacketLog->LogPacket(packet, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort());
 
-    if (_worldSession && packet.size() > 0x400 && !packet.IsCompressed())
-        packet.Compress(_worldSession->GetCompressionStream());
+    bool compress = _worldSession && packet.size() > CompressionThreshold && !packet.IsCompressed();
 
-    ServerPktHeader header(packet.size() + 2, packet.GetOpcode());
+    std::unique_lock<std::mutex> guard(_writeLock);
+
+    // large packets are compressed on the network thread, everything sent after them
+    // has to wait in the same queue to keep the wire order (and the encryption state) intact
+    if (compress || _compressionPending)
+    {
+        _compressionQueue.push_back(CompressionQueueEntry(packet, compress));
+        if (!_compressionPending)
+        {
+            _compressionPending = true;
+            GetIoService().post(std::bind(&WorldSocket::ProcessCompressionQueue, shared_from_this()));
+        }
+
+        return;
+    }
+
+    WritePacketToBuffer(packet, guard);
+}
+
+void WorldSocket::SendSharedPacket(SharedWorldPacket const& packet)
+{
+    if (!IsOpen())
+        return;
+
+    // compressed contents depend on the deflate stream of each connection, these can't be shared
+    if (_worldSession && packet->size() > CompressionThreshold && !packet->IsCompressed())
+    {
+        WorldPacket copy(*packet);
+        SendPacket(copy);
+        return;
+    }
+
+    if (sPacketLog->CanLogPacket())
+        sPacketLog->LogPacket(*packet, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort());
 
     std::unique_lock<std::mutex> guard(_writeLock);
 
+    if (_compressionPending)
+    {
+        _compressionQueue.push_back(CompressionQueueEntry(packet));
+        return;
+    }
+
+    WriteSharedPacketToBuffer(packet, guard);
+}
+
+void WorldSocket::WritePacketToBuffer(WorldPacket const& packet, std::unique_lock<std::mutex>& guard)
+{
+    ServerPktHeader header(packet.size() + 2, packet.GetOpcode());
+
     _authCrypt.EncryptSend(header.header, header.getHeaderLength());
 
 #ifndef TC_SOCKET_USE_IOCP
@@ -304,16 +371,84 @@ void WorldSocket::SendPacket(WorldPacket& packet)
         _writeBuffer.Write(header.header, header.getHeaderLength());
         if (!packet.empty())
             _writeBuffer.Write(packet.contents(), packet.size());
+
+        ScheduleWrite(guard);
     }
     else
 #endif
     {
-        MessageBuffer buffer(header.getHeaderLength() + packet.size());
+        // coalesce into the last queued buffer when possible, the whole queue is flushed with a single gather write
+        MessageBuffer& buffer = GetQueuedWriteBuffer(header.getHeaderLength() + packet.size());
         buffer.Write(header.header, header.getHeaderLength());
         if (!packet.empty())
             buffer.Write(packet.contents(), packet.size());
 
-        QueuePacket(std::move(buffer), guard);
+        ScheduleWrite(guard);
+    }
+}
+
+void WorldSocket::WriteSharedPacketToBuffer(SharedWorldPacket const& packet, std::unique_lock<std::mutex>& guard)
+{
+    ServerPktHeader header(packet->size() + 2, packet->GetOpcode());
+
+    _authCrypt.EncryptSend(header.header, header.getHeaderLength());
+
+    GetQueuedWriteBuffer(header.getHeaderLength()).Write(header.header, header.getHeaderLength());
+    if (!packet->empty())
+        QueueSharedBuffer(std::shared_ptr<uint8 const>(packet, packet->contents()), packet->size());
+
+    ScheduleWrite(guard);
+}
+
+void WorldSocket::ProcessCompressionQueue()
+{
+    std::deque<CompressionQueueEntry> batch;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> guard(_writeLock);
+
+            for (CompressionQueueEntry const& entry : batch)
+            {
+                if (entry.SharedPacket)
+                    WriteSharedPacketToBuffer(entry.SharedPacket, guard);
+                else
+                    WritePacketToBuffer(entry.Packet, guard);
+            }
+
+            batch.clear();
+
+            if (_compressionQueue.empty() || !IsOpen())
+            {
+                _compressionQueue.clear();
+                _compressionPending = false;
+                return;
+            }
+
+            batch.swap(_compressionQueue);
+        }
+
+        // compression runs without holding the write lock, senders only append to _compressionQueue meanwhile
+        for (CompressionQueueEntry& entry : batch)
+        {
+            if (!entry.Compress)
+                continue;
+
+            uint16 opcode = entry.Packet.GetOpcode();
+            std::size_t uncompressedSize = entry.Packet.size();
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+            entry.Packet.Compress(_compressionStream, _compressionBuffer);
+
+            if (opcode < NUM_OPCODE_HANDLERS)
+            {
+                CompressionStats& stats = _compressionStats[opcode];
+                stats.Count.fetch_add(1, std::memory_order_relaxed);
+                stats.UncompressedBytes.fetch_add(uncompressedSize, std::memory_order_relaxed);
+                stats.CompressedBytes.fetch_add(entry.Packet.size(), std::memory_order_relaxed);
+                stats.Time.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+            }
+        }
     }
 }
 
@@ -26,7 +26,9 @@
 #include "Util.h"
 #include "WorldPacket.h"
 #include "WorldSession.h"
+#include <atomic>
 #include <chrono>
+#include <deque>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/buffer.hpp>
 
@@ -51,8 +53,12 @@ class WorldSocket : public Socket<WorldSocket>
 
     static std::string const ClientConnectionInitialize;
 
+    /// Packets larger than this are compressed before sending
+    static std::size_t const CompressionThreshold = 0x400;
+
 public:
     WorldSocket(tcp::socket&& socket);
+    ~WorldSocket();
 
     WorldSocket(WorldSocket const& right) = delete;
     WorldSocket& operator=(WorldSocket const& right) = delete;
@@ -60,6 +66,26 @@ public:
     void Start() override;
 
     void SendPacket(WorldPacket& packet);
+    /// Only the header is encrypted and copied per socket, the contents are queued by reference
+    void SendSharedPacket(SharedWorldPacket const& packet);
+
+    /// Whether sending the packet as shared packet avoids copies: small packets are cheaper to copy
+    /// and large ones are compressed by each connection
+    static bool IsShareable(WorldPacket const& packet)
+    {
+        return packet.size() >= WRITE_SHARED_MIN_SIZE && (packet.size() <= CompressionThreshold || packet.IsCompressed());
+    }
+
+    /// Accumulated cost of compressing outgoing packets, Time is in microseconds
+    struct CompressionStats
+    {
+        std::atomic<uint64> Count;
+        std::atomic<uint64> UncompressedBytes;
+        std::atomic<uint64> CompressedBytes;
+        std::atomic<uint64> Time;
+    };
+
+    static CompressionStats const& GetCompressionStats(uint16 opcode) { return _compressionStats[opcode]; }
 
 protected:
     void OnClose() override;
@@ -73,6 +99,11 @@ private:
     void LogOpcodeText(uint16 opcode, std::unique_lock<std::mutex> const& guard) const;
     /// sends and logs network.opcode without accessing WorldSession
     void SendPacketAndLogOpcode(WorldPacket& packet);
+    /// encrypts the header and appends the packet to the write buffers, must be called with _writeLock held
+    void WritePacketToBuffer(WorldPacket const& packet, std::unique_lock<std::mutex>& guard);
+    void WriteSharedPacketToBuffer(SharedWorldPacket const& packet, std::unique_lock<std::mutex>& guard);
+    /// compresses queued packets on the network thread and hands them over for writing in order
+    void ProcessCompressionQueue();
     void HandleSendAuthSession();
     void HandleAuthSession(WorldPacket& recvPacket);
     void SendAuthResponseError(uint8 code);
@@ -93,6 +124,25 @@ private:
     MessageBuffer _packetBuffer;
 
     bool _initialized;
+
+    struct CompressionQueueEntry
+    {
+        CompressionQueueEntry(WorldPacket const& packet, bool compress) : Packet(packet), Compress(compress) { }
+        explicit CompressionQueueEntry(SharedWorldPacket const& packet) : SharedPacket(packet), Compress(false) { }
+
+        WorldPacket Packet;
+        SharedWorldPacket SharedPacket;                     // set instead of Packet for shared packets, never compressed
+        bool Compress;
+    };
+
+    /// only touched by ProcessCompressionQueue which never runs concurrently for the same socket
+    z_stream_s* _compressionStream;
+    std::vector<uint8> _compressionBuffer;
+    /// guarded by _writeLock
+    std::deque<CompressionQueueEntry> _compressionQueue;
+    bool _compressionPending;
+
+    static CompressionStats _compressionStats[NUM_OPCODE_HANDLERS];
 };
 
 #endif
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2008-2015 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AuraEffectIndex.h"
+#include "Log.h"
+#include "SpellAuraEffects.h"
+#include "SpellMgr.h"
+#include "Util.h"
+
+// different misc values queried for one aura type before its cache is dropped, real units use a handful
+static size_t const MAX_CACHED_FILTERS = 16;
+
+static AuraEffectIndex::EffectList const EmptyEffects;
+static AuraEffectIndex::Modifiers const EmptyModifiers = { 0, 1.0f, 0, 0 };
+
+std::atomic<bool> AuraEffectIndex::_cacheEnabled(true);
+std::atomic<bool> AuraEffectIndex::_checkEnabled(false);
+std::atomic<uint32> AuraEffectIndex::_mismatches(0);
+
+AuraEffectIndex::~AuraEffectIndex()
+{
+    for (auto itr = _types.begin(); itr != _types.end(); ++itr)
+        delete itr->second;
+}
+
+AuraEffectIndex::EffectList const& AuraEffectIndex::GetEffects(AuraType type) const
+{
+    auto itr = _types.find(type);
+    return itr != _types.end() ? itr->second->Effects : EmptyEffects;
+}
+
+void AuraEffectIndex::Add(AuraEffect* aurEff)
+{
+    TypeEffects*& entry = _types[aurEff->GetAuraType()];
+    if (!entry)
+        entry = new TypeEffects();
+
+    entry->Effects.push_back(aurEff);
+    entry->Cache.clear();
+}
+
+void AuraEffectIndex::Remove(AuraEffect* aurEff)
+{
+    auto itr = _types.find(aurEff->GetAuraType());
+    if (itr == _types.end())
+        return;
+
+    itr->second->Effects.remove(aurEff);
+    itr->second->Cache.clear();
+}
+
+void AuraEffectIndex::Invalidate(AuraType type)
+{
+    auto itr = _types.find(type);
+    if (itr != _types.end())
+        itr->second->Cache.clear();
+}
+
+AuraEffectIndex::Modifiers AuraEffectIndex::GetModifiers(AuraType type, Filter filter /*= FILTER_NONE*/, int32 misc /*= 0*/) const
+{
+    auto itr = _types.find(type);
+    if (itr == _types.end() || itr->second->Effects.empty())
+        return EmptyModifiers;
+
+    TypeEffects* entry = itr->second;
+    if (!IsCacheEnabled())
+        return Calculate(entry->Effects, filter, misc);
+
+    // the same effect stack groups are part of the cached values
+    uint32 generation = sSpellMgr->GetSpellGroupGeneration();
+    if (entry->Generation != generation)
+    {
+        entry->Cache.clear();
+        entry->Generation = generation;
+    }
+
+    for (CachedModifiers const& cached : entry->Cache)
+    {
+        if (cached.FilterType != filter || cached.Misc != misc)
+            continue;
+
+        if (_checkEnabled.load(std::memory_order_relaxed))
+        {
+            Modifiers current = Calculate(entry->Effects, filter, misc);
+            if (current.Total != cached.Values.Total || current.Multiplier != cached.Values.Multiplier ||
+                current.MaxPositive != cached.Values.MaxPositive || current.MaxNegative != cached.Values.MaxNegative)
+            {
+                ++_mismatches;
+                TC_LOG_ERROR("spells", "AuraEffectIndex: cached modifiers of aura type %u (filter %u, misc %d) are stale: total %d instead of %d, multiplier %f instead of %f, max %d/%d instead of %d/%d",
+                    uint32(type), uint32(filter), misc, cached.Values.Total, current.Total, cached.Values.Multiplier, current.Multiplier,
+                    cached.Values.MaxPositive, cached.Values.MaxNegative, current.MaxPositive, current.MaxNegative);
+                return current;
+            }
+        }
+
+        return cached.Values;
+    }
+
+    if (entry->Cache.size() >= MAX_CACHED_FILTERS)
+        entry->Cache.clear();
+
+    CachedModifiers cached;
+    cached.FilterType = filter;
+    cached.Misc = misc;
+    cached.Values = Calculate(entry->Effects, filter, misc);
+    entry->Cache.push_back(cached);
+    return cached.Values;
+}
+
+AuraEffectIndex::Modifiers AuraEffectIndex::Calculate(EffectList const& effects, Filter filter, int32 misc)
+{
+    Modifiers modifiers = EmptyModifiers;
+    std::map<SpellGroup, int32> sameEffectSpellGroup;
+
+    for (AuraEffect const* aurEff : effects)
+    {
+        if ((filter == FILTER_MISC_VALUE && aurEff->GetMiscValue() != misc) ||
+            (filter == FILTER_MISC_MASK && !(aurEff->GetMiscValue() & misc)))
+            continue;
+
+        int32 amount = aurEff->GetAmount();
+
+        // Check if the Aura Effect has a the Same Effect Stack Rule and if so, use the highest amount of that SpellGroup
+        // If the Aura Effect does not have this Stack Rule, it returns false so we can add to the modifiers as usual
+        if (!sSpellMgr->AddSameEffectStackRuleSpellGroups(aurEff->GetSpellInfo(), amount, sameEffectSpellGroup))
+        {
+            modifiers.Total += amount;
+            if (filter != FILTER_NONE)
+                AddPct(modifiers.Multiplier, amount);
+        }
+
+        // the unfiltered multiplier has always counted every effect
+        if (filter == FILTER_NONE)
+            AddPct(modifiers.Multiplier, amount);
+
+        if (amount > modifiers.MaxPositive)
+            modifiers.MaxPositive = amount;
+        if (amount < modifiers.MaxNegative)
+            modifiers.MaxNegative = amount;
+    }
+
+    for (std::map<SpellGroup, int32>::const_iterator itr = sameEffectSpellGroup.begin(); itr != sameEffectSpellGroup.end(); ++itr)
+    {
+        modifiers.Total += itr->second;
+        if (filter != FILTER_NONE)
+            AddPct(modifiers.Multiplier, itr->second);
+    }
+
+    return modifiers;
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2008-2015 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_AURAEFFECTINDEX_H
+#define TRINITY_AURAEFFECTINDEX_H
+
+#include "Define.h"
+#include "FlatHashMap.h"
+#include "SpellAuraDefines.h"
+#include <atomic>
+#include <list>
+#include <vector>
+
+class AuraEffect;
+
+/*
+ * Aura effects applied to a unit grouped by aura type, with the values of the Unit::GetTotalAuraModifier
+ * family computed once per aura type and misc value or mask. They are kept until an effect of that type
+ * is added, removed or changes its amount, or the spell group stack rules are reloaded.
+ * Only aura types the unit ever had an effect of get a list, lists are never freed before the unit
+ * so references returned by GetEffects stay valid while effects are added and removed.
+ */
+class AuraEffectIndex
+{
+    public:
+        typedef std::list<AuraEffect*> EffectList;
+
+        enum Filter
+        {
+            FILTER_NONE,
+            FILTER_MISC_VALUE,                              // misc value equal to the argument
+            FILTER_MISC_MASK                                // misc value sharing a bit with the argument
+        };
+
+        struct Modifiers
+        {
+            int32 Total;                                    // sum of the amounts, only the highest of each same effect stack group counts
+            float Multiplier;                               // product of the amounts as percent, filtered queries apply the stack groups as for Total
+            int32 MaxPositive;
+            int32 MaxNegative;
+        };
+
+        AuraEffectIndex() { }
+        ~AuraEffectIndex();
+
+        EffectList const& GetEffects(AuraType type) const;
+
+        void Add(AuraEffect* aurEff);
+        void Remove(AuraEffect* aurEff);
+        // drops the cached modifiers of the type, called when the amount of one of its effects changes
+        void Invalidate(AuraType type);
+
+        Modifiers GetModifiers(AuraType type, Filter filter = FILTER_NONE, int32 misc = 0) const;
+
+        // full scan of the effects, what the cached modifiers are filled with and checked against
+        static Modifiers Calculate(EffectList const& effects, Filter filter, int32 misc);
+
+        // world config, with checking enabled every cached value is compared to a full scan when it is used
+        static void SetCacheEnabled(bool enabled) { _cacheEnabled = enabled; }
+        static bool IsCacheEnabled() { return _cacheEnabled.load(std::memory_order_relaxed); }
+        static void SetCheckEnabled(bool enabled) { _checkEnabled = enabled; }
+        static uint32 GetMismatches() { return _mismatches; }
+
+    private:
+        struct CachedModifiers
+        {
+            Filter FilterType;
+            int32 Misc;
+            Modifiers Values;
+        };
+
+        struct TypeEffects
+        {
+            TypeEffects() : Generation(0) { }
+
+            EffectList Effects;
+            uint32 Generation;                              // SpellMgr::GetSpellGroupGeneration() the cache was filled with
+            std::vector<CachedModifiers> Cache;
+        };
+
+        FlatHashMap<TypeEffects*> _types;
+
+        static std::atomic<bool> _cacheEnabled;
+        static std::atomic<bool> _checkEnabled;
+        static std::atomic<uint32> _mismatches;
+
+        AuraEffectIndex(AuraEffectIndex const& right) = delete;
+        AuraEffectIndex& operator=(AuraEffectIndex const& right) = delete;
+};
+
+#endif
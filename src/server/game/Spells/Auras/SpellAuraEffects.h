@@ -53,7 +53,7 @@ class AuraEffect
         int32 GetMiscValue() const { return m_spellInfo->Effects[m_effIndex].MiscValue; }
         AuraType GetAuraType() const { return (AuraType)m_spellInfo->Effects[m_effIndex].ApplyAuraName; }
         int32 GetAmount() const { return m_amount; }
-        void SetAmount(int32 amount) { m_amount = amount; m_canBeRecalculated = false;}
+        void SetAmount(int32 amount);
 
         int32 GetPeriodicTimer() const { return m_periodicTimer; }
         void SetPeriodicTimer(int32 periodicTimer) { m_periodicTimer = periodicTimer; }
@@ -120,6 +120,7 @@ class AuraEffect
         bool m_isPeriodic;
     private:
         bool CanPeriodicTickCrit(Unit const* caster) const;
+        void InvalidateTargetAuraModifiers();
 
     public:
         // aura effect apply/remove handlers
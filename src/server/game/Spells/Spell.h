@@ -24,6 +24,7 @@
 #include "ObjectMgr.h"
 #include "SpellInfo.h"
 #include "PathGenerator.h"
+#include "SmallObjectPool.h"
 
 class Unit;
 class Player;
@@ -223,6 +224,9 @@ class Spell
     friend void Unit::SetCurrentCastSpell(Spell* pSpell);
     friend class SpellScript;
     public:
+        // a spell lives for one cast, its memory is reused through the pool of the thread updating the caster
+        static void* operator new(size_t size) { return SmallObjectPool::Allocate(size); }
+        static void operator delete(void* block, size_t size) { SmallObjectPool::Deallocate(block, size); }
 
         void EffectNULL(SpellEffIndex effIndex);
         void EffectUnused(SpellEffIndex effIndex);
@@ -599,7 +603,8 @@ class Spell
             bool   scaleAura:1;
             int32  damage;
         };
-        std::list<TargetInfo> m_UniqueTargetInfo;
+        typedef std::list<TargetInfo, PoolAllocator<TargetInfo>> TargetInfoList;
+        TargetInfoList m_UniqueTargetInfo;
         uint8 m_channelTargetEffectMask;                        // Mask req. alive targets
 
         struct GOTargetInfo
@@ -609,14 +614,16 @@ class Spell
             uint8  effectMask:8;
             bool   processed:1;
         };
-        std::list<GOTargetInfo> m_UniqueGOTargetInfo;
+        typedef std::list<GOTargetInfo, PoolAllocator<GOTargetInfo>> GOTargetInfoList;
+        GOTargetInfoList m_UniqueGOTargetInfo;
 
         struct ItemTargetInfo
         {
             Item  *item;
             uint8 effectMask;
         };
-        std::list<ItemTargetInfo> m_UniqueItemInfo;
+        typedef std::list<ItemTargetInfo, PoolAllocator<ItemTargetInfo>> ItemTargetInfoList;
+        ItemTargetInfoList m_UniqueItemInfo;
 
         SpellDestination m_destTargets[MAX_SPELL_EFFECTS];
 
@@ -766,6 +773,9 @@ class SpellEvent : public BasicEvent
         SpellEvent(Spell* spell);
         virtual ~SpellEvent();
 
+        static void* operator new(size_t size) { return SmallObjectPool::Allocate(size); }
+        static void operator delete(void* block, size_t size) { SmallObjectPool::Deallocate(block, size); }
+
         virtual bool Execute(uint64 e_time, uint32 p_time) override;
         virtual void Abort(uint64 e_time) override;
         virtual bool IsDeletable() const override;
@@ -119,6 +119,8 @@ void SpellHistory::SaveToDB(SQLTransaction& trans)
             trans->Append(stmt);
         }
     }
+
+    _cooldownsChanged = false;
 }
 
 void SpellHistory::Update()
@@ -430,6 +432,7 @@ void SpellHistory::AddCooldown(uint32 spellId, uint32 itemId, Clock::time_point
     cooldownEntry.CooldownEnd = cooldownEnd;
     cooldownEntry.ItemId = itemId;
     cooldownEntry.OnHold = onHold;
+    _cooldownsChanged = true;
 }
 
 void SpellHistory::ModifyCooldown(uint32 spellId, int32 cooldownModMs)
@@ -445,6 +448,8 @@ void SpellHistory::ModifyCooldown(uint32 spellId, int32 cooldownModMs)
     else
         _spellCooldowns.erase(itr);
 
+    _cooldownsChanged = true;
+
     if (Player* playerOwner = GetPlayerOwner())
     {
         WorldPacket modifyCooldown(SMSG_MODIFY_COOLDOWN, 4 + 8 + 4);
@@ -478,6 +483,7 @@ void SpellHistory::ResetCooldown(CooldownStorageType::iterator& itr, bool update
     }
 
     itr = _spellCooldowns.erase(itr);
+    _cooldownsChanged = true;
 }
 
 void SpellHistory::ResetAllCooldowns()
@@ -492,6 +498,9 @@ void SpellHistory::ResetAllCooldowns()
         SendClearCooldowns(cooldowns);
     }
 
+    if (!_spellCooldowns.empty())
+        _cooldownsChanged = true;
+
     _spellCooldowns.clear();
 }
 
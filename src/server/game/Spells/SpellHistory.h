@@ -49,13 +49,15 @@ public:
     typedef std::unordered_map<uint32 /*spellId*/, CooldownEntry> CooldownStorageType;
     typedef std::unordered_map<uint32 /*categoryId*/, Clock::time_point> GlobalCooldownStorageType;
 
-    explicit SpellHistory(Unit* owner) : _owner(owner), _schoolLockouts() { }
+    explicit SpellHistory(Unit* owner) : _owner(owner), _schoolLockouts(), _cooldownsChanged(true) { }
 
     template<class OwnerType>
     void LoadFromDB(PreparedQueryResult cooldownsResult);
 
     template<class OwnerType>
     void SaveToDB(SQLTransaction& trans);
+    /// Cooldowns were added, modified or removed since the last SaveToDB (expiring ones do not count)
+    bool HasUnsavedCooldowns() const { return _cooldownsChanged; }
 
     void Update();
 
@@ -129,6 +131,7 @@ private:
     CooldownStorageType _spellCooldowns;
     Clock::time_point _schoolLockouts[MAX_SPELL_SCHOOL];
     GlobalCooldownStorageType _globalCooldowns;
+    bool _cooldownsChanged;
 
     template<class T>
     struct PersistenceHelper { };
@@ -355,7 +355,7 @@ bool IsDiminishingReturnsGroupDurationLimited(DiminishingGroup group)
     }
 }
 
-SpellMgr::SpellMgr() { }
+SpellMgr::SpellMgr() : mSpellGroupGeneration(1) { }
 
 SpellMgr::~SpellMgr()
 {
@@ -1772,6 +1772,7 @@ void SpellMgr::LoadSpellGroups()
 
     mSpellSpellGroup.clear();                                  // need for reload case
     mSpellGroupSpell.clear();
+    ++mSpellGroupGeneration;
 
     //                                                0     1
     QueryResult result = WorldDatabase.Query("SELECT id, spell_id FROM spell_group");
@@ -1851,6 +1852,7 @@ void SpellMgr::LoadSpellGroupStackRules()
     uint32 oldMSTime = getMSTime();
 
     mSpellGroupStack.clear();                                  // need for reload case
+    ++mSpellGroupGeneration;
 
     //                                                       0         1
     QueryResult result = WorldDatabase.Query("SELECT group_id, stack_rule FROM spell_group_stack_rules");
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2008-2015 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LoaderGraph.h"
+#include "Errors.h"
+#include "Log.h"
+#include "Timer.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <thread>
+
+void LoaderGraph::Add(char const* name, std::initializer_list<char const*> dependencies, Loader&& loader)
+{
+    ASSERT(FindNode(name) == _nodes.size(), "Startup loader %s added twice", name);
+
+    uint32 index = uint32(_nodes.size());
+    _nodes.emplace_back(name, std::move(loader));
+
+    for (char const* dependency : dependencies)
+    {
+        uint32 dependencyIndex = FindNode(dependency);
+        ASSERT(dependencyIndex < index, "Startup loader %s depends on %s which was not added before it", name, dependency);
+
+        _nodes[index].Dependencies.push_back(dependencyIndex);
+        _nodes[dependencyIndex].Dependents.push_back(index);
+    }
+}
+
+uint32 LoaderGraph::FindNode(char const* name) const
+{
+    for (uint32 i = 0; i < _nodes.size(); ++i)
+        if (!strcmp(_nodes[i].Name, name))
+            return i;
+
+    return uint32(_nodes.size());
+}
+
+void LoaderGraph::Run(uint32 threadCount)
+{
+    _threadCount = std::max<uint32>(std::min<uint32>(threadCount, uint32(_nodes.size())), 1);
+
+    uint32 runStart = getMSTime();
+
+    std::mutex lock;
+    std::condition_variable wakeUp;
+
+    // loaders whose dependencies all finished, the lowest index goes first so one thread keeps the declared order
+    std::set<uint32> ready;
+    std::vector<uint32> unfinishedDependencies(_nodes.size());
+    uint32 remaining = uint32(_nodes.size());
+
+    for (uint32 i = 0; i < _nodes.size(); ++i)
+    {
+        unfinishedDependencies[i] = uint32(_nodes[i].Dependencies.size());
+        if (!unfinishedDependencies[i])
+            ready.insert(i);
+    }
+
+    auto worker = [&](uint32 thread)
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        for (;;)
+        {
+            wakeUp.wait(guard, [&]() { return !ready.empty() || !remaining; });
+            if (ready.empty())
+                return;
+
+            Node& node = _nodes[*ready.begin()];
+            ready.erase(ready.begin());
+            guard.unlock();
+
+            node.Thread = thread;
+            node.StartTime = GetMSTimeDiffToNow(runStart);
+            node.Load();
+            node.Duration = GetMSTimeDiffToNow(runStart) - node.StartTime;
+
+            guard.lock();
+            --remaining;
+            for (uint32 dependent : node.Dependents)
+                if (!--unfinishedDependencies[dependent])
+                    ready.insert(dependent);
+
+            wakeUp.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32 i = 1; i < _threadCount; ++i)
+        threads.push_back(std::thread(worker, i));
+
+    worker(0);
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    _totalTime = GetMSTimeDiffToNow(runStart);
+}
+
+void LoaderGraph::LogReport() const
+{
+    uint32 loaderTime = 0;
+    for (Node const& node : _nodes)
+    {
+        loaderTime += node.Duration;
+        TC_LOG_DEBUG("server.loading", "Loader %-32s %6u ms, started after %6u ms on thread %u", node.Name, node.Duration, node.StartTime, node.Thread);
+    }
+
+    TC_LOG_INFO("server.loading", ">> Ran %u startup loaders on %u threads in %u ms, %u ms spent inside the loaders",
+        uint32(_nodes.size()), _threadCount, _totalTime, loaderTime);
+
+    std::vector<uint32> slowest(_nodes.size());
+    for (uint32 i = 0; i < slowest.size(); ++i)
+        slowest[i] = i;
+
+    size_t shown = std::min<size_t>(slowest.size(), 10);
+    std::partial_sort(slowest.begin(), slowest.begin() + shown, slowest.end(), [this](uint32 left, uint32 right)
+    {
+        return _nodes[left].Duration > _nodes[right].Duration;
+    });
+
+    TC_LOG_INFO("server.loading", "Slowest startup loaders:");
+    for (size_t i = 0; i < shown; ++i)
+        TC_LOG_INFO("server.loading", "    %-32s %6u ms", _nodes[slowest[i]].Name, _nodes[slowest[i]].Duration);
+
+    if (_nodes.empty())
+        return;
+
+    // the chain of dependencies with the largest summed duration bounds the startup time, however many threads are used
+    std::vector<uint32> pathTime(_nodes.size());
+    std::vector<uint32> previous(_nodes.size(), uint32(_nodes.size()));
+    uint32 last = 0;
+    for (uint32 i = 0; i < _nodes.size(); ++i)
+    {
+        for (uint32 dependency : _nodes[i].Dependencies)
+        {
+            if (previous[i] == _nodes.size() || pathTime[dependency] > pathTime[previous[i]])
+                previous[i] = dependency;
+        }
+
+        pathTime[i] = _nodes[i].Duration + (previous[i] != _nodes.size() ? pathTime[previous[i]] : 0);
+        if (pathTime[i] > pathTime[last])
+            last = i;
+    }
+
+    std::vector<uint32> path;
+    for (uint32 i = last; i != _nodes.size(); i = previous[i])
+        path.push_back(i);
+
+    TC_LOG_INFO("server.loading", "Startup critical path, %u ms:", pathTime[last]);
+    for (auto itr = path.rbegin(); itr != path.rend(); ++itr)
+        TC_LOG_INFO("server.loading", "    %-32s %6u ms", _nodes[*itr].Name, _nodes[*itr].Duration);
+}
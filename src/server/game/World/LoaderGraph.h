@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2008-2015 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_LOADERGRAPH_H
+#define TRINITY_LOADERGRAPH_H
+
+#include "Define.h"
+#include <functional>
+#include <initializer_list>
+#include <vector>
+
+/*
+ * Runs the world startup loaders as a dependency graph.
+ *
+ * Every loader names the loaders whose data it reads (or modifies) and starts once all
+ * of them are done. Dependencies can only name loaders added before, so the order of
+ * Add() calls is always a valid order and is exactly what a single thread executes.
+ * With more threads independent loaders run concurrently, their queries are spread over
+ * the synchronous connections of the database pools.
+ */
+class LoaderGraph
+{
+    public:
+        typedef std::function<void()> Loader;
+
+        LoaderGraph() : _threadCount(0), _totalTime(0) { }
+
+        void Add(char const* name, std::initializer_list<char const*> dependencies, Loader&& loader);
+
+        // blocks until every loader finished, the calling thread is one of the workers
+        void Run(uint32 threadCount);
+
+        // per loader timings (debug) and the slowest loaders and critical path (info)
+        void LogReport() const;
+
+    private:
+        struct Node
+        {
+            Node(char const* name, Loader&& loader) : Name(name), Load(std::move(loader)), StartTime(0), Duration(0), Thread(0) { }
+
+            char const* Name;
+            Loader Load;
+            std::vector<uint32> Dependencies;
+            std::vector<uint32> Dependents;
+
+            uint32 StartTime;                               // ms since Run() started
+            uint32 Duration;                                // ms
+            uint32 Thread;
+        };
+
+        uint32 FindNode(char const* name) const;
+
+        std::vector<Node> _nodes;
+        uint32 _threadCount;
+        uint32 _totalTime;
+};
+
+#endif
@@ -25,6 +25,7 @@
 #include "ArenaTeamMgr.h"
 #include "AuctionHouseBot.h"
 #include "AuctionHouseMgr.h"
+#include "AuraEffectIndex.h"
 #include "BattlefieldMgr.h"
 #include "BattlegroundMgr.h"
 #include "CalendarMgr.h"
@@ -44,9 +45,11 @@
 #include "InstanceSaveMgr.h"
 #include "Language.h"
 #include "LFGMgr.h"
+#include "LoaderGraph.h"
 #include "MapManager.h"
 #include "Memory.h"
 #include "MMapFactory.h"
+#include "MovementStatusCodec.h"
 #include "ObjectMgr.h"
 #include "OutdoorPvPMgr.h"
 #include "Player.h"
@@ -54,6 +57,7 @@
 #include "ScriptMgr.h"
 #include "SkillDiscovery.h"
 #include "SkillExtraItems.h"
+#include "SmallObjectPool.h"
 #include "SmartAI.h"
 #include "SystemConfig.h"
 #include "TicketMgr.h"
@@ -1209,6 +1213,8 @@ void World::LoadConfigSettings(bool reload)
     m_bool_configs[CONFIG_ENABLE_MMAPS] = sConfigMgr->GetBoolDefault("mmap.enablePathFinding", false);
     TC_LOG_INFO("server.loading", "WORLD: MMap data directory is: %smmaps", m_dataPath.c_str());
 
+    m_bool_configs[CONFIG_MEMORY_MAPPED_DATA_FILES] = sConfigMgr->GetBoolDefault("DataFiles.MemoryMapped", false);
+
     m_bool_configs[CONFIG_VMAP_INDOOR_CHECK] = sConfigMgr->GetBoolDefault("vmap.enableIndoorCheck", 0);
     bool enableIndoor = sConfigMgr->GetBoolDefault("vmap.enableIndoorCheck", true);
     bool enableLOS = sConfigMgr->GetBoolDefault("vmap.enableLOS", true);
@@ -1222,6 +1228,13 @@ void World::LoadConfigSettings(bool reload)
     TC_LOG_INFO("server.loading", "VMap support included. LineOfSight: %i, getHeight: %i, indoorCheck: %i", enableLOS, enableHeight, enableIndoor);
     TC_LOG_INFO("server.loading", "VMap data directory is: %svmaps", m_dataPath.c_str());
 
+    m_int_configs[CONFIG_VMAP_COLLISION_CACHE_SIZE] = sConfigMgr->GetIntDefault("vmap.collisionCacheSize", 0);
+    if (m_int_configs[CONFIG_VMAP_COLLISION_CACHE_SIZE] > 1048576)
+    {
+        TC_LOG_ERROR("server.loading", "vmap.collisionCacheSize (%u) can't be greater than 1048576. Using 1048576 instead.", m_int_configs[CONFIG_VMAP_COLLISION_CACHE_SIZE]);
+        m_int_configs[CONFIG_VMAP_COLLISION_CACHE_SIZE] = 1048576;
+    }
+
     m_int_configs[CONFIG_MAX_WHO] = sConfigMgr->GetIntDefault("MaxWhoListReturns", 49);
     m_bool_configs[CONFIG_START_ALL_SPELLS] = sConfigMgr->GetBoolDefault("PlayerStart.AllSpells", false);
     m_int_configs[CONFIG_HONOR_AFTER_DUEL] = sConfigMgr->GetIntDefault("HonorPointsAfterDuel", 0);
@@ -1243,6 +1256,31 @@ void World::LoadConfigSettings(bool reload)
     m_int_configs[CONFIG_INTERVAL_LOG_UPDATE] = sConfigMgr->GetIntDefault("RecordUpdateTimeDiffInterval", 60000);
     m_int_configs[CONFIG_MIN_LOG_UPDATE] = sConfigMgr->GetIntDefault("MinRecordUpdateTimeDiff", 100);
     m_int_configs[CONFIG_NUMTHREADS] = sConfigMgr->GetIntDefault("MapUpdate.Threads", 1);
+    m_bool_configs[CONFIG_MAP_REGION_UPDATE] = sConfigMgr->GetBoolDefault("MapUpdate.Regions.Enable", false);
+    m_int_configs[CONFIG_MAP_REGION_UPDATE_MARGIN] = sConfigMgr->GetIntDefault("MapUpdate.Regions.Margin", 2);
+    if (m_int_configs[CONFIG_MAP_REGION_UPDATE_MARGIN] < 1)
+    {
+        TC_LOG_ERROR("server.loading", "MapUpdate.Regions.Margin (%u) must be at least 1. Using 1 instead.", m_int_configs[CONFIG_MAP_REGION_UPDATE_MARGIN]);
+        m_int_configs[CONFIG_MAP_REGION_UPDATE_MARGIN] = 1;
+    }
+    m_int_configs[CONFIG_GRID_PRELOAD_LOOKAHEAD] = sConfigMgr->GetIntDefault("GridPreload.Lookahead", 0);
+    if (m_int_configs[CONFIG_GRID_PRELOAD_LOOKAHEAD] > 60)
+    {
+        TC_LOG_ERROR("server.loading", "GridPreload.Lookahead (%u) can't be greater than 60. Using 60 instead.", m_int_configs[CONFIG_GRID_PRELOAD_LOOKAHEAD]);
+        m_int_configs[CONFIG_GRID_PRELOAD_LOOKAHEAD] = 60;
+    }
+    m_int_configs[CONFIG_STARTUP_LOADER_THREADS] = sConfigMgr->GetIntDefault("Startup.LoaderThreads", 1);
+    if (m_int_configs[CONFIG_STARTUP_LOADER_THREADS] < 1 || m_int_configs[CONFIG_STARTUP_LOADER_THREADS] > 16)
+    {
+        TC_LOG_ERROR("server.loading", "Startup.LoaderThreads (%u) must be in range 1..16. Using 1 instead.", m_int_configs[CONFIG_STARTUP_LOADER_THREADS]);
+        m_int_configs[CONFIG_STARTUP_LOADER_THREADS] = 1;
+    }
+    m_bool_configs[CONFIG_AURA_MODIFIER_CACHE] = sConfigMgr->GetBoolDefault("Auras.ModifierCache", true);
+    m_bool_configs[CONFIG_AURA_MODIFIER_CACHE_CHECK] = sConfigMgr->GetBoolDefault("Auras.ModifierCache.Check", false);
+    AuraEffectIndex::SetCacheEnabled(m_bool_configs[CONFIG_AURA_MODIFIER_CACHE]);
+    AuraEffectIndex::SetCheckEnabled(m_bool_configs[CONFIG_AURA_MODIFIER_CACHE_CHECK]);
+    m_bool_configs[CONFIG_SPELL_ALLOCATION_POOL] = sConfigMgr->GetBoolDefault("Spells.AllocationPool", true);
+    SmallObjectPool::SetEnabled(m_bool_configs[CONFIG_SPELL_ALLOCATION_POOL]);
     m_int_configs[CONFIG_MAX_RESULTS_LOOKUP_COMMANDS] = sConfigMgr->GetIntDefault("Command.LookupMaxResults", 0);
 
     // Warden
@@ -1328,6 +1366,16 @@ void World::LoadConfigSettings(bool reload)
 
     m_int_configs[CONFIG_PACKET_SPOOF_BANDURATION] = sConfigMgr->GetIntDefault("PacketSpoof.BanDuration", 86400);
 
+    m_int_configs[CONFIG_SESSION_RECV_QUEUE_SIZE] = sConfigMgr->GetIntDefault("Network.RecvQueueSize", 1024);
+    if (m_int_configs[CONFIG_SESSION_RECV_QUEUE_SIZE] < 128)
+    {
+        TC_LOG_ERROR("server.loading", "Network.RecvQueueSize (%u) must be at least 128. Using 128 instead.", m_int_configs[CONFIG_SESSION_RECV_QUEUE_SIZE]);
+        m_int_configs[CONFIG_SESSION_RECV_QUEUE_SIZE] = 128;
+    }
+    m_int_configs[CONFIG_SESSION_RECV_QUEUE_OVERFLOW_POLICY] = sConfigMgr->GetIntDefault("Network.RecvQueueOverflowPolicy", RECV_QUEUE_OVERFLOW_KICK);
+    if (m_int_configs[CONFIG_SESSION_RECV_QUEUE_OVERFLOW_POLICY] > RECV_QUEUE_OVERFLOW_KICK)
+        m_int_configs[CONFIG_SESSION_RECV_QUEUE_OVERFLOW_POLICY] = RECV_QUEUE_OVERFLOW_KICK;
+
     m_bool_configs[CONFIG_IP_BASED_ACTION_LOGGING] = sConfigMgr->GetBoolDefault("Allow.IP.Based.Action.Logging", false);
 
     // AHBot
@@ -1432,243 +1480,493 @@ void World::SetInitialWorldSettings()
     MMAP::MMapManager* mmmgr = MMAP::MMapFactory::createOrGetMMapManager();
     mmmgr->InitializeThreadUnsafe(mapIds);
 
-    TC_LOG_INFO("server.loading", "Loading SpellInfo store...");
-    sSpellMgr->LoadSpellInfoStore();
+    ///- Load the static world data. Loaders that do not depend on each other may run concurrently,
+    ///- so every loader lists the loaders it reads data from. SpellRanks is the last loader modifying
+    ///- SpellInfo, everything looking at spells outside of SpellMgr waits for it, except the
+    ///- GameObject templates which are loaded before it.
 
-    TC_LOG_INFO("server.loading", "Loading SpellInfo corrections...");
-    sSpellMgr->LoadSpellInfoCorrections();
+    // the managers are function local statics, construct them before several threads can race on it
+    sSpellMgr;
+    sInstanceSaveMgr;
+    sAccountMgr;
+    sTransportMgr;
+    sLFGMgr;
+    sAchievementMgr;
 
-    TC_LOG_INFO("server.loading", "Loading SkillLineAbilityMultiMap Data...");
-    sSpellMgr->LoadSkillLineAbilityMap();
+    sObjectMgr->SetDBCLocaleIndex(GetDefaultDbcLocale());        // Get once for all the locale index of DBC language (console/broadcasts)
 
-    TC_LOG_INFO("server.loading", "Loading SpellInfo custom attributes...");
-    sSpellMgr->LoadSpellInfoCustomAttributes();
+    LoaderGraph loaders;
 
-    TC_LOG_INFO("server.loading", "Loading GameObject models...");
-    LoadGameObjectModelList(m_dataPath);
+    loaders.Add("SpellInfoStore", { }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading SpellInfo store...");
+        sSpellMgr->LoadSpellInfoStore();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Script Names...");
-    sObjectMgr->LoadScriptNames();
+    loaders.Add("SpellInfoCorrections", { "SpellInfoStore" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading SpellInfo corrections...");
+        sSpellMgr->LoadSpellInfoCorrections();
+    });
+
+    loaders.Add("SkillLineAbilityMap", { }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading SkillLineAbilityMultiMap Data...");
+        sSpellMgr->LoadSkillLineAbilityMap();
+    });
+
+    loaders.Add("SpellInfoCustomAttributes", { "SpellInfoCorrections", "SkillLineAbilityMap" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading SpellInfo custom attributes...");
+        sSpellMgr->LoadSpellInfoCustomAttributes();
+    });
+
+    std::string const dataPath = m_dataPath;
+    loaders.Add("GameObjectModels", { }, [dataPath]
+    {
+        TC_LOG_INFO("server.loading", "Loading GameObject models...");
+        LoadGameObjectModelList(dataPath);
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Instance Template...");
-    sObjectMgr->LoadInstanceTemplate();
+    loaders.Add("ScriptNames", { }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Script Names...");
+        sObjectMgr->LoadScriptNames();
+    });
+
+    loaders.Add("InstanceTemplate", { "ScriptNames" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Instance Template...");
+        sObjectMgr->LoadInstanceTemplate();
+    });
 
     // Must be called before `creature_respawn`/`gameobject_respawn` tables
-    TC_LOG_INFO("server.loading", "Loading instances...");
-    sInstanceSaveMgr->LoadInstances();
+    loaders.Add("Instances", { }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading instances...");
+        sInstanceSaveMgr->LoadInstances();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Broadcast texts...");
-    sObjectMgr->LoadBroadcastTexts();
-    sObjectMgr->LoadBroadcastTextLocales();
+    loaders.Add("BroadcastTexts", { }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Broadcast texts...");
+        sObjectMgr->LoadBroadcastTexts();
+        sObjectMgr->LoadBroadcastTextLocales();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Localization strings...");
-    uint32 oldMSTime = getMSTime();
-    sObjectMgr->LoadCreatureLocales();
-    sObjectMgr->LoadGameObjectLocales();
-    sObjectMgr->LoadItemLocales();
-    sObjectMgr->LoadQuestLocales();
-    sObjectMgr->LoadNpcTextLocales();
-    sObjectMgr->LoadPageTextLocales();
-    sObjectMgr->LoadGossipMenuItemsLocales();
-    sObjectMgr->LoadPointOfInterestLocales();
+    loaders.Add("Localization", { }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Localization strings...");
+        uint32 oldMSTime = getMSTime();
+        sObjectMgr->LoadCreatureLocales();
+        sObjectMgr->LoadGameObjectLocales();
+        sObjectMgr->LoadItemLocales();
+        sObjectMgr->LoadQuestLocales();
+        sObjectMgr->LoadNpcTextLocales();
+        sObjectMgr->LoadPageTextLocales();
+        sObjectMgr->LoadGossipMenuItemsLocales();
+        sObjectMgr->LoadPointOfInterestLocales();
+        TC_LOG_INFO("server.loading", ">> Localization strings loaded in %u ms", GetMSTimeDiffToNow(oldMSTime));
+    });
 
-    sObjectMgr->SetDBCLocaleIndex(GetDefaultDbcLocale());        // Get once for all the locale index of DBC language (console/broadcasts)
-    TC_LOG_INFO("server.loading", ">> Localization strings loaded in %u ms", GetMSTimeDiffToNow(oldMSTime));
+    loaders.Add("RBAC", { }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Account Roles and Permissions...");
+        sAccountMgr->LoadRBAC();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Account Roles and Permissions...");
-    sAccountMgr->LoadRBAC();
+    loaders.Add("PageTexts", { }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Page Texts...");
+        sObjectMgr->LoadPageTexts();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Page Texts...");
-    sObjectMgr->LoadPageTexts();
+    loaders.Add("GameObjectTemplates", { "PageTexts", "ScriptNames", "SpellInfoCustomAttributes" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Game Object Templates...");
+        sObjectMgr->LoadGameObjectTemplate();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Game Object Templates...");         // must be after LoadPageTexts
-    sObjectMgr->LoadGameObjectTemplate();
+    loaders.Add("TransportTemplates", { "GameObjectTemplates" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Transport templates...");
+        sTransportMgr->LoadTransportTemplates();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Transport templates...");
-    sTransportMgr->LoadTransportTemplates();
+    // waits for the GameObject templates instead, they checked their spells before the ranks were set up
+    loaders.Add("SpellRanks", { "SpellInfoCustomAttributes", "GameObjectTemplates" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Spell Rank Data...");
+        sSpellMgr->LoadSpellRanks();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Spell Rank Data...");
-    sSpellMgr->LoadSpellRanks();
+    loaders.Add("SpellRequired", { "SpellRanks" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Spell Required Data...");
+        sSpellMgr->LoadSpellRequired();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Spell Required Data...");
-    sSpellMgr->LoadSpellRequired();
+    loaders.Add("SpellGroups", { "SpellRanks" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Spell Group types...");
+        sSpellMgr->LoadSpellGroups();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Spell Group types...");
-    sSpellMgr->LoadSpellGroups();
+    loaders.Add("SpellLearnSkills", { "SpellRanks" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Spell Learn Skills...");
+        sSpellMgr->LoadSpellLearnSkills();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Spell Learn Skills...");
-    sSpellMgr->LoadSpellLearnSkills();                           // must be after LoadSpellRanks
+    loaders.Add("SpellLearnSpells", { "SpellRanks" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Spell Learn Spells...");
+        sSpellMgr->LoadSpellLearnSpells();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Spell Learn Spells...");
-    sSpellMgr->LoadSpellLearnSpells();
+    loaders.Add("SpellProcEvents", { "SpellRanks" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Spell Proc Event conditions...");
+        sSpellMgr->LoadSpellProcEvents();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Spell Proc Event conditions...");
-    sSpellMgr->LoadSpellProcEvents();
+    loaders.Add("SpellProcs", { "SpellRanks" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Spell Proc conditions and data...");
+        sSpellMgr->LoadSpellProcs();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Spell Proc conditions and data...");
-    sSpellMgr->LoadSpellProcs();
+    loaders.Add("SpellBonuses", { "SpellRanks" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Spell Bonus Data...");
+        sSpellMgr->LoadSpellBonusess();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Spell Bonus Data...");
-    sSpellMgr->LoadSpellBonusess();
+    loaders.Add("SpellThreats", { "SpellRanks" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Aggro Spells Definitions...");
+        sSpellMgr->LoadSpellThreats();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Aggro Spells Definitions...");
-    sSpellMgr->LoadSpellThreats();
+    loaders.Add("SpellGroupStackRules", { "SpellGroups" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Spell Group Stack Rules...");
+        sSpellMgr->LoadSpellGroupStackRules();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Spell Group Stack Rules...");
-    sSpellMgr->LoadSpellGroupStackRules();
+    loaders.Add("NpcTexts", { "BroadcastTexts" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading NPC Texts...");
+        sObjectMgr->LoadGossipText();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading NPC Texts...");
-    sObjectMgr->LoadGossipText();
+    loaders.Add("SpellEnchantProcData", { }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Enchant Spells Proc datas...");
+        sSpellMgr->LoadSpellEnchantProcData();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Enchant Spells Proc datas...");
-    sSpellMgr->LoadSpellEnchantProcData();
+    loaders.Add("RandomEnchantments", { }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Item Random Enchantments Table...");
+        LoadRandomEnchantmentsTable();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Item Random Enchantments Table...");
-    LoadRandomEnchantmentsTable();
+    // the vmap disables are also read when LoadCreatures/LoadGameobjects calculate zone and area ids
+    loaders.Add("Disables", { "SpellRanks" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Disables");
+        DisableMgr::LoadDisables();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Disables");                         // must be before loading quests and items
-    DisableMgr::LoadDisables();
+    loaders.Add("ItemTemplates", { "RandomEnchantments", "PageTexts", "Disables" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Items...");
+        sObjectMgr->LoadItemTemplates();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Items...");                         // must be after LoadRandomEnchantmentsTable and LoadPageTexts
-    sObjectMgr->LoadItemTemplates();
+    loaders.Add("ItemTemplateAddons", { "ItemTemplates" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Item set names...");
+        sObjectMgr->LoadItemTemplateAddon();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Item set names...");                // must be after LoadItemPrototypes
-    sObjectMgr->LoadItemTemplateAddon();
+    loaders.Add("ItemScriptNames", { "ItemTemplates", "ScriptNames" }, []
+    {
+        TC_LOG_INFO("misc", "Loading Item Scripts...");
+        sObjectMgr->LoadItemScriptNames();
+    });
 
-    TC_LOG_INFO("misc", "Loading Item Scripts...");                 // must be after LoadItemPrototypes
-    sObjectMgr->LoadItemScriptNames();
+    loaders.Add("CreatureModelInfo", { }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Creature Model Based Info Data...");
+        sObjectMgr->LoadCreatureModelInfo();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Creature Model Based Info Data...");
-    sObjectMgr->LoadCreatureModelInfo();
+    loaders.Add("CreatureTemplates", { "CreatureModelInfo", "ScriptNames", "SpellRanks" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Creature templates...");
+        sObjectMgr->LoadCreatureTemplates();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Creature templates...");
-    sObjectMgr->LoadCreatureTemplates();
+    loaders.Add("EquipmentTemplates", { "CreatureTemplates" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Equipment templates...");
+        sObjectMgr->LoadEquipmentTemplates();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Equipment templates...");           // must be after LoadCreatureTemplates
-    sObjectMgr->LoadEquipmentTemplates();
+    loaders.Add("CreatureTemplateAddons", { "CreatureTemplates", "SpellRanks" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Creature template addons...");
+        sObjectMgr->LoadCreatureTemplateAddons();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Creature template addons...");
-    sObjectMgr->LoadCreatureTemplateAddons();
+    loaders.Add("ReputationRewardRates", { }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Reputation Reward Rates...");
+        sObjectMgr->LoadReputationRewardRate();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Reputation Reward Rates...");
-    sObjectMgr->LoadReputationRewardRate();
+    loaders.Add("ReputationOnKill", { "CreatureTemplates" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Creature Reputation OnKill Data...");
+        sObjectMgr->LoadReputationOnKill();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Creature Reputation OnKill Data...");
-    sObjectMgr->LoadReputationOnKill();
+    loaders.Add("ReputationSpillover", { }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Reputation Spillover Data...");
+        sObjectMgr->LoadReputationSpilloverTemplate();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Reputation Spillover Data...");
-    sObjectMgr->LoadReputationSpilloverTemplate();
+    loaders.Add("PointsOfInterest", { }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Points Of Interest Data...");
+        sObjectMgr->LoadPointsOfInterest();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Points Of Interest Data...");
-    sObjectMgr->LoadPointsOfInterest();
+    loaders.Add("CreatureBaseStats", { "CreatureTemplates" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Creature Base Stats...");
+        sObjectMgr->LoadCreatureClassLevelStats();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Creature Base Stats...");
-    sObjectMgr->LoadCreatureClassLevelStats();
+    loaders.Add("Creatures", { "CreatureTemplates", "EquipmentTemplates", "Disables" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Creature Data...");
+        sObjectMgr->LoadCreatures();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Creature Data...");
-    sObjectMgr->LoadCreatures();
+    loaders.Add("TempSummons", { "CreatureTemplates", "GameObjectTemplates" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Temporary Summon Data...");
+        sObjectMgr->LoadTempSummons();
+    });
+
+    loaders.Add("PetLevelupSpells", { "SpellRanks" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading pet levelup spells...");
+        sSpellMgr->LoadPetLevelupSpellMap();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Temporary Summon Data...");
-    sObjectMgr->LoadTempSummons();                               // must be after LoadCreatureTemplates() and LoadGameObjectTemplates()
+    loaders.Add("PetDefaultSpells", { "PetLevelupSpells", "CreatureTemplates" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading pet default spells additional to levelup spells...");
+        sSpellMgr->LoadPetDefaultSpells();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading pet levelup spells...");
-    sSpellMgr->LoadPetLevelupSpellMap();
+    loaders.Add("CreatureAddons", { "Creatures", "SpellRanks" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Creature Addon Data...");
+        sObjectMgr->LoadCreatureAddons();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading pet default spells additional to levelup spells...");
-    sSpellMgr->LoadPetDefaultSpells();
+    // creatures and gameobjects share the per cell spawn lists
+    loaders.Add("Gameobjects", { "GameObjectTemplates", "Creatures", "Disables" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Gameobject Data...");
+        sObjectMgr->LoadGameobjects();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Creature Addon Data...");
-    sObjectMgr->LoadCreatureAddons();                            // must be after LoadCreatureTemplates() and LoadCreatures()
+    loaders.Add("GameObjectAddons", { "Gameobjects" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading GameObject Addon Data...");
+        sObjectMgr->LoadGameObjectAddons();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Gameobject Data...");
-    sObjectMgr->LoadGameobjects();
-    
-    TC_LOG_INFO("server.loading", "Loading GameObject Addon Data...");
-    sObjectMgr->LoadGameObjectAddons();                          // must be after LoadGameObjectTemplate() and LoadGameobjects()
+    loaders.Add("GameObjectQuestItems", { "GameObjectTemplates" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading GameObject Quest Items...");
+        sObjectMgr->LoadGameObjectQuestItems();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading GameObject Quest Items...");
-    sObjectMgr->LoadGameObjectQuestItems();
+    loaders.Add("CreatureQuestItems", { "CreatureTemplates" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Creature Quest Items...");
+        sObjectMgr->LoadCreatureQuestItems();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Creature Quest Items...");
-    sObjectMgr->LoadCreatureQuestItems();
+    loaders.Add("LinkedRespawn", { "Creatures", "Gameobjects" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Creature Linked Respawn...");
+        sObjectMgr->LoadLinkedRespawn();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Creature Linked Respawn...");
-    sObjectMgr->LoadLinkedRespawn();                             // must be after LoadCreatures(), LoadGameObjects()
+    loaders.Add("WeatherData", { "ScriptNames" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Weather Data...");
+        WeatherMgr::LoadWeatherData();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Weather Data...");
-    WeatherMgr::LoadWeatherData();
+    loaders.Add("Quests", { "CreatureTemplates", "ItemTemplates", "GameObjectTemplates", "Disables", "SpellRanks" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Quests...");
+        sObjectMgr->LoadQuests();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Quests...");
-    sObjectMgr->LoadQuests();                                    // must be loaded after DBCs, creature_template, item_template, gameobject tables
+    loaders.Add("QuestDisables", { "Quests" }, []
+    {
+        TC_LOG_INFO("server.loading", "Checking Quest Disables");
+        DisableMgr::CheckQuestDisables();
+    });
 
-    TC_LOG_INFO("server.loading", "Checking Quest Disables");
-    DisableMgr::CheckQuestDisables();                           // must be after loading quests
+    loaders.Add("QuestPOI", { }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Quest POI");
+        sObjectMgr->LoadQuestPOI();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Quest POI");
-    sObjectMgr->LoadQuestPOI();
+    // also fills the quest relations of PoolMgr
+    loaders.Add("QuestStartersAndEnders", { "Quests", "CreatureTemplates", "GameObjectTemplates" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Quests Starters and Enders...");
+        sObjectMgr->LoadQuestStartersAndEnders();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Quests Starters and Enders...");
-    sObjectMgr->LoadQuestStartersAndEnders();                    // must be after quest load
+    loaders.Add("Pools", { "Creatures", "Gameobjects", "Quests", "QuestStartersAndEnders" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Objects Pooling Data...");
+        sPoolMgr->LoadFromDB();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Objects Pooling Data...");
-    sPoolMgr->LoadFromDB();
+    loaders.Add("GameEvents", { "Pools", "EquipmentTemplates", "ItemTemplates" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Game Event Data...");
+        sGameEventMgr->LoadFromDB();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Game Event Data...");               // must be after loading pools fully
-    sGameEventMgr->LoadFromDB();
+    // strips UNIT_NPC_FLAG_SPELLCLICK from creature templates, the quest starter and vendor checks read npcflag
+    loaders.Add("SpellClickSpells", { "Quests", "SpellRanks", "QuestStartersAndEnders", "GameEvents" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading UNIT_NPC_FLAG_SPELLCLICK Data...");
+        sObjectMgr->LoadNPCSpellClickSpells();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading UNIT_NPC_FLAG_SPELLCLICK Data..."); // must be after LoadQuests
-    sObjectMgr->LoadNPCSpellClickSpells();
+    loaders.Add("VehicleTemplateAccessories", { "CreatureTemplates", "SpellClickSpells" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Vehicle Template Accessories...");
+        sObjectMgr->LoadVehicleTemplateAccessories();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Vehicle Template Accessories...");
-    sObjectMgr->LoadVehicleTemplateAccessories();                // must be after LoadCreatureTemplates() and LoadNPCSpellClickSpells()
+    loaders.Add("VehicleAccessories", { "CreatureTemplates", "SpellClickSpells" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Vehicle Accessories...");
+        sObjectMgr->LoadVehicleAccessories();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Vehicle Accessories...");
-    sObjectMgr->LoadVehicleAccessories();                       // must be after LoadCreatureTemplates() and LoadNPCSpellClickSpells()
+    loaders.Add("SpellAreas", { "Quests", "SpellRanks" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading SpellArea Data...");
+        sSpellMgr->LoadSpellAreas();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading SpellArea Data...");                // must be after quest load
-    sSpellMgr->LoadSpellAreas();
+    loaders.Add("AreaTriggerTeleports", { }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading AreaTrigger definitions...");
+        sObjectMgr->LoadAreaTriggerTeleports();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading AreaTrigger definitions...");
-    sObjectMgr->LoadAreaTriggerTeleports();
+    loaders.Add("AccessRequirements", { "ItemTemplates", "Quests" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Access Requirements...");
+        sObjectMgr->LoadAccessRequirements();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Access Requirements...");
-    sObjectMgr->LoadAccessRequirements();                        // must be after item template load
+    // sets quest special flags, keep it behind the loaders inspecting quests beyond their existence
+    loaders.Add("QuestAreaTriggers", { "Quests", "GameEvents" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Quest Area Triggers...");
+        sObjectMgr->LoadQuestAreaTriggers();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Quest Area Triggers...");
-    sObjectMgr->LoadQuestAreaTriggers();                         // must be after LoadQuests
+    loaders.Add("TavernAreaTriggers", { }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Tavern Area Triggers...");
+        sObjectMgr->LoadTavernAreaTriggers();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Tavern Area Triggers...");
-    sObjectMgr->LoadTavernAreaTriggers();
+    loaders.Add("AreaTriggerScripts", { "ScriptNames" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading AreaTrigger script names...");
+        sObjectMgr->LoadAreaTriggerScripts();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading AreaTrigger script names...");
-    sObjectMgr->LoadAreaTriggerScripts();
+    loaders.Add("LFGDungeons", { "AreaTriggerTeleports" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading LFG entrance positions...");
+        sLFGMgr->LoadLFGDungeons();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading LFG entrance positions..."); // Must be after areatriggers
-    sLFGMgr->LoadLFGDungeons();
+    loaders.Add("InstanceEncounters", { "CreatureTemplates", "LFGDungeons", "SpellRanks" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Dungeon boss data...");
+        sObjectMgr->LoadInstanceEncounters();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Dungeon boss data...");
-    sObjectMgr->LoadInstanceEncounters();
+    loaders.Add("LFGRewards", { "LFGDungeons", "Quests" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading LFG rewards...");
+        sLFGMgr->LoadRewards();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading LFG rewards...");
-    sLFGMgr->LoadRewards();
+    loaders.Add("GraveyardZones", { }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Graveyard-zone links...");
+        sObjectMgr->LoadGraveyardZones();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Graveyard-zone links...");
-    sObjectMgr->LoadGraveyardZones();
+    loaders.Add("GraveyardOrientations", { }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Graveyard Orientations...");
+        sObjectMgr->LoadGraveyardOrientations();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Graveyard Orientations...");
-    sObjectMgr->LoadGraveyardOrientations();
+    loaders.Add("SpellPetAuras", { "SpellRanks" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading spell pet auras...");
+        sSpellMgr->LoadSpellPetAuras();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading spell pet auras...");
-    sSpellMgr->LoadSpellPetAuras();
+    loaders.Add("SpellTargetPositions", { "SpellRanks" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading Spell target coordinates...");
+        sSpellMgr->LoadSpellTargetPositions();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Spell target coordinates...");
-    sSpellMgr->LoadSpellTargetPositions();
+    loaders.Add("EnchantCustomAttributes", { "SpellRanks" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading enchant custom attributes...");
+        sSpellMgr->LoadEnchantCustomAttr();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading enchant custom attributes...");
-    sSpellMgr->LoadEnchantCustomAttr();
+    loaders.Add("SpellLinked", { "SpellRanks" }, []
+    {
+        TC_LOG_INFO("server.loading", "Loading linked spells...");
+        sSpellMgr->LoadSpellLinked();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading linked spells...");
-    sSpellMgr->LoadSpellLinked();
+    loaders.Run(getIntConfig(CONFIG_STARTUP_LOADER_THREADS));
+    loaders.LogReport();
 
     TC_LOG_INFO("server.loading", "Loading Player Create Data...");
     sObjectMgr->LoadPlayerInfo();
@@ -1964,6 +2262,9 @@ void World::SetInitialWorldSettings()
     TC_LOG_INFO("misc", "Initializing Opcodes...");
     opcodeTable.Initialize();
 
+    TC_LOG_INFO("server.loading", "Building movement status codecs...");
+    Movement::InitializeMovementStatusCodecs();
+
     TC_LOG_INFO("misc", "Loading hotfix info...");
     sObjectMgr->LoadHotfixData();
 
@@ -2250,6 +2551,7 @@ void World::ForceGameEventUpdate()
 /// Send a packet to all players (except self if mentioned)
 void World::SendGlobalMessage(WorldPacket* packet, WorldSession* self, uint32 team)
 {
+    PacketBroadcaster broadcaster(packet);
     SessionMap::const_iterator itr;
     for (itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
     {
@@ -2259,7 +2561,7 @@ void World::SendGlobalMessage(WorldPacket* packet, WorldSession* self, uint32 te
             itr->second != self &&
             (team == 0 || itr->second->GetPlayer()->GetTeam() == team))
         {
-            itr->second->SendPacket(packet);
+            broadcaster.SendTo(itr->second);
         }
     }
 }
@@ -2267,6 +2569,7 @@ void World::SendGlobalMessage(WorldPacket* packet, WorldSession* self, uint32 te
 /// Send a packet to all GMs (except self if mentioned)
 void World::SendGlobalGMMessage(WorldPacket* packet, WorldSession* self, uint32 team)
 {
+    PacketBroadcaster broadcaster(packet);
     for (SessionMap::const_iterator itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
     {
         // check if session and can receive global GM Messages and its not self
@@ -2281,7 +2584,7 @@ void World::SendGlobalGMMessage(WorldPacket* packet, WorldSession* self, uint32
 
         // Send only to same team, if team is given
         if (!team || player->GetTeam() == team)
-            session->SendPacket(packet);
+            broadcaster.SendTo(session);
     }
 }
 
@@ -3375,3 +3678,38 @@ void World::ReloadRBAC()
         if (WorldSession* session = itr->second)
             session->InvalidateRBACData();
 }
+
+static uint32 GetAutoSaveSlotCount()
+{
+    return std::max<uint32>(sWorld->getIntConfig(CONFIG_INTERVAL_SAVE) / IN_MILLISECONDS, 1);
+}
+
+uint32 World::AssignAutoSaveSlot()
+{
+    std::lock_guard<std::mutex> lock(m_autoSaveSlotsLock);
+
+    // interval changed by config reload, already assigned slots are forgotten
+    uint32 slotCount = GetAutoSaveSlotCount();
+    if (m_autoSaveSlots.size() != slotCount)
+        m_autoSaveSlots.assign(slotCount, 0);
+
+    uint32 slot = uint32(std::min_element(m_autoSaveSlots.begin(), m_autoSaveSlots.end()) - m_autoSaveSlots.begin());
+    ++m_autoSaveSlots[slot];
+    return slot;
+}
+
+void World::ReleaseAutoSaveSlot(uint32 slot)
+{
+    std::lock_guard<std::mutex> lock(m_autoSaveSlotsLock);
+
+    if (slot < m_autoSaveSlots.size() && m_autoSaveSlots[slot])
+        --m_autoSaveSlots[slot];
+}
+
+uint32 World::GetAutoSaveDelay(uint32 slot) const
+{
+    uint32 slotCount = GetAutoSaveSlotCount();
+    uint32 current = uint32(m_gameTime % slotCount);
+    uint32 delay = (slot % slotCount + slotCount - current) % slotCount;
+    return (delay ? delay : slotCount) * IN_MILLISECONDS;
+}
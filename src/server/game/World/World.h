@@ -33,6 +33,7 @@
 
 #include <atomic>
 #include <map>
+#include <mutex>
 #include <set>
 #include <list>
 
@@ -170,6 +171,11 @@ enum WorldBoolConfigs
     CONFIG_ALLOW_TRACK_BOTH_RESOURCES,
     CONFIG_CALCULATE_CREATURE_ZONE_AREA_DATA,
     CONFIG_CALCULATE_GAMEOBJECT_ZONE_AREA_DATA,
+    CONFIG_MAP_REGION_UPDATE,
+    CONFIG_MEMORY_MAPPED_DATA_FILES,
+    CONFIG_AURA_MODIFIER_CACHE,
+    CONFIG_AURA_MODIFIER_CACHE_CHECK,
+    CONFIG_SPELL_ALLOCATION_POOL,
     BOOL_CONFIG_VALUE_COUNT
 };
 
@@ -349,6 +355,8 @@ enum WorldIntConfigs
     CONFIG_PACKET_SPOOF_POLICY,
     CONFIG_PACKET_SPOOF_BANMODE,
     CONFIG_PACKET_SPOOF_BANDURATION,
+    CONFIG_SESSION_RECV_QUEUE_SIZE,
+    CONFIG_SESSION_RECV_QUEUE_OVERFLOW_POLICY,
     CONFIG_ACC_PASSCHANGESEC,
     CONFIG_BG_REWARD_WINNER_HONOR_FIRST,
     CONFIG_BG_REWARD_WINNER_HONOR_LAST,
@@ -364,6 +372,10 @@ enum WorldIntConfigs
     CONFIG_CHARTER_COST_ARENA_5v5,
     CONFIG_NO_GRAY_AGGRO_ABOVE,
     CONFIG_NO_GRAY_AGGRO_BELOW,
+    CONFIG_MAP_REGION_UPDATE_MARGIN,
+    CONFIG_VMAP_COLLISION_CACHE_SIZE,
+    CONFIG_STARTUP_LOADER_THREADS,
+    CONFIG_GRID_PRELOAD_LOOKAHEAD,
     INT_CONFIG_VALUE_COUNT
 };
 
@@ -782,6 +794,13 @@ class World
         void UpdatePhaseDefinitions();
         void ReloadRBAC();
 
+        /// Player autosaves are spread over PlayerSaveInterval in one second slots,
+        /// every logged in player is assigned the least used slot
+        uint32 AssignAutoSaveSlot();
+        void ReleaseAutoSaveSlot(uint32 slot);
+        /// Milliseconds until the next occurrence of the slot, never less than a second
+        uint32 GetAutoSaveDelay(uint32 slot) const;
+
     protected:
         void _UpdateGameTime();
         // callback for UpdateRealmCharacters
@@ -886,6 +905,9 @@ class World
 
         void ProcessQueryCallbacks();
         std::deque<std::future<PreparedQueryResult>> m_realmCharCallbacks;
+
+        std::vector<uint32> m_autoSaveSlots;                // players per slot
+        std::mutex m_autoSaveSlotsLock;
 };
 
 extern Battlenet::RealmHandle realmHandle;
@@ -23,6 +23,8 @@ Category: commandscripts
 EndScriptData */
 
 #include "ScriptMgr.h"
+#include "AchievementMgr.h"
+#include "AllocationCounter.h"
 #include "ObjectMgr.h"
 #include "BattlegroundMgr.h"
 #include "Chat.h"
@@ -33,8 +35,55 @@ EndScriptData */
 #include "GossipDef.h"
 #include "Transport.h"
 #include "Language.h"
-
+#include "LFGQueue.h"
+#include "MapManager.h"
+#include "MappedFile.h"
+#include "MMapFactory.h"
+#include "WorldSocket.h"
+#include "AuctionHouseSearchIndex.h"
+#include "AuctionHouseMgr.h"
+#include "MovementStatusCodec.h"
+#include "SmallObjectPool.h"
+#include "VMapFactory.h"
+#include "VMapManager2.h"
+#include "WorldModel.h"
+
+#include <chrono>
 #include <fstream>
+#include <thread>
+
+#if PLATFORM == PLATFORM_WINDOWS
+#include <psapi.h>
+#pragma comment(linker, "/DEFAULTLIB:psapi.lib")
+#endif
+
+/// Client end of a loopback connection of .debug broadcastbench, reads and counts everything the server side sends
+class BroadcastBenchClient : public std::enable_shared_from_this<BroadcastBenchClient>
+{
+public:
+    BroadcastBenchClient(boost::asio::io_service& ioService, std::atomic<uint64>& received) : Socket(ioService), _received(received) { }
+
+    void AsyncRead()
+    {
+        Socket.async_read_some(boost::asio::buffer(_buffer, sizeof(_buffer)),
+            std::bind(&BroadcastBenchClient::ReadHandler, shared_from_this(), std::placeholders::_1, std::placeholders::_2));
+    }
+
+    tcp::socket Socket;
+
+private:
+    void ReadHandler(boost::system::error_code error, std::size_t transferredBytes)
+    {
+        if (error)
+            return;
+
+        _received += transferredBytes;
+        AsyncRead();
+    }
+
+    std::atomic<uint64>& _received;
+    uint8 _buffer[16384];
+};
 
 class debug_commandscript : public CommandScript
 {
@@ -94,6 +143,26 @@ public:
             { "moveflags",     rbac::RBAC_PERM_COMMAND_DEBUG_MOVEFLAGS,     false, &HandleDebugMoveflagsCommand,        "", NULL },
             { "transport",     rbac::RBAC_PERM_COMMAND_DEBUG_TRANSPORT,     false, &HandleDebugTransportCommand,        "", NULL },
             { "phase",         rbac::RBAC_PERM_COMMAND_DEBUG_PHASE,         false, &HandleDebugPhaseCommand,            "", NULL },
+            { "mapupdater",    rbac::RBAC_PERM_COMMAND_DEBUG_MAPUPDATER,    true,  &HandleDebugMapUpdaterCommand,       "", NULL },
+            { "netlatency",    rbac::RBAC_PERM_COMMAND_DEBUG_NETLATENCY,    true,  &HandleDebugNetLatencyCommand,       "", NULL },
+            { "compression",   rbac::RBAC_PERM_COMMAND_DEBUG_COMPRESSION,   true,  &HandleDebugCompressionCommand,      "", NULL },
+            { "updatecache",   rbac::RBAC_PERM_COMMAND_DEBUG_UPDATECACHE,   true,  &HandleDebugUpdateCacheCommand,      "", NULL },
+            { "auctionsearch", rbac::RBAC_PERM_COMMAND_DEBUG_AUCTIONSEARCH, true,  &HandleDebugAuctionSearchCommand,    "", NULL },
+            { "movementcodecs", rbac::RBAC_PERM_COMMAND_DEBUG_MOVEMENTCODECS, true, &HandleDebugMovementCodecsCommand,  "", NULL },
+            { "dbqueues",      rbac::RBAC_PERM_COMMAND_DEBUG_DBQUEUES,      true,  &HandleDebugDbQueuesCommand,         "", NULL },
+            { "playersave",    rbac::RBAC_PERM_COMMAND_DEBUG_PLAYERSAVE,    true,  &HandleDebugPlayerSaveCommand,       "", NULL },
+            { "logbench",      rbac::RBAC_PERM_COMMAND_DEBUG_LOGBENCH,      true,  &HandleDebugLogBenchCommand,         "", NULL },
+            { "vmapbench",     rbac::RBAC_PERM_COMMAND_DEBUG_VMAPBENCH,     false, &HandleDebugVmapBenchCommand,        "", NULL },
+            { "collisioncache", rbac::RBAC_PERM_COMMAND_DEBUG_COLLISIONCACHE, false, &HandleDebugCollisionCacheCommand, "", NULL },
+            { "achievementstats", rbac::RBAC_PERM_COMMAND_DEBUG_ACHIEVEMENTSTATS, true, &HandleDebugAchievementStatsCommand, "", NULL },
+            { "objectupdates", rbac::RBAC_PERM_COMMAND_DEBUG_OBJECTUPDATES, false, &HandleDebugObjectUpdatesCommand,    "", NULL },
+            { "gridpreload",   rbac::RBAC_PERM_COMMAND_DEBUG_GRIDPRELOAD,   true,  &HandleDebugGridPreloadCommand,      "", NULL },
+            { "terrainbench",  rbac::RBAC_PERM_COMMAND_DEBUG_TERRAINBENCH,  false, &HandleDebugTerrainBenchCommand,     "", NULL },
+            { "auramodbench",  rbac::RBAC_PERM_COMMAND_DEBUG_AURAMODBENCH,  false, &HandleDebugAuraModBenchCommand,     "", NULL },
+            { "spellallocbench", rbac::RBAC_PERM_COMMAND_DEBUG_SPELLALLOCBENCH, false, &HandleDebugSpellAllocBenchCommand, "", NULL },
+            { "regionbench",   rbac::RBAC_PERM_COMMAND_DEBUG_REGIONBENCH,   false, &HandleDebugRegionBenchCommand,      "", NULL },
+            { "lfgbench",      rbac::RBAC_PERM_COMMAND_DEBUG_LFGBENCH,      true,  &HandleDebugLfgBenchCommand,         "", NULL },
+            { "broadcastbench", rbac::RBAC_PERM_COMMAND_DEBUG_BROADCASTBENCH, true, &HandleDebugBroadcastBenchCommand,   "", NULL },
             { NULL,            0,                                     false, NULL,                                "", NULL }
         };
         static ChatCommand commandTable[] =
@@ -1073,6 +1142,1508 @@ public:
         return true;
     }
 
+    static bool HandleDebugMapUpdaterCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        MapUpdater* updater = sMapMgr->GetMapUpdater();
+        if (!updater->activated())
+        {
+            handler->PSendSysMessage("Map updater is not active, maps are updated by the world thread.");
+            return true;
+        }
+
+        std::vector<MapUpdater::WorkerStats> stats = updater->GetWorkerStats();
+        for (size_t i = 0; i < stats.size(); ++i)
+        {
+            uint64 total = stats[i].BusyTime + stats[i].IdleTime;
+            handler->PSendSysMessage("Worker %u: busy " UI64FMTD " ms, idle " UI64FMTD " ms (%.1f%% busy), %u updates, %u stolen",
+                uint32(i), stats[i].BusyTime / IN_MILLISECONDS, stats[i].IdleTime / IN_MILLISECONDS,
+                total ? float(stats[i].BusyTime) * 100.0f / float(total) : 0.0f, stats[i].Updates, stats[i].Steals);
+        }
+
+        return true;
+    }
+
+    static bool HandleDebugNetLatencyCommand(ChatHandler* handler, char const* args)
+    {
+        LatencyHistogram& histogram = WorldSocket::GetSendLatencyHistogram();
+
+        handler->PSendSysMessage("Send latency over " UI64FMTD " flushes: avg " UI64FMTD " us, p50 < " UI64FMTD " us, p90 < " UI64FMTD " us, p99 < " UI64FMTD " us, max " UI64FMTD " us",
+            histogram.GetCount(), histogram.GetAverage(), histogram.GetPercentile(50), histogram.GetPercentile(90), histogram.GetPercentile(99), histogram.GetMax());
+
+        if (args && strncmp(args, "reset", 5) == 0)
+        {
+            histogram.Reset();
+            handler->PSendSysMessage("Send latency histogram reset.");
+        }
+
+        return true;
+    }
+
+    static void PrintDatabaseWorkerStats(ChatHandler* handler, char const* name, DatabaseWorkerStats& stats, bool reset)
+    {
+        uint64 batches = stats.Batches;
+        handler->PSendSysMessage("%s: queued %u (max %u), " UI64FMTD " operations, " UI64FMTD " batches (avg %.1f, max %u statements), " UI64FMTD " fallbacks",
+            name, uint32(stats.QueueSize), uint32(stats.MaxQueueSize), uint64(stats.Operations), batches,
+            batches ? float(uint64(stats.BatchedStatements)) / float(batches) : 0.0f, uint32(stats.MaxBatchSize), uint64(stats.BatchFallbacks));
+        handler->PSendSysMessage("  queue wait: avg " UI64FMTD " us, p99 < " UI64FMTD " us, max " UI64FMTD " us; execution: avg " UI64FMTD " us, p99 < " UI64FMTD " us, max " UI64FMTD " us",
+            stats.QueueLatency.GetAverage(), stats.QueueLatency.GetPercentile(99), stats.QueueLatency.GetMax(),
+            stats.ExecutionLatency.GetAverage(), stats.ExecutionLatency.GetPercentile(99), stats.ExecutionLatency.GetMax());
+
+        if (reset)
+            stats.Reset();
+    }
+
+    static bool HandleDebugDbQueuesCommand(ChatHandler* handler, char const* args)
+    {
+        bool reset = args && strncmp(args, "reset", 5) == 0;
+
+        PrintDatabaseWorkerStats(handler, "Login", LoginDatabase.GetStats(), reset);
+        PrintDatabaseWorkerStats(handler, "World", WorldDatabase.GetStats(), reset);
+        PrintDatabaseWorkerStats(handler, "Character", CharacterDatabase.GetStats(), reset);
+
+        if (reset)
+            handler->PSendSysMessage("Database queue statistics reset.");
+
+        return true;
+    }
+
+    static bool HandleDebugPlayerSaveCommand(ChatHandler* handler, char const* args)
+    {
+        bool reset = args && strncmp(args, "reset", 5) == 0;
+
+        for (uint8 i = 0; i < 2; ++i)
+        {
+            PlayerSaveStats& stats = Player::GetSaveStats(i != 0);
+            uint64 saves = stats.Saves;
+            handler->PSendSysMessage("%s: " UI64FMTD " saves, avg " UI64FMTD " statements (max %u), avg " UI64FMTD " bytes, avg %.1f unchanged sections skipped",
+                i ? "Autosaves" : "Other saves", saves, saves ? uint64(stats.Statements) / saves : 0, uint32(stats.MaxStatements),
+                saves ? uint64(stats.Bytes) / saves : 0, saves ? float(uint64(stats.SkippedSections)) / float(saves) : 0.0f);
+
+            if (reset)
+                stats.Reset();
+        }
+
+        if (reset)
+            handler->PSendSysMessage("Player save statistics reset.");
+
+        return true;
+    }
+
+    static bool HandleDebugLogBenchCommand(ChatHandler* handler, char const* args)
+    {
+        // USAGE: .debug logbench [#count] [filter]
+        char* countStr = strtok((char*)args, " ");
+        char* filterStr = strtok(NULL, " ");
+
+        uint32 count = countStr ? uint32(atoi(countStr)) : 10000;
+        if (!count || count > 1000000)
+        {
+            handler->PSendSysMessage("Message count must be between 1 and 1000000.");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        std::string filter = filterStr ? filterStr : "debug.logbench";
+
+        // filtered out messages, what every disabled TC_LOG_* call pays
+        uint32 passed = 0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < count; ++i)
+            if (sLog->ShouldLog(filter.c_str(), LOG_LEVEL_TRACE))
+                ++passed;
+        uint64 elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        handler->PSendSysMessage("Level check for '%s': " UI64FMTD " ns per call (trace %s)",
+            filter.c_str(), elapsed / count, passed ? "enabled" : "disabled");
+
+        // only write to a logger set up for the benchmark, never through a parent into the server's own logs
+        if (filter == LOGGER_ROOT || !sLog->HasLogger(filter))
+        {
+            handler->PSendSysMessage("No Logger.%s is configured, add one with its own appender to measure writing.", filter.c_str());
+            return true;
+        }
+
+        if (!sLog->ShouldLog(filter.c_str(), LOG_LEVEL_INFO))
+        {
+            handler->PSendSysMessage("Logger.%s does not log at info level, writing is not measured.", filter.c_str());
+            return true;
+        }
+
+        uint64 ringFullWaits = sLog->GetRingFullWaits();
+        uint64 maxLatency = 0;
+        start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < count; ++i)
+        {
+            std::chrono::steady_clock::time_point callStart = std::chrono::steady_clock::now();
+            TC_LOG_INFO(filter.c_str(), "Log benchmark message %u of %u", i + 1, count);
+            uint64 latency = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - callStart).count();
+            maxLatency = std::max(maxLatency, latency);
+        }
+        elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        handler->PSendSysMessage("%u messages (%s): " UI64FMTD " messages/s, caller latency avg " UI64FMTD " ns, max " UI64FMTD " ns, " UI64FMTD " full ring waits",
+            count, sLog->IsAsync() ? "async" : "sync", elapsed ? uint64(count) * UI64LIT(1000000000) / elapsed : 0, elapsed / count, maxLatency,
+            sLog->GetRingFullWaits() - ringFullWaits);
+
+        return true;
+    }
+
+    static bool HandleDebugVmapBenchCommand(ChatHandler* handler, char const* args)
+    {
+        // USAGE: .debug vmapbench [#rays]
+        uint32 count = *args ? uint32(atoi(args)) : 10000;
+        if (!count || count > 100000)
+        {
+            handler->PSendSysMessage("Ray count must be between 1 and 100000.");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        if (!VMAP::HasTrianglePackets())
+        {
+            handler->PSendSysMessage("This build has no packet triangle test, only the scalar one is used.");
+            return true;
+        }
+
+        VMAP::VMapManager2* vmgr = static_cast<VMAP::VMapManager2*>(VMAP::VMapFactory::createOrGetVMapManager());
+        if (!vmgr->isLineOfSightCalcEnabled())
+        {
+            handler->PSendSysMessage("Line of sight checks are disabled (vmap.enableLOS).");
+            return true;
+        }
+
+        // random rays around the player, so they go through the vmap tiles loaded for the grids nearby
+        Player* player = handler->GetSession()->GetPlayer();
+        uint32 mapId = player->GetMapId();
+        std::vector<VMAP::LineOfSightRay> rays(count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            VMAP::LineOfSightRay& ray = rays[i];
+            ray.X1 = player->GetPositionX() + frand(-50.0f, 50.0f);
+            ray.Y1 = player->GetPositionY() + frand(-50.0f, 50.0f);
+            ray.Z1 = player->GetPositionZ() + frand(0.0f, 10.0f);
+            ray.X2 = ray.X1 + frand(-50.0f, 50.0f);
+            ray.Y2 = ray.Y1 + frand(-50.0f, 50.0f);
+            ray.Z2 = player->GetPositionZ() + frand(0.0f, 10.0f);
+        }
+
+        // batched with the scalar triangle test, batched with the packet test, then one call per ray
+        std::vector<VMAP::LineOfSightRay> results[3] = { rays, rays, rays };
+        uint64 elapsed[3];
+        for (uint8 i = 0; i < 3; ++i)
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            if (i < 2)
+                vmgr->isInLineOfSight(mapId, &results[i][0], count, i != 0);
+            else
+            {
+                for (uint32 j = 0; j < count; ++j)
+                {
+                    VMAP::LineOfSightRay& ray = results[i][j];
+                    ray.Result = vmgr->isInLineOfSight(mapId, ray.X1, ray.Y1, ray.Z1, ray.X2, ray.Y2, ray.Z2);
+                }
+            }
+            elapsed[i] = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        uint32 blocked = 0;
+        uint32 mismatches = 0;
+        for (uint32 i = 0; i < count; ++i)
+        {
+            if (!results[1][i].Result)
+                ++blocked;
+            if (results[0][i].Result != results[1][i].Result || results[1][i].Result != results[2][i].Result)
+                ++mismatches;
+        }
+
+        handler->PSendSysMessage("%u rays on map %u, %u blocked, %u results differing between the runs", count, mapId, blocked, mismatches);
+        handler->PSendSysMessage("Batch scalar: " UI64FMTD " us, batch packets: " UI64FMTD " us, one call per ray: " UI64FMTD " us",
+            elapsed[0], elapsed[1], elapsed[2]);
+        return true;
+    }
+
+    static bool HandleDebugCollisionCacheCommand(ChatHandler* handler, char const* args)
+    {
+        Map* map = handler->GetSession()->GetPlayer()->GetMap();
+        MapCollisionCache* cache = map->GetCollisionCache();
+        if (!cache)
+        {
+            handler->PSendSysMessage("Collision cache is disabled (vmap.collisionCacheSize).");
+            return true;
+        }
+
+        MapCollisionCache::Stats stats = cache->GetStats();
+        uint64 total = stats.Hits + stats.StaticHits + stats.Misses;
+        handler->PSendSysMessage("Map %u instance %u: %u entries, " UI64FMTD " hits, " UI64FMTD " hits with GameObjects checked again, " UI64FMTD " misses (%.1f%% hit rate), %u grid invalidations",
+            map->GetId(), map->GetInstanceId(), cache->GetSize(), stats.Hits, stats.StaticHits, stats.Misses,
+            total ? float(stats.Hits + stats.StaticHits) * 100.0f / float(total) : 0.0f, cache->GetStaticInvalidations());
+
+        if (args && strncmp(args, "reset", 5) == 0)
+        {
+            cache->ResetStats();
+            handler->PSendSysMessage("Collision cache statistics reset.");
+        }
+
+        return true;
+    }
+
+    static bool HandleDebugObjectUpdatesCommand(ChatHandler* handler, char const* args)
+    {
+        Map* map = handler->GetSession()->GetPlayer()->GetMap();
+        Map::ObjectUpdateStats stats = map->GetObjectUpdateStats();
+        handler->PSendSysMessage("Map %u instance %u: %u flushes, " UI64FMTD " objects, " UI64FMTD " packets, build " UI64FMTD " ms, send " UI64FMTD " ms, avg %.1f us per flush, max %u us",
+            map->GetId(), map->GetInstanceId(), stats.Flushes, stats.Objects, stats.Packets, stats.BuildTime / IN_MILLISECONDS, stats.SendTime / IN_MILLISECONDS,
+            stats.Flushes ? float(stats.BuildTime + stats.SendTime) / float(stats.Flushes) : 0.0f, stats.MaxTime);
+
+        if (args && strncmp(args, "reset", 5) == 0)
+        {
+            map->ResetObjectUpdateStats();
+            handler->PSendSysMessage("Object update statistics reset.");
+        }
+
+        return true;
+    }
+
+    static bool HandleDebugGridPreloadCommand(ChatHandler* handler, char const* args)
+    {
+        GridPreloader* preloader = sMapMgr->GetGridPreloader();
+        if (!preloader->IsActive())
+        {
+            handler->PSendSysMessage("Grid preloading is disabled (GridPreload.Lookahead).");
+            return true;
+        }
+
+        GridPreloader::Stats stats = preloader->GetStats();
+        handler->PSendSysMessage("Grid preloader: %u requests, %u dropped, %u grids read in " UI64FMTD " ms, %u expired unused",
+            stats.Requests, stats.Dropped, stats.Prefetched, stats.PrefetchTime / IN_MILLISECONDS, stats.Expired);
+        handler->PSendSysMessage("Prefetched grid loads: %u, avg %.1f us on the map thread",
+            stats.PrefetchedLoads, stats.PrefetchedLoads ? float(stats.PrefetchedLoadTime) / float(stats.PrefetchedLoads) : 0.0f);
+        handler->PSendSysMessage("Synchronous grid loads: %u, avg %.1f us on the map thread",
+            stats.SyncLoads, stats.SyncLoads ? float(stats.SyncLoadTime) / float(stats.SyncLoads) : 0.0f);
+
+        if (args && strncmp(args, "reset", 5) == 0)
+        {
+            preloader->ResetStats();
+            handler->PSendSysMessage("Grid preloader statistics reset.");
+        }
+
+        return true;
+    }
+
+    // resident memory of the process in KB. On Linux it is split into anonymous (heap) and file backed pages,
+    // Windows only reports the whole working set, returned as anonymous
+    static bool GetResidentMemory(uint64& anonymous, uint64& fileBacked)
+    {
+        anonymous = 0;
+        fileBacked = 0;
+
+#if PLATFORM == PLATFORM_WINDOWS
+        PROCESS_MEMORY_COUNTERS counters;
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return false;
+
+        anonymous = counters.WorkingSetSize / 1024;
+        return true;
+#else
+        std::ifstream status("/proc/self/status");
+        if (!status)
+            return false;
+
+        std::string line;
+        while (std::getline(status, line))
+        {
+            if (!line.compare(0, 8, "RssAnon:"))
+                anonymous = strtoull(line.c_str() + 8, NULL, 10);
+            else if (!line.compare(0, 8, "RssFile:"))
+                fileBacked = strtoull(line.c_str() + 8, NULL, 10);
+        }
+
+        return true;
+#endif
+    }
+
+    static bool HandleDebugTerrainBenchCommand(ChatHandler* handler, char const* args)
+    {
+        // USAGE: .debug terrainbench [#radius]
+        // the files are loaded synchronously on the thread updating the map, keep it to a few grids
+        int32 radius = *args ? atoi(args) : 1;
+        if (radius < 0 || radius > 2)
+        {
+            handler->PSendSysMessage("Radius must be between 0 and 2 grids.");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        // the .map and .mmtile files of the grids around the player, loaded outside of the map
+        Player* player = handler->GetSession()->GetPlayer();
+        uint32 mapId = player->GetMapId();
+        GridCoord center = Trinity::ComputeGridCoord(player->GetPositionX(), player->GetPositionY());
+        int32 centerX = (MAX_NUMBER_OF_GRIDS - 1) - int32(center.x_coord);
+        int32 centerY = (MAX_NUMBER_OF_GRIDS - 1) - int32(center.y_coord);
+
+        std::vector<std::pair<int32, int32>> grids;
+        for (int32 gx = std::max(centerX - radius, 0); gx <= std::min(centerX + radius, MAX_NUMBER_OF_GRIDS - 1); ++gx)
+            for (int32 gy = std::max(centerY - radius, 0); gy <= std::min(centerY + radius, MAX_NUMBER_OF_GRIDS - 1); ++gy)
+                grids.push_back(std::make_pair(gx, gy));
+
+        MMAP::MMapManager* mmgr = MMAP::MMapFactory::createOrGetMMapManager();
+        int len = sWorld->GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
+        std::vector<char> fileName(len);
+
+        // pass 0 only brings the files into the page cache, 1 reads them into buffers, 2 maps them.
+        // Pass 0 maps the files too, so the heap it would free again does not hide the growth of pass 1
+        char const* modeNames[] = { "", "Buffered", "Mapped" };
+        for (uint8 mode = 0; mode < 3; ++mode)
+        {
+            bool mapFiles = mode != 1;
+            uint64 anonymousBefore, fileBackedBefore;
+            bool haveMemory = GetResidentMemory(anonymousBefore, fileBackedBefore);
+
+            std::vector<GridMap*> terrain;
+            std::vector<unsigned char*> tiles;
+            std::vector<std::unique_ptr<MappedFile>> tileFiles;
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (std::pair<int32, int32> const& grid : grids)
+            {
+                snprintf(fileName.data(), len, (sWorld->GetDataPath() + "maps/%03u%02u%02u.map").c_str(), mapId, grid.first, grid.second);
+                GridMap* gridMap = new GridMap();
+                gridMap->loadData(fileName.data(), mapFiles);
+                terrain.push_back(gridMap);
+
+                if (mapFiles)
+                {
+                    if (std::unique_ptr<MappedFile> file = mmgr->mapTileFile(mapId, grid.first, grid.second))
+                        tileFiles.push_back(std::move(file));
+                }
+                else
+                {
+                    uint32 size = 0;
+                    if (unsigned char* data = mmgr->readTileData(mapId, grid.first, grid.second, size))
+                        tiles.push_back(data);
+                }
+            }
+            uint64 loadTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+            // first access, mapped pages are only read in here
+            start = std::chrono::steady_clock::now();
+            float heightSum = 0.0f;
+            for (GridMap* gridMap : terrain)
+                for (uint32 x = 0; x < 128; ++x)
+                    for (uint32 y = 0; y < 128; ++y)
+                        heightSum += gridMap->getHeight((x + 0.5f) * SIZE_OF_GRIDS / 128, (y + 0.5f) * SIZE_OF_GRIDS / 128);
+
+            uint32 checksum = 0;
+            for (std::unique_ptr<MappedFile> const& file : tileFiles)
+                for (size_t offset = 0; offset < file->GetSize(); offset += 4096)
+                    checksum += file->GetData()[offset];
+            uint64 touchTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+            uint64 anonymousAfter, fileBackedAfter;
+            GetResidentMemory(anonymousAfter, fileBackedAfter);
+
+            uint32 mapped = 0;
+            for (GridMap* gridMap : terrain)
+            {
+                if (gridMap->isMapped())
+                    ++mapped;
+                delete gridMap;
+            }
+
+            for (unsigned char* data : tiles)
+                dtFree(data);
+
+            if (!mode)
+                continue;
+
+            handler->PSendSysMessage("%s: %u grids (%u mapped), %u navmesh tiles, load " UI64FMTD " us, first access " UI64FMTD " us (checksum %.0f/%u)",
+                modeNames[mode], uint32(terrain.size()), mapped, uint32(tiles.size() + tileFiles.size()), loadTime, touchTime, heightSum, checksum);
+
+            if (!haveMemory)
+                continue;
+
+#if PLATFORM == PLATFORM_WINDOWS
+            handler->PSendSysMessage("%s: working set grew by " SI64FMTD " KB",
+                modeNames[mode], int64(anonymousAfter - anonymousBefore));
+#else
+            handler->PSendSysMessage("%s: resident memory grew by " SI64FMTD " KB anonymous, " SI64FMTD " KB file backed (shared through the page cache)",
+                modeNames[mode], int64(anonymousAfter - anonymousBefore), int64(fileBackedAfter - fileBackedBefore));
+#endif
+        }
+
+        return true;
+    }
+
+    static bool HandleDebugAuraModBenchCommand(ChatHandler* handler, char const* args)
+    {
+        // USAGE: .debug auramodbench [#hits]
+        // runs on the thread updating the map, every hit stalls it
+        uint32 count = *args ? uint32(atoi(args)) : 10000;
+        if (!count || count > 100000)
+        {
+            handler->PSendSysMessage("Hit count must be between 1 and 100000.");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        Unit* unit = handler->getSelectedUnit();
+        if (!unit)
+        {
+            handler->SendSysMessage(LANG_SELECT_CHAR_OR_CREATURE);
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        // the modifiers a melee or spell hit queries, every few hits an effect of one of the
+        // damage types changes its amount as stacking and periodically recalculated auras do
+        AuraType const queriedTypes[] = { SPELL_AURA_MOD_DAMAGE_PERCENT_DONE, SPELL_AURA_MOD_DAMAGE_DONE, SPELL_AURA_MOD_DAMAGE_PERCENT_TAKEN,
+            SPELL_AURA_MOD_HIT_CHANCE, SPELL_AURA_MOD_CRIT_PCT, SPELL_AURA_MOD_INCREASE_SPEED, SPELL_AURA_MOD_HEALING_DONE_PERCENT, SPELL_AURA_MOD_STAT };
+        uint32 const queriesPerHit = 8;
+        uint32 const hitsPerChange = 16;
+
+        uint32 mismatches = AuraEffectIndex::GetMismatches();
+
+        // the full scans walk the effects the way the unit fills its cache, the cached run uses the
+        // unit's queries and so only hits the cache if Auras.ModifierCache is enabled
+        double results[2];
+        uint64 elapsed[2];
+        for (uint8 mode = 0; mode < 2; ++mode)
+        {
+            double result = 0.0;
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (uint32 i = 0; i < count; ++i)
+            {
+                uint32 schoolMask = 1 << (i % MAX_SPELL_SCHOOL);
+                int32 stat = int32(i % MAX_STATS);
+                if (!mode)
+                {
+                    result += AuraEffectIndex::Calculate(unit->GetAuraEffectsByType(SPELL_AURA_MOD_DAMAGE_PERCENT_DONE), AuraEffectIndex::FILTER_MISC_MASK, int32(schoolMask)).Multiplier;
+                    result += AuraEffectIndex::Calculate(unit->GetAuraEffectsByType(SPELL_AURA_MOD_DAMAGE_DONE), AuraEffectIndex::FILTER_MISC_MASK, int32(schoolMask)).Total;
+                    result += AuraEffectIndex::Calculate(unit->GetAuraEffectsByType(SPELL_AURA_MOD_DAMAGE_PERCENT_TAKEN), AuraEffectIndex::FILTER_MISC_MASK, int32(schoolMask)).Multiplier;
+                    result += AuraEffectIndex::Calculate(unit->GetAuraEffectsByType(SPELL_AURA_MOD_HIT_CHANCE), AuraEffectIndex::FILTER_NONE, 0).Total;
+                    result += AuraEffectIndex::Calculate(unit->GetAuraEffectsByType(SPELL_AURA_MOD_CRIT_PCT), AuraEffectIndex::FILTER_NONE, 0).Total;
+                    result += AuraEffectIndex::Calculate(unit->GetAuraEffectsByType(SPELL_AURA_MOD_INCREASE_SPEED), AuraEffectIndex::FILTER_NONE, 0).MaxPositive;
+                    result += AuraEffectIndex::Calculate(unit->GetAuraEffectsByType(SPELL_AURA_MOD_HEALING_DONE_PERCENT), AuraEffectIndex::FILTER_NONE, 0).Multiplier;
+                    result += AuraEffectIndex::Calculate(unit->GetAuraEffectsByType(SPELL_AURA_MOD_STAT), AuraEffectIndex::FILTER_MISC_VALUE, stat).Total;
+                }
+                else
+                {
+                    result += unit->GetTotalAuraMultiplierByMiscMask(SPELL_AURA_MOD_DAMAGE_PERCENT_DONE, schoolMask);
+                    result += unit->GetTotalAuraModifierByMiscMask(SPELL_AURA_MOD_DAMAGE_DONE, schoolMask);
+                    result += unit->GetTotalAuraMultiplierByMiscMask(SPELL_AURA_MOD_DAMAGE_PERCENT_TAKEN, schoolMask);
+                    result += unit->GetTotalAuraModifier(SPELL_AURA_MOD_HIT_CHANCE);
+                    result += unit->GetTotalAuraModifier(SPELL_AURA_MOD_CRIT_PCT);
+                    result += unit->GetMaxPositiveAuraModifier(SPELL_AURA_MOD_INCREASE_SPEED);
+                    result += unit->GetTotalAuraMultiplier(SPELL_AURA_MOD_HEALING_DONE_PERCENT);
+                    result += unit->GetTotalAuraModifierByMiscValue(SPELL_AURA_MOD_STAT, stat);
+
+                    if (!(i % hitsPerChange))
+                        unit->InvalidateAuraModifiers(queriedTypes[(i / hitsPerChange) % 3]);
+                }
+            }
+            elapsed[mode] = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+            results[mode] = result;
+        }
+
+        uint32 effects = 0;
+        for (AuraType type : queriedTypes)
+            effects += uint32(unit->GetAuraEffectsByType(type).size());
+
+        handler->PSendSysMessage("%u simulated hits on %s, %u aura effects of the %u queried aura types, modifier cache %s",
+            count, unit->GetName().c_str(), effects, uint32(sizeof(queriedTypes) / sizeof(queriedTypes[0])),
+            AuraEffectIndex::IsCacheEnabled() ? "enabled" : "disabled");
+        handler->PSendSysMessage("Full scan: " UI64FMTD " us (%.1f ns per query), unit queries: " UI64FMTD " us (%.1f ns per query), results %s",
+            elapsed[0], float(elapsed[0]) * 1000.0f / float(count * queriesPerHit), elapsed[1], float(elapsed[1]) * 1000.0f / float(count * queriesPerHit),
+            results[0] == results[1] ? "identical" : "differing");
+        handler->PSendSysMessage("Stale cached values found by Auras.ModifierCache.Check: %u during the benchmark, %u in total",
+            AuraEffectIndex::GetMismatches() - mismatches, AuraEffectIndex::GetMismatches());
+        return true;
+    }
+
+    static bool HandleDebugSpellAllocBenchCommand(ChatHandler* handler, char const* args)
+    {
+        // USAGE: .debug spellallocbench #spellid [#rounds]
+        char* spellIdStr = strtok((char*)args, " ");
+        char* roundsStr = strtok(NULL, " ");
+        if (!spellIdStr)
+            return false;
+
+        SpellInfo const* spellInfo = sSpellMgr->GetSpellInfo(uint32(atoi(spellIdStr)));
+        if (!spellInfo)
+        {
+            handler->PSendSysMessage(LANG_COMMAND_NOSPELLFOUND);
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        // runs on the thread updating the map, every round stalls it for a simulated two seconds of fighting
+        uint32 rounds = roundsStr ? uint32(atoi(roundsStr)) : 20;
+        if (!rounds || rounds > 200)
+        {
+            handler->PSendSysMessage("Round count must be between 1 and 200.");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        // a raid of 25 triggers in a ring around a pack of hostile dummies in front of the player
+        uint32 const casterCount = 25;
+        uint32 const dummyCount = 10;
+        uint32 const castTicks = 10;                        // the raid casts within the first second of a round
+        uint32 const roundTicks = 20;                       // the second one lets launched spells arrive
+        uint32 const tickTime = 100;
+
+        Player* player = handler->GetSession()->GetPlayer();
+        Position center = player->GetNearPosition(15.0f, 0.0f);
+
+        std::vector<TempSummon*> dummies;
+        std::vector<TempSummon*> casters;
+        for (uint32 i = 0; i < dummyCount; ++i)
+        {
+            TempSummon* dummy = player->SummonCreature(WORLD_TRIGGER, center.GetPositionX() + frand(-3.0f, 3.0f), center.GetPositionY() + frand(-3.0f, 3.0f),
+                center.GetPositionZ(), 0.0f, TEMPSUMMON_MANUAL_DESPAWN);
+            if (!dummy)
+                break;
+
+            dummy->setFaction(14);
+            dummy->RemoveFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_NOT_SELECTABLE | UNIT_FLAG_NON_ATTACKABLE | UNIT_FLAG_IMMUNE_TO_PC | UNIT_FLAG_IMMUNE_TO_NPC);
+            dummy->SetMaxHealth(1000000000);
+            dummy->SetFullHealth();
+            dummies.push_back(dummy);
+        }
+
+        for (uint32 i = 0; i < casterCount && dummies.size() == dummyCount; ++i)
+        {
+            float angle = float(i) * 2.0f * float(M_PI) / float(casterCount);
+            TempSummon* caster = player->SummonCreature(WORLD_TRIGGER, center.GetPositionX() + 8.0f * std::cos(angle), center.GetPositionY() + 8.0f * std::sin(angle),
+                center.GetPositionZ(), Position::NormalizeOrientation(angle + float(M_PI)), TEMPSUMMON_MANUAL_DESPAWN);
+            if (!caster)
+                break;
+
+            casters.push_back(caster);
+        }
+
+        if (dummies.size() != dummyCount || casters.size() != casterCount)
+        {
+            for (TempSummon* summon : dummies)
+                summon->DespawnOrUnsummon();
+            for (TempSummon* summon : casters)
+                summon->DespawnOrUnsummon();
+
+            handler->PSendSysMessage("Could not summon the raid and the dummies.");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        std::vector<SpellCastTargets> targets(casterCount);
+        for (uint32 i = 0; i < casterCount; ++i)
+        {
+            targets[i].SetUnitTarget(dummies[i % dummyCount]);
+            targets[i].SetSrc(*casters[i]);
+            targets[i].SetDst(center);
+        }
+
+        // the same fight with the pool enabled and disabled, allocations of every thread are counted while it runs
+        bool poolEnabled = SmallObjectPool::IsEnabled();
+        uint32 casts = rounds * casterCount;
+        handler->PSendSysMessage("%u casts of spell %u by %u casters on %u dummies in %u rounds, pool configured %s",
+            casts, spellInfo->Id, casterCount, dummyCount, rounds, poolEnabled ? "enabled" : "disabled");
+
+        for (uint8 mode = 0; mode < 2; ++mode)
+        {
+            SmallObjectPool::SetEnabled(mode == 0);
+            SmallObjectPool::Stats poolBefore = SmallObjectPool::GetThreadStats();
+            uint64 damage = 0;
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            AllocationCounter::Start();
+            for (uint32 round = 0; round < rounds; ++round)
+            {
+                for (uint32 tick = 0; tick < roundTicks; ++tick)
+                {
+                    if (tick < castTicks)
+                        for (uint32 i = tick; i < casterCount; i += castTicks)
+                            casters[i]->CastSpell(targets[i], spellInfo, NULL, TRIGGERED_FULL_MASK);
+
+                    // delayed spells hit from the events of their casters
+                    for (TempSummon* caster : casters)
+                        caster->m_Events.Update(tickTime);
+                }
+
+                for (TempSummon* dummy : dummies)
+                {
+                    damage += dummy->GetMaxHealth() - dummy->GetHealth();
+                    dummy->SetFullHealth();
+                }
+            }
+            AllocationCounter::Stats allocations = AllocationCounter::Stop();
+            uint64 elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+            SmallObjectPool::Stats poolAfter = SmallObjectPool::GetThreadStats();
+            uint64 pooled = (poolAfter.Allocations - poolBefore.Allocations) - (poolAfter.HeapAllocations - poolBefore.HeapAllocations);
+
+            handler->PSendSysMessage("Pool %s: " UI64FMTD " us (%.2f us per cast), " UI64FMTD " damage dealt, %.1f heap allocations and %.0f bytes per cast, %.1f allocations per cast served by the pool",
+                mode == 0 ? "enabled" : "disabled", elapsed, float(elapsed) / float(casts), damage,
+                float(allocations.Allocations) / float(casts), float(allocations.Bytes) / float(casts), float(pooled) / float(casts));
+        }
+
+        SmallObjectPool::SetEnabled(poolEnabled);
+
+        for (TempSummon* summon : dummies)
+            summon->DespawnOrUnsummon();
+        for (TempSummon* summon : casters)
+            summon->DespawnOrUnsummon();
+
+        return true;
+    }
+
+    static bool HandleDebugRegionBenchCommand(ChatHandler* handler, char const* args)
+    {
+        // USAGE: .debug regionbench [#clusters] [#creatures]
+        char* clustersStr = strtok((char*)args, " ");
+        char* creaturesStr = strtok(NULL, " ");
+
+        uint32 clusterCount = clustersStr ? uint32(atoi(clustersStr)) : 4;
+        uint32 creatureCount = creaturesStr ? uint32(atoi(creaturesStr)) : 50;
+        if (!clusterCount || clusterCount > 16 || !creatureCount || creatureCount > 200)
+        {
+            handler->PSendSysMessage("Cluster count must be between 1 and 16, creatures per cluster between 1 and 200.");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        MapUpdater* updater = sMapMgr->GetMapUpdater();
+        if (!updater->activated())
+        {
+            handler->PSendSysMessage("MapUpdate.Threads is 0, there are no threads to update regions on.");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        Player* player = handler->GetSession()->GetPlayer();
+        Map* map = player->GetMap();
+        uint32 margin = map->GetRegionMargin();
+
+        // clusters in a row east of the player, the cells kept active around them are more than margin cells apart
+        float activationRange = std::max(map->GetVisibilityRange(), sWorld->getFloatConfig(CONFIG_SIGHT_MONSTER));
+        float spacing = 2 * activationRange + (margin + 2) * SIZE_OF_GRID_CELL;
+
+        std::vector<TempSummon*> summons;
+        for (uint32 cluster = 0; cluster < clusterCount; ++cluster)
+        {
+            float x = player->GetPositionX() + (cluster + 1) * spacing;
+            float y = player->GetPositionY();
+            if (!Trinity::IsValidMapCoord(x + 20.0f, y))
+                break;
+
+            for (uint32 i = 0; i < creatureCount; ++i)
+            {
+                float cx = x + frand(-20.0f, 20.0f);
+                float cy = y + frand(-20.0f, 20.0f);
+                float cz = map->GetHeight(player->GetPhaseMask(), cx, cy, MAX_HEIGHT);
+                if (cz <= INVALID_HEIGHT)
+                    cz = player->GetPositionZ();
+
+                TempSummon* summon = player->SummonCreature(WORLD_TRIGGER, cx, cy, cz, 0.0f, TEMPSUMMON_MANUAL_DESPAWN);
+                if (!summon)
+                    continue;
+
+                // one active creature per cluster keeps its cells updated, the others wander around it
+                if (!i)
+                    summon->setActive(true);
+                summon->GetMotionMaster()->MoveRandom(10.0f);
+                summons.push_back(summon);
+            }
+        }
+
+        if (summons.empty())
+        {
+            handler->PSendSysMessage("No room for a cluster east of you.");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        // the same ticks run with one thread, then with twice as many up to one per region or all map update threads
+        uint32 const ticks = 20;
+        uint32 const diff = 100;
+        uint32 maxThreads = uint32(updater->GetWorkerStats().size()) + 1;
+        uint32 regions = map->UpdateRegionsForBenchmark(diff, 0);
+        maxThreads = std::min(maxThreads, regions);
+
+        handler->PSendSysMessage("%u creatures in %u clusters %.0f yards apart, margin %u cells, %u regions",
+            uint32(summons.size()), clusterCount, spacing, margin, regions);
+        if (Map::GetMaxSpellReach() > margin * SIZE_OF_GRID_CELL)
+            handler->PSendSysMessage("Spells reach %.1f yards, further than the margin: the map is updated as one region.", Map::GetMaxSpellReach());
+
+        uint64 singleThreadTime = 0;
+        for (uint32 threads = 1; ; threads = std::min(threads * 2, maxThreads))
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (uint32 i = 0; i < ticks; ++i)
+                map->UpdateRegionsForBenchmark(diff, threads);
+            uint64 elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / ticks;
+
+            if (threads == 1)
+                singleThreadTime = elapsed;
+
+            handler->PSendSysMessage("%u threads: " UI64FMTD " us per tick (%.2fx)", threads, elapsed,
+                elapsed ? float(singleThreadTime) / float(elapsed) : 0.0f);
+
+            if (threads >= maxThreads)
+                break;
+        }
+
+        // removed with the next map update
+        for (TempSummon* summon : summons)
+            summon->DespawnOrUnsummon();
+
+        return true;
+    }
+
+    static bool HandleDebugLfgBenchCommand(ChatHandler* handler, char const* args)
+    {
+        // USAGE: .debug lfgbench [#players]
+        // matching runs on the world thread like LFGMgr::Update, the server stalls until it is done
+        uint32 count = *args ? uint32(atoi(args)) : 5000;
+        if (!count || count > 5000)
+        {
+            handler->PSendSysMessage("Player count must be between 1 and 5000.");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        // a queue of its own, the players in the real queues are not touched and no proposals are sent
+        lfg::LFGQueue queue;
+        queue.SetSimulated(true);
+
+        uint32 const playersPerUpdate = 250;
+        uint32 const maxTime = 30 * IN_MILLISECONDS;        // no new updates are started after that, in ms
+        uint32 const randomDungeon = 1000;                  // fake ids, only compared with each other
+        uint32 const dungeonCount = 10;
+
+        time_t now = time(NULL);
+        uint32 joined = 0;
+        uint32 updates = 0;
+        uint64 totalTime = 0;
+        uint64 maxUpdateTime = 0;
+        std::chrono::steady_clock::time_point benchStart = std::chrono::steady_clock::now();
+        while (joined < count)
+        {
+            if (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - benchStart).count() > maxTime)
+                break;
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (uint32 i = 0; i < playersPerUpdate && joined < count; ++i, ++joined)
+            {
+                // guid counters far above the real characters, most players choose damage and the random dungeon
+                ObjectGuid guid(HIGHGUID_PLAYER, 0xF0000000 + joined);
+
+                uint32 roll = urand(0, 99);
+                uint8 roles = roll < 15 ? lfg::PLAYER_ROLE_TANK
+                    : roll < 30 ? lfg::PLAYER_ROLE_HEALER
+                    : roll < 35 ? lfg::PLAYER_ROLE_TANK | lfg::PLAYER_ROLE_DAMAGE
+                    : roll < 40 ? lfg::PLAYER_ROLE_HEALER | lfg::PLAYER_ROLE_DAMAGE
+                    : lfg::PLAYER_ROLE_DAMAGE;
+
+                lfg::LfgDungeonSet dungeons;
+                if (urand(0, 9) < 7)
+                    dungeons.insert(randomDungeon);
+                else
+                    for (uint32 j = urand(1, 3); j > 0; --j)
+                        dungeons.insert(urand(1, dungeonCount));
+
+                lfg::LfgRolesMap rolesMap;
+                rolesMap[guid] = roles;
+                queue.AddQueueData(guid, now, dungeons, rolesMap);
+            }
+
+            queue.FindGroups();
+            uint64 elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+            totalTime += elapsed;
+            maxUpdateTime = std::max(maxUpdateTime, elapsed);
+            ++updates;
+        }
+
+        if (joined < count)
+            handler->PSendSysMessage("Stopped after %u s, only %u of %u players joined.", maxTime / IN_MILLISECONDS, joined, count);
+
+        handler->PSendSysMessage("%u simulated players joined in %u updates of up to %u: %u groups formed, %u still queued, %u cached combinations",
+            joined, updates, playersPerUpdate, queue.GetSimulatedGroups(), queue.GetQueuedCount(), queue.GetCompatibleCount());
+        handler->PSendSysMessage("Matching took " UI64FMTD " ms, avg " UI64FMTD " us and max " UI64FMTD " us per update",
+            totalTime / IN_MILLISECONDS, updates ? totalTime / updates : 0, maxUpdateTime);
+        return true;
+    }
+
+    static bool HandleDebugBroadcastBenchCommand(ChatHandler* handler, char const* args)
+    {
+        // USAGE: .debug broadcastbench [#sessions] [#bytes]
+        char* sessionsStr = strtok((char*)args, " ");
+        char* bytesStr = strtok(NULL, " ");
+
+        uint32 sessionCount = sessionsStr ? uint32(atoi(sessionsStr)) : 5000;
+        uint32 messageSize = bytesStr ? uint32(atoi(bytesStr)) : 512;
+        if (!sessionCount || sessionCount > 5000 || !messageSize || messageSize > 900)
+        {
+            handler->PSendSysMessage("Session count must be between 1 and 5000, message size between 1 and 900 bytes.");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        // every session gets a socket connected to a client socket over loopback, both ends are driven by a network
+        // thread of their own. The sessions have no account and are not added to the world, the sockets skip the handshake
+        boost::asio::io_service ioService;
+        boost::system::error_code error;
+        tcp::acceptor acceptor(ioService);
+        acceptor.open(tcp::v4(), error);
+        if (!error)
+            acceptor.bind(tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0), error);
+        if (!error)
+            acceptor.listen(boost::asio::socket_base::max_connections, error);
+        if (error)
+        {
+            handler->PSendSysMessage("Can't listen on loopback: %s", error.message().c_str());
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        std::atomic<uint64> received(0);
+        std::vector<std::shared_ptr<BroadcastBenchClient>> clients;
+        std::vector<WorldSession*> sessions;
+        clients.reserve(sessionCount);
+        sessions.reserve(sessionCount);
+        for (uint32 i = 0; i < sessionCount; ++i)
+        {
+            std::shared_ptr<BroadcastBenchClient> client = std::make_shared<BroadcastBenchClient>(ioService, received);
+            client->Socket.connect(acceptor.local_endpoint(), error);
+            if (error)
+                break;
+
+            tcp::socket serverSocket(ioService);
+            acceptor.accept(serverSocket, error);
+            if (error)
+                break;
+
+            std::shared_ptr<WorldSocket> worldSocket = std::make_shared<WorldSocket>(std::move(serverSocket));
+            sessions.push_back(new WorldSession(0, 0, worldSocket, SEC_PLAYER, 0, 0, LOCALE_enUS, 0, false));
+            client->AsyncRead();
+            clients.push_back(client);
+        }
+
+        if (error)
+            handler->PSendSysMessage("Only %u sessions connected: %s (open file limit?)", uint32(sessions.size()), error.message().c_str());
+
+        std::thread networkThread([&ioService]() { ioService.run(); });
+
+        // a system message like the announcements of World::SendGlobalMessage
+        WorldPacket packet;
+        ChatHandler::BuildChatPacket(packet, CHAT_MSG_SYSTEM, LANG_UNIVERSAL, NULL, NULL, std::string(messageSize, 'x'));
+        uint64 const bytesPerSession = packet.size() + ServerPktHeader(packet.size() + 2, packet.GetOpcode()).getHeaderLength();
+        uint32 const broadcasts = 10;
+
+        // mode 0 copies the packet into every socket, mode 1 queues one shared copy by reference
+        char const* modeNames[] = { "Copied per session", "Shared" };
+        for (uint8 mode = 0; mode < 2; ++mode)
+        {
+            uint64 expected = received + bytesPerSession * broadcasts * sessions.size();
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (uint32 i = 0; i < broadcasts; ++i)
+            {
+                if (mode == 0)
+                {
+                    for (WorldSession* session : sessions)
+                        session->SendPacket(&packet);
+                }
+                else
+                {
+                    PacketBroadcaster broadcaster(&packet);
+                    for (WorldSession* session : sessions)
+                        broadcaster.SendTo(session);
+                }
+            }
+            uint64 sendTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+            while (received < expected && std::chrono::steady_clock::now() - start < std::chrono::seconds(30))
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            uint64 deliverTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+            handler->PSendSysMessage("%s: " UI64FMTD " us per broadcast on the sending thread, all received after " UI64FMTD " ms%s",
+                modeNames[mode], sendTime / broadcasts, deliverTime / IN_MILLISECONDS, received < expected ? " (timed out)" : "");
+        }
+
+        handler->PSendSysMessage("%u sessions, %u broadcasts of %u bytes each", uint32(sessions.size()), broadcasts, uint32(packet.size()));
+
+        // the sockets are closed with the network thread stopped, pending handlers are dropped with the io_service
+        ioService.stop();
+        networkThread.join();
+
+        for (std::shared_ptr<BroadcastBenchClient> const& client : clients)
+            client->Socket.close(error);
+
+        for (WorldSession* session : sessions)
+            delete session;
+
+        return true;
+    }
+
+    static bool HandleDebugAchievementStatsCommand(ChatHandler* handler, char const* args)
+    {
+        AchievementGlobalMgr::CriteriaStats total = { 0, 0, 0 };
+        std::vector<std::pair<uint64, uint32>> types;
+        for (uint32 type = 0; type < ACHIEVEMENT_CRITERIA_TYPE_TOTAL; ++type)
+        {
+            AchievementGlobalMgr::CriteriaStats stats = sAchievementMgr->GetCriteriaStats(AchievementCriteriaTypes(type));
+            total.Events += stats.Events;
+            total.Visited += stats.Visited;
+            total.Skipped += stats.Skipped;
+            if (stats.Visited)
+                types.push_back(std::make_pair(stats.Visited, type));
+        }
+
+        handler->PSendSysMessage("Achievement criteria updates: " UI64FMTD " events, " UI64FMTD " criteria visited (%.2f per event), " UI64FMTD " skipped by the index",
+            total.Events, total.Visited, total.Events ? float(total.Visited) / float(total.Events) : 0.0f, total.Skipped);
+
+        std::sort(types.begin(), types.end(), std::greater<std::pair<uint64, uint32>>());
+        if (types.size() > 10)
+            types.resize(10);
+
+        for (std::pair<uint64, uint32> const& entry : types)
+        {
+            AchievementGlobalMgr::CriteriaStats stats = sAchievementMgr->GetCriteriaStats(AchievementCriteriaTypes(entry.second));
+            handler->PSendSysMessage("%s: " UI64FMTD " events, " UI64FMTD " visited (%.2f per event), " UI64FMTD " skipped",
+                AchievementGlobalMgr::GetCriteriaTypeString(entry.second), stats.Events, stats.Visited,
+                stats.Events ? float(stats.Visited) / float(stats.Events) : 0.0f, stats.Skipped);
+        }
+
+        if (args && strncmp(args, "reset", 5) == 0)
+        {
+            sAchievementMgr->ResetCriteriaStats();
+            handler->PSendSysMessage("Achievement criteria statistics reset.");
+        }
+
+        return true;
+    }
+
+    static bool HandleDebugCompressionCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        std::vector<std::pair<uint64, uint16>> opcodes;
+        for (uint16 opcode = 0; opcode < NUM_OPCODE_HANDLERS; ++opcode)
+            if (uint64 time = WorldSocket::GetCompressionStats(opcode).Time)
+                opcodes.push_back(std::make_pair(time, opcode));
+
+        if (opcodes.empty())
+        {
+            handler->PSendSysMessage("No packets were compressed yet.");
+            return true;
+        }
+
+        std::sort(opcodes.begin(), opcodes.end(), std::greater<std::pair<uint64, uint16>>());
+        if (opcodes.size() > 10)
+            opcodes.resize(10);
+
+        for (std::pair<uint64, uint16> const& entry : opcodes)
+        {
+            WorldSocket::CompressionStats const& stats = WorldSocket::GetCompressionStats(entry.second);
+            uint64 count = stats.Count;
+            uint64 uncompressed = stats.UncompressedBytes;
+            handler->PSendSysMessage("%s: " UI64FMTD " packets, " UI64FMTD " us total (" UI64FMTD " us avg), %.1f%% of original size",
+                GetOpcodeNameForLogging(Opcodes(entry.second)).c_str(), count, entry.first, count ? entry.first / count : 0,
+                uncompressed ? float(stats.CompressedBytes) * 100.0f / float(uncompressed) : 0.0f);
+        }
+
+        return true;
+    }
+
+    static bool HandleDebugUpdateCacheCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        uint64 built = ValuesUpdateBlockCache::GetBuiltCount();
+        uint64 reused = ValuesUpdateBlockCache::GetReusedCount();
+        uint64 total = built + reused;
+
+        handler->PSendSysMessage("Values update blocks: " UI64FMTD " built, " UI64FMTD " reused (%.1f%% hit rate), " UI64FMTD " receiver dependent fields rewritten",
+            built, reused, total ? float(reused) * 100.0f / float(total) : 0.0f, ValuesUpdateBlockCache::GetPatchedFieldCount());
+        return true;
+    }
+
+    static bool HandleDebugAuctionSearchCommand(ChatHandler* handler, char const* args)
+    {
+        // USAGE: .debug auctionsearch [#auctions]
+        uint32 auctionCount = *args ? uint32(atoi(args)) : 2000;
+        if (!auctionCount || auctionCount > 5000)
+        {
+            handler->PSendSysMessage("Auction count must be between 1 and 5000.");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        std::vector<ItemTemplate const*> protos;
+        ItemTemplateContainer const* itemTemplates = sObjectMgr->GetItemTemplateStore();
+        for (ItemTemplateContainer::const_iterator itr = itemTemplates->begin(); itr != itemTemplates->end(); ++itr)
+            if (!itr->second.Name1.empty())
+                protos.push_back(&itr->second);
+
+        if (protos.empty())
+            return false;
+
+        using namespace std::chrono;
+
+        // synthetic auction house, entries only need an id for the index
+        std::vector<AuctionEntry> auctions(auctionCount);
+        std::vector<ItemTemplate const*> auctionProtos(auctionCount);
+        AuctionHouseSearchIndex index;
+
+        steady_clock::time_point start = steady_clock::now();
+        for (uint32 i = 0; i < auctionCount; ++i)
+        {
+            auctions[i].Id = i + 1;
+            auctionProtos[i] = protos[urand(0, protos.size() - 1)];
+            index.AddAuction(&auctions[i], auctionProtos[i], 0);
+        }
+
+        handler->PSendSysMessage("Indexed %u synthetic auctions in %u ms", auctionCount, uint32(duration_cast<milliseconds>(steady_clock::now() - start).count()));
+
+        std::wstring wsearchedname;
+        if (!Utf8toWStr(auctionProtos[0]->Name1, wsearchedname))
+            return false;
+
+        wstrToLower(wsearchedname);
+        wsearchedname.resize(std::min<std::size_t>(wsearchedname.size(), 5));
+
+        std::vector<std::pair<char const*, AuctionSearchFilters>> queries(6);
+        queries[0].first = "no filter";
+        queries[1].first = "name";
+        queries[1].second.SearchedName = wsearchedname;
+        queries[2].first = "name (2 letters)";
+        queries[2].second.SearchedName = wsearchedname.substr(0, 2);
+        queries[3].first = "weapons";
+        queries[3].second.ItemClass = ITEM_CLASS_WEAPON;
+        queries[4].first = "rare two-handed swords";
+        queries[4].second.ItemClass = ITEM_CLASS_WEAPON;
+        queries[4].second.ItemSubClass = ITEM_SUBCLASS_WEAPON_SWORD2;
+        queries[4].second.Quality = ITEM_QUALITY_RARE;
+        queries[5].first = "level 20-30 name";
+        queries[5].second.SearchedName = wsearchedname;
+        queries[5].second.LevelMin = 20;
+        queries[5].second.LevelMax = 30;
+
+        // builds the per locale name index outside of the measured searches
+        start = steady_clock::now();
+        std::vector<AuctionEntry*> result;
+        index.Search(queries[1].second, result);
+        handler->PSendSysMessage("Built name index in %u ms", uint32(duration_cast<milliseconds>(steady_clock::now() - start).count()));
+
+        for (std::size_t q = 0; q < queries.size(); ++q)
+        {
+            AuctionSearchFilters const& filters = queries[q].second;
+
+            // the way searches were done before the index existed
+            start = steady_clock::now();
+            uint32 scanned = 0;
+            for (uint32 i = 0; i < auctionCount; ++i)
+            {
+                ItemTemplate const* proto = auctionProtos[i];
+                if (filters.ItemClass != 0xffffffff && proto->Class != filters.ItemClass)
+                    continue;
+
+                if (filters.ItemSubClass != 0xffffffff && proto->SubClass != filters.ItemSubClass)
+                    continue;
+
+                if (filters.InventoryType != 0xffffffff && proto->InventoryType != filters.InventoryType)
+                    continue;
+
+                if (filters.Quality != 0xffffffff && proto->Quality != filters.Quality)
+                    continue;
+
+                if (filters.LevelMin != 0x00 && (proto->RequiredLevel < filters.LevelMin || (filters.LevelMax != 0x00 && proto->RequiredLevel > filters.LevelMax)))
+                    continue;
+
+                if (!filters.SearchedName.empty())
+                {
+                    std::wstring wname;
+                    if (!AuctionHouseSearchIndex::BuildSearchName(proto, 0, filters.DbLocale, filters.DbcLocale, wname) || wname.find(filters.SearchedName) == std::wstring::npos)
+                        continue;
+                }
+
+                ++scanned;
+            }
+
+            uint64 scanTime = duration_cast<microseconds>(steady_clock::now() - start).count();
+
+            start = steady_clock::now();
+            result.clear();
+            index.Search(filters, result);
+            uint64 indexTime = duration_cast<microseconds>(steady_clock::now() - start).count();
+
+            handler->PSendSysMessage("%s: %u matches (%s), scan " UI64FMTD " us, index " UI64FMTD " us", queries[q].first,
+                uint32(result.size()), scanned == result.size() ? "identical" : "MISMATCH", scanTime, indexTime);
+        }
+
+        return true;
+    }
+
+    static void FillRandomMovementStatus(MovementInfo& mi, Movement::MovementStatusState& state)
+    {
+        mi.guid = ObjectGuid(uint64(urand(0, 0xFFFFFFFF)) << 32 | urand(0, 0xFFFFFFFF));
+        mi.transport.guid = ObjectGuid(uint64(urand(0, 0xFFFFFFFF)) << 32 | urand(0, 0xFFFFFFFF));
+        mi.flags = urand(0, 0x3FFFFFFF);
+        mi.flags2 = uint16(urand(0, 0xFFF));
+        mi.time = urand(0, 0xFFFFFFFF);
+        mi.pos.Relocate(frand(-10000.0f, 10000.0f), frand(-10000.0f, 10000.0f), frand(-500.0f, 500.0f), frand(0.0f, 2 * float(M_PI)));
+        mi.transport.pos.Relocate(frand(-50.0f, 50.0f), frand(-50.0f, 50.0f), frand(-50.0f, 50.0f), frand(0.0f, 2 * float(M_PI)));
+        mi.transport.seat = int8(urand(0, 7));
+        mi.transport.time = urand(0, 0xFFFFFFFF);
+        mi.transport.time2 = urand(0, 0xFFFFFFFF);
+        mi.transport.vehicleId = urand(0, 0xFFFFFFFF);
+        mi.pitch = frand(-float(M_PI), float(M_PI));
+        mi.jump.fallTime = urand(0, 0xFFFFFFFF);
+        mi.jump.zspeed = frand(-50.0f, 50.0f);
+        mi.jump.sinAngle = frand(-1.0f, 1.0f);
+        mi.jump.cosAngle = frand(-1.0f, 1.0f);
+        mi.jump.xyspeed = frand(0.0f, 50.0f);
+        mi.splineElevation = frand(-10.0f, 10.0f);
+
+        bool hasTransportData = roll_chance_i(50);
+        bool hasFallDirection = roll_chance_i(50);
+        state.SetGuid(Movement::MSS_GUID, mi.guid);
+        if (hasTransportData)
+            state.SetGuid(Movement::MSS_TRANSPORT_GUID, mi.transport.guid);
+        state.Set(Movement::MSS_HAS_MOVEMENT_FLAGS, roll_chance_i(50));
+        state.Set(Movement::MSS_HAS_MOVEMENT_FLAGS2, roll_chance_i(50));
+        state.Set(Movement::MSS_HAS_TIMESTAMP, roll_chance_i(50));
+        state.Set(Movement::MSS_HAS_ORIENTATION, roll_chance_i(50));
+        state.Set(Movement::MSS_HAS_TRANSPORT_DATA, hasTransportData);
+        state.Set(Movement::MSS_HAS_TRANSPORT_TIME2, hasTransportData && roll_chance_i(50));
+        state.Set(Movement::MSS_HAS_TRANSPORT_VEHICLE_ID, hasTransportData && roll_chance_i(50));
+        state.Set(Movement::MSS_HAS_PITCH, roll_chance_i(50));
+        state.Set(Movement::MSS_HAS_FALL_DATA, hasFallDirection || roll_chance_i(50));
+        state.Set(Movement::MSS_HAS_FALL_DIRECTION, hasFallDirection);
+        state.Set(Movement::MSS_HAS_SPLINE_ELEVATION, roll_chance_i(50));
+        // read side discards the spline bit, it cannot survive a round trip
+        state.Set(Movement::MSS_HAS_SPLINE, false);
+    }
+
+    // the element interpreter Unit::WriteMovementInfo used before the codecs, values taken from mi and state
+    // instead of the unit, kept here as the reference the codecs are checked against
+    static bool WriteMovementStatusReference(ByteBuffer& data, MovementStatusElements const* sequence, MovementInfo const& mi, Movement::MovementStatusState const& state, uint32& counter)
+    {
+        bool hasMovementFlags = state.Has(Movement::MSS_HAS_MOVEMENT_FLAGS);
+        bool hasMovementFlags2 = state.Has(Movement::MSS_HAS_MOVEMENT_FLAGS2);
+        bool hasTimestamp = state.Has(Movement::MSS_HAS_TIMESTAMP);
+        bool hasOrientation = state.Has(Movement::MSS_HAS_ORIENTATION);
+        bool hasTransportData = state.Has(Movement::MSS_HAS_TRANSPORT_DATA);
+        bool hasSpline = state.Has(Movement::MSS_HAS_SPLINE);
+
+        bool hasTransportTime2 = hasTransportData && state.Has(Movement::MSS_HAS_TRANSPORT_TIME2);
+        bool hasTransportVehicleId = hasTransportData && state.Has(Movement::MSS_HAS_TRANSPORT_VEHICLE_ID);
+        bool hasPitch = state.Has(Movement::MSS_HAS_PITCH);
+        bool hasFallDirection = state.Has(Movement::MSS_HAS_FALL_DIRECTION);
+        bool hasFallData = state.Has(Movement::MSS_HAS_FALL_DATA);
+        bool hasSplineElevation = state.Has(Movement::MSS_HAS_SPLINE_ELEVATION);
+
+        ObjectGuid guid = state.GetGuid(Movement::MSS_GUID);
+        ObjectGuid tguid = hasTransportData ? state.GetGuid(Movement::MSS_TRANSPORT_GUID) : ObjectGuid::Empty;
+
+        for (; *sequence != MSEEnd; ++sequence)
+        {
+            MovementStatusElements const& element = *sequence;
+
+            switch (element)
+            {
+            case MSEHasGuidByte0:
+            case MSEHasGuidByte1:
+            case MSEHasGuidByte2:
+            case MSEHasGuidByte3:
+            case MSEHasGuidByte4:
+            case MSEHasGuidByte5:
+            case MSEHasGuidByte6:
+            case MSEHasGuidByte7:
+                data.WriteBit(guid[element - MSEHasGuidByte0]);
+                break;
+            case MSEHasTransportGuidByte0:
+            case MSEHasTransportGuidByte1:
+            case MSEHasTransportGuidByte2:
+            case MSEHasTransportGuidByte3:
+            case MSEHasTransportGuidByte4:
+            case MSEHasTransportGuidByte5:
+            case MSEHasTransportGuidByte6:
+            case MSEHasTransportGuidByte7:
+                if (hasTransportData)
+                    data.WriteBit(tguid[element - MSEHasTransportGuidByte0]);
+                break;
+            case MSEGuidByte0:
+            case MSEGuidByte1:
+            case MSEGuidByte2:
+            case MSEGuidByte3:
+            case MSEGuidByte4:
+            case MSEGuidByte5:
+            case MSEGuidByte6:
+            case MSEGuidByte7:
+                data.WriteByteSeq(guid[element - MSEGuidByte0]);
+                break;
+            case MSETransportGuidByte0:
+            case MSETransportGuidByte1:
+            case MSETransportGuidByte2:
+            case MSETransportGuidByte3:
+            case MSETransportGuidByte4:
+            case MSETransportGuidByte5:
+            case MSETransportGuidByte6:
+            case MSETransportGuidByte7:
+                if (hasTransportData)
+                    data.WriteByteSeq(tguid[element - MSETransportGuidByte0]);
+                break;
+            case MSEHasMovementFlags:
+                data.WriteBit(!hasMovementFlags);
+                break;
+            case MSEHasMovementFlags2:
+                data.WriteBit(!hasMovementFlags2);
+                break;
+            case MSEHasTimestamp:
+                data.WriteBit(!hasTimestamp);
+                break;
+            case MSEHasOrientation:
+                data.WriteBit(!hasOrientation);
+                break;
+            case MSEHasTransportData:
+                data.WriteBit(hasTransportData);
+                break;
+            case MSEHasTransportTime2:
+                if (hasTransportData)
+                    data.WriteBit(hasTransportTime2);
+                break;
+            case MSEHasTransportTime3:
+                if (hasTransportData)
+                    data.WriteBit(hasTransportVehicleId);
+                break;
+            case MSEHasPitch:
+                data.WriteBit(!hasPitch);
+                break;
+            case MSEHasFallData:
+                data.WriteBit(hasFallData);
+                break;
+            case MSEHasFallDirection:
+                if (hasFallData)
+                    data.WriteBit(hasFallDirection);
+                break;
+            case MSEHasSplineElevation:
+                data.WriteBit(!hasSplineElevation);
+                break;
+            case MSEHasSpline:
+                data.WriteBit(hasSpline);
+                break;
+            case MSEMovementFlags:
+                if (hasMovementFlags)
+                    data.WriteBits(mi.flags, 30);
+                break;
+            case MSEMovementFlags2:
+                if (hasMovementFlags2)
+                    data.WriteBits(mi.flags2, 12);
+                break;
+            case MSETimestamp:
+                if (hasTimestamp)
+                    data << mi.time;
+                break;
+            case MSEPositionX:
+                data << mi.pos.GetPositionX();
+                break;
+            case MSEPositionY:
+                data << mi.pos.GetPositionY();
+                break;
+            case MSEPositionZ:
+                data << mi.pos.GetPositionZ();
+                break;
+            case MSEOrientation:
+                if (hasOrientation)
+                    data << mi.pos.GetOrientation();
+                break;
+            case MSETransportPositionX:
+                if (hasTransportData)
+                    data << mi.transport.pos.GetPositionX();
+                break;
+            case MSETransportPositionY:
+                if (hasTransportData)
+                    data << mi.transport.pos.GetPositionY();
+                break;
+            case MSETransportPositionZ:
+                if (hasTransportData)
+                    data << mi.transport.pos.GetPositionZ();
+                break;
+            case MSETransportOrientation:
+                if (hasTransportData)
+                    data << mi.transport.pos.GetOrientation();
+                break;
+            case MSETransportSeat:
+                if (hasTransportData)
+                    data << mi.transport.seat;
+                break;
+            case MSETransportTime:
+                if (hasTransportData)
+                    data << mi.transport.time;
+                break;
+            case MSETransportTime2:
+                if (hasTransportData && hasTransportTime2)
+                    data << mi.transport.time2;
+                break;
+            case MSETransportVehicleId:
+                if (hasTransportData && hasTransportVehicleId)
+                    data << mi.transport.vehicleId;
+                break;
+            case MSEPitch:
+                if (hasPitch)
+                    data << mi.pitch;
+                break;
+            case MSEFallTime:
+                if (hasFallData)
+                    data << mi.jump.fallTime;
+                break;
+            case MSEFallVerticalSpeed:
+                if (hasFallData)
+                    data << mi.jump.zspeed;
+                break;
+            case MSEFallCosAngle:
+                if (hasFallData && hasFallDirection)
+                    data << mi.jump.cosAngle;
+                break;
+            case MSEFallSinAngle:
+                if (hasFallData && hasFallDirection)
+                    data << mi.jump.sinAngle;
+                break;
+            case MSEFallHorizontalSpeed:
+                if (hasFallData && hasFallDirection)
+                    data << mi.jump.xyspeed;
+                break;
+            case MSESplineElevation:
+                if (hasSplineElevation)
+                    data << mi.splineElevation;
+                break;
+            case MSECounter:
+                data << counter++;
+                break;
+            case MSEZeroBit:
+                data.WriteBit(0);
+                break;
+            case MSEOneBit:
+                data.WriteBit(1);
+                break;
+            default:
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static bool HandleDebugMovementCodecsCommand(ChatHandler* handler, char const* args)
+    {
+        // USAGE: .debug movementcodecs [#iterations]
+        uint32 iterations = *args ? uint32(atoi(args)) : 100;
+        if (!iterations || iterations > 1000)
+        {
+            handler->PSendSysMessage("Iteration count must be between 1 and 1000.");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        // random blocks written by the codec must match the bytes of the old interpreter,
+        // and reading them back and writing again must reproduce the same bytes
+        uint32 opcodes = 0;
+        uint32 blocks = 0;
+        for (uint32 opcode = 0; opcode < NUM_OPCODE_HANDLERS; ++opcode)
+        {
+            Movement::MovementStatusCodec const* codec = Movement::GetMovementStatusCodec(opcode);
+            if (!codec || codec->HasExtraElements())
+                continue;
+
+            ++opcodes;
+            uint32 failures = 0;
+            for (uint32 i = 0; i < iterations; ++i)
+            {
+                MovementInfo mi;
+                Movement::MovementStatusState state;
+                FillRandomMovementStatus(mi, state);
+
+                ByteBuffer reference;
+                uint32 counter = 0;
+                if (!WriteMovementStatusReference(reference, codec->GetSequence(), mi, state, counter))
+                {
+                    ++failures;
+                    continue;
+                }
+                reference.FlushBits();
+
+                ByteBuffer written;
+                counter = 0;
+                codec->Write(written, mi, state, counter, NULL);
+                written.FlushBits();
+
+                if (written.size() != reference.size() || memcmp(written.contents(), reference.contents(), written.size()))
+                {
+                    ++failures;
+                    continue;
+                }
+
+                MovementInfo readInfo;
+                Movement::MovementStatusState readState;
+                ByteBuffer rewritten;
+                try
+                {
+                    codec->Read(written, readInfo, readState, NULL);
+                    counter = 0;
+                    codec->Write(rewritten, readInfo, readState, counter, NULL);
+                    rewritten.FlushBits();
+                }
+                catch (ByteBufferException const&)
+                {
+                    ++failures;
+                    continue;
+                }
+
+                if (written.rpos() != written.size() || rewritten.size() != written.size() ||
+                    memcmp(rewritten.contents(), written.contents(), written.size()))
+                    ++failures;
+                else
+                    ++blocks;
+            }
+
+            if (failures)
+                handler->PSendSysMessage("%s: %u of %u blocks differ from the old encoding or do not round trip", GetOpcodeNameForLogging(opcode).c_str(), failures, iterations);
+        }
+
+        handler->PSendSysMessage("%u opcodes, %u blocks matched the old encoding and round tripped", opcodes, blocks);
+
+        Movement::MovementStatusCodec const* heartbeat = Movement::GetMovementStatusCodec(MSG_MOVE_HEARTBEAT);
+        if (!heartbeat)
+            return true;
+
+        std::vector<ByteBuffer> packets(1000);
+        for (std::size_t i = 0; i < packets.size(); ++i)
+        {
+            MovementInfo mi;
+            Movement::MovementStatusState state;
+            FillRandomMovementStatus(mi, state);
+            uint32 counter = 0;
+            heartbeat->Write(packets[i], mi, state, counter, NULL);
+            packets[i].FlushBits();
+        }
+
+        using namespace std::chrono;
+
+        steady_clock::time_point start = steady_clock::now();
+        for (uint32 i = 0; i < iterations; ++i)
+        {
+            for (std::size_t p = 0; p < packets.size(); ++p)
+            {
+                ByteBuffer packet(packets[p]);
+                MovementInfo mi;
+                Movement::MovementStatusState state;
+                heartbeat->Read(packet, mi, state, NULL);
+            }
+        }
+
+        uint64 elapsed = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+        handler->PSendSysMessage("Decoded %u heartbeats, " UI64FMTD " ns per block (including a packet copy)", uint32(packets.size()) * iterations, elapsed / (uint64(packets.size()) * iterations));
+        return true;
+    }
+
     static bool HandleDebugLoSCommand(ChatHandler* handler, char const* /*args*/)
     {
         if (Unit* unit = handler->getSelectedUnit())
@@ -51,6 +51,15 @@ DatabaseLoader& DatabaseLoader::AddDatabase(DatabaseWorkerPool<T>& pool, std::st
 
         uint8 const synchThreads = uint8(sConfigMgr->GetIntDefault(name + "Database.SynchThreads", 1));
 
+        int32 const batchSize = sConfigMgr->GetIntDefault(name + "Database.BatchSize", 1);
+        if (batchSize < 1 || batchSize > 1000)
+        {
+            TC_LOG_ERROR(_logger.c_str(), "%s database: invalid batch size specified. "
+                "Please pick a value between 1 and 1000.", name.c_str());
+            return false;
+        }
+
+        pool.SetBatchSize(uint32(batchSize));
         pool.SetConnectionInfo(dbString, asyncThreads, synchThreads);
         if (uint32 error = pool.Open())
         {
@@ -20,7 +20,9 @@
 #include "SQLOperation.h"
 #include "ProducerConsumerQueue.h"
 
-DatabaseWorker::DatabaseWorker(ProducerConsumerQueue<SQLOperation*>* newQueue, MySQLConnection* connection)
+#include <mysqld_error.h>
+
+DatabaseWorker::DatabaseWorker(DatabaseWorkerQueue* newQueue, MySQLConnection* connection)
 {
     _connection = connection;
     _queue = newQueue;
@@ -32,7 +34,7 @@ DatabaseWorker::~DatabaseWorker()
 {
     _cancelationToken = true;
 
-    _queue->Cancel();
+    _queue->Operations.Cancel();
 
     _workerThread.join();
 }
@@ -42,18 +44,112 @@ void DatabaseWorker::WorkerThread()
     if (!_queue)
         return;
 
+    std::vector<SQLOperation*> operations;
     for (;;)
     {
-        SQLOperation* operation = nullptr;
+        operations.clear();
 
-        _queue->WaitAndPop(operation);
+        _queue->Operations.WaitAndPop(operations, std::max<uint32>(_queue->BatchSize, 1));
 
-        if (_cancelationToken || !operation)
+        if (_cancelationToken || operations.empty())
+        {
+            for (SQLOperation* operation : operations)
+                delete operation;
             return;
+        }
+
+        _queue->Stats.QueueSize -= uint32(operations.size());
 
-        operation->SetConnection(_connection);
-        operation->call();
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        for (SQLOperation* operation : operations)
+        {
+            operation->SetConnection(_connection);
+            _queue->Stats.QueueLatency.Record(std::chrono::duration_cast<std::chrono::microseconds>(now - operation->m_queueTime).count());
+        }
 
-        delete operation;
+        for (std::size_t i = 0; i < operations.size();)
+        {
+            // consecutive one-way statements share a transaction, everything else keeps running on its own
+            std::size_t end = i;
+            while (end < operations.size() && operations[end]->IsBatchable())
+                ++end;
+
+            if (end - i > 1)
+            {
+                ExecuteBatch(&operations[i], end - i);
+                i = end;
+            }
+            else
+                ExecuteOperation(operations[i++]);
+        }
     }
 }
+
+void DatabaseWorker::ExecuteOperation(SQLOperation* operation)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    operation->call();
+
+    _queue->Stats.ExecutionLatency.Record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    ++_queue->Stats.Operations;
+
+    delete operation;
+}
+
+void DatabaseWorker::ExecuteBatch(SQLOperation* const* operations, std::size_t count)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    _connection->BeginTransaction();
+
+    // statements executed in the transaction are only lost together. A statement that fails because
+    // the connection was lost is not retried by the connection here, the whole batch is replayed instead
+    uint32 const reconnects = _connection->GetReconnectCount();
+    _connection->SetRetryAfterReconnect(false);
+
+    std::size_t failed = count;
+    bool reconnected = false;
+    int errorCode = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (!operations[i]->Execute())
+        {
+            reconnected = _connection->GetReconnectCount() != reconnects;
+            errorCode = _connection->GetLastError();
+            failed = i;
+            break;
+        }
+    }
+
+    _connection->SetRetryAfterReconnect(true);
+
+    if (failed == count)
+        _connection->CommitTransaction();
+    else
+    {
+        ++_queue->Stats.BatchFallbacks;
+
+        // the transaction died with the old connection, everything is replayed in order
+        std::size_t skip = count;
+        if (!reconnected)
+        {
+            _connection->RollbackTransaction();
+            if (errorCode != ER_LOCK_DEADLOCK)
+                skip = failed;  // already failed once, like it would have on its own
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+            if (i != skip)
+                operations[i]->Execute();
+    }
+
+    _queue->Stats.ExecutionLatency.Record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    _queue->Stats.Operations += count;
+    ++_queue->Stats.Batches;
+    _queue->Stats.BatchedStatements += count;
+    DatabaseWorkerStats::UpdateMax(_queue->Stats.MaxBatchSize, uint32(count));
+
+    for (std::size_t i = 0; i < count; ++i)
+        delete operations[i];
+}
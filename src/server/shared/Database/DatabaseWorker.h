@@ -19,22 +19,73 @@
 #define _WORKERTHREAD_H
 
 #include <thread>
+#include <vector>
 #include "ProducerConsumerQueue.h"
+#include "LatencyHistogram.h"
 
 class MySQLConnection;
 class SQLOperation;
 
+//- Counters of the asynchronous side of a DatabaseWorkerPool
+struct DatabaseWorkerStats
+{
+    DatabaseWorkerStats() : QueueSize(0) { Reset(); }
+
+    void Reset()
+    {
+        MaxQueueSize = 0;
+        Operations = 0;
+        Batches = 0;
+        BatchedStatements = 0;
+        MaxBatchSize = 0;
+        BatchFallbacks = 0;
+        QueueLatency.Reset();
+        ExecutionLatency.Reset();
+    }
+
+    static void UpdateMax(std::atomic<uint32>& max, uint32 value)
+    {
+        uint32 current = max.load(std::memory_order_relaxed);
+        while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed))
+            ;
+    }
+
+    std::atomic<uint32> QueueSize;              //- Operations waiting for a worker, not reset
+    std::atomic<uint32> MaxQueueSize;
+    std::atomic<uint64> Operations;             //- Operations executed
+    std::atomic<uint64> Batches;                //- Transactions made of consecutive queued statements
+    std::atomic<uint64> BatchedStatements;      //- Statements executed as part of these transactions
+    std::atomic<uint32> MaxBatchSize;
+    std::atomic<uint64> BatchFallbacks;         //- Batches re-executed statement by statement after an error
+    LatencyHistogram QueueLatency;              //- Time between queueing and start of execution
+    LatencyHistogram ExecutionLatency;          //- Time needed to execute an operation or a batch
+};
+
+//- State shared by the asynchronous connections of a DatabaseWorkerPool
+struct DatabaseWorkerQueue
+{
+    DatabaseWorkerQueue() : BatchSize(1) { }
+
+    ProducerConsumerQueue<SQLOperation*> Operations;
+    //- Max operations a worker takes from the queue at once, 1 disables batching.
+    //- Consecutive one-way statements among them are executed in a single transaction.
+    uint32 BatchSize;
+    DatabaseWorkerStats Stats;
+};
+
 class DatabaseWorker
 {
     public:
-        DatabaseWorker(ProducerConsumerQueue<SQLOperation*>* newQueue, MySQLConnection* connection);
+        DatabaseWorker(DatabaseWorkerQueue* newQueue, MySQLConnection* connection);
         ~DatabaseWorker();
 
     private:
-        ProducerConsumerQueue<SQLOperation*>* _queue;
+        DatabaseWorkerQueue* _queue;
         MySQLConnection* _connection;
 
         void WorkerThread();
+        void ExecuteOperation(SQLOperation* operation);
+        void ExecuteBatch(SQLOperation* const* operations, std::size_t count);
         std::thread _workerThread;
 
         std::atomic_bool _cancelationToken;
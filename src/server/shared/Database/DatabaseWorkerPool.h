@@ -59,7 +59,7 @@ class DatabaseWorkerPool
 
     public:
         /* Activity state */
-        DatabaseWorkerPool() : _queue(new ProducerConsumerQueue<SQLOperation*>()),
+        DatabaseWorkerPool() : _queue(new DatabaseWorkerQueue()),
             _async_threads(0), _synch_threads(0)
         {
             memset(_connectionCount, 0, sizeof(_connectionCount));
@@ -71,7 +71,21 @@ class DatabaseWorkerPool
 
         ~DatabaseWorkerPool()
         {
-            _queue->Cancel();
+            _queue->Operations.Cancel();
+        }
+
+        //! Maximum number of queued operations an async worker takes at once.
+        //! Consecutive one-way prepared statements among them are committed in a single transaction.
+        //! Must be called before Open().
+        void SetBatchSize(uint32 batchSize)
+        {
+            _queue->BatchSize = std::max<uint32>(batchSize, 1);
+        }
+
+        //! Queue and execution statistics of the async workers
+        DatabaseWorkerStats& GetStats()
+        {
+            return _queue->Stats;
         }
 
         void SetConnectionInfo(std::string const& infoString, uint8 const asyncThreads, uint8 const synchThreads)
@@ -525,7 +539,9 @@ class DatabaseWorkerPool
 
         void Enqueue(SQLOperation* op)
         {
-            _queue->Push(op);
+            op->m_queueTime = std::chrono::steady_clock::now();
+            DatabaseWorkerStats::UpdateMax(_queue->Stats.MaxQueueSize, ++_queue->Stats.QueueSize);
+            _queue->Operations.Push(op);
         }
 
         //! Gets a free connection in the synchronous connection pool.
@@ -553,7 +569,7 @@ class DatabaseWorkerPool
         }
 
         //! Queue shared by async worker threads.
-        std::unique_ptr<ProducerConsumerQueue<SQLOperation*>> _queue;
+        std::unique_ptr<DatabaseWorkerQueue> _queue;
         std::vector<std::vector<T*>> _connections;
         //! Counter of MySQL connections;
         uint32 _connectionCount[IDX_SIZE];
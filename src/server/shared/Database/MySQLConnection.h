@@ -24,6 +24,7 @@
 #define _MYSQLCONNECTION_H
 
 class DatabaseWorker;
+struct DatabaseWorkerQueue;
 class PreparedStatement;
 class MySQLPreparedStatement;
 class PingOperation;
@@ -69,7 +70,7 @@ class MySQLConnection
 
     public:
         MySQLConnection(MySQLConnectionInfo& connInfo);                               //! Constructor for synchronous connections.
-        MySQLConnection(ProducerConsumerQueue<SQLOperation*>* queue, MySQLConnectionInfo& connInfo);  //! Constructor for asynchronous connections.
+        MySQLConnection(DatabaseWorkerQueue* queue, MySQLConnectionInfo& connInfo);  //! Constructor for asynchronous connections.
         virtual ~MySQLConnection();
 
         virtual uint32 Open();
@@ -95,6 +96,12 @@ class MySQLConnection
 
         uint32 GetLastError() { return mysql_errno(m_Mysql); }
 
+        //! Number of times the connection was re-established after being lost
+        uint32 GetReconnectCount() const { return m_reconnects; }
+
+        //! Whether a statement that failed because the connection was lost is executed again once it is re-established
+        void SetRetryAfterReconnect(bool retry) { m_retryAfterReconnect = retry; }
+
     protected:
         bool LockIfReady()
         {
@@ -120,12 +127,14 @@ class MySQLConnection
         PreparedStatementMap                 m_queries;       //! Query storage
         bool                                 m_reconnecting;  //! Are we reconnecting?
         bool                                 m_prepareError;  //! Was there any error while preparing statements?
+        uint32                               m_reconnects;    //! Successful reconnections
+        bool                                 m_retryAfterReconnect; //! Execute statements again after reconnecting?
 
     private:
         bool _HandleMySQLErrno(uint32 errNo);
 
     private:
-        ProducerConsumerQueue<SQLOperation*>* m_queue;      //! Queue shared with other asynchronous connections.
+        DatabaseWorkerQueue*  m_queue;                      //! Queue shared with other asynchronous connections.
         DatabaseWorker*       m_worker;                     //! Core worker task.
         MYSQL *               m_Mysql;                      //! MySQL Handle.
         MySQLConnectionInfo&  m_connectionInfo;             //! Connection info (used for logging)
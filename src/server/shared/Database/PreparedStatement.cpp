@@ -198,6 +198,64 @@ void PreparedStatement::setNull(const uint8 index)
     statement_data[index].type = TYPE_NULL;
 }
 
+static std::size_t GetParameterSize(PreparedStatementData const& data)
+{
+    switch (data.type)
+    {
+        case TYPE_BOOL:
+        case TYPE_UI8:
+        case TYPE_I8:
+            return 1;
+        case TYPE_UI16:
+        case TYPE_I16:
+            return 2;
+        case TYPE_UI32:
+        case TYPE_I32:
+        case TYPE_FLOAT:
+            return 4;
+        case TYPE_UI64:
+        case TYPE_I64:
+        case TYPE_DOUBLE:
+            return 8;
+        case TYPE_STRING:
+            return data.str.length();
+        default:
+            return 0;
+    }
+}
+
+std::size_t PreparedStatement::GetParametersSize() const
+{
+    std::size_t size = 0;
+    for (PreparedStatementData const& data : statement_data)
+        size += GetParameterSize(data);
+    return size;
+}
+
+uint64 PreparedStatement::GetParametersHash() const
+{
+    // FNV-1a over statement index, value types and values
+    uint64 hash = UI64LIT(14695981039346656037);
+    auto add = [&hash](uint8 const* bytes, std::size_t length)
+    {
+        for (std::size_t i = 0; i < length; ++i)
+            hash = (hash ^ bytes[i]) * UI64LIT(1099511628211);
+    };
+
+    add(reinterpret_cast<uint8 const*>(&m_index), sizeof(m_index));
+    for (PreparedStatementData const& data : statement_data)
+    {
+        uint8 type = uint8(data.type);
+        add(&type, 1);
+        if (data.type == TYPE_STRING)
+            add(reinterpret_cast<uint8 const*>(data.str.c_str()), data.str.length() + 1);
+        else
+            add(reinterpret_cast<uint8 const*>(&data.data), GetParameterSize(data));
+    }
+
+    return hash;
+}
+
 MySQLPreparedStatement::MySQLPreparedStatement(MYSQL_STMT* stmt) :
 m_stmt(NULL),
 m_Mstmt(stmt),
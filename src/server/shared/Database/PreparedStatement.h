@@ -70,7 +70,7 @@ struct PreparedStatementData
 class MySQLPreparedStatement;
 
 //- Upper-level class that is used in code
-class PreparedStatement
+class PreparedStatement : public PooledSQLObject
 {
     friend class PreparedStatementTask;
     friend class MySQLPreparedStatement;
@@ -94,6 +94,11 @@ class PreparedStatement
         void setString(const uint8 index, const std::string& value);
         void setNull(const uint8 index);
 
+        //- Size of the bound values in bytes
+        std::size_t GetParametersSize() const;
+        //- Hash of the statement index and bound values, equal for statements that would write the same data
+        uint64 GetParametersHash() const;
+
     protected:
         void BindParameters();
 
@@ -132,6 +137,11 @@ class MySQLPreparedStatement
         void setString(const uint8 index, const char* value);
         void setNull(const uint8 index);
 
+        //- Size of the bound values in bytes
+        std::size_t GetParametersSize() const;
+        //- Hash of the statement index and bound values, equal for statements that would write the same data
+        uint64 GetParametersHash() const;
+
     protected:
         MYSQL_STMT* GetSTMT() { return m_Mstmt; }
         MYSQL_BIND* GetBind() { return m_bind; }
@@ -164,6 +174,7 @@ class PreparedStatementTask : public SQLOperation
         ~PreparedStatementTask();
 
         bool Execute() override;
+        bool IsBatchable() const override { return !m_has_result; }
         PreparedQueryResultFuture GetFuture() { return m_result->get_future(); }
 
     protected:
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2008-2015 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SQLOperation.h"
+
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    std::size_t const SQL_OBJECT_POOL_GRANULARITY = 16;
+    std::size_t const SQL_OBJECT_POOL_SIZE_CLASSES = 16;    // objects up to 256 bytes are pooled
+    std::size_t const SQL_OBJECT_POOL_MAX_FREE = 4096;      // per size class, anything above goes back to the heap
+
+    struct SQLObjectFreeList
+    {
+        std::mutex Lock;
+        std::vector<void*> Blocks;
+    };
+
+    // intentionally never destroyed, statements may still be released during static destruction
+    SQLObjectFreeList* const SQLObjectFreeLists = new SQLObjectFreeList[SQL_OBJECT_POOL_SIZE_CLASSES];
+
+    inline std::size_t GetSizeClass(std::size_t size)
+    {
+        return (size + SQL_OBJECT_POOL_GRANULARITY - 1) / SQL_OBJECT_POOL_GRANULARITY - 1;
+    }
+}
+
+void* SQLObjectPool::Allocate(std::size_t size)
+{
+    std::size_t sizeClass = GetSizeClass(size);
+    if (sizeClass >= SQL_OBJECT_POOL_SIZE_CLASSES)
+        return ::operator new(size);
+
+    SQLObjectFreeList& freeList = SQLObjectFreeLists[sizeClass];
+    {
+        std::lock_guard<std::mutex> lock(freeList.Lock);
+        if (!freeList.Blocks.empty())
+        {
+            void* ptr = freeList.Blocks.back();
+            freeList.Blocks.pop_back();
+            return ptr;
+        }
+    }
+
+    // blocks of one size class must be interchangeable
+    return ::operator new((sizeClass + 1) * SQL_OBJECT_POOL_GRANULARITY);
+}
+
+void SQLObjectPool::Release(void* ptr, std::size_t size)
+{
+    if (!ptr)
+        return;
+
+    std::size_t sizeClass = GetSizeClass(size);
+    if (sizeClass < SQL_OBJECT_POOL_SIZE_CLASSES)
+    {
+        SQLObjectFreeList& freeList = SQLObjectFreeLists[sizeClass];
+        std::lock_guard<std::mutex> lock(freeList.Lock);
+        if (freeList.Blocks.size() < SQL_OBJECT_POOL_MAX_FREE)
+        {
+            freeList.Blocks.push_back(ptr);
+            return;
+        }
+    }
+
+    ::operator delete(ptr);
+}
@@ -20,6 +20,8 @@
 
 #include "QueryResult.h"
 
+#include <chrono>
+
 //- Forward declare (don't include header to prevent circular includes)
 class PreparedStatement;
 
@@ -53,7 +55,25 @@ union SQLResultSetUnion
 
 class MySQLConnection;
 
-class SQLOperation
+//- Free lists for the small objects created for every queued statement.
+//- They are allocated by the game threads and released by the database workers,
+//- so the lists are shared between threads and guarded by a lock per size class.
+class SQLObjectPool
+{
+    public:
+        static void* Allocate(std::size_t size);
+        static void Release(void* ptr, std::size_t size);
+};
+
+//- Base of classes whose instances are taken from SQLObjectPool
+class PooledSQLObject
+{
+    public:
+        static void* operator new(std::size_t size) { return SQLObjectPool::Allocate(size); }
+        static void operator delete(void* ptr, std::size_t size) { SQLObjectPool::Release(ptr, size); }
+};
+
+class SQLOperation : public PooledSQLObject
 {
     public:
         SQLOperation(): m_conn(NULL) { }
@@ -67,7 +87,12 @@ class SQLOperation
         virtual bool Execute() = 0;
         virtual void SetConnection(MySQLConnection* con) { m_conn = con; }
 
+        //- One-way prepared statements without result, consecutive ones may be executed in a shared transaction.
+        //- Ad-hoc statements are never batched, they may contain anything including statements that implicitly commit.
+        virtual bool IsBatchable() const { return false; }
+
         MySQLConnection* m_conn;
+        std::chrono::steady_clock::time_point m_queueTime;  //- Set when the operation is queued for an async worker
 
     private:
         SQLOperation(SQLOperation const& right) = delete;
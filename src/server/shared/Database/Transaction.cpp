@@ -39,15 +39,33 @@ void Transaction::Append(PreparedStatement* stmt)
     m_queries.push_back(data);
 }
 
+size_t Transaction::GetDataSize() const
+{
+    size_t size = 0;
+    for (SQLElementData const& data : m_queries)
+    {
+        switch (data.type)
+        {
+            case SQL_ELEMENT_PREPARED:
+                size += data.element.stmt->GetParametersSize();
+            break;
+            case SQL_ELEMENT_RAW:
+                size += strlen(data.element.query);
+            break;
+        }
+    }
+
+    return size;
+}
+
 void Transaction::Cleanup()
 {
     // This might be called by explicit calls to Cleanup or by the auto-destructor
     if (_cleanedUp)
         return;
 
-    while (!m_queries.empty())
+    for (SQLElementData const& data : m_queries)
     {
-        SQLElementData const &data = m_queries.front();
         switch (data.type)
         {
             case SQL_ELEMENT_PREPARED:
@@ -57,10 +75,10 @@ void Transaction::Cleanup()
                 free((void*)(data.element.query));
             break;
         }
-
-        m_queries.pop_front();
     }
 
+    m_queries.clear();
+
     _cleanedUp = true;
 }
 
@@ -46,10 +46,12 @@ class Transaction
         }
 
         size_t GetSize() const { return m_queries.size(); }
+        //- Size of the raw queries and prepared statement parameters in bytes
+        size_t GetDataSize() const;
 
     protected:
         void Cleanup();
-        std::list<SQLElementData> m_queries;
+        std::vector<SQLElementData> m_queries;
 
     private:
         bool _cleanedUp;
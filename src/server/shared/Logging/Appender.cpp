@@ -77,18 +77,21 @@ void Appender::write(LogMessage* message)
     if (!level || level > message->level)
         return;
 
-    std::ostringstream ss;
+    message->prefix.clear();
 
     if (flags & APPENDER_FLAGS_PREFIX_TIMESTAMP)
-        ss << message->getTimeStr() << ' ';
+        message->prefix.append(message->getTimeStr()).push_back(' ');
 
     if (flags & APPENDER_FLAGS_PREFIX_LOGLEVEL)
-        ss << Trinity::StringFormat("%-5s ", Appender::getLogLevelString(message->level));
+    {
+        char levelStr[12];
+        snprintf(levelStr, sizeof(levelStr), "%-5s ", Appender::getLogLevelString(message->level));
+        message->prefix.append(levelStr);
+    }
 
     if (flags & APPENDER_FLAGS_PREFIX_LOGFILTERTYPE)
-        ss << '[' << message->type << "] ";
+        message->prefix.append(1, '[').append(message->type).append("] ");
 
-    message->prefix = ss.str();
     _write(message);
 }
 
@@ -96,6 +96,8 @@ class Appender
 
         void setLogLevel(LogLevel);
         void write(LogMessage* message);
+        /// Writes out anything buffered by previous write() calls
+        virtual void Flush() { }
         static const char* getLogLevelString(LogLevel level);
 
     private:
@@ -25,6 +25,7 @@
 AppenderFile::AppenderFile(uint8 id, std::string const& name, LogLevel level, const char* filename, const char* logDir, const char* mode, AppenderFlags flags, uint64 fileSize):
     Appender(id, name, APPENDER_FILE, level, flags),
     logfile(NULL),
+    _dynamicBufferSize(0),
     _fileName(filename),
     _logDir(logDir),
     _maxFileSize(fileSize),
@@ -39,36 +40,74 @@ AppenderFile::AppenderFile(uint8 id, std::string const& name, LogLevel level, co
 
 AppenderFile::~AppenderFile()
 {
+    Flush();
     CloseFile();
 }
 
 void AppenderFile::_write(LogMessage const* message)
 {
-    bool exceedMaxSize = _maxFileSize > 0 && (_fileSize.load() + message->Size()) > _maxFileSize;
-
     if (_dynamicName)
     {
         char namebuf[TRINITY_PATH_MAX];
         snprintf(namebuf, TRINITY_PATH_MAX, _fileName.c_str(), message->param1.c_str());
-        // always use "a" with dynamic name otherwise it could delete the log we wrote in last _write() call
-        FILE* file = OpenFile(namebuf, "a", _backup || exceedMaxSize);
-        if (!file)
-            return;
-        fprintf(file, "%s%s\n", message->prefix.c_str(), message->text.c_str());
-        fflush(file);
-        _fileSize += uint64(message->Size());
-        fclose(file);
+
+        // with backups every message starts a new file, don't merge it with one still pending
+        if (_backup && _dynamicBuffers.find(namebuf) != _dynamicBuffers.end())
+            Flush();
+
+        std::string& buffer = _dynamicBuffers[namebuf];
+        buffer.append(message->prefix).append(message->text).push_back('\n');
+        _dynamicBufferSize += message->Size() + 1;
+        if (_dynamicBufferSize >= MAX_BUFFER_SIZE)
+            Flush();
         return;
     }
-    else if (exceedMaxSize)
+
+    if (_maxFileSize > 0 && (_fileSize.load() + _buffer.size() + message->Size()) > _maxFileSize)
+    {
+        Flush();
         logfile = OpenFile(_fileName, "w", true);
+    }
 
     if (!logfile)
         return;
 
-    fprintf(logfile, "%s%s\n", message->prefix.c_str(), message->text.c_str());
+    _buffer.append(message->prefix).append(message->text).push_back('\n');
+    if (_buffer.size() >= MAX_BUFFER_SIZE)
+        Flush();
+}
+
+void AppenderFile::Flush()
+{
+    if (_dynamicName)
+    {
+        // moved out first, OpenFile may need to be called for every file
+        std::unordered_map<std::string, std::string> buffers;
+        buffers.swap(_dynamicBuffers);
+        _dynamicBufferSize = 0;
+
+        for (auto itr = buffers.begin(); itr != buffers.end(); ++itr)
+        {
+            bool exceedMaxSize = _maxFileSize > 0 && (_fileSize.load() + itr->second.size()) > _maxFileSize;
+            // always use "a" with dynamic name otherwise it could delete the log we wrote in last Flush() call
+            FILE* file = OpenFile(itr->first, "a", _backup || exceedMaxSize);
+            if (!file)
+                continue;
+
+            fwrite(itr->second.data(), 1, itr->second.size(), file);
+            _fileSize += uint64(itr->second.size());
+            fclose(file);
+        }
+        return;
+    }
+
+    if (!logfile || _buffer.empty())
+        return;
+
+    fwrite(_buffer.data(), 1, _buffer.size(), logfile);
     fflush(logfile);
-    _fileSize += uint64(message->Size());
+    _fileSize += uint64(_buffer.size());
+    _buffer.clear();
 }
 
 FILE* AppenderFile::OpenFile(std::string const& filename, std::string const& mode, bool backup)
@@ -19,6 +19,7 @@
 #define APPENDERFILE_H
 
 #include <atomic>
+#include <unordered_map>
 #include "Appender.h"
 
 class AppenderFile: public Appender
@@ -27,11 +28,17 @@ class AppenderFile: public Appender
         AppenderFile(uint8 id, std::string const& name, LogLevel level, const char* filename, const char* logDir, const char* mode, AppenderFlags flags, uint64 maxSize);
         ~AppenderFile();
         FILE* OpenFile(std::string const& name, std::string const& mode, bool backup);
+        void Flush() override;
 
     private:
+        static size_t const MAX_BUFFER_SIZE = 64 * 1024;
+
         void CloseFile();
         void _write(LogMessage const* message) override;
         FILE* logfile;
+        std::string _buffer;
+        std::unordered_map<std::string, std::string> _dynamicBuffers;   // file name -> pending text
+        size_t _dynamicBufferSize;
         std::string _fileName;
         std::string _logDir;
         bool _dynamicName;
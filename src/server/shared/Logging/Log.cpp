@@ -23,20 +23,28 @@
 #include "AppenderConsole.h"
 #include "AppenderFile.h"
 #include "AppenderDB.h"
-#include "LogOperation.h"
 
 #include <cstdio>
 #include <sstream>
+#include <chrono>
 
-Log::Log() : _ioService(nullptr), _strand(nullptr)
+Log::Log() : _loggerCacheGeneration(1), _asyncRings(nullptr), _stopAsyncWriter(false), _ringFullWaits(0)
 {
+    for (uint32 i = 0; i < LOGGER_CACHE_SIZE; ++i)
+    {
+        _loggerCache[i].Key.store(0, std::memory_order_relaxed);
+        _loggerCache[i].State.store(0, std::memory_order_relaxed);
+    }
+
     m_logsTimestamp = "_" + GetTimestampStr();
     LoadFromConfig();
 }
 
 Log::~Log()
 {
-    delete _strand;
+    StopAsyncWriter();
+
+    std::lock_guard<std::mutex> lock(_writeLock);
     Close();
 }
 
@@ -263,18 +271,213 @@ void Log::ReadLoggersFromConfig()
     }
 }
 
-void Log::write(std::unique_ptr<LogMessage>&& msg) const
+void Log::write(LogLevel level, char const* type, char const* text, size_t length)
 {
-    Logger const* logger = GetLoggerByType(msg->type);
+    LogRing* rings = _asyncRings.load(std::memory_order_acquire);
+    size_t typeLength = strlen(type);
+    if (!rings || typeLength > LogRing::MAX_TYPE_LENGTH || length > LogRing::MAX_TEXT_LENGTH)
+    {
+        write(Trinity::make_unique<LogMessage>(level, type, std::string(text, length)));
+        return;
+    }
 
-    if (_ioService)
+    LogRing& ring = GetThreadRing();
+    size_t pos;
+    LogRing::Slot* slot;
+    while (!(slot = ring.BeginPush(pos)))
     {
-        auto logOperation = std::shared_ptr<LogOperation>(new LogOperation(logger, std::move(msg)));
+        ++_ringFullWaits;
+        std::this_thread::yield();
+    }
 
-        _ioService->post(_strand->wrap([logOperation](){ logOperation->call(); }));
+    slot->Message = NULL;
+    slot->Time = time(NULL);
+    slot->Level = level;
+    slot->TypeLength = uint8(typeLength);
+    slot->TextLength = uint16(length);
+    memcpy(slot->Type, type, typeLength);
+    memcpy(slot->Text, text, length);
+    ring.EndPush(slot, pos);
+}
+
+void Log::write(std::unique_ptr<LogMessage>&& msg)
+{
+    if (_asyncRings.load(std::memory_order_acquire))
+    {
+        LogRing& ring = GetThreadRing();
+        size_t pos;
+        LogRing::Slot* slot;
+        while (!(slot = ring.BeginPush(pos)))
+        {
+            ++_ringFullWaits;
+            std::this_thread::yield();
+        }
+
+        slot->Message = msg.release();
+        ring.EndPush(slot, pos);
+        return;
     }
-    else
-        logger->write(msg.get());
+
+    std::lock_guard<std::mutex> lock(_writeLock);
+    Dispatch(msg.get());
+    FlushAppenders();
+}
+
+void Log::Dispatch(LogMessage* msg) const
+{
+    if (Logger const* logger = GetLoggerByType(msg->type))
+        logger->write(msg);
+}
+
+void Log::FlushAppenders()
+{
+    for (AppenderMap::iterator it = appenders.begin(); it != appenders.end(); ++it)
+        if (it->second)
+            it->second->Flush();
+}
+
+LogRing& Log::GetThreadRing()
+{
+    // thread ids are often aligned addresses, mix the bits before picking a ring
+    uint64 h = uint64(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    h ^= h >> 33;
+    h *= UI64LIT(0xFF51AFD7ED558CCD);
+    h ^= h >> 33;
+    return _asyncRings.load(std::memory_order_relaxed)[h % ASYNC_RING_COUNT];
+}
+
+void Log::StartAsyncWriter()
+{
+    if (_asyncRings.load(std::memory_order_acquire))
+        return;
+
+    _stopAsyncWriter = false;
+    _asyncRings.store(new LogRing[ASYNC_RING_COUNT], std::memory_order_release);
+    _asyncWriterThread = std::thread(&Log::AsyncWriterThread, this);
+}
+
+void Log::StopAsyncWriter()
+{
+    LogRing* rings = _asyncRings.load(std::memory_order_acquire);
+    if (!rings)
+        return;
+
+    _stopAsyncWriter = true;
+    if (_asyncWriterThread.joinable())
+        _asyncWriterThread.join();
+
+    std::lock_guard<std::mutex> lock(_writeLock);
+    DrainRings();
+    _asyncRings.store(nullptr, std::memory_order_release);
+    delete[] rings;
+}
+
+void Log::AsyncWriterThread()
+{
+    while (!_stopAsyncWriter)
+    {
+        bool wrote;
+        {
+            std::lock_guard<std::mutex> lock(_writeLock);
+            wrote = DrainRings();
+        }
+
+        // nothing queued, messages written in the meantime wait at most this long before reaching the files
+        if (!wrote)
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+}
+
+bool Log::DrainRings()
+{
+    LogRing* rings = _asyncRings.load(std::memory_order_relaxed);
+    bool wrote = false;
+    for (uint32 i = 0; i < ASYNC_RING_COUNT; ++i)
+    {
+        LogRing& ring = rings[i];
+        // bounded so a busy ring can't starve the others
+        for (uint32 count = 0; count < LogRing::SLOT_COUNT; ++count)
+        {
+            LogRing::Slot* slot = ring.Front();
+            if (!slot)
+                break;
+
+            if (slot->Message)
+            {
+                std::unique_ptr<LogMessage> msg(slot->Message);
+                slot->Message = NULL;
+                Dispatch(msg.get());
+            }
+            else
+            {
+                LogMessage msg(slot->Level, std::string(slot->Type, slot->TypeLength), std::string(slot->Text, slot->TextLength));
+                msg.mtime = slot->Time;
+                Dispatch(&msg);
+            }
+
+            ring.Pop();
+            wrote = true;
+        }
+    }
+
+    // one write per appender and pass instead of one per message
+    if (wrote)
+        FlushAppenders();
+
+    return wrote;
+}
+
+LogLevel Log::GetCachedLogLevel(char const* type) const
+{
+    // FNV-1a, keyed by content so temporaries and reused buffers resolve to the same entry
+    uint64 key = UI64LIT(14695981039346656037);
+    for (char const* c = type; *c; ++c)
+    {
+        key ^= uint8(*c);
+        key *= UI64LIT(1099511628211);
+    }
+
+    if (!key)
+        key = 1;
+
+    uint32 generation = _loggerCacheGeneration.load(std::memory_order_acquire) & 0xFFFFFF;
+    LoggerCacheEntry* entry = NULL;
+    for (uint32 i = 0; i < LOGGER_CACHE_PROBES; ++i)
+    {
+        LoggerCacheEntry& candidate = _loggerCache[(key + i) & (LOGGER_CACHE_SIZE - 1)];
+        uint64 current = candidate.Key.load(std::memory_order_acquire);
+        if (!current && candidate.Key.compare_exchange_strong(current, key, std::memory_order_acq_rel))
+            current = key;
+
+        if (current != key)
+            continue;
+
+        uint32 state = candidate.State.load(std::memory_order_acquire);
+        if ((state >> 8) == generation)
+            return LogLevel(state & 0xFF);
+
+        entry = &candidate;
+        break;
+    }
+
+    Logger const* logger = GetLoggerByType(type);
+    LogLevel level = logger ? logger->getLogLevel() : LOG_LEVEL_DISABLED;
+
+    // all probed entries belong to other types, resolve every time
+    if (entry)
+        entry->State.store((generation << 8) | uint32(level), std::memory_order_release);
+
+    return level;
+}
+
+void Log::InvalidateLoggerCache()
+{
+    uint32 generation = (_loggerCacheGeneration.load() + 1) & 0xFFFFFF;
+    // 0 is the state of entries never resolved
+    if (!generation)
+        generation = 1;
+
+    _loggerCacheGeneration.store(generation, std::memory_order_release);
 }
 
 std::string Log::GetTimestampStr()
@@ -300,6 +503,8 @@ bool Log::SetLogLevel(std::string const& name, const char* newLevelc, bool isLog
     if (newLevel < 0)
         return false;
 
+    std::lock_guard<std::mutex> lock(_writeLock);
+
     if (isLogger)
     {
         LoggerMap::iterator it = loggers.begin();
@@ -310,6 +515,7 @@ bool Log::SetLogLevel(std::string const& name, const char* newLevelc, bool isLog
             return false;
 
         it->second.setLogLevel(newLevel);
+        InvalidateLoggerCache();
 
         if (newLevel != LOG_LEVEL_DISABLED && newLevel < lowestLogLevel)
             lowestLogLevel = newLevel;
@@ -346,6 +552,7 @@ void Log::outCharDump(char const* str, uint32 accountId, uint64 guid, char const
 
 void Log::SetRealmId(uint32 id)
 {
+    std::lock_guard<std::mutex> lock(_writeLock);
     for (AppenderMap::iterator it = appenders.begin(); it != appenders.end(); ++it)
         if (it->second && it->second->getType() == APPENDER_DB)
             static_cast<AppenderDB*>(it->second)->setRealmId(id);
@@ -364,6 +571,7 @@ void Log::Close()
 
 void Log::LoadFromConfig()
 {
+    std::lock_guard<std::mutex> lock(_writeLock);
     Close();
 
     lowestLogLevel = LOG_LEVEL_FATAL;
@@ -375,4 +583,5 @@ void Log::LoadFromConfig()
 
     ReadAppendersFromConfig();
     ReadLoggersFromConfig();
+    InvalidateLoggerCache();
 }
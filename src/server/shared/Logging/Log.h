@@ -22,12 +22,14 @@
 #include "Define.h"
 #include "Appender.h"
 #include "Logger.h"
+#include "LogRing.h"
 #include "StringFormat.h"
 #include "Common.h"
-#include <boost/asio/io_service.hpp>
-#include <boost/asio/strand.hpp>
 
 #include <stdarg.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <string>
 #include <memory>
@@ -44,29 +46,30 @@ class Log
 
     public:
 
-        static Log* instance(boost::asio::io_service* ioService = nullptr)
+        static Log* instance()
         {
             static Log instance;
-
-            if (ioService != nullptr)
-            {
-                instance._ioService = ioService;
-                instance._strand = new boost::asio::strand(*ioService);
-            }
-
             return &instance;
         }
 
+        /// Moves writing to the appenders to a background thread, callers only format into per thread rings
+        void StartAsyncWriter();
+
         void LoadFromConfig();
-        void Close();
-        bool ShouldLog(std::string const& type, LogLevel level) const;
+        bool ShouldLog(char const* type, LogLevel level) const;
+        bool ShouldLog(std::string const& type, LogLevel level) const { return ShouldLog(type.c_str(), level); }
         bool SetLogLevel(std::string const& name, char const* level, bool isLogger = true);
+        /// True if a logger is configured for exactly this type, without falling back to a parent logger
+        bool HasLogger(std::string const& type) const { return loggers.find(type) != loggers.end(); }
 
-        template<typename Format, typename... Args>
-        inline void outMessage(std::string const& filter, LogLevel const level, Format&& fmt, Args&&... args)
+        template<typename Filter, typename Format, typename... Args>
+        inline void outMessage(Filter const& filter, LogLevel const level, Format const& format, Args const&... args)
         {
-            write(Trinity::make_unique<LogMessage>(level, filter,
-                Trinity::StringFormat(std::forward<Format>(fmt), std::forward<Args>(args)...)));
+            // formats on the stack, only messages longer than the inline buffer allocate
+            fmt::MemoryWriter text;
+            typename fmt::internal::ArgArray<sizeof...(Args)>::Type array;
+            fmt::printf(text, fmt::CStringRef(GetFormatString(format)), fmt::internal::make_arg_list<char>(array, args...));
+            write(level, GetFilterString(filter), text.data(), text.size());
         }
 
         template<typename Format, typename... Args>
@@ -88,9 +91,41 @@ class Log
 
         void SetRealmId(uint32 id);
 
+        bool IsAsync() const { return _asyncRings.load(std::memory_order_relaxed) != nullptr; }
+        /// Number of times a caller found its ring full and had to wait for the writer
+        uint64 GetRingFullWaits() const { return _ringFullWaits.load(std::memory_order_relaxed); }
+
     private:
+        static uint32 const LOGGER_CACHE_SIZE = 512;       // must be a power of 2
+        static uint32 const LOGGER_CACHE_PROBES = 8;
+        static uint32 const ASYNC_RING_COUNT = 8;
+
+        /// Effective level of a filter type, resolved once per type and configuration
+        struct LoggerCacheEntry
+        {
+            std::atomic<uint64> Key;                        // hash of the type, 0 if unused
+            std::atomic<uint32> State;                      // generation << 8 | LogLevel
+        };
+
+        static char const* GetFilterString(char const* filter) { return filter; }
+        static char const* GetFilterString(std::string const& filter) { return filter.c_str(); }
+        static char const* GetFormatString(char const* fmt) { return fmt; }
+        static char const* GetFormatString(std::string const& fmt) { return fmt.c_str(); }
+
         static std::string GetTimestampStr();
-        void write(std::unique_ptr<LogMessage>&& msg) const;
+        void write(LogLevel level, char const* type, char const* text, size_t length);
+        void write(std::unique_ptr<LogMessage>&& msg);
+        void Dispatch(LogMessage* msg) const;
+        void FlushAppenders();
+
+        LogRing& GetThreadRing();
+        void StopAsyncWriter();
+        void AsyncWriterThread();
+        bool DrainRings();                                  // _writeLock must be held
+        void Close();                                       // _writeLock must be held
+
+        LogLevel GetCachedLogLevel(char const* type) const;
+        void InvalidateLoggerCache();
 
         Logger const* GetLoggerByType(std::string const& type) const;
         Appender* GetAppenderByName(std::string const& name);
@@ -108,8 +143,16 @@ class Log
         std::string m_logsDir;
         std::string m_logsTimestamp;
 
-        boost::asio::io_service* _ioService;
-        boost::asio::strand* _strand;
+        mutable LoggerCacheEntry _loggerCache[LOGGER_CACHE_SIZE];
+        std::atomic<uint32> _loggerCacheGeneration;
+
+        // guards appenders and loggers while messages are written
+        std::mutex _writeLock;
+
+        std::atomic<LogRing*> _asyncRings;
+        std::thread _asyncWriterThread;
+        std::atomic<bool> _stopAsyncWriter;
+        std::atomic<uint64> _ringFullWaits;
 };
 
 inline Logger const* Log::GetLoggerByType(std::string const& type) const
@@ -129,21 +172,13 @@ inline Logger const* Log::GetLoggerByType(std::string const& type) const
     return GetLoggerByType(parentLogger);
 }
 
-inline bool Log::ShouldLog(std::string const& type, LogLevel level) const
+inline bool Log::ShouldLog(char const* type, LogLevel level) const
 {
-    // TODO: Use cache to store "Type.sub1.sub2": "Type" equivalence, should
-    // Speed up in cases where requesting "Type.sub1.sub2" but only configured
-    // Logger "Type"
-
     // Don't even look for a logger if the LogLevel is lower than lowest log levels across all loggers
     if (level < lowestLogLevel)
         return false;
 
-    Logger const* logger = GetLoggerByType(type);
-    if (!logger)
-        return false;
-
-    LogLevel logLevel = logger->getLogLevel();
+    LogLevel logLevel = GetCachedLogLevel(type);
     return logLevel != LOG_LEVEL_DISABLED && logLevel <= level;
 }
 
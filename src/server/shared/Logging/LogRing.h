@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2008-2015 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LOGRING_H
+#define LOGRING_H
+
+#include "Appender.h"
+#include <atomic>
+
+/// Bounded lock-free queue of preformatted log messages, any number of producers and a single consumer.
+/// Slots are preallocated and hold the formatted text inline, messages that do not fit
+/// (or carry extra parameters) are passed as a heap allocated LogMessage instead.
+class LogRing
+{
+    public:
+        static uint32 const SLOT_COUNT = 512;               // must be a power of 2
+        static uint32 const MAX_TYPE_LENGTH = 48;
+        static uint32 const MAX_TEXT_LENGTH = 432;
+
+        struct Slot
+        {
+            std::atomic<size_t> Sequence;
+            LogMessage* Message;                            // owned, when not NULL the inline fields are unused
+            time_t Time;
+            LogLevel Level;
+            uint8 TypeLength;
+            uint16 TextLength;
+            char Type[MAX_TYPE_LENGTH];
+            char Text[MAX_TEXT_LENGTH];
+        };
+
+        LogRing() : _enqueuePos(0), _dequeuePos(0)
+        {
+            for (size_t i = 0; i < SLOT_COUNT; ++i)
+                _slots[i].Sequence.store(i, std::memory_order_relaxed);
+        }
+
+        /// Reserves a slot, returns NULL if the ring is full. Must be followed by EndPush(slot, pos)
+        Slot* BeginPush(size_t& pos)
+        {
+            pos = _enqueuePos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Slot* slot = &_slots[pos & (SLOT_COUNT - 1)];
+                size_t seq = slot->Sequence.load(std::memory_order_acquire);
+                intptr_t diff = intptr_t(seq) - intptr_t(pos);
+                if (diff == 0)
+                {
+                    if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        return slot;
+                }
+                else if (diff < 0)
+                    return NULL;
+                else
+                    pos = _enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        /// Publishes the slot to the consumer
+        void EndPush(Slot* slot, size_t pos)
+        {
+            slot->Sequence.store(pos + 1, std::memory_order_release);
+        }
+
+        /// Consumer only: oldest published slot or NULL
+        Slot* Front()
+        {
+            Slot* slot = &_slots[_dequeuePos & (SLOT_COUNT - 1)];
+            if (slot->Sequence.load(std::memory_order_acquire) != _dequeuePos + 1)
+                return NULL;
+            return slot;
+        }
+
+        /// Consumer only: releases the slot returned by Front()
+        void Pop()
+        {
+            Slot* slot = &_slots[_dequeuePos & (SLOT_COUNT - 1)];
+            slot->Sequence.store(_dequeuePos + SLOT_COUNT, std::memory_order_release);
+            ++_dequeuePos;
+        }
+
+    private:
+        Slot _slots[SLOT_COUNT];
+        std::atomic<size_t> _enqueuePos;
+        size_t _dequeuePos;
+
+        LogRing(LogRing const& right) = delete;
+        LogRing& operator=(LogRing const& right) = delete;
+};
+
+#endif
@@ -24,10 +24,15 @@
 #include "Timer.h"
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
-#include <set>
 #include <thread>
+#include <vector>
+
+/// All socket io (including writes) is driven by the io_service, the network thread only
+/// keeps connections alive and periodically reaps closed ones
+#define SOCKET_SWEEP_INTERVAL 1000
 
 template<class SocketType>
 class NetworkThread
@@ -49,7 +54,9 @@ public:
 
     void Stop()
     {
+        std::lock_guard<std::mutex> lock(_newSocketsLock);
         _stopped = true;
+        _newSocketsCondition.notify_one();
     }
 
     bool Start()
@@ -80,8 +87,9 @@ public:
         std::lock_guard<std::mutex> lock(_newSocketsLock);
 
         ++_connections;
-        _newSockets.insert(sock);
+        _newSockets.push_back(sock);
         SocketAdded(sock);
+        _newSocketsCondition.notify_one();
     }
 
 protected:
@@ -95,7 +103,7 @@ protected:
         if (_newSockets.empty())
             return;
 
-        for (typename SocketSet::const_iterator i = _newSockets.begin(); i != _newSockets.end(); ++i)
+        for (typename SocketContainer::const_iterator i = _newSockets.begin(); i != _newSockets.end(); ++i)
         {
             if (!(*i)->IsOpen())
             {
@@ -104,63 +112,72 @@ protected:
                 --_connections;
             }
             else
-                _Sockets.insert(*i);
+                _sockets.push_back(*i);
         }
 
         _newSockets.clear();
     }
 
-    void Run()
+    void RemoveClosedSockets()
     {
-        TC_LOG_DEBUG("misc", "Network Thread Starting");
+        for (std::size_t i = 0; i < _sockets.size();)
+        {
+            // sockets marked for delayed close are kept until their write handler closed them after the last write
+            std::shared_ptr<SocketType>& sock = _sockets[i];
+            if (!sock->IsClosed())
+            {
+                ++i;
+                continue;
+            }
 
-        typename SocketSet::iterator i, t;
+            sock->CloseSocket();
 
-        uint32 sleepTime = 10;
-        uint32 tickStart = 0, diff = 0;
-        while (!_stopped)
-        {
-            std::this_thread::sleep_for(std::chrono::milliseconds(sleepTime));
+            SocketRemoved(sock);
 
-            tickStart = getMSTime();
+            --_connections;
 
-            AddNewSockets();
+            // order does not matter, swap with the last element to keep the container contiguous
+            if (i != _sockets.size() - 1)
+                std::swap(sock, _sockets.back());
 
-            for (i = _Sockets.begin(); i != _Sockets.end();)
-            {
-                if (!(*i)->Update())
-                {
-                    if ((*i)->IsOpen())
-                        (*i)->CloseSocket();
+            _sockets.pop_back();
+        }
+    }
 
-                    SocketRemoved(*i);
+    void Run()
+    {
+        TC_LOG_DEBUG("misc", "Network Thread Starting");
 
-                    --_connections;
-                    _Sockets.erase(i++);
-                }
-                else
-                    ++i;
+        while (!_stopped)
+        {
+            {
+                std::unique_lock<std::mutex> lock(_newSocketsLock);
+                _newSocketsCondition.wait_for(lock, std::chrono::milliseconds(SOCKET_SWEEP_INTERVAL), [this]()
+                {
+                    return _stopped || !_newSockets.empty();
+                });
             }
 
-            diff = GetMSTimeDiffToNow(tickStart);
-            sleepTime = diff > 10 ? 0 : 10 - diff;
+            AddNewSockets();
+            RemoveClosedSockets();
         }
 
         TC_LOG_DEBUG("misc", "Network Thread exits");
     }
 
 private:
-    typedef std::set<std::shared_ptr<SocketType> > SocketSet;
+    typedef std::vector<std::shared_ptr<SocketType> > SocketContainer;
 
     std::atomic<int32> _connections;
     std::atomic<bool> _stopped;
 
     std::thread* _thread;
 
-    SocketSet _Sockets;
+    SocketContainer _sockets;
 
     std::mutex _newSocketsLock;
-    SocketSet _newSockets;
+    std::condition_variable _newSocketsCondition;
+    SocketContainer _newSockets;
 };
 
 #endif // NetworkThread_h__
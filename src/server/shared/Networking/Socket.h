@@ -19,21 +19,32 @@
 #define __SOCKET_H__
 
 #include "MessageBuffer.h"
+#include "LatencyHistogram.h"
 #include "Log.h"
 #include <atomic>
+#include <chrono>
 #include <vector>
 #include <mutex>
-#include <queue>
+#include <deque>
+#include <algorithm>
 #include <memory>
 #include <functional>
 #include <type_traits>
+#include <boost/asio/io_service.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/write.hpp>
 #include <boost/asio/read.hpp>
+#include <boost/version.hpp>
 
 using boost::asio::ip::tcp;
 
 #define READ_BLOCK_SIZE 4096
+#define WRITE_BLOCK_SIZE 4096
+#define WRITE_GATHER_MAX_BUFFERS 64
+// idle write buffers kept by each socket, at most 32 KiB per connection
+#define WRITE_BUFFER_POOL_SIZE 2
+#define WRITE_BUFFER_POOL_MAX_BUFFER_SIZE 16384
+#define WRITE_SHARED_MIN_SIZE 256
 #ifdef BOOST_ASIO_HAS_IOCP
 #define TC_SOCKET_USE_IOCP
 #endif
@@ -43,9 +54,10 @@ class Socket : public std::enable_shared_from_this<T>
 {
 public:
     explicit Socket(tcp::socket&& socket) : _socket(std::move(socket)), _remoteAddress(_socket.remote_endpoint().address()),
-        _remotePort(_socket.remote_endpoint().port()), _readBuffer(), _closed(false), _closing(false), _isWritingAsync(false)
+        _remotePort(_socket.remote_endpoint().port()), _readBuffer(), _closed(false), _closing(false), _isWritingAsync(false), _hasPendingWrite(false)
     {
         _readBuffer.Resize(READ_BLOCK_SIZE);
+        _gatherBuffers.reserve(WRITE_GATHER_MAX_BUFFERS + 2);
     }
 
     virtual ~Socket()
@@ -57,26 +69,6 @@ public:
 
     virtual void Start() = 0;
 
-    virtual bool Update()
-    {
-        if (!IsOpen())
-            return false;
-
-#ifndef TC_SOCKET_USE_IOCP
-        std::unique_lock<std::mutex> guard(_writeLock);
-        if (!guard)
-            return true;
-
-        if (_isWritingAsync || (!_writeBuffer.GetActiveSize() && _writeQueue.empty()))
-            return true;
-
-        for (; WriteHandler(guard);)
-            ;
-#endif
-
-        return true;
-    }
-
     boost::asio::ip::address GetRemoteIpAddress() const
     {
         return _remoteAddress;
@@ -100,16 +92,13 @@ public:
 
     void QueuePacket(MessageBuffer&& buffer, std::unique_lock<std::mutex>& guard)
     {
-        _writeQueue.push(std::move(buffer));
-
-#ifdef TC_SOCKET_USE_IOCP
-        AsyncProcessQueue(guard);
-#else
-        (void)guard;
-#endif
+        _writeQueue.push_back(WriteQueueEntry(std::move(buffer)));
+        ScheduleWrite(guard);
     }
 
     bool IsOpen() const { return !_closed && !_closing; }
+    /// Sockets marked for delayed close are not open anymore but only closed once their writes are flushed
+    bool IsClosed() const { return _closed; }
 
     void CloseSocket()
     {
@@ -126,15 +115,48 @@ public:
     }
 
     /// Marks the socket for closing after write buffer becomes empty
-    void DelayedCloseSocket() { _closing = true; }
+    void DelayedCloseSocket()
+    {
+        std::unique_lock<std::mutex> guard(_writeLock);
+        _closing = true;
+
+        // nothing in flight that would close it when done
+        if (!_isWritingAsync && !HasPendingWrites())
+            CloseSocket();
+    }
 
     MessageBuffer& GetReadBuffer() { return _readBuffer; }
 
+    /// Time between queueing outgoing data on an idle socket and that data being fully handed to the kernel
+    static LatencyHistogram& GetSendLatencyHistogram() { return _sendLatency; }
+
 protected:
     virtual void OnClose() { }
 
     virtual void ReadHandler() = 0;
 
+    boost::asio::io_service& GetIoService()
+    {
+#if BOOST_VERSION >= 107000
+        return static_cast<boost::asio::io_service&>(_socket.get_executor().context());
+#else
+        return _socket.get_io_service();
+#endif
+    }
+
+    /// Must be called with _writeLock held after appending data to the write buffers.
+    /// Writes are started on demand and driven by socket readiness, idle sockets are never polled
+    void ScheduleWrite(std::unique_lock<std::mutex>& guard)
+    {
+        if (!_hasPendingWrite)
+        {
+            _hasPendingWrite = true;
+            _pendingWriteSince = std::chrono::steady_clock::now();
+        }
+
+        AsyncProcessQueue(guard);
+    }
+
     bool AsyncProcessQueue(std::unique_lock<std::mutex>&)
     {
         if (_isWritingAsync)
@@ -143,8 +165,8 @@ protected:
         _isWritingAsync = true;
 
 #ifdef TC_SOCKET_USE_IOCP
-        MessageBuffer& buffer = _writeQueue.front();
-        _socket.async_write_some(boost::asio::buffer(buffer.GetReadPointer(), buffer.GetActiveSize()), std::bind(&Socket<T>::WriteHandler,
+        PrepareGatherBuffers();
+        _socket.async_write_some(_gatherBuffers, std::bind(&Socket<T>::WriteHandler,
             this->shared_from_this(), std::placeholders::_1, std::placeholders::_2));
 #else
         _socket.async_write_some(boost::asio::null_buffers(), std::bind(&Socket<T>::WriteHandlerWrapper,
@@ -154,13 +176,87 @@ protected:
         return false;
     }
 
+    /// Returns a buffer with room for at least size bytes at the end of the write queue.
+    /// Small writes are appended to the last queued buffer, new buffers are taken from the socket's pool.
+    /// Must be called with _writeLock held
+    MessageBuffer& GetQueuedWriteBuffer(std::size_t size)
+    {
+        if (!_writeQueue.empty() && !_writeQueue.back().SharedData && _writeQueue.back().Buffer.GetRemainingSpace() >= size)
+            return _writeQueue.back().Buffer;
+
+        if (!_writeBufferPool.empty() && _writeBufferPool.back().GetBufferSize() >= size)
+        {
+            _writeQueue.push_back(WriteQueueEntry(std::move(_writeBufferPool.back())));
+            _writeBufferPool.pop_back();
+        }
+        else
+            _writeQueue.push_back(WriteQueueEntry(MessageBuffer(std::max<std::size_t>(size, WRITE_BLOCK_SIZE))));
+
+        return _writeQueue.back().Buffer;
+    }
+
+    /// Queues data that is not modified anymore and may be queued on other sockets as well, it is sent
+    /// straight from the shared memory instead of being copied. Small blocks are copied anyway as that
+    /// is cheaper than an extra gather buffer. Must be called with _writeLock held
+    void QueueSharedBuffer(std::shared_ptr<uint8 const> const& data, std::size_t size)
+    {
+        if (size < WRITE_SHARED_MIN_SIZE)
+        {
+            GetQueuedWriteBuffer(size).Write(data.get(), size);
+            return;
+        }
+
+        // shared data is sent after the owned bytes of the entry, so it can only be attached to the last one
+        if (_writeQueue.empty() || _writeQueue.back().SharedData)
+            _writeQueue.push_back(WriteQueueEntry(MessageBuffer(0)));
+
+        WriteQueueEntry& entry = _writeQueue.back();
+        entry.SharedData = data;
+        entry.SharedSize = size;
+        entry.SharedSent = 0;
+    }
+
+    /// Bytes owned by this socket followed by an optional block shared with other sockets
+    struct WriteQueueEntry
+    {
+        explicit WriteQueueEntry(MessageBuffer&& buffer) : Buffer(std::move(buffer)), SharedSize(0), SharedSent(0) { }
+
+        WriteQueueEntry(WriteQueueEntry&& right) : Buffer(std::move(right.Buffer)), SharedData(std::move(right.SharedData)),
+            SharedSize(right.SharedSize), SharedSent(right.SharedSent) { }
+
+        WriteQueueEntry& operator=(WriteQueueEntry&& right)
+        {
+            Buffer = std::move(right.Buffer);
+            SharedData = std::move(right.SharedData);
+            SharedSize = right.SharedSize;
+            SharedSent = right.SharedSent;
+            return *this;
+        }
+
+        std::size_t GetActiveSize() const { return Buffer.GetActiveSize() + SharedSize - SharedSent; }
+
+        MessageBuffer Buffer;
+        std::shared_ptr<uint8 const> SharedData;
+        std::size_t SharedSize;
+        std::size_t SharedSent;
+    };
+
     std::mutex _writeLock;
-    std::queue<MessageBuffer> _writeQueue;
+    std::deque<WriteQueueEntry> _writeQueue;
 #ifndef TC_SOCKET_USE_IOCP
     MessageBuffer _writeBuffer;
 #endif
 
 private:
+    void WriteDrained()
+    {
+        if (!_hasPendingWrite)
+            return;
+
+        _hasPendingWrite = false;
+        _sendLatency.Record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _pendingWriteSince).count());
+    }
+
     void ReadHandlerInternal(boost::system::error_code error, size_t transferredBytes)
     {
         if (error)
@@ -173,6 +269,91 @@ private:
         ReadHandler();
     }
 
+    /// Collects pending outgoing data into _gatherBuffers so that it can be sent with a single gather write,
+    /// returns total number of bytes to send
+    std::size_t PrepareGatherBuffers()
+    {
+        std::size_t bytesToSend = 0;
+        _gatherBuffers.clear();
+
+#ifndef TC_SOCKET_USE_IOCP
+        if (_writeBuffer.GetActiveSize())
+        {
+            _gatherBuffers.push_back(boost::asio::const_buffer(_writeBuffer.GetReadPointer(), _writeBuffer.GetActiveSize()));
+            bytesToSend += _writeBuffer.GetActiveSize();
+        }
+#endif
+
+        for (typename std::deque<WriteQueueEntry>::iterator itr = _writeQueue.begin(); itr != _writeQueue.end() && _gatherBuffers.size() < WRITE_GATHER_MAX_BUFFERS; ++itr)
+        {
+            if (std::size_t active = itr->Buffer.GetActiveSize())
+            {
+                _gatherBuffers.push_back(boost::asio::const_buffer(itr->Buffer.GetReadPointer(), active));
+                bytesToSend += active;
+            }
+
+            if (std::size_t shared = itr->SharedSize - itr->SharedSent)
+            {
+                _gatherBuffers.push_back(boost::asio::const_buffer(itr->SharedData.get() + itr->SharedSent, shared));
+                bytesToSend += shared;
+            }
+        }
+
+        return bytesToSend;
+    }
+
+    /// Marks bytes as sent, fully sent queue buffers are returned to the pool
+    void ConsumeWrittenBytes(std::size_t bytes)
+    {
+#ifndef TC_SOCKET_USE_IOCP
+        if (std::size_t active = _writeBuffer.GetActiveSize())
+        {
+            std::size_t consumed = std::min(bytes, active);
+            _writeBuffer.ReadCompleted(consumed);
+            if (consumed == active)
+                _writeBuffer.Reset();
+            else
+                _writeBuffer.Normalize();
+
+            bytes -= consumed;
+        }
+#endif
+
+        while (!_writeQueue.empty())
+        {
+            WriteQueueEntry& entry = _writeQueue.front();
+            MessageBuffer& buffer = entry.Buffer;
+            std::size_t consumed = std::min(bytes, buffer.GetActiveSize());
+            buffer.ReadCompleted(consumed);
+            bytes -= consumed;
+
+            consumed = std::min(bytes, entry.SharedSize - entry.SharedSent);
+            entry.SharedSent += consumed;
+            bytes -= consumed;
+
+            if (entry.GetActiveSize())
+                break;
+
+            if (buffer.GetBufferSize() && _writeBufferPool.size() < WRITE_BUFFER_POOL_SIZE && buffer.GetBufferSize() <= WRITE_BUFFER_POOL_MAX_BUFFER_SIZE)
+            {
+                buffer.Reset();
+                _writeBufferPool.push_back(std::move(buffer));
+            }
+
+            _writeQueue.pop_front();
+        }
+    }
+
+    bool HasPendingWrites() const
+    {
+#ifndef TC_SOCKET_USE_IOCP
+        if (_writeBuffer.GetActiveSize())
+            return true;
+#endif
+
+        return !_writeQueue.empty();
+    }
+
 #ifdef TC_SOCKET_USE_IOCP
 
     void WriteHandler(boost::system::error_code error, std::size_t transferedBytes)
@@ -182,14 +363,16 @@ private:
             std::unique_lock<std::mutex> deleteGuard(_writeLock);
 
             _isWritingAsync = false;
-            _writeQueue.front().ReadCompleted(transferedBytes);
-            if (!_writeQueue.front().GetActiveSize())
-                _writeQueue.pop();
+            ConsumeWrittenBytes(transferedBytes);
 
-            if (!_writeQueue.empty())
+            if (HasPendingWrites())
                 AsyncProcessQueue(deleteGuard);
-            else if (_closing)
-                CloseSocket();
+            else
+            {
+                WriteDrained();
+                if (_closing)
+                    CloseSocket();
+            }
         }
         else
             CloseSocket();
@@ -201,77 +384,55 @@ private:
     {
         std::unique_lock<std::mutex> guard(_writeLock);
         _isWritingAsync = false;
-        WriteHandler(guard);
+        for (; WriteHandler(guard);)
+            ;
     }
 
     bool WriteHandler(std::unique_lock<std::mutex>& guard)
     {
-        if (!IsOpen())
+        // sockets marked for delayed close still flush what they have queued
+        if (_closed)
             return false;
 
-        std::size_t bytesToSend = _writeBuffer.GetActiveSize();
-
+        std::size_t bytesToSend = PrepareGatherBuffers();
         if (bytesToSend == 0)
-            return HandleQueue(guard);
-
-        boost::system::error_code error;
-        std::size_t bytesWritten = _socket.write_some(boost::asio::buffer(_writeBuffer.GetReadPointer(), bytesToSend), error);
-
-        if (error)
         {
-            if (error == boost::asio::error::would_block || error == boost::asio::error::try_again)
-                return AsyncProcessQueue(guard);
+            WriteDrained();
+            if (_closing)
+                CloseSocket();
 
             return false;
         }
-        else if (bytesWritten == 0)
-            return false;
-        else if (bytesWritten < bytesToSend)
-        {
-            _writeBuffer.ReadCompleted(bytesWritten);
-            _writeBuffer.Normalize();
-            return AsyncProcessQueue(guard);
-        }
-
-        // now bytesWritten == bytesToSend
-        _writeBuffer.Reset();
-
-        return HandleQueue(guard);
-    }
-
-    bool HandleQueue(std::unique_lock<std::mutex>& guard)
-    {
-        if (_writeQueue.empty())
-            return false;
-
-        MessageBuffer& queuedMessage = _writeQueue.front();
-
-        std::size_t bytesToSend = queuedMessage.GetActiveSize();
 
         boost::system::error_code error;
-        std::size_t bytesSent = _socket.write_some(boost::asio::buffer(queuedMessage.GetReadPointer(), bytesToSend), error);
+        std::size_t bytesWritten = _socket.write_some(_gatherBuffers, error);
 
         if (error)
         {
             if (error == boost::asio::error::would_block || error == boost::asio::error::try_again)
                 return AsyncProcessQueue(guard);
 
-            _writeQueue.pop();
+            CloseSocket();
             return false;
         }
-        else if (bytesSent == 0)
-        {
-            _writeQueue.pop();
+        else if (bytesWritten == 0)
             return false;
-        }
-        else if (bytesSent < bytesToSend) // now n > 0
-        {
-            queuedMessage.ReadCompleted(bytesSent);
+
+        ConsumeWrittenBytes(bytesWritten);
+
+        // kernel send buffer is full, wait until the socket becomes writable again
+        if (bytesWritten < bytesToSend)
             return AsyncProcessQueue(guard);
-        }
 
-        _writeQueue.pop();
-        return !_writeQueue.empty();
+        // more buffers were queued than fit in a single gather write
+        if (HasPendingWrites())
+            return true;
+
+        WriteDrained();
+        if (_closing)
+            CloseSocket();
+
+        return false;
     }
 
 #endif
@@ -287,6 +448,17 @@ private:
     std::atomic<bool> _closing;
 
     bool _isWritingAsync;
+
+    std::vector<MessageBuffer> _writeBufferPool;
+    std::vector<boost::asio::const_buffer> _gatherBuffers;
+
+    bool _hasPendingWrite;
+    std::chrono::steady_clock::time_point _pendingWriteSince;
+
+    static LatencyHistogram _sendLatency;
 };
 
+template<class T>
+LatencyHistogram Socket<T>::_sendLatency;
+
 #endif // __SOCKET_H__
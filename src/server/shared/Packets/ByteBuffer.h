@@ -24,6 +24,7 @@
 #include "ByteConverter.h"
 #include "Util.h"
 
+#include <algorithm>
 #include <exception>
 #include <list>
 #include <map>
@@ -163,16 +164,43 @@ class ByteBuffer
 
         template <typename T> void WriteBits(T value, size_t bits)
         {
-            for (int32 i = bits-1; i >= 0; --i)
-                WriteBit((value >> i) & 1);
+            // fill the current byte with as many bits as fit instead of going bit by bit
+            while (bits)
+            {
+                size_t count = std::min<size_t>(_bitpos, bits);
+                bits -= count;
+                _bitpos -= count;
+                _curbitval |= uint8(((value >> bits) & ((1 << count) - 1)) << _bitpos);
+
+                if (_bitpos == 0)
+                {
+                    _bitpos = 8;
+                    append((uint8 *)&_curbitval, sizeof(_curbitval));
+                    _curbitval = 0;
+                }
+            }
         }
 
         uint32 ReadBits(size_t bits)
         {
+            // consume as many bits of the current byte as needed at once, same order as ReadBit
             uint32 value = 0;
-            for (int32 i = bits-1; i >= 0; --i)
-                if (ReadBit())
-                    value |= (1 << (i));
+            while (bits)
+            {
+                size_t available;
+                if (_bitpos >= 7)
+                {
+                    _curbitval = read<uint8>();
+                    available = 8;
+                }
+                else
+                    available = 7 - _bitpos;
+
+                size_t count = std::min(available, bits);
+                value = (value << count) | ((_curbitval >> (available - count)) & ((1 << count) - 1));
+                _bitpos = 7 - (available - count);
+                bits -= count;
+            }
 
             return value;
         }
@@ -0,0 +1,157 @@
+/*
+* Copyright (C) 2008-2015 TrinityCore <http://www.trinitycore.org/>
+*
+* This program is free software; you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the
+* Free Software Foundation; either version 2 of the License, or (at your
+* option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along
+* with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BOUNDEDMPSCQUEUE_H
+#define BOUNDEDMPSCQUEUE_H
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+//! Fixed size lock-free queue with any number of producer threads and a single consumer thread.
+//! Each slot carries a sequence number telling whether it is free for the producer at that position
+//! or holds a value for the consumer (D. Vyukov's bounded queue), so neither side ever takes a lock.
+template <typename T>
+class BoundedMPSCQueue
+{
+public:
+    //! capacity is rounded up to the next power of two
+    explicit BoundedMPSCQueue(size_t capacity) : _mask(RoundUpToPowerOfTwo(capacity) - 1), _buffer(new Slot[_mask + 1]), _enqueuePos(0), _dequeuePos(0), _highWaterMark(0)
+    {
+        for (size_t i = 0; i <= _mask; ++i)
+            _buffer[i].Sequence.store(i, std::memory_order_relaxed);
+    }
+
+    //! Adds an item to the queue, returns false if the queue is full. Safe to call from any thread.
+    bool add(T const& item)
+    {
+        Slot* slot;
+        size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            slot = &_buffer[pos & _mask];
+            size_t sequence = slot->Sequence.load(std::memory_order_acquire);
+            intptr_t difference = intptr_t(sequence) - intptr_t(pos);
+            if (difference == 0)
+            {
+                if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (difference < 0)
+                return false;
+            else
+                pos = _enqueuePos.load(std::memory_order_relaxed);
+        }
+
+        slot->Data = item;
+        slot->Sequence.store(pos + 1, std::memory_order_release);
+
+        size_t size = pos + 1 - _dequeuePos.load(std::memory_order_relaxed);
+        size_t highWaterMark = _highWaterMark.load(std::memory_order_relaxed);
+        while (size > highWaterMark && !_highWaterMark.compare_exchange_weak(highWaterMark, size, std::memory_order_relaxed))
+            ;
+
+        return true;
+    }
+
+    //! Gets the next item in the queue, if any. Consumer thread only.
+    bool next(T& result)
+    {
+        if (!peek(result))
+            return false;
+
+        pop_front();
+        return true;
+    }
+
+    //! Gets the next item in the queue if the checker accepts it, otherwise it stays at the front. Consumer thread only.
+    template<class Checker>
+    bool next(T& result, Checker& check)
+    {
+        if (!peek(result))
+            return false;
+
+        if (!check.Process(result))
+            return false;
+
+        pop_front();
+        return true;
+    }
+
+    //! Reads the item at the front of the queue without removing it. Consumer thread only.
+    bool peek(T& result) const
+    {
+        size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+        Slot const& slot = _buffer[pos & _mask];
+        if (slot.Sequence.load(std::memory_order_acquire) != pos + 1)
+            return false;
+
+        result = slot.Data;
+        return true;
+    }
+
+    //! Checks if there is an item ready for the consumer. Consumer thread only.
+    bool empty() const
+    {
+        size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+        return _buffer[pos & _mask].Sequence.load(std::memory_order_acquire) != pos + 1;
+    }
+
+    size_t capacity() const { return _mask + 1; }
+
+    //! Largest number of items that were queued at the same time
+    size_t high_water_mark() const { return _highWaterMark.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> Sequence;
+        T Data;
+    };
+
+    static size_t RoundUpToPowerOfTwo(size_t value)
+    {
+        size_t result = 2;
+        while (result < value)
+            result <<= 1;
+        return result;
+    }
+
+    void pop_front()
+    {
+        size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+        _buffer[pos & _mask].Sequence.store(pos + _mask + 1, std::memory_order_release);
+        _dequeuePos.store(pos + 1, std::memory_order_relaxed);
+    }
+
+    size_t const _mask;
+    std::unique_ptr<Slot[]> const _buffer;
+
+    // producers and the consumer write different positions, keep them off each other's cache line
+    char _pad0[64];
+    std::atomic<size_t> _enqueuePos;
+    char _pad1[64];
+    std::atomic<size_t> _dequeuePos;
+    char _pad2[64];
+    std::atomic<size_t> _highWaterMark;
+
+    BoundedMPSCQueue(BoundedMPSCQueue const&) = delete;
+    BoundedMPSCQueue& operator=(BoundedMPSCQueue const&) = delete;
+};
+
+#endif
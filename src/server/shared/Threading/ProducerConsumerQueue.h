@@ -23,6 +23,7 @@
 #include <queue>
 #include <atomic>
 #include <type_traits>
+#include <vector>
 
 template <typename T>
 class ProducerConsumerQueue
@@ -83,6 +84,24 @@ public:
         _queue.pop();
     }
 
+    //! Waits like WaitAndPop, then takes up to maxCount elements at once
+    void WaitAndPop(std::vector<T>& values, std::size_t maxCount)
+    {
+        std::unique_lock<std::mutex> lock(_queueLock);
+
+        while (_queue.empty() && !_shutdown)
+            _condition.wait(lock);
+
+        if (_queue.empty() || _shutdown)
+            return;
+
+        do
+        {
+            values.push_back(_queue.front());
+            _queue.pop();
+        } while (!_queue.empty() && values.size() < maxCount);
+    }
+
     void Cancel()
     {
         std::unique_lock<std::mutex> lock(_queueLock);
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2008-2015 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// zero initialized before any dynamic initialization, operator new may run before main
+static std::atomic<bool> counting;
+static std::atomic<uint64> allocations;
+static std::atomic<uint64> allocatedBytes;
+
+static void* CountedAllocate(std::size_t size)
+{
+    if (counting.load(std::memory_order_relaxed))
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    return std::malloc(size ? size : 1);
+}
+
+void AllocationCounter::Start()
+{
+    allocations = 0;
+    allocatedBytes = 0;
+    counting = true;
+}
+
+AllocationCounter::Stats AllocationCounter::Stop()
+{
+    counting = false;
+
+    Stats stats;
+    stats.Allocations = allocations;
+    stats.Bytes = allocatedBytes;
+    return stats;
+}
+
+void* operator new(std::size_t size)
+{
+    if (void* block = CountedAllocate(size))
+        return block;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    if (void* block = CountedAllocate(size))
+        return block;
+
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::nothrow_t const&) throw()
+{
+    return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size, std::nothrow_t const&) throw()
+{
+    return CountedAllocate(size);
+}
+
+void operator delete(void* block) throw()
+{
+    std::free(block);
+}
+
+void operator delete[](void* block) throw()
+{
+    std::free(block);
+}
+
+void operator delete(void* block, std::nothrow_t const&) throw()
+{
+    std::free(block);
+}
+
+void operator delete[](void* block, std::nothrow_t const&) throw()
+{
+    std::free(block);
+}
@@ -15,28 +15,27 @@
  * with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#ifndef LOGOPERATION_H
-#define LOGOPERATION_H
+#ifndef AllocationCounter_h__
+#define AllocationCounter_h__
 
-#include <memory>
+#include "Define.h"
 
-class Logger;
-struct LogMessage;
-
-class LogOperation
+/// Counts the calls to the global operator new of all threads between Start and Stop, for benchmarks.
+/// Linking this replaces the global operator new and delete of the program with ones forwarding to
+/// malloc and free, outside of a count they only check a flag.
+class AllocationCounter
 {
     public:
-        LogOperation(Logger const* _logger, std::unique_ptr<LogMessage>&& _msg)
-            : logger(_logger), msg(std::forward<std::unique_ptr<LogMessage>>(_msg))
-        { }
-
-        ~LogOperation() { }
-
-        int call();
-
-    protected:
-        Logger const* logger;
-        std::unique_ptr<LogMessage> msg;
+        struct Stats
+        {
+            uint64 Allocations;
+            uint64 Bytes;
+        };
+
+        /// Resets the counters and starts counting
+        static void Start();
+        /// Stops counting and returns what was counted since Start
+        static Stats Stop();
 };
 
-#endif
+#endif // AllocationCounter_h__
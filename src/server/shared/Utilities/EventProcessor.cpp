@@ -18,9 +18,24 @@
 
 #include "EventProcessor.h"
 
+#include <algorithm>
+
+// orders the heap so the event with the earliest execution time is in front, same times by insertion
+struct EventQueueOrder
+{
+    bool operator()(BasicEvent const* left, BasicEvent const* right) const
+    {
+        if (left->m_execTime != right->m_execTime)
+            return left->m_execTime > right->m_execTime;
+
+        return left->m_queueOrder > right->m_queueOrder;
+    }
+};
+
 EventProcessor::EventProcessor()
 {
     m_time = 0;
+    m_queueOrder = 0;
     m_aborting = false;
 }
 
@@ -35,12 +50,10 @@ void EventProcessor::Update(uint32 p_time)
     m_time += p_time;
 
     // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    while (!m_events.empty() && m_events.front()->m_execTime <= m_time)
     {
         // get and remove event from queue
-        BasicEvent* Event = i->second;
-        m_events.erase(i);
+        BasicEvent* Event = PopEvent();
 
         if (!Event->to_Abort)
         {
@@ -64,32 +77,31 @@ void EventProcessor::KillAllEvents(bool force)
     m_aborting = true;
 
     // first, abort all existing events
-    for (EventList::iterator i = m_events.begin(); i != m_events.end();)
-    {
-        EventList::iterator i_old = i;
-        ++i;
-
-        i_old->second->to_Abort = true;
-        i_old->second->Abort(m_time);
-        if (force || i_old->second->IsDeletable())
-        {
-            delete i_old->second;
+    EventList events;
+    events.swap(m_events);
 
-            if (!force)                                      // need per-element cleanup
-                m_events.erase (i_old);
-        }
+    for (BasicEvent* Event : events)
+    {
+        Event->to_Abort = true;
+        Event->Abort(m_time);
+        if (force || Event->IsDeletable())
+            delete Event;
+        else
+            m_events.push_back(Event);                      // kept until it is deletable, aborted on a later update
     }
 
     // fast clear event list (in force case)
     if (force)
         m_events.clear();
+    else
+        std::make_heap(m_events.begin(), m_events.end(), EventQueueOrder());
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
 {
     if (set_addtime) Event->m_addTime = m_time;
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    PushEvent(Event);
 }
 
 uint64 EventProcessor::CalculateTime(uint64 t_offset) const
@@ -97,3 +109,17 @@ uint64 EventProcessor::CalculateTime(uint64 t_offset) const
     return(m_time + t_offset);
 }
 
+void EventProcessor::PushEvent(BasicEvent* Event)
+{
+    Event->m_queueOrder = m_queueOrder++;
+    m_events.push_back(Event);
+    std::push_heap(m_events.begin(), m_events.end(), EventQueueOrder());
+}
+
+BasicEvent* EventProcessor::PopEvent()
+{
+    std::pop_heap(m_events.begin(), m_events.end(), EventQueueOrder());
+    BasicEvent* Event = m_events.back();
+    m_events.pop_back();
+    return Event;
+}
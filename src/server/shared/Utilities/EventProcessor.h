@@ -21,7 +21,7 @@
 
 #include "Define.h"
 
-#include <map>
+#include <vector>
 
 // Note. All times are in milliseconds here.
 
@@ -33,6 +33,7 @@ class BasicEvent
             to_Abort = false;
             m_addTime = 0;
             m_execTime = 0;
+            m_queueOrder = 0;
         }
         virtual ~BasicEvent() { }                           // override destructor to perform some actions on event removal
 
@@ -51,9 +52,11 @@ class BasicEvent
         // these can be used for time offset control
         uint64 m_addTime;                                   // time when the event was added to queue, filled by event handler
         uint64 m_execTime;                                  // planned time of next execution, filled by event handler
+        uint64 m_queueOrder;                                // insertion order, filled by event handler, events planned for the same time execute in the order they were added
 };
 
-typedef std::multimap<uint64, BasicEvent*> EventList;
+// events are the nodes of the queue themselves, queueing one only stores its pointer in the heap
+typedef std::vector<BasicEvent*> EventList;
 
 class EventProcessor
 {
@@ -67,7 +70,12 @@ class EventProcessor
         uint64 CalculateTime(uint64 t_offset) const;
     protected:
         uint64 m_time;
-        EventList m_events;
+        EventList m_events;                                 // binary heap, the next event to execute is in front
+        uint64 m_queueOrder;
         bool m_aborting;
+
+    private:
+        void PushEvent(BasicEvent* Event);
+        BasicEvent* PopEvent();
 };
 #endif
@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2008-2015 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FlatHashMap_h__
+#define FlatHashMap_h__
+
+#include "Define.h"
+#include "Errors.h"
+#include <iterator>
+#include <utility>
+#include <vector>
+
+/// Open addressed hash map from uint32 ids to small values, stored in a single array with linear probing.
+/// Follows the std::unordered_map interface as far as it is used, with two differences:
+/// key 0xFFFFFFFF is reserved to mark free slots and inserting may move elements, so
+/// pointers and iterators are invalidated by operator[] and erase().
+template<class Value>
+class FlatHashMap
+{
+    public:
+        typedef uint32 key_type;
+        typedef Value mapped_type;
+        typedef std::pair<uint32, Value> value_type;
+
+        static uint32 const FREE_KEY = 0xFFFFFFFF;
+
+        template<class Slot>
+        class Iterator : public std::iterator<std::forward_iterator_tag, Slot>
+        {
+            public:
+                Iterator(Slot* slot, Slot* end) : _slot(slot), _end(end) { SkipFree(); }
+
+                template<class Other>
+                Iterator(Iterator<Other> const& right) : _slot(right._slot), _end(right._end) { }
+
+                Slot& operator*() const { return *_slot; }
+                Slot* operator->() const { return _slot; }
+
+                Iterator& operator++() { ++_slot; SkipFree(); return *this; }
+                Iterator operator++(int) { Iterator itr = *this; ++(*this); return itr; }
+
+                template<class Other>
+                bool operator==(Iterator<Other> const& right) const { return _slot == right._slot; }
+                template<class Other>
+                bool operator!=(Iterator<Other> const& right) const { return _slot != right._slot; }
+
+            private:
+                template<class> friend class Iterator;
+                friend class FlatHashMap;
+
+                void SkipFree()
+                {
+                    while (_slot != _end && _slot->first == FREE_KEY)
+                        ++_slot;
+                }
+
+                Slot* _slot;
+                Slot* _end;
+        };
+
+        typedef Iterator<value_type> iterator;
+        typedef Iterator<value_type const> const_iterator;
+
+        FlatHashMap() : _size(0) { }
+
+        iterator begin() { return iterator(_slots.data(), _slots.data() + _slots.size()); }
+        iterator end() { return iterator(_slots.data() + _slots.size(), _slots.data() + _slots.size()); }
+        const_iterator begin() const { return const_iterator(_slots.data(), _slots.data() + _slots.size()); }
+        const_iterator end() const { return const_iterator(_slots.data() + _slots.size(), _slots.data() + _slots.size()); }
+
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+        void clear()
+        {
+            _slots.clear();
+            _size = 0;
+        }
+
+        iterator find(uint32 key)
+        {
+            size_t index = FindSlot(key);
+            return index < _slots.size() ? iterator(&_slots[index], _slots.data() + _slots.size()) : end();
+        }
+
+        const_iterator find(uint32 key) const
+        {
+            size_t index = FindSlot(key);
+            return index < _slots.size() ? const_iterator(&_slots[index], _slots.data() + _slots.size()) : end();
+        }
+
+        Value& operator[](uint32 key)
+        {
+            ASSERT(key != FREE_KEY);
+
+            size_t index = FindSlot(key);
+            if (index < _slots.size())
+                return _slots[index].second;
+
+            // keep at least half of the slots free, probe sequences stay short
+            if ((_size + 1) * 2 > _slots.size())
+                Grow();
+
+            size_t mask = _slots.size() - 1;
+            for (index = Hash(key) & mask; _slots[index].first != FREE_KEY; index = (index + 1) & mask)
+                ;
+
+            _slots[index].first = key;
+            _slots[index].second = Value();
+            ++_size;
+            return _slots[index].second;
+        }
+
+        void erase(iterator itr)
+        {
+            // backward shift deletion, moves every following element of the probe sequence that
+            // may live in the freed slot one step back so no tombstones are needed
+            size_t mask = _slots.size() - 1;
+            size_t hole = size_t(itr._slot - _slots.data());
+            for (size_t index = (hole + 1) & mask; _slots[index].first != FREE_KEY; index = (index + 1) & mask)
+            {
+                size_t home = Hash(_slots[index].first) & mask;
+                if (((index - home) & mask) >= ((index - hole) & mask))
+                {
+                    _slots[hole] = std::move(_slots[index]);
+                    hole = index;
+                }
+            }
+
+            _slots[hole].first = FREE_KEY;
+            _slots[hole].second = Value();
+            --_size;
+        }
+
+        size_t erase(uint32 key)
+        {
+            iterator itr = find(key);
+            if (itr == end())
+                return 0;
+
+            erase(itr);
+            return 1;
+        }
+
+    private:
+        static size_t Hash(uint32 key)
+        {
+            // ids are mostly sequential, spread them with a multiplicative hash
+            return size_t((key * 2654435761u) >> 7);
+        }
+
+        size_t FindSlot(uint32 key) const
+        {
+            if (_slots.empty())
+                return 0;
+
+            size_t mask = _slots.size() - 1;
+            for (size_t index = Hash(key) & mask; _slots[index].first != FREE_KEY; index = (index + 1) & mask)
+                if (_slots[index].first == key)
+                    return index;
+
+            return _slots.size();
+        }
+
+        void Grow()
+        {
+            std::vector<value_type> old;
+            old.swap(_slots);
+            _slots.resize(old.empty() ? 16 : old.size() * 2, value_type(FREE_KEY, Value()));
+
+            size_t mask = _slots.size() - 1;
+            for (value_type& slot : old)
+            {
+                if (slot.first == FREE_KEY)
+                    continue;
+
+                size_t index = Hash(slot.first) & mask;
+                while (_slots[index].first != FREE_KEY)
+                    index = (index + 1) & mask;
+
+                _slots[index] = std::move(slot);
+            }
+        }
+
+        std::vector<value_type> _slots;
+        size_t _size;
+};
+
+#endif // FlatHashMap_h__
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2008-2015 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LatencyHistogram_h__
+#define LatencyHistogram_h__
+
+#include "Define.h"
+#include <atomic>
+
+/// Lock-free histogram of durations in microseconds.
+/// Bucket N holds samples in [2^(N-1), 2^N) us, bucket 0 holds samples below 1 us
+/// and the last bucket collects everything that does not fit anywhere else.
+class LatencyHistogram
+{
+public:
+    static uint32 const BUCKET_COUNT = 32;
+
+    LatencyHistogram() { Reset(); }
+
+    void Record(uint64 microseconds)
+    {
+        _buckets[GetBucket(microseconds)].fetch_add(1, std::memory_order_relaxed);
+        _count.fetch_add(1, std::memory_order_relaxed);
+        _total.fetch_add(microseconds, std::memory_order_relaxed);
+
+        uint64 max = _max.load(std::memory_order_relaxed);
+        while (microseconds > max && !_max.compare_exchange_weak(max, microseconds, std::memory_order_relaxed))
+            ;
+    }
+
+    void Reset()
+    {
+        for (uint32 i = 0; i < BUCKET_COUNT; ++i)
+            _buckets[i].store(0, std::memory_order_relaxed);
+
+        _count.store(0, std::memory_order_relaxed);
+        _total.store(0, std::memory_order_relaxed);
+        _max.store(0, std::memory_order_relaxed);
+    }
+
+    uint64 GetCount() const { return _count.load(std::memory_order_relaxed); }
+    uint64 GetMax() const { return _max.load(std::memory_order_relaxed); }
+
+    uint64 GetAverage() const
+    {
+        uint64 count = GetCount();
+        return count ? _total.load(std::memory_order_relaxed) / count : 0;
+    }
+
+    /// Returns the upper bound (in microseconds) of the bucket containing the given percentile (0-100)
+    uint64 GetPercentile(uint32 percentile) const
+    {
+        uint64 count = GetCount();
+        if (!count)
+            return 0;
+
+        uint64 wanted = (count * percentile + 99) / 100;
+        uint64 seen = 0;
+        for (uint32 i = 0; i < BUCKET_COUNT; ++i)
+        {
+            seen += _buckets[i].load(std::memory_order_relaxed);
+            if (seen >= wanted)
+                return i + 1 < BUCKET_COUNT ? (UI64LIT(1) << i) : GetMax();
+        }
+
+        return GetMax();
+    }
+
+private:
+    static uint32 GetBucket(uint64 value)
+    {
+        uint32 bucket = 0;
+        while (value && bucket < BUCKET_COUNT - 1)
+        {
+            value >>= 1;
+            ++bucket;
+        }
+
+        return bucket;
+    }
+
+    std::atomic<uint64> _buckets[BUCKET_COUNT];
+    std::atomic<uint64> _count;
+    std::atomic<uint64> _total;
+    std::atomic<uint64> _max;
+};
+
+#endif // LatencyHistogram_h__
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2008-2015 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MappedFile.h"
+
+#if PLATFORM == PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : _data(NULL), _size(0)
+{
+#if PLATFORM == PLATFORM_WINDOWS
+    _mapping = NULL;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+#if PLATFORM == PLATFORM_WINDOWS
+
+bool MappedFile::Open(char const* fileName, bool copyOnWrite /*= false*/)
+{
+    Close();
+
+    HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || !size.QuadPart)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    // the mapping keeps its own reference to the file
+    _mapping = CreateFileMappingA(file, NULL, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!_mapping)
+        return false;
+
+    _data = static_cast<uint8*>(MapViewOfFile(_mapping, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0));
+    if (!_data)
+    {
+        CloseHandle(_mapping);
+        _mapping = NULL;
+        return false;
+    }
+
+    _size = size_t(size.QuadPart);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (_data)
+        UnmapViewOfFile(_data);
+
+    if (_mapping)
+        CloseHandle(_mapping);
+
+    _data = NULL;
+    _mapping = NULL;
+    _size = 0;
+}
+
+#else
+
+bool MappedFile::Open(char const* fileName, bool copyOnWrite /*= false*/)
+{
+    Close();
+
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) || !st.st_size)
+    {
+        close(fd);
+        return false;
+    }
+
+    // the mapping keeps its own reference to the file
+    void* data = mmap(NULL, size_t(st.st_size), copyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return false;
+
+    _data = static_cast<uint8*>(data);
+    _size = size_t(st.st_size);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (_data)
+        munmap(_data, _size);
+
+    _data = NULL;
+    _size = 0;
+}
+
+#endif
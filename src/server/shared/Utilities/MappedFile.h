@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2008-2015 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MappedFile_h__
+#define MappedFile_h__
+
+#include "Define.h"
+
+/// Read only view of a whole file mapped into the address space, unmapped on destruction.
+/// Pages are only read from disk when touched and are shared through the page cache with every
+/// other process mapping the same file. A copy on write view may be written to, the written pages
+/// become private to this mapping and the file itself is never modified.
+class MappedFile
+{
+    public:
+        MappedFile();
+        ~MappedFile();
+
+        bool Open(char const* fileName, bool copyOnWrite = false);
+        void Close();
+
+        bool IsOpen() const { return _data != NULL; }
+        uint8* GetData() const { return _data; }
+        size_t GetSize() const { return _size; }
+
+    private:
+        uint8* _data;
+        size_t _size;
+#if PLATFORM == PLATFORM_WINDOWS
+        void* _mapping;                                     // HANDLE of the file mapping object
+#endif
+
+        MappedFile(MappedFile const& right) = delete;
+        MappedFile& operator=(MappedFile const& right) = delete;
+};
+
+#endif // MappedFile_h__
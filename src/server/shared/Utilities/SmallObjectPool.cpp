@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2008-2015 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SmallObjectPool.h"
+#include <boost/thread/tss.hpp>
+
+// size classes are multiples of this, the alignment ::operator new gives on 64 bit platforms
+static size_t const POOL_GRANULARITY = 16;
+static size_t const POOL_CLASS_COUNT = SmallObjectPool::MAX_POOLED_SIZE / POOL_GRANULARITY;
+// free blocks kept per class and thread, what is freed beyond goes back to the heap
+static uint32 const MAX_FREE_BLOCKS = 512;
+
+std::atomic<bool> SmallObjectPool::_enabled(true);
+
+namespace
+{
+    struct FreeBlock
+    {
+        FreeBlock* Next;
+    };
+
+    struct ThreadPool
+    {
+        ThreadPool()
+        {
+            for (size_t i = 0; i < POOL_CLASS_COUNT; ++i)
+            {
+                FreeLists[i] = nullptr;
+                FreeCounts[i] = 0;
+            }
+
+            Stats.Allocations = 0;
+            Stats.HeapAllocations = 0;
+        }
+
+        ~ThreadPool()
+        {
+            for (size_t i = 0; i < POOL_CLASS_COUNT; ++i)
+            {
+                while (FreeBlock* block = FreeLists[i])
+                {
+                    FreeLists[i] = block->Next;
+                    ::operator delete(block);
+                }
+            }
+        }
+
+        FreeBlock* FreeLists[POOL_CLASS_COUNT];
+        uint32 FreeCounts[POOL_CLASS_COUNT];
+        SmallObjectPool::Stats Stats;
+    };
+
+    boost::thread_specific_ptr<ThreadPool> threadPool;
+
+    ThreadPool* GetThreadPool()
+    {
+        ThreadPool* pool = threadPool.get();
+        if (!pool)
+        {
+            pool = new ThreadPool();
+            threadPool.reset(pool);
+        }
+
+        return pool;
+    }
+
+    size_t GetSizeClass(size_t size)
+    {
+        return size ? (size - 1) / POOL_GRANULARITY : 0;
+    }
+}
+
+void* SmallObjectPool::Allocate(size_t size)
+{
+    if (size > MAX_POOLED_SIZE)
+        return ::operator new(size);
+
+    ThreadPool* pool = GetThreadPool();
+    ++pool->Stats.Allocations;
+
+    size_t sizeClass = GetSizeClass(size);
+    if (_enabled)
+    {
+        if (FreeBlock* block = pool->FreeLists[sizeClass])
+        {
+            pool->FreeLists[sizeClass] = block->Next;
+            --pool->FreeCounts[sizeClass];
+            return block;
+        }
+    }
+
+    ++pool->Stats.HeapAllocations;
+    return ::operator new((sizeClass + 1) * POOL_GRANULARITY);
+}
+
+void SmallObjectPool::Deallocate(void* block, size_t size)
+{
+    if (!block)
+        return;
+
+    if (size > MAX_POOLED_SIZE || !_enabled)
+    {
+        ::operator delete(block);
+        return;
+    }
+
+    ThreadPool* pool = GetThreadPool();
+    size_t sizeClass = GetSizeClass(size);
+    if (pool->FreeCounts[sizeClass] >= MAX_FREE_BLOCKS)
+    {
+        ::operator delete(block);
+        return;
+    }
+
+    FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+    freeBlock->Next = pool->FreeLists[sizeClass];
+    pool->FreeLists[sizeClass] = freeBlock;
+    ++pool->FreeCounts[sizeClass];
+}
+
+SmallObjectPool::Stats SmallObjectPool::GetThreadStats()
+{
+    return GetThreadPool()->Stats;
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2008-2015 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SmallObjectPool_h__
+#define SmallObjectPool_h__
+
+#include "Define.h"
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <utility>
+
+/// Keeps freed blocks of the short lived objects created on every cast (spells, their events and
+/// target list nodes) in per thread free lists, sized in 16 byte classes. Maps are updated by one
+/// thread at a time, so the objects of a map are reused by the thread updating it without locking.
+/// Every block is allocated with ::operator new of its class size, a block may be freed on
+/// any thread and the pool may be disabled at any time.
+class SmallObjectPool
+{
+    public:
+        struct Stats
+        {
+            uint64 Allocations;                             // blocks requested from the pool
+            uint64 HeapAllocations;                         // requests the free lists could not serve
+        };
+
+        static size_t const MAX_POOLED_SIZE = 2048;
+
+        static void* Allocate(size_t size);
+        static void Deallocate(void* block, size_t size);
+
+        static void SetEnabled(bool enabled) { _enabled = enabled; }
+        static bool IsEnabled() { return _enabled; }
+
+        // counters of the calling thread
+        static Stats GetThreadStats();
+
+    private:
+        static std::atomic<bool> _enabled;
+};
+
+/// Standard allocator on top of SmallObjectPool, for node based containers
+template<class T>
+class PoolAllocator
+{
+    public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef T const* const_pointer;
+        typedef T& reference;
+        typedef T const& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        template<class U>
+        struct rebind { typedef PoolAllocator<U> other; };
+
+        PoolAllocator() { }
+        template<class U>
+        PoolAllocator(PoolAllocator<U> const& /*right*/) { }
+
+        pointer address(reference value) const { return &value; }
+        const_pointer address(const_reference value) const { return &value; }
+
+        pointer allocate(size_type count, void const* /*hint*/ = nullptr)
+        {
+            if (count > max_size())
+                throw std::bad_alloc();
+
+            return static_cast<pointer>(SmallObjectPool::Allocate(count * sizeof(T)));
+        }
+
+        void deallocate(pointer block, size_type count) { SmallObjectPool::Deallocate(block, count * sizeof(T)); }
+
+        size_type max_size() const { return std::numeric_limits<size_type>::max() / sizeof(T); }
+
+        template<class U, class... Args>
+        void construct(U* object, Args&&... args) { ::new(static_cast<void*>(object)) U(std::forward<Args>(args)...); }
+
+        template<class U>
+        void destroy(U* object) { object->~U(); }
+
+        template<class U>
+        bool operator==(PoolAllocator<U> const& /*right*/) const { return true; }
+        template<class U>
+        bool operator!=(PoolAllocator<U> const& /*right*/) const { return false; }
+};
+
+#endif // SmallObjectPool_h__
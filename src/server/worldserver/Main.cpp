@@ -124,8 +124,8 @@ extern int main(int argc, char** argv)
 
     if (sConfigMgr->GetBoolDefault("Log.Async.Enable", false))
     {
-        // If logs are supposed to be handled async then we need to pass the io_service into the Log singleton
-        Log::instance(&_ioService);
+        // Callers only queue their messages, a dedicated thread writes them to the appenders
+        sLog->StartAsyncWriter();
     }
 
     TC_LOG_INFO("server.worldserver", "%s (worldserver-daemon)", _FULLVERSION);
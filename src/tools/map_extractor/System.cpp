@@ -373,11 +373,28 @@ void ReadLiquidTypeTableDBC()
 
 // Map file format data
 static char const* MAP_MAGIC         = "MAPS";
-static char const* MAP_VERSION_MAGIC = "v1.3";
+static char const* MAP_VERSION_MAGIC = "v1.4";
 static char const* MAP_AREA_MAGIC    = "AREA";
 static char const* MAP_HEIGHT_MAGIC  = "MHGT";
 static char const* MAP_LIQUID_MAGIC  = "MLIQ";
 
+// every section starts at a multiple of this, the server points into memory mapped files
+// instead of copying them and needs the arrays aligned to their element size
+static uint32 const MAP_SECTION_ALIGNMENT = 16;
+
+static uint32 AlignMapSection(uint32 offset)
+{
+    return (offset + MAP_SECTION_ALIGNMENT - 1) & ~(MAP_SECTION_ALIGNMENT - 1);
+}
+
+static void PadMapSection(FILE* output, uint32 offset)
+{
+    char const padding[MAP_SECTION_ALIGNMENT] = { };
+    long position = ftell(output);
+    if (position >= 0 && uint32(position) < offset)
+        fwrite(padding, offset - uint32(position), 1, output);
+}
+
 struct map_fileheader
 {
     uint32 mapMagic;
@@ -519,7 +536,7 @@ bool ConvertADT(char *filename, char *filename2, int /*cell_y*/, int /*cell_x*/,
         }
     }
 
-    map.areaMapOffset = sizeof(map);
+    map.areaMapOffset = AlignMapSection(sizeof(map));
     map.areaMapSize   = sizeof(map_areaHeader);
 
     map_areaHeader areaHeader;
@@ -648,7 +665,7 @@ bool ConvertADT(char *filename, char *filename2, int /*cell_y*/, int /*cell_x*/,
             maxHeight = CONF_use_minHeight;
     }
 
-    map.heightMapOffset = map.areaMapOffset + map.areaMapSize;
+    map.heightMapOffset = AlignMapSection(map.areaMapOffset + map.areaMapSize);
     map.heightMapSize = sizeof(map_heightHeader);
 
     map_heightHeader heightHeader;
@@ -894,7 +911,7 @@ bool ConvertADT(char *filename, char *filename2, int /*cell_y*/, int /*cell_x*/,
                     liquid_height[y][x] = CONF_use_minHeight;
             }
         }
-        map.liquidMapOffset = map.heightMapOffset + map.heightMapSize;
+        map.liquidMapOffset = AlignMapSection(map.heightMapOffset + map.heightMapSize);
         map.liquidMapSize = sizeof(map_liquidHeader);
         liquidHeader.fourcc = *(uint32 const*)MAP_LIQUID_MAGIC;
         liquidHeader.flags = 0;
@@ -928,9 +945,9 @@ bool ConvertADT(char *filename, char *filename2, int /*cell_y*/, int /*cell_x*/,
     uint16 holes[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
 
     if (map.liquidMapOffset)
-        map.holesOffset = map.liquidMapOffset + map.liquidMapSize;
+        map.holesOffset = AlignMapSection(map.liquidMapOffset + map.liquidMapSize);
     else
-        map.holesOffset = map.heightMapOffset + map.heightMapSize;
+        map.holesOffset = AlignMapSection(map.heightMapOffset + map.heightMapSize);
 
     memset(holes, 0, sizeof(holes));
     bool hasHoles = false;
@@ -962,11 +979,13 @@ bool ConvertADT(char *filename, char *filename2, int /*cell_y*/, int /*cell_x*/,
     }
     fwrite(&map, sizeof(map), 1, output);
     // Store area data
+    PadMapSection(output, map.areaMapOffset);
     fwrite(&areaHeader, sizeof(areaHeader), 1, output);
     if (!(areaHeader.flags&MAP_AREA_NO_AREA))
         fwrite(area_flags, sizeof(area_flags), 1, output);
 
     // Store height data
+    PadMapSection(output, map.heightMapOffset);
     fwrite(&heightHeader, sizeof(heightHeader), 1, output);
     if (!(heightHeader.flags & MAP_HEIGHT_NO_HEIGHT))
     {
@@ -990,6 +1009,7 @@ bool ConvertADT(char *filename, char *filename2, int /*cell_y*/, int /*cell_x*/,
     // Store liquid data if need
     if (map.liquidMapOffset)
     {
+        PadMapSection(output, map.liquidMapOffset);
         fwrite(&liquidHeader, sizeof(liquidHeader), 1, output);
         if (!(liquidHeader.flags & MAP_LIQUID_NO_TYPE))
         {
@@ -1006,7 +1026,10 @@ bool ConvertADT(char *filename, char *filename2, int /*cell_y*/, int /*cell_x*/,
 
     // store hole data
     if (hasHoles)
+    {
+        PadMapSection(output, map.holesOffset);
         fwrite(holes, map.holesSize, 1, output);
+    }
 
     fclose(output);
 
@@ -80,7 +80,9 @@ struct map_liquidHeader
 namespace MMAP
 {
 
-    char const* MAP_VERSION_MAGIC = "v1.3";
+    char const* MAP_VERSION_MAGIC = "v1.4";
+    // same sections without the padding that aligns them, still readable
+    char const* MAP_VERSION_MAGIC_UNALIGNED = "v1.3";
 
     TerrainBuilder::TerrainBuilder(bool skipLiquid) : m_skipLiquid (skipLiquid){ }
     TerrainBuilder::~TerrainBuilder() { }
@@ -142,7 +144,7 @@ namespace MMAP
 
         map_fileheader fheader;
         if (fread(&fheader, sizeof(map_fileheader), 1, mapFile) != 1 ||
-            fheader.versionMagic != *((uint32 const*)(MAP_VERSION_MAGIC)))
+            (fheader.versionMagic != *((uint32 const*)(MAP_VERSION_MAGIC)) && fheader.versionMagic != *((uint32 const*)(MAP_VERSION_MAGIC_UNALIGNED))))
         {
             fclose(mapFile);
             printf("%s is the wrong version, please extract new .map files\n", mapFileName);